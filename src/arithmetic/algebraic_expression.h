@@ -217,6 +217,17 @@ void AlgebraicExpression_Eval
 	GrB_Matrix res                  // Result output.
 );
 
+/* Evaluate a flat multiplication into a UINT64 matrix, carrying the entries
+ * of the expression's single non-diagonal operand (other than the left-most)
+ * into the result, e.g. F * L * R * L yields R's edge IDs.
+ * Each row of the left-most operand is expected to hold at most one entry,
+ * such that every result entry originates from a single relation entry. */
+void AlgebraicExpression_EvalCarry
+(
+	const AlgebraicExpression *exp, // Root node.
+	GrB_Matrix res                  // UINT64 result output.
+);
+
 //------------------------------------------------------------------------------
 // AlgebraicExpression debugging utilities.
 //------------------------------------------------------------------------------
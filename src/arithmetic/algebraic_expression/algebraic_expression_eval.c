@@ -6,6 +6,7 @@
 
 #include "utils.h"
 #include "../../query_ctx.h"
+#include "../../util/thread_budget.h"
 #include "../algebraic_expression.h"
 
 // Forward declarations
@@ -21,7 +22,9 @@ static GrB_Matrix _Eval_Transpose
 
 	AlgebraicExpression *child = FIRST_CHILD(exp);
 	assert(child->type == AL_OPERAND);
-	GrB_Info info = GrB_transpose(res, GrB_NULL, GrB_NULL, child->operand.matrix, GrB_NULL);
+	GrB_Descriptor desc = ThreadBudget_Acquire(GrB_NULL);
+	GrB_Info info = GrB_transpose(res, GrB_NULL, GrB_NULL, child->operand.matrix, desc);
+	ThreadBudget_Release();
 	assert(info == GrB_SUCCESS);
 	return res;
 }
@@ -83,8 +86,10 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 	}
 
 	// Perform addition.
-	if(GrB_eWiseAdd_Matrix_Semiring(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, a, b,
-									desc) != GrB_SUCCESS) {
+	info = GrB_eWiseAdd_Matrix_Semiring(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, a, b,
+										ThreadBudget_Acquire(desc));
+	ThreadBudget_Release();
+	if(info != GrB_SUCCESS) {
 		printf("Failed adding operands, error:%s\n", GrB_error());
 		assert(false);
 	}
@@ -116,8 +121,10 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 		}
 
 		// Perform addition.
-		if(GrB_eWiseAdd_Matrix_Semiring(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, res, b,
-										GrB_NULL) != GrB_SUCCESS) {
+		info = GrB_eWiseAdd_Matrix_Semiring(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, res, b,
+											ThreadBudget_Acquire(GrB_NULL));
+		ThreadBudget_Release();
+		if(info != GrB_SUCCESS) {
 			printf("Failed adding operands, error:%s\n", GrB_error());
 			assert(false);
 		}
@@ -161,7 +168,9 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 		// Reset descriptor, as the identity matrix does not need to be transposed.
 		if(desc != GrB_NULL) GrB_Descriptor_set(desc, GrB_INP1, GxB_DEFAULT);
 		// B is the identity matrix, Perform A * I.
-		info = GrB_Matrix_apply(res, GrB_NULL, GrB_NULL, GrB_IDENTITY_BOOL, A, desc);
+		info = GrB_Matrix_apply(res, GrB_NULL, GrB_NULL, GrB_IDENTITY_BOOL, A,
+								ThreadBudget_Acquire(desc));
+		ThreadBudget_Release();
 		if(info != GrB_SUCCESS) {
 			// If the multiplication failed, print error info to stderr and exit.
 			fprintf(stderr, "Encountered an error in matrix multiplication:\n%s\n", GrB_error());
@@ -169,7 +178,8 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 		}
 	} else {
 		// Perform multiplication.
-		info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, A, B, desc);
+		info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, A, B, ThreadBudget_Acquire(desc));
+		ThreadBudget_Release();
 		if(info != GrB_SUCCESS) {
 			// If the multiplication failed, print error info to stderr and exit.
 			fprintf(stderr, "Encountered an error in matrix multiplication:\n%s\n", GrB_error());
@@ -200,7 +210,9 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 			// Reset descriptor, as the identity matrix does not need to be transposed.
 			if(desc != GrB_NULL) GrB_Descriptor_set(desc, GrB_INP1, GxB_DEFAULT);
 			// Perform multiplication.
-			info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, res, B, desc);
+			info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, res, B,
+						   ThreadBudget_Acquire(desc));
+			ThreadBudget_Release();
 			if(info != GrB_SUCCESS) {
 				// If the multiplication failed, print error info to stderr and exit.
 				fprintf(stderr, "Encountered an error in matrix multiplication:\n%s\n", GrB_error());
@@ -254,3 +266,45 @@ void AlgebraicExpression_Eval(const AlgebraicExpression *exp, GrB_Matrix res) {
 	_AlgebraicExpression_Eval(exp, res);
 }
 
+void AlgebraicExpression_EvalCarry(const AlgebraicExpression *exp, GrB_Matrix res) {
+	assert(exp &&
+		   exp->type == AL_OPERATION &&
+		   exp->operation.op == AL_EXP_MUL);
+
+	GrB_Info info;
+	bool carrying = false;
+	GrB_Matrix A = CHILD_AT(exp, 0)->operand.matrix;
+	uint child_count = AlgebraicExpression_ChildCount(exp);
+
+	for(uint i = 1; i < child_count; i++) {
+		AlgebraicExpression *right = CHILD_AT(exp, i);
+		assert(right->type == AL_OPERAND);
+		GrB_Matrix B = right->operand.matrix;
+		if(B == IDENTITY_MATRIX) continue;
+
+		/* As each entry is the product of a single pair of entries:
+		 * before reaching the carried operand entries are irrelevant,
+		 * the carried operand's entries are taken as is,
+		 * and are kept by following multiplications. */
+		GrB_Semiring semiring = GxB_ANY_PAIR_UINT64;
+		if(!right->operand.diagonal) {
+			assert(!carrying);
+			semiring = GxB_ANY_SECOND_UINT64;
+			carrying = true;
+		} else if(carrying) {
+			semiring = GxB_ANY_FIRST_UINT64;
+		}
+
+		info = GrB_mxm(res, GrB_NULL, GrB_NULL, semiring, A, B, ThreadBudget_Acquire(GrB_NULL));
+		ThreadBudget_Release();
+		if(info != GrB_SUCCESS) {
+			// If the multiplication failed, print error info to stderr and exit.
+			fprintf(stderr, "Encountered an error in matrix multiplication:\n%s\n", GrB_error());
+			assert(false);
+		}
+		A = res;
+	}
+
+	assert(carrying);
+}
+
@@ -67,6 +67,20 @@ static AR_ExpNode *_AR_EXP_NewOpNode(const char *func_name, uint child_count) {
 	return node;
 }
 
+/* Attribute access nodes created before the attribute was introduced
+ * hold ATTRIBUTE_NOTFOUND, in which case the attribute ID is resolved
+ * by name on every evaluation, try resolving it now. */
+static void _AR_EXP_ResolveAttribute(AR_ExpNode *exp) {
+	if(!AR_EXP_IsAttribute(exp, NULL)) return;
+
+	AR_ExpNode *idx = exp->op.children[2];
+	if(!AR_EXP_IsConstant(idx) || idx->operand.constant.longval != ATTRIBUTE_NOTFOUND) return;
+
+	const char *attr = exp->op.children[1]->operand.constant.stringval;
+	Attribute_ID id = GraphContext_GetAttributeID(QueryCtx_GetGraphCtx(), attr);
+	if(id != ATTRIBUTE_NOTFOUND) idx->operand.constant = SI_LongVal(id);
+}
+
 static AR_ExpNode *_AR_EXP_CloneOp(AR_ExpNode *exp) {
 	AR_ExpNode *clone = _AR_EXP_NewOpNode(exp->op.func_name, exp->op.child_count);
 	if(exp->op.type == AR_OP_FUNC) {
@@ -83,6 +97,8 @@ static AR_ExpNode *_AR_EXP_CloneOp(AR_ExpNode *exp) {
 		AR_ExpNode *child = AR_EXP_Clone(exp->op.children[i]);
 		clone->op.children[i] = child;
 	}
+	// Plans are cloned once per execution, resolve late-bound attributes.
+	_AR_EXP_ResolveAttribute(clone);
 	return clone;
 }
 
@@ -247,7 +263,7 @@ bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val) {
 	}
 }
 
-static bool _AR_EXP_ValidateInvocation(AR_FuncDesc *fdesc, SIValue *argv, uint argc) {
+bool AR_EXP_ValidateInvocation(AR_FuncDesc *fdesc, SIValue *argv, uint argc) {
 	SIType actual_type;
 	SIType expected_type = T_NULL;
 
@@ -336,7 +352,7 @@ static AR_EXP_Result _AR_EXP_EvaluateFunctionCall(AR_ExpNode *node, const Record
 	if(include_privdata) sub_trees[child_count - 1] = SI_PtrVal(node->op.f->privdata);
 
 	/* Validate before evaluation. */
-	if(!_AR_EXP_ValidateInvocation(node->op.f, sub_trees, child_count)) {
+	if(!AR_EXP_ValidateInvocation(node->op.f, sub_trees, child_count)) {
 		// The expression tree failed its validations and set an error message.
 		res = EVAL_ERR;
 		goto cleanup;
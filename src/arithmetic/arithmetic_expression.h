@@ -116,6 +116,10 @@ bool AR_EXP_PerformDistinct(AR_ExpNode *op);
  * The val pointer is out-by-ref returned computation. */
 bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val);
 
+/* Validates function's arguments against its signature,
+ * sets a query-level error and returns false on mismatch. */
+bool AR_EXP_ValidateInvocation(AR_FuncDesc *fdesc, SIValue *argv, uint argc);
+
 /* Evaluate arithmetic expression tree. */
 SIValue AR_EXP_Evaluate(AR_ExpNode *root, const Record r);
 void AR_EXP_Aggregate(const AR_ExpNode *root, const Record r);
@@ -0,0 +1,487 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "./arithmetic_program.h"
+
+#include "../RG.h"
+#include "rax.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+
+#include <string.h>
+#include <strings.h>
+
+//------------------------------------------------------------------------------
+// Program construction
+//------------------------------------------------------------------------------
+
+AR_Program *AR_Program_New(void) {
+	AR_Program *p = rm_malloc(sizeof(AR_Program));
+	p->code = array_new(AR_Instruction, 8);
+	p->regs = array_new(SIValue, 8);
+	p->constant = array_new(bool, 8);
+	p->owned = array_new(SIValue, 0);
+	p->args = array_new(uint, 0);
+	p->cse = array_new(AR_ComputedExp, 4);
+	p->result = AR_PROGRAM_INVALID_REG;
+	return p;
+}
+
+uint AR_Program_NewRegister(AR_Program *p) {
+	p->regs = array_append(p->regs, SI_NullVal());
+	p->constant = array_append(p->constant, false);
+	return array_len(p->regs) - 1;
+}
+
+// Allocates a register initialized to a constant, the value is not owned by the program.
+static uint _AR_Program_ConstRegister(AR_Program *p, SIValue v) {
+	p->regs = array_append(p->regs, SI_ShareValue(v));
+	p->constant = array_append(p->constant, true);
+	return array_len(p->regs) - 1;
+}
+
+static inline AR_Instruction *_AR_Program_Append(AR_Program *p, AR_OpCode code, uint dst) {
+	AR_Instruction ins = {.code = code, .dst = dst};
+	p->code = array_append(p->code, ins);
+	return &array_tail(p->code);
+}
+
+// Returns true if both expressions are structurally identical.
+static bool _AR_Program_SameExp(const AR_ExpNode *a, const AR_ExpNode *b) {
+	if(a->type != b->type) return false;
+
+	if(a->type == AR_EXP_OP) {
+		if(a->op.type != AR_OP_FUNC || b->op.type != AR_OP_FUNC) return false;
+		if(a->op.f != b->op.f) return false;
+		if(a->op.child_count != b->op.child_count) return false;
+		for(int i = 0; i < a->op.child_count; i++) {
+			if(!_AR_Program_SameExp(a->op.children[i], b->op.children[i])) return false;
+		}
+		return true;
+	}
+
+	if(a->operand.type != b->operand.type) return false;
+	switch(a->operand.type) {
+	case AR_EXP_CONSTANT: {
+		SIValue x = a->operand.constant;
+		SIValue y = b->operand.constant;
+		if(SI_TYPE(x) != SI_TYPE(y)) return false;
+		int disjointOrNull = 0;
+		return (SIValue_Compare(x, y, &disjointOrNull) == 0 && disjointOrNull == 0);
+	}
+	case AR_EXP_VARIADIC:
+		return strcmp(a->operand.variadic.entity_alias, b->operand.variadic.entity_alias) == 0;
+	case AR_EXP_PARAM:
+		return strcmp(a->operand.param_name, b->operand.param_name) == 0;
+	default:
+		return false;
+	}
+}
+
+// Returns true if expression is deterministic given a record
+// and can therefore be computed once and reused.
+static bool _AR_Program_Reusable(const AR_ExpNode *exp) {
+	if(exp->type == AR_EXP_OPERAND) return exp->operand.type == AR_EXP_VARIADIC;
+	if(exp->op.type != AR_OP_FUNC) return false;
+	AR_FuncDesc *f = exp->op.f;
+	if(f->privdata) return false;
+	return f->reducible || strcasecmp(f->name, "property") == 0;
+}
+
+static uint _AR_Program_Lookup(const AR_Program *p, const AR_ExpNode *exp) {
+	uint n = array_len(p->cse);
+	for(uint i = 0; i < n; i++) {
+		if(_AR_Program_SameExp(p->cse[i].exp, exp)) return p->cse[i].reg;
+	}
+	return AR_PROGRAM_INVALID_REG;
+}
+
+// Checks arguments against function's signature without reporting errors.
+static bool _AR_Program_AcceptsArgs(const AR_FuncDesc *f, const SIValue *argv, uint argc) {
+	if(argc < f->min_argc || argc > f->max_argc) return false;
+
+	SIType expected_type = T_NULL;
+	uint expected_types_count = array_len(f->types);
+	for(uint i = 0; i < argc; i++) {
+		if(i < expected_types_count) expected_type = f->types[i];
+		if(!(SI_TYPE(argv[i]) & expected_type)) return false;
+	}
+	return true;
+}
+
+// Evaluates a reducible function over constant arguments at compile time,
+// returns the register holding the result or AR_PROGRAM_INVALID_REG.
+static uint _AR_Program_Fold(AR_Program *p, AR_FuncDesc *f, const uint *regs, uint argc) {
+	SIValue argv[argc + 1];
+	for(uint i = 0; i < argc; i++) argv[i] = p->regs[regs[i]];
+	if(!_AR_Program_AcceptsArgs(f, argv, argc)) return AR_PROGRAM_INVALID_REG;
+
+	SIValue v = f->func(argv, argc);
+	// Similar to AR_EXP_ReduceToScalar, NULLs are not folded.
+	if(SIValue_IsNull(v)) return AR_PROGRAM_INVALID_REG;
+
+	if(v.allocation == M_SELF || v.allocation == M_SHARED) p->owned = array_append(p->owned, v);
+	return _AR_Program_ConstRegister(p, v);
+}
+
+static uint _AR_Program_EmitOperand(AR_Program *p, AR_ExpNode *exp) {
+	AR_Instruction *ins;
+	uint dst;
+
+	switch(exp->operand.type) {
+	case AR_EXP_CONSTANT:
+		return _AR_Program_ConstRegister(p, exp->operand.constant);
+	case AR_EXP_PARAM: {
+		rax *params = QueryCtx_GetParams();
+		AR_ExpNode *param = raxFind(params, (unsigned char *)exp->operand.param_name,
+									strlen(exp->operand.param_name));
+		// Missing parameters are reported by the expression evaluator.
+		if(param == raxNotFound) return AR_PROGRAM_INVALID_REG;
+		return _AR_Program_ConstRegister(p, param->operand.constant);
+	}
+	case AR_EXP_VARIADIC:
+		dst = AR_Program_NewRegister(p);
+		ins = _AR_Program_Append(p, AR_INS_LOAD, dst);
+		ins->entry.alias = exp->operand.variadic.entity_alias;
+		ins->entry.idx = INVALID_INDEX;
+		return dst;
+	case AR_EXP_BORROW_RECORD:
+		dst = AR_Program_NewRegister(p);
+		_AR_Program_Append(p, AR_INS_RECORD, dst);
+		return dst;
+	default:
+		ASSERT(false && "Invalid expression type");
+		return AR_PROGRAM_INVALID_REG;
+	}
+}
+
+static uint _AR_Program_EmitOp(AR_Program *p, AR_ExpNode *exp) {
+	// Aggregated values are produced outside of the expression tree.
+	if(exp->op.type == AR_OP_AGGREGATE) return AR_PROGRAM_INVALID_REG;
+
+	AR_FuncDesc *f = exp->op.f;
+	uint argc = exp->op.child_count;
+	uint regs[argc + 1];
+	bool constant = f->reducible && f->privdata == NULL;
+
+	for(uint i = 0; i < argc; i++) {
+		regs[i] = AR_Program_EmitExpression(p, exp->op.children[i]);
+		if(regs[i] == AR_PROGRAM_INVALID_REG) return AR_PROGRAM_INVALID_REG;
+		constant &= p->constant[regs[i]];
+	}
+
+	if(constant) {
+		uint reg = _AR_Program_Fold(p, f, regs, argc);
+		if(reg != AR_PROGRAM_INVALID_REG) return reg;
+	}
+
+	AR_Instruction *ins;
+	uint dst = AR_Program_NewRegister(p);
+
+	if(argc == 3 && strcasecmp(f->name, "property") == 0 &&
+	   AR_EXP_IsConstant(exp->op.children[1]) && AR_EXP_IsConstant(exp->op.children[2])) {
+		const char *name = exp->op.children[1]->operand.constant.stringval;
+		Attribute_ID id = exp->op.children[2]->operand.constant.longval;
+		GraphContext *gc = QueryCtx_GetGraphCtx();
+		// The attribute might have been introduced since the expression was built.
+		if(id == ATTRIBUTE_NOTFOUND) id = GraphContext_GetAttributeID(gc, name);
+		ins = _AR_Program_Append(p, AR_INS_PROPERTY, dst);
+		ins->a = regs[0];
+		ins->f = f;
+		ins->attr.name = name;
+		ins->attr.id = id;
+		ins->attr.attr_count = GraphContext_AttributeCount(gc);
+		return dst;
+	}
+
+	if(argc == 2) {
+		AR_OpCode code = AR_INS_CALL;
+		if(strcasecmp(f->name, "add") == 0) code = AR_INS_ADD;
+		else if(strcasecmp(f->name, "sub") == 0) code = AR_INS_SUB;
+		else if(strcasecmp(f->name, "mul") == 0) code = AR_INS_MUL;
+		if(code != AR_INS_CALL) {
+			ins = _AR_Program_Append(p, code, dst);
+			ins->a = regs[0];
+			ins->b = regs[1];
+			ins->f = f;
+			return dst;
+		}
+	}
+
+	ins = _AR_Program_Append(p, AR_INS_CALL, dst);
+	ins->f = f;
+	ins->argc = argc;
+	ins->argv = array_len(p->args);
+	for(uint i = 0; i < argc; i++) p->args = array_append(p->args, regs[i]);
+	return dst;
+}
+
+uint AR_Program_EmitExpression(AR_Program *p, AR_ExpNode *exp) {
+	bool reusable = _AR_Program_Reusable(exp);
+	if(reusable) {
+		uint reg = _AR_Program_Lookup(p, exp);
+		if(reg != AR_PROGRAM_INVALID_REG) return reg;
+	}
+
+	uint reg;
+	if(exp->type == AR_EXP_OP) reg = _AR_Program_EmitOp(p, exp);
+	else reg = _AR_Program_EmitOperand(p, exp);
+
+	if(reusable && reg != AR_PROGRAM_INVALID_REG) {
+		AR_ComputedExp computed = {.exp = exp, .reg = reg};
+		p->cse = array_append(p->cse, computed);
+	}
+	return reg;
+}
+
+void AR_Program_EmitCompare(AR_Program *p, AST_Operator op, uint lhs, uint rhs, uint dst) {
+	AR_Instruction *ins = _AR_Program_Append(p, AR_INS_CMP, dst);
+	ins->a = lhs;
+	ins->b = rhs;
+	ins->op = op;
+}
+
+void AR_Program_EmitTruthy(AR_Program *p, uint src, uint dst) {
+	AR_Instruction *ins = _AR_Program_Append(p, AR_INS_TRUTHY, dst);
+	ins->a = src;
+}
+
+uint AR_Program_EmitJump(AR_Program *p, uint src, bool when) {
+	AR_OpCode code = (when) ? AR_INS_JMP_TRUE : AR_INS_JMP_FALSE;
+	AR_Instruction *ins = _AR_Program_Append(p, code, AR_PROGRAM_INVALID_REG);
+	ins->a = src;
+	return array_len(p->code) - 1;
+}
+
+void AR_Program_PatchJump(AR_Program *p, uint jump) {
+	ASSERT(p->code[jump].code == AR_INS_JMP_TRUE || p->code[jump].code == AR_INS_JMP_FALSE);
+	p->code[jump].target = array_len(p->code);
+}
+
+uint AR_Program_ScopeBegin(const AR_Program *p) {
+	return array_len(p->cse);
+}
+
+void AR_Program_ScopeEnd(AR_Program *p, uint scope) {
+	// Values computed within the scope are not guaranteed to be set.
+	p->cse = array_trimm_len(p->cse, scope);
+}
+
+void AR_Program_SetResult(AR_Program *p, uint reg) {
+	ASSERT(reg < array_len(p->regs));
+	p->result = reg;
+}
+
+AR_Program *AR_Program_FromExpression(AR_ExpNode *exp) {
+	AR_Program *p = AR_Program_New();
+	uint reg = AR_Program_EmitExpression(p, exp);
+	if(reg == AR_PROGRAM_INVALID_REG) {
+		AR_Program_Free(p);
+		return NULL;
+	}
+	AR_Program_SetResult(p, reg);
+	return p;
+}
+
+//------------------------------------------------------------------------------
+// Program evaluation
+//------------------------------------------------------------------------------
+
+static inline bool _AR_Program_ApplyOp(AST_Operator op, int rel) {
+	switch(op) {
+	case OP_EQUAL:
+		return rel == 0;
+	case OP_NEQUAL:
+		return rel != 0;
+	case OP_GT:
+		return rel > 0;
+	case OP_GE:
+		return rel >= 0;
+	case OP_LT:
+		return rel < 0;
+	case OP_LE:
+		return rel <= 0;
+	default:
+		ASSERT(false && "Unexpected comparison operator");
+		return false;
+	}
+}
+
+// Compares a and b, mirrors the semantics of filter tree predicates.
+static inline bool _AR_Program_Compare(SIValue a, SIValue b, AST_Operator op) {
+	if(SI_TYPE(a) == T_INT64 && SI_TYPE(b) == T_INT64) {
+		return _AR_Program_ApplyOp(op, (a.longval > b.longval) - (a.longval < b.longval));
+	}
+
+	int disjointOrNull = 0;
+	int rel = SIValue_Compare(a, b, &disjointOrNull);
+	// Comparisons against NULL fail.
+	if(disjointOrNull == COMPARED_NULL) return false;
+	// Values of disjoint types are only unequal.
+	if(disjointOrNull == DISJOINT) return op == OP_NEQUAL;
+	return _AR_Program_ApplyOp(op, rel);
+}
+
+// Mirrors the semantics of filter tree expressions.
+static inline bool _AR_Program_Truthy(SIValue v) {
+	if(SIValue_IsNull(v)) return false;
+	if(SI_TYPE(v) & (SI_NUMERIC | T_BOOL)) return SI_GET_NUMERIC(v) != 0;
+	if(SI_TYPE(v) & T_ARRAY) return SIArray_Length(v) != 0;
+	return true;
+}
+
+// Generic function invocation, returns false if an error was encountered.
+static bool _AR_Program_Invoke(AR_FuncDesc *f, SIValue *argv, uint argc, SIValue *result) {
+	// Functions with private data will have it appended as an additional argument.
+	if(f->privdata) argv[argc++] = SI_PtrVal(f->privdata);
+
+	if(!AR_EXP_ValidateInvocation(f, argv, argc)) return false;
+
+	*result = f->func(argv, argc);
+	// An error was encountered while evaluating the function.
+	if(SIValue_IsNull(*result) && QueryCtx_EncounteredError()) return false;
+	return true;
+}
+
+static bool _AR_Program_ResolveEntry(AR_Instruction *ins, const Record r) {
+	if(!r) {
+		QueryCtx_SetError("No record was given to locate a value with alias %s", ins->entry.alias);
+		return false;
+	}
+	int idx = Record_GetEntryIdx(r, ins->entry.alias);
+	if(idx == INVALID_INDEX) {
+		QueryCtx_SetError("Unable to locate a value with alias %s within the record", ins->entry.alias);
+		return false;
+	}
+	ins->entry.idx = idx;
+	return true;
+}
+
+static inline void _AR_Program_FreeRegisters(SIValue *regs, uint count, uint keep) {
+	for(uint i = 0; i < count; i++) {
+		if(i != keep) SIValue_Free(regs[i]);
+	}
+}
+
+SIValue AR_Program_Evaluate(AR_Program *p, const Record r) {
+	ASSERT(p->result != AR_PROGRAM_INVALID_REG);
+
+	uint reg_count = array_len(p->regs);
+	uint ins_count = array_len(p->code);
+	SIValue regs[reg_count];
+	// Constants are shared, all other registers start out as NULL.
+	memcpy(regs, p->regs, sizeof(SIValue) * reg_count);
+
+	uint pc = 0;
+	while(pc < ins_count) {
+		AR_Instruction *ins = p->code + pc;
+		pc++;
+
+		switch(ins->code) {
+		case AR_INS_LOAD:
+			if(ins->entry.idx == INVALID_INDEX && !_AR_Program_ResolveEntry(ins, r)) goto error;
+			// The value was not created here; share with the caller.
+			regs[ins->dst] = SI_ShareValue(Record_Get(r, ins->entry.idx));
+			break;
+		case AR_INS_RECORD:
+			regs[ins->dst] = SI_PtrVal(r);
+			break;
+		case AR_INS_PROPERTY: {
+			SIValue e = regs[ins->a];
+			if(SI_TYPE(e) & (T_NODE | T_EDGE)) {
+				// A missing attribute is only looked up again once new attributes were added.
+				if(ins->attr.id == ATTRIBUTE_NOTFOUND) {
+					GraphContext *gc = QueryCtx_GetGraphCtx();
+					uint attr_count = GraphContext_AttributeCount(gc);
+					if(attr_count != ins->attr.attr_count) {
+						ins->attr.id = GraphContext_GetAttributeID(gc, ins->attr.name);
+						ins->attr.attr_count = attr_count;
+					}
+				}
+				SIValue *v = GraphEntity_GetProperty((GraphEntity *)e.ptrval, ins->attr.id);
+				regs[ins->dst] = SI_ConstValue(*v);
+			} else if(SIValue_IsNull(e)) {
+				regs[ins->dst] = SI_NullVal();
+			} else {
+				SIValue argv[4] = {e, SI_ConstStringVal((char *)ins->attr.name), SI_LongVal(ins->attr.id)};
+				if(!_AR_Program_Invoke(ins->f, argv, 3, regs + ins->dst)) goto error;
+			}
+			break;
+		}
+		case AR_INS_ADD:
+		case AR_INS_SUB:
+		case AR_INS_MUL: {
+			SIValue a = regs[ins->a];
+			SIValue b = regs[ins->b];
+			if(SI_TYPE(a) == T_INT64 && SI_TYPE(b) == T_INT64) {
+				int64_t x = a.longval;
+				int64_t y = b.longval;
+				int64_t v = (ins->code == AR_INS_ADD) ? x + y : (ins->code == AR_INS_SUB) ? x - y : x * y;
+				regs[ins->dst] = SI_LongVal(v);
+			} else if((SI_TYPE(a) & SI_NUMERIC) && (SI_TYPE(b) & SI_NUMERIC)) {
+				double x = SI_GET_NUMERIC(a);
+				double y = SI_GET_NUMERIC(b);
+				double v = (ins->code == AR_INS_ADD) ? x + y : (ins->code == AR_INS_SUB) ? x - y : x * y;
+				regs[ins->dst] = SI_DoubleVal(v);
+			} else {
+				// Strings, lists and NULLs.
+				SIValue argv[3] = {a, b};
+				if(!_AR_Program_Invoke(ins->f, argv, 2, regs + ins->dst)) goto error;
+			}
+			break;
+		}
+		case AR_INS_CALL: {
+			SIValue argv[ins->argc + 1];
+			const uint *args = p->args + ins->argv;
+			for(uint i = 0; i < ins->argc; i++) argv[i] = regs[args[i]];
+			if(!_AR_Program_Invoke(ins->f, argv, ins->argc, regs + ins->dst)) goto error;
+			break;
+		}
+		case AR_INS_CMP:
+			regs[ins->dst] = SI_BoolVal(_AR_Program_Compare(regs[ins->a], regs[ins->b], ins->op));
+			break;
+		case AR_INS_TRUTHY:
+			regs[ins->dst] = SI_BoolVal(_AR_Program_Truthy(regs[ins->a]));
+			break;
+		case AR_INS_JMP_FALSE:
+			if(!regs[ins->a].longval) pc = ins->target;
+			break;
+		case AR_INS_JMP_TRUE:
+			if(regs[ins->a].longval) pc = ins->target;
+			break;
+		default:
+			ASSERT(false && "Unknown instruction");
+		}
+	}
+
+	SIValue result = regs[p->result];
+	_AR_Program_FreeRegisters(regs, reg_count, p->result);
+	return result;
+
+error:
+	_AR_Program_FreeRegisters(regs, reg_count, AR_PROGRAM_INVALID_REG);
+	QueryCtx_RaiseRuntimeException();  // Raise an exception if we're in a run-time context.
+	return SI_NullVal(); // Otherwise return NULL; the query-level error will be emitted after cleanup.
+}
+
+void AR_Program_Free(AR_Program *p) {
+	if(p == NULL) return;
+
+	uint owned_count = array_len(p->owned);
+	for(uint i = 0; i < owned_count; i++) SIValue_Free(p->owned[i]);
+
+	array_free(p->code);
+	array_free(p->regs);
+	array_free(p->constant);
+	array_free(p->owned);
+	array_free(p->args);
+	array_free(p->cse);
+	rm_free(p);
+}
+
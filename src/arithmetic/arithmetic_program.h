@@ -0,0 +1,132 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "./func_desc.h"
+#include "./arithmetic_expression.h"
+#include "../ast/ast_shared.h"
+#include "../execution_plan/record.h"
+#include "../graph/entities/graph_entity.h"
+
+/* AR_Program is a flat, register based compilation of arithmetic expressions.
+ * Expressions are lowered once per execution, after query parameters are
+ * known, into a linear sequence of instructions which is then evaluated
+ * for every record without recursion.
+ *
+ * While lowering, sub-expressions with constant inputs are folded and
+ * repeated deterministic sub-expressions are computed once,
+ * e.g. in `n.v > 1 AND n.v < 5` the attribute n.v is fetched a single time. */
+
+#define AR_PROGRAM_INVALID_REG UINT_MAX
+
+/* AR_OpCode lists instructions of an arithmetic program. */
+typedef enum {
+	AR_INS_LOAD,        // dst = record[entry]
+	AR_INS_RECORD,      // dst = pointer to the current record
+	AR_INS_PROPERTY,    // dst = attribute of graph entity a
+	AR_INS_ADD,         // dst = a + b, numeric fast path
+	AR_INS_SUB,         // dst = a - b, numeric fast path
+	AR_INS_MUL,         // dst = a * b, numeric fast path
+	AR_INS_CALL,        // dst = f(args)
+	AR_INS_CMP,         // dst = a op b, using filter semantics
+	AR_INS_TRUTHY,      // dst = truthiness of a, using filter semantics
+	AR_INS_JMP_FALSE,   // if a is false jump to target
+	AR_INS_JMP_TRUE,    // if a is true jump to target
+} AR_OpCode;
+
+typedef struct {
+	AR_OpCode code;         // Instruction type.
+	uint dst;               // Destination register.
+	uint a;                 // First operand register.
+	uint b;                 // Second operand register.
+	AR_FuncDesc *f;         // Function to invoke, fallback for specialized instructions.
+	uint argc;              // Number of arguments, AR_INS_CALL.
+	uint argv;              // Offset of first argument within program args, AR_INS_CALL.
+	union {
+		AST_Operator op;    // Comparison operator, AR_INS_CMP.
+		uint target;        // Jump target, AR_INS_JMP_*.
+		struct {
+			const char *alias;
+			int idx;
+		} entry;            // Record entry, AR_INS_LOAD.
+		struct {
+			const char *name;
+			Attribute_ID id;
+			uint attr_count;    // Number of graph attributes when id was resolved.
+		} attr;             // Attribute, AR_INS_PROPERTY.
+	};
+} AR_Instruction;
+
+/* Sub-expression computed into a register. */
+typedef struct {
+	AR_ExpNode *exp;
+	uint reg;
+} AR_ComputedExp;
+
+typedef struct {
+	AR_Instruction *code;   // Instructions.
+	SIValue *regs;          // Initial register file, holds constants.
+	bool *constant;         // Marks registers holding constants.
+	SIValue *owned;         // Constants produced by folding, owned by the program.
+	uint *args;             // Argument registers of AR_INS_CALL instructions.
+	AR_ComputedExp *cse;    // Computed sub-expressions visible at this point.
+	uint result;            // Register holding the program's result.
+} AR_Program;
+
+/* Creates a new empty program. */
+AR_Program *AR_Program_New(void);
+
+/* Compiles a single arithmetic expression,
+ * returns NULL if the expression can't be compiled,
+ * in which case it should be evaluated using AR_EXP_Evaluate. */
+AR_Program *AR_Program_FromExpression(AR_ExpNode *exp);
+
+//------------------------------------------------------------------------------
+// Program construction
+//------------------------------------------------------------------------------
+
+/* Appends instructions evaluating 'exp', returns the register holding
+ * the expression's value or AR_PROGRAM_INVALID_REG if 'exp' can't be compiled,
+ * e.g. it contains an aggregation function or a missing parameter. */
+uint AR_Program_EmitExpression(AR_Program *p, AR_ExpNode *exp);
+
+/* Allocates a new register. */
+uint AR_Program_NewRegister(AR_Program *p);
+
+/* Appends an instruction setting 'dst' to the boolean result of 'lhs op rhs'. */
+void AR_Program_EmitCompare(AR_Program *p, AST_Operator op, uint lhs, uint rhs, uint dst);
+
+/* Appends an instruction setting 'dst' to the boolean truthiness of 'src'. */
+void AR_Program_EmitTruthy(AR_Program *p, uint src, uint dst);
+
+/* Appends a conditional jump taken when the boolean in 'src' equals 'when',
+ * returns the jump's position to be resolved by AR_Program_PatchJump. */
+uint AR_Program_EmitJump(AR_Program *p, uint src, bool when);
+
+/* Sets jump's target to the end of the program. */
+void AR_Program_PatchJump(AR_Program *p, uint jump);
+
+/* Opens a conditional scope, sub-expressions computed within the scope
+ * are not reused once the scope is closed. */
+uint AR_Program_ScopeBegin(const AR_Program *p);
+
+/* Closes a conditional scope. */
+void AR_Program_ScopeEnd(AR_Program *p, uint scope);
+
+/* Sets the register returned by the program. */
+void AR_Program_SetResult(AR_Program *p, uint reg);
+
+//------------------------------------------------------------------------------
+// Program evaluation
+//------------------------------------------------------------------------------
+
+/* Evaluates program against record, returns the value of its result register. */
+SIValue AR_Program_Evaluate(AR_Program *p, const Record r);
+
+/* Free program. */
+void AR_Program_Free(AR_Program *p);
+
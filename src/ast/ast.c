@@ -114,9 +114,12 @@ bool AST_ReadOnly(const cypher_astnode_t *root) {
 	if(type == CYPHER_AST_CALL) {
 		const char *proc_name = cypher_ast_proc_name_get_value(cypher_ast_call_get_proc_name(root));
 		ProcedureCtx *proc = Proc_Get(proc_name);
-		bool read_only = Procedure_IsReadOnly(proc);
-		Proc_Free(proc);
-		if(!read_only) return false;
+		// Unknown procedures are reported by validations.
+		if(proc) {
+			bool read_only = Procedure_IsReadOnly(proc);
+			Proc_Free(proc);
+			if(!read_only) return false;
+		}
 	}
 	uint num_children = cypher_astnode_nchildren(root);
 	for(uint i = 0; i < num_children; i ++) {
@@ -239,6 +242,7 @@ AST *AST_Build(cypher_parse_result_t *parse_result) {
 	ast->free_root = false;
 	ast->params_parse_result = NULL;
 	ast->referenced_entities = NULL;
+	ast->materialized_entities = NULL;
 	ast->parse_result = parse_result;
 	ast->canonical_entity_names = raxNew();
 	ast->anot_ctx_collection = AST_AnnotationCtxCollection_New();
@@ -318,6 +322,12 @@ inline bool AST_AliasIsReferenced(AST *ast, const char *alias) {
 	return (raxFind(ast->referenced_entities, (unsigned char *)alias, strlen(alias)) != raxNotFound);
 }
 
+bool AST_AliasRequiresMaterialization(AST *ast, const char *alias) {
+	// Without a reference map, materialize conservatively.
+	if(ast->materialized_entities == NULL) return true;
+	return (raxFind(ast->materialized_entities, (unsigned char *)alias, strlen(alias)) != raxNotFound);
+}
+
 bool AST_IdentifierIsAlias(const cypher_astnode_t *root, const char *identifier) {
 	if(cypher_astnode_type(root) == CYPHER_AST_PROJECTION) {
 		const cypher_astnode_t *alias_node = cypher_ast_projection_get_alias(root);
@@ -487,6 +497,7 @@ void AST_Free(AST *ast) {
 
 	// No valid references - the struct can be disposed completely.
 	if(ast->referenced_entities) raxFree(ast->referenced_entities);
+	if(ast->materialized_entities) raxFree(ast->materialized_entities);
 	if(ast->free_root) {
 		// This is a generated AST, free its root node.
 		cypher_astnode_free((cypher_astnode_t *)ast->root);
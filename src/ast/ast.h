@@ -23,6 +23,7 @@ typedef enum {
 typedef struct {
 	const cypher_astnode_t *root;                       // Root element of libcypher-parser AST
 	rax *referenced_entities;                           // Mapping of the referenced entities.
+	rax *materialized_entities;                         // Referenced entities whose attributes are accessed.
 	AST_AnnotationCtxCollection *anot_ctx_collection;   // Holds annotations contexts.
 	rax *canonical_entity_names;                        // Storage for canonical graph entity names.
 	bool free_root;                                     // The root should only be freed if this is a sub-AST we constructed
@@ -93,6 +94,10 @@ void AST_AttachName(AST *ast, const cypher_astnode_t *node, const char *name);
 // Returns true if the given alias is referenced within this AST segment.
 bool AST_AliasIsReferenced(AST *ast, const char *alias);
 
+// Returns true if the entity bound to alias should be fetched from the graph
+// as soon as it is introduced, rather than carried by ID until accessed.
+bool AST_AliasRequiresMaterialization(AST *ast, const char *alias);
+
 // Returns true if the given identifier is used as an alias within this tree.
 bool AST_IdentifierIsAlias(const cypher_astnode_t *root, const char *identifier);
 
@@ -1,33 +1,55 @@
 #include "ast.h"
 #include "../RG.h"
 #include "../util/arr.h"
+#include <strings.h>
 
 // Forward declerations:
 static void _AST_MapReferencedEntitiesInPath(AST *ast, const cypher_astnode_t *path);
 
+/* Functions which only inspect their arguments' IDs or graph topology,
+ * arguments of these functions are not required to be materialized. */
+static const char *_id_only_functions[] = {"id", "labels", "indegree", "outdegree", "count"};
+
 // Adds an identifier or an alias to the reference map.
-static inline void _AST_UpdateRefMap(AST *ast, const char *name) {
+// If the entity's attributes are accessed, adds it to the materialization map as well.
+static inline void _AST_UpdateRefMap(AST *ast, const char *name, bool materialize) {
 	raxInsert(ast->referenced_entities, (unsigned char *)name, strlen(name), NULL, NULL);
+	if(materialize) {
+		raxInsert(ast->materialized_entities, (unsigned char *)name, strlen(name), NULL, NULL);
+	}
+}
+
+// Returns true if the given function application only requires its arguments' IDs.
+static bool _AST_IsIDOnlyApplication(const cypher_astnode_t *exp) {
+	const cypher_astnode_t *func_node = cypher_ast_apply_operator_get_func_name(exp);
+	const char *func_name = cypher_ast_function_name_get_value(func_node);
+	uint func_count = sizeof(_id_only_functions) / sizeof(_id_only_functions[0]);
+	for(uint i = 0; i < func_count; i++) {
+		if(strcasecmp(func_name, _id_only_functions[i]) == 0) return true;
+	}
+	return false;
 }
 
 // Map identifiers within an expression.
-static void _AST_MapExpression(AST *ast, const cypher_astnode_t *exp) {
+static void _AST_MapExpression(AST *ast, const cypher_astnode_t *exp, bool materialize) {
 	cypher_astnode_type_t type = cypher_astnode_type(exp);
 
 	// In case of identifier.
 	if(type == CYPHER_AST_IDENTIFIER) {
 		const char *identifier_name = cypher_ast_identifier_get_name(exp);
-		_AST_UpdateRefMap(ast, identifier_name);
+		_AST_UpdateRefMap(ast, identifier_name, materialize);
 	} else if(type == CYPHER_AST_PATTERN_PATH) {
 		// In case of pattern filter.
 		_AST_MapReferencedEntitiesInPath(ast, exp);
 	} else {
+		// Entities passed to functions such as id() are not materialized.
+		if(type == CYPHER_AST_APPLY_OPERATOR && _AST_IsIDOnlyApplication(exp)) materialize = false;
 		// Recurse over children.
 		uint child_count = cypher_astnode_nchildren(exp);
 		for(uint i = 0; i < child_count; i++) {
 			const cypher_astnode_t *child = cypher_astnode_get_child(exp, i);
 			// Recursively continue mapping.
-			_AST_MapExpression(ast, child);
+			_AST_MapExpression(ast, child, materialize);
 		}
 	}
 }
@@ -42,7 +64,7 @@ static inline void _AST_MapProjectionAlias(AST *ast, const cypher_astnode_t *pro
 	}
 	// WITH and RETURN projections are always either aliased or themselves identifiers.
 	const char *alias = cypher_ast_identifier_get_name(ast_alias);
-	_AST_UpdateRefMap(ast, alias);
+	_AST_UpdateRefMap(ast, alias, false);
 }
 
 // Adds referenced entities of ORDER BY clause.
@@ -52,7 +74,7 @@ static void _AST_MapOrderByReferences(AST *ast, const cypher_astnode_t *order_by
 	for(uint i = 0; i < count; i++) {
 		const cypher_astnode_t *item = cypher_ast_order_by_get_item(order_by, i);
 		const cypher_astnode_t *expression = cypher_ast_sort_item_get_expression(item);
-		_AST_MapExpression(ast, expression);
+		_AST_MapExpression(ast, expression, true);
 	}
 }
 
@@ -64,11 +86,11 @@ static void _AST_MapReferencedNode(AST *ast, const cypher_astnode_t *node, bool
 	// (In the case of a CREATE path, these are properties being set)
 	if(properties || force_mapping) {
 		const char *alias = AST_GetEntityName(ast, node);
-		_AST_UpdateRefMap(ast, alias);
+		_AST_UpdateRefMap(ast, alias, true);
 
 		// Map any references within the properties map, such as 'b' in:
 		// ({val: ID(b)})
-		if(properties) _AST_MapExpression(ast, properties);
+		if(properties) _AST_MapExpression(ast, properties, true);
 	}
 }
 
@@ -80,11 +102,11 @@ static void _AST_MapReferencedEdge(AST *ast, const cypher_astnode_t *edge, bool
 	// (In the case of a CREATE path, these are properties being set)
 	if(properties || force_mapping) {
 		const char *alias = AST_GetEntityName(ast, edge);
-		_AST_UpdateRefMap(ast, alias);
+		_AST_UpdateRefMap(ast, alias, true);
 
 		// Map any references within the properties map, such as 'b' in:
 		// ({val: ID(b)})
-		if(properties) _AST_MapExpression(ast, properties);
+		if(properties) _AST_MapExpression(ast, properties, true);
 	}
 }
 
@@ -113,7 +135,7 @@ static void _AST_MapMatchClauseReferences(AST *ast, const cypher_astnode_t *matc
 
 	// Where clause.
 	const cypher_astnode_t *predicate = cypher_ast_match_get_predicate(match_clause);
-	if(predicate) _AST_MapExpression(ast, predicate);
+	if(predicate) _AST_MapExpression(ast, predicate, true);
 }
 
 // Add referenced aliases from CREATE clause.
@@ -134,11 +156,11 @@ static void _AST_MapSetPropertyReferences(AST *ast, const cypher_astnode_t *set_
 	assert(cypher_astnode_type(ast_entity) == CYPHER_AST_IDENTIFIER);
 
 	const char *alias = cypher_ast_identifier_get_name(ast_entity);
-	_AST_UpdateRefMap(ast, alias);
+	_AST_UpdateRefMap(ast, alias, true);
 
 	// Map expression right hand side, e.g. a.v = 1, a.x = b.x
 	const cypher_astnode_t *set_exp = cypher_ast_set_property_get_expression(set_item);
-	_AST_MapExpression(ast, set_exp);
+	_AST_MapExpression(ast, set_exp, true);
 }
 
 // Maps entities in SET clause.
@@ -157,7 +179,7 @@ static void _AST_MapDeleteClauseReferences(AST *ast, const cypher_astnode_t *del
 	uint nitems = cypher_ast_delete_nexpressions(delete_clause);
 	for(uint i = 0; i < nitems; i++) {
 		const cypher_astnode_t *delete_exp = cypher_ast_delete_get_expression(delete_clause, i);
-		_AST_MapExpression(ast, delete_exp);
+		_AST_MapExpression(ast, delete_exp, true);
 	}
 }
 
@@ -199,7 +221,7 @@ static void _AST_MapWithReferredEntities(AST *ast_segment, const cypher_astnode_
 		const cypher_astnode_t *projection = cypher_ast_with_get_projection(with_clause, i);
 		// The expression forms the LHS of the projection.
 		const cypher_astnode_t *exp = cypher_ast_projection_get_expression(projection);
-		_AST_MapExpression(ast_segment, exp);
+		_AST_MapExpression(ast_segment, exp, true);
 	}
 	// Add referenced aliases for WITH's ORDER BY entities.
 	const cypher_astnode_t *order_by = cypher_ast_with_get_order_by(with_clause);
@@ -215,7 +237,7 @@ static void _AST_MapReturnReferredEntities(AST *ast_segment,
 		const cypher_astnode_t *projection = cypher_ast_return_get_projection(return_clause, i);
 		// The expression forms the LHS of the projection.
 		const cypher_astnode_t *exp = cypher_ast_projection_get_expression(projection);
-		_AST_MapExpression(ast_segment, exp);
+		_AST_MapExpression(ast_segment, exp, true);
 	}
 	// Add referenced aliases for RETURN's ORDER BY entities.
 	const cypher_astnode_t *order_by = cypher_ast_return_get_order_by(return_clause);
@@ -226,7 +248,7 @@ static void _AST_MapProjectAll(AST *ast, const cypher_astnode_t *project_clause)
 	const char **aliases = AST_GetProjectAll(project_clause);
 	uint alias_count = array_len(aliases);
 	for(uint i = 0; i < alias_count; i ++) {
-		_AST_UpdateRefMap(ast, aliases[i]);
+		_AST_UpdateRefMap(ast, aliases[i], true);
 	}
 }
 
@@ -289,6 +311,7 @@ static void _AST_MapProjectionClause(AST *ast_segment, const cypher_astnode_t *p
 // Populate the AST's map of all referenced aliases.
 void AST_BuildReferenceMap(AST *ast, const cypher_astnode_t *project_clause) {
 	ast->referenced_entities = raxNew();
+	ast->materialized_entities = raxNew();
 
 	// If this segment is followed by a projection clause, map that clause's references.
 	if(project_clause) _AST_MapProjectionClause(ast, project_clause);
@@ -14,6 +14,7 @@ AST *AST_MockMatchClause(AST *master_ast, cypher_astnode_t *node, bool node_is_p
 	 * TODO consider updating parser to improve this. */
 	AST *ast = rm_malloc(sizeof(AST));
 	ast->referenced_entities = master_ast->referenced_entities;
+	ast->materialized_entities = master_ast->materialized_entities;
 	ast->anot_ctx_collection = master_ast->anot_ctx_collection;
 	ast->free_root = true;
 	cypher_astnode_t *pattern;
@@ -1535,6 +1535,7 @@ static AST *_NewMockASTSegment(const cypher_astnode_t *root, uint start_offset,
 	AST *ast = rm_malloc(sizeof(AST));
 	ast->free_root = true;
 	ast->referenced_entities = NULL;
+	ast->materialized_entities = NULL;
 	ast->anot_ctx_collection = NULL;
 	uint n = end_offset - start_offset;
 
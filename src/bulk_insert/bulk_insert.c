@@ -11,17 +11,6 @@
 #include <errno.h>
 #include <assert.h>
 
-// The first byte of each property in the binary stream
-// is used to indicate the type of the subsequent SIValue
-typedef enum {
-	BI_NULL = 0,
-	BI_BOOL = 1,
-	BI_DOUBLE = 2,
-	BI_STRING = 3,
-	BI_LONG = 4,
-	BI_ARRAY = 5,
-} TYPE;
-
 // Read the header of a data stream to parse its property keys and update schemas.
 static Attribute_ID *_BulkInsert_ReadHeader(GraphContext *gc, SchemaType t,
 											const char *data, size_t *data_idx,
@@ -60,7 +49,7 @@ static Attribute_ID *_BulkInsert_ReadHeader(GraphContext *gc, SchemaType t,
 // Read an SIValue from the data stream and update the index appropriately
 static inline SIValue _BulkInsert_ReadProperty(const char *data, size_t *data_idx) {
 	/* Binary property format:
-	 * - property type : 1-byte integer corresponding to TYPE enum
+	 * - property type : 1-byte integer corresponding to BulkInsertType enum
 	 * - Nothing if type is NULL
 	 * - 1-byte true/false if type is boolean
 	 * - 8-byte double if type is double
@@ -69,7 +58,7 @@ static inline SIValue _BulkInsert_ReadProperty(const char *data, size_t *data_id
 	 * - 8-byte array length followed by N values if type is array
 	 */
 	SIValue v;
-	TYPE t = data[*data_idx];
+	BulkInsertType t = data[*data_idx];
 	*data_idx += 1;
 	if(t == BI_NULL) {
 		v = SI_NullVal();
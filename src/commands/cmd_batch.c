@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_batch.h"
+#include "group_commit.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+BatchCtx *BatchCtx_New
+(
+	CommandCtx *command_ctx,
+	RedisModuleString *cmd_name,
+	RedisModuleString **statements,
+	int count,
+	bool readonly
+) {
+	ASSERT(command_ctx != NULL);
+	ASSERT(count > 0);
+
+	BatchCtx *batch = rm_malloc(sizeof(BatchCtx));
+	batch->readonly = readonly;
+	batch->command_ctx = command_ctx;
+	batch->statements = array_new(CommandCtx *, count);
+
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	for(int i = 0; i < count; i++) {
+		// Statements reply through the batch's Redis context once it is set,
+		// each statement releases its own reference to the graph.
+		GraphContext_Retain(gc);
+		CommandCtx *statement = CommandCtx_New(command_ctx->ctx, NULL, cmd_name, statements[i], gc,
+											   command_ctx->replicated_command, command_ctx->compact, 0);
+		batch->statements = array_append(batch->statements, statement);
+	}
+
+	return batch;
+}
+
+/* GRAPH.BATCH <graph> <query> [<query> ...] [--compact]
+ * Plans all statements, then executes them in order under a single
+ * acquisition of the graph's lock: the read lock if none of the statements
+ * modify the graph, otherwise Redis GIL and the graph's write lock, such that
+ * no other query observes the graph in between the batch's statements.
+ * Replies with an array holding each statement's reply, a statement failure
+ * is reported in its own reply and does not affect the statements following it. */
+void Graph_Batch(void *args) {
+	BatchCtx *batch = (BatchCtx *)args;
+	CommandCtx *command_ctx = batch->command_ctx;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	uint count = array_len(batch->statements);
+
+	for(uint i = 0; i < count; i++) batch->statements[i]->ctx = ctx;
+
+	RedisModule_ReplyWithArray(ctx, count);
+	// A batch without a blocked client runs on Redis main thread, which holds the GIL.
+	RedisModuleCtx *main_ctx = (command_ctx->bc) ? NULL : ctx;
+	GroupCommit_Execute(main_ctx, gc, batch->statements, count, batch->readonly);
+
+	// Statements track themselves while executing, the batch is tracked on release.
+	CommandCtx_TrackCtx(command_ctx);
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	array_free(batch->statements);
+	rm_free(batch);
+}
@@ -0,0 +1,29 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "cmd_context.h"
+
+// Batch of statements executed in order on a single thread,
+// under a single acquisition of the graph's lock.
+typedef struct {
+	CommandCtx *command_ctx;    // Batch command context, replies to the client.
+	CommandCtx **statements;    // Statement contexts, executed in order.
+	bool readonly;              // Whether none of the statements modify the graph.
+} BatchCtx;
+
+// Create a new batch, a context is created for each of the statements.
+BatchCtx *BatchCtx_New
+(
+	CommandCtx *command_ctx,        // Batch command context.
+	RedisModuleString *cmd_name,    // Command name statements are reported under.
+	RedisModuleString **statements, // Statements to execute.
+	int count,                      // Number of statements.
+	bool readonly                   // Whether none of the statements modify the graph.
+);
+
+void Graph_Batch(void *args);
@@ -4,6 +4,7 @@
 #include "../util/rmalloc.h"
 #include "../util/thpool/thpool.h"
 #include "../slow_log/slow_log.h"
+#include "group_commit.h"
 #include <assert.h>
 
 extern threadpool _thpool; // Declared in module.c
@@ -31,6 +32,8 @@ CommandCtx *CommandCtx_New
 	context->compact = compact;
 	context->timeout = timeout;
 	context->command_name = NULL;
+	context->params = NULL;
+	context->params_len = 0;
 	context->graph_ctx = graph_ctx;
 	context->replicated_command = replicated_command;
 
@@ -54,6 +57,16 @@ CommandCtx *CommandCtx_New
 	return context;
 }
 
+void CommandCtx_SetParams(CommandCtx *command_ctx, RedisModuleString *params) {
+	ASSERT(command_ctx && params);
+	ASSERT(command_ctx->params == NULL);
+
+	// Make a copy of parameters, which may hold any byte.
+	const char *p = RedisModule_StringPtrLen(params, &command_ctx->params_len);
+	command_ctx->params = rm_malloc(command_ctx->params_len);
+	memcpy(command_ctx->params, p, command_ctx->params_len);
+}
+
 // place given 'ctx' in 'command_ctxs' at position 'tid'
 // representing the current thread
 void CommandCtx_TrackCtx(CommandCtx *ctx) {
@@ -117,8 +130,10 @@ const char *CommandCtx_GetQuery(const CommandCtx *command_ctx) {
 void CommandCtx_ThreadSafeContextLock(const CommandCtx *command_ctx) {
 	/* Acquire lock only when working with a blocked client
 	 * otherwise we're running on Redis main thread,
-	 * no need to acquire lock. */
+	 * no need to acquire lock.
+	 * A group commit holds the lock throughout its commit section. */
 	assert(command_ctx && command_ctx->ctx);
+	if(GroupCommit_InProgress()) return;
 	if(command_ctx->bc) RedisModule_ThreadSafeContextLock(command_ctx->ctx);
 }
 
@@ -127,6 +142,7 @@ void CommandCtx_ThreadSafeContextUnlock(const CommandCtx *command_ctx) {
 	 * otherwise we're running on Redis main thread,
 	 * no need to release lock. */
 	assert(command_ctx && command_ctx->ctx);
+	if(GroupCommit_InProgress()) return;
 	if(command_ctx->bc) RedisModule_ThreadSafeContextUnlock(command_ctx->ctx);
 }
 
@@ -139,6 +155,7 @@ void CommandCtx_Free(CommandCtx *command_ctx) {
 	CommandCtx_UntrackCtx(command_ctx);
 
 	if(command_ctx->query) rm_free(command_ctx->query);
+	if(command_ctx->params) rm_free(command_ctx->params);
 	rm_free(command_ctx->command_name);
 	rm_free(command_ctx);
 }
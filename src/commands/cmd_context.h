@@ -20,6 +20,8 @@ typedef struct {
 	bool replicated_command;        // Whether this instance was spawned by a replication command.
 	bool compact;                   // Whether this query was issued with the compact flag.
 	long long timeout;              // The query timeout, if specified.
+	char *params;                   // Binary parameters bound to a prepared statement.
+	size_t params_len;              // Size of binary parameters.
 } CommandCtx;
 
 // Create a new command context.
@@ -35,10 +37,20 @@ CommandCtx *CommandCtx_New
 	long long timeout               // The query timeout, if specified.
 );
 
+// Set binary parameters bound to the prepared statement being executed.
+void CommandCtx_SetParams
+(
+	CommandCtx *command_ctx,
+	RedisModuleString *params
+);
+
 // Tracks given 'ctx' such that in case of a crash we will be able to report
 // back all of the currently running commands
 void CommandCtx_TrackCtx(CommandCtx *ctx);
 
+// Stop tracking 'ctx', which must be tracked by the calling thread.
+void CommandCtx_UntrackCtx(CommandCtx *ctx);
+
 // Get Redis module context
 RedisModuleCtx *CommandCtx_GetRedisCtx
 (
@@ -6,16 +6,24 @@
 
 #include "commands.h"
 #include "cmd_context.h"
+#include "group_commit.h"
+#include "prepared_statement.h"
+#include "../config.h"
 #include "../RG.h"
+#include "../util/rmalloc.h"
+#include "../procedures/procedure.h"
+#include <ctype.h>
 #include <assert.h>
+#include <string.h>
 #include <strings.h>
 
 // Command handler function pointer.
 typedef void(*Command_Handler)(void *args);
 
-// Read configuration flags, returning REDIS_MODULE_ERR if flag parsing failed.
-static int _read_flags(RedisModuleString **argv, int argc, bool *compact, long long *timeout,
-					   char **errmsg) {
+// Read configuration flags, starting at argv[first],
+// returning REDIS_MODULE_ERR if flag parsing failed.
+static int _read_flags(RedisModuleString **argv, int argc, int first, bool *compact,
+					   long long *timeout, char **errmsg) {
 	ASSERT(compact);
 	ASSERT(timeout);
 
@@ -24,11 +32,12 @@ static int _read_flags(RedisModuleString **argv, int argc, bool *compact, long l
 	*compact = false;  // verbose
 
 	// GRAPH.QUERY <GRAPH_KEY> <QUERY>
-	// make sure we've got more than 3 arguments
-	if(argc <= 3) return REDISMODULE_OK;
+	// GRAPH.EXECUTE <GRAPH_KEY> <HANDLE> <PARAMS>
+	// make sure we've got arguments past the command's own
+	if(argc <= first) return REDISMODULE_OK;
 
 	// scan arguments
-	for(int i = 3; i < argc; i++) {
+	for(int i = first; i < argc; i++) {
 		const char *arg = RedisModule_StringPtrLen(argv[i], NULL);
 
 		// compact result-set
@@ -55,6 +64,38 @@ static int _read_flags(RedisModuleString **argv, int argc, bool *compact, long l
 	return REDISMODULE_OK;
 }
 
+// Read batch flags, only a trailing flag is considered as statements may take any value.
+// argc is updated to exclude the flag.
+static void _read_batch_flags(RedisModuleString **argv, int *argc, bool *compact,
+							  long long *timeout) {
+	*timeout = 0;      // no timeout
+	*compact = false;  // verbose
+
+	// GRAPH.BATCH <GRAPH_KEY> <QUERY> [<QUERY> ...] [--compact]
+	if(*argc <= 3) return;
+
+	const char *arg = RedisModule_StringPtrLen(argv[*argc - 1], NULL);
+	if(!strcasecmp(arg, "--compact")) {
+		*compact = true;
+		*argc -= 1;
+	}
+}
+
+// Read reorder flags, only a trailing flag is considered, following an optional strategy.
+// argc is updated to exclude the flag.
+static void _read_reorder_flags(RedisModuleString **argv, int *argc, bool *mapping) {
+	*mapping = false;  // summary only
+
+	// GRAPH.REORDER <GRAPH_KEY> [STRATEGY] [MAPPING]
+	if(*argc <= 2) return;
+
+	const char *arg = RedisModule_StringPtrLen(argv[*argc - 1], NULL);
+	if(!strcasecmp(arg, "MAPPING")) {
+		*mapping = true;
+		*argc -= 1;
+	}
+}
+
 // Return true if the command has a valid number of arguments.
 static inline bool _validate_command_arity(GRAPH_Commands cmd, int arity) {
 	switch(cmd) {
@@ -67,6 +108,24 @@ static inline bool _validate_command_arity(GRAPH_Commands cmd, int arity) {
 	case CMD_SLOWLOG:
 		// Expect just a command and graph name.
 		return arity == 2;
+	case CMD_REORDER:
+		// Expect a command, graph name and an optional reorder strategy.
+		return arity >= 2 && arity <= 3;
+	case CMD_MEMORY:
+		// Expect a command, graph name and an optional number of samples.
+		return arity >= 2 && arity <= 3;
+	case CMD_BATCH:
+		// Expect a command, graph name and at least one query.
+		return arity >= 3;
+	case CMD_PREPARE:
+		// Expect a command, graph name and a query.
+		return arity == 3;
+	case CMD_EXECUTE:
+		// Expect a command, graph name, a statement handle, parameters and optional config flags.
+		return arity >= 4 && arity <= 7;
+	case CMD_DEALLOCATE:
+		// Expect a command, graph name and a statement handle.
+		return arity == 3;
 	default:
 		assert("encountered unhandled query type" && false);
 	}
@@ -77,6 +136,7 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 	switch(cmd) {
 	case CMD_QUERY:
 	case CMD_RO_QUERY:
+	case CMD_EXECUTE:
 		return Graph_Query;
 	case CMD_EXPLAIN:
 		return Graph_Explain;
@@ -84,12 +144,146 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 		return Graph_Profile;
 	case CMD_SLOWLOG:
 		return Graph_Slowlog;
+	case CMD_REORDER:
+		return Graph_Reorder;
+	case CMD_MEMORY:
+		return Graph_Memory;
+	case CMD_BATCH:
+		return Graph_Batch;
+	case CMD_PREPARE:
+		return Graph_Prepare;
+	case CMD_DEALLOCATE:
+		return Graph_Deallocate;
 	default:
 		assert(false);
 	}
 	return NULL;
 }
 
+// Maximal length of a procedure name resolved while classifying a query.
+#define CLASSIFY_MAX_PROC_NAME 128
+
+// Returns true if c may be part of an unescaped identifier.
+static inline bool _identifier_char(char c) {
+	return isalnum((unsigned char)c) || c == '_';
+}
+
+// Returns true if the procedure called at q[i] is known to be read only, i is advanced past its name.
+static bool _read_only_procedure(const char *q, size_t len, size_t *i) {
+	while(*i < len && isspace((unsigned char)q[*i])) (*i)++;
+	size_t start = *i;
+	while(*i < len && (_identifier_char(q[*i]) || q[*i] == '.')) (*i)++;
+
+	size_t name_len = *i - start;
+	if(name_len == 0 || name_len >= CLASSIFY_MAX_PROC_NAME) return false;
+	char name[CLASSIFY_MAX_PROC_NAME];
+	memcpy(name, q + start, name_len);
+	name[name_len] = '\0';
+
+	ProcedureCtx *proc = Proc_Get(name);
+	if(!proc) return false;
+	bool read_only = Procedure_IsReadOnly(proc);
+	Proc_Free(proc);
+	return read_only;
+}
+
+/* Classify a query with a lexical scan, such that queries aren't parsed on the main thread.
+ * Clause keywords are matched as whole words, skipping string literals, escaped identifiers
+ * and comments, a word following '.', ':' or '$' is a property, label or parameter name.
+ * The scan errs towards writes: a query is only reported as read only if it
+ * contains no updating keyword and calls no procedure which isn't known to be read only. */
+static void _classify_query(const char *q, size_t len, bool *read_only, bool *procedure_call) {
+	static const char *write_keywords[] = {"CREATE", "MERGE", "SET", "DELETE", "REMOVE", "DROP"};
+
+	size_t i = 0;
+	while(i < len) {
+		char c = q[i];
+		// Skip string literals and escaped identifiers.
+		if(c == '\'' || c == '"' || c == '`') {
+			for(i++; i < len && q[i] != c; i++) {
+				if(q[i] == '\\') i++;
+			}
+			i++;
+			continue;
+		}
+		// Skip comments.
+		if(c == '/' && i + 1 < len && q[i + 1] == '/') {
+			while(i < len && q[i] != '\n') i++;
+			continue;
+		}
+		if(c == '/' && i + 1 < len && q[i + 1] == '*') {
+			for(i += 2; i + 1 < len && !(q[i] == '*' && q[i + 1] == '/'); i++);
+			i += 2;
+			continue;
+		}
+		if(!_identifier_char(c)) {
+			i++;
+			continue;
+		}
+
+		// Read a word.
+		size_t start = i;
+		while(i < len && _identifier_char(q[i])) i++;
+		if(start > 0 && (q[start - 1] == '.' || q[start - 1] == ':' || q[start - 1] == '$')) continue;
+
+		size_t word_len = i - start;
+		if(word_len == 4 && strncasecmp(q + start, "CALL", 4) == 0) {
+			*procedure_call = true;
+			if(!_read_only_procedure(q, len, &i)) *read_only = false;
+			continue;
+		}
+		for(uint k = 0; k < sizeof(write_keywords) / sizeof(write_keywords[0]); k++) {
+			if(word_len == strlen(write_keywords[k]) &&
+			   strncasecmp(q + start, write_keywords[k], word_len) == 0) {
+				*read_only = false;
+				break;
+			}
+		}
+	}
+}
+
+// Determine the thread pool lane of a classified query.
+static inline thpool_lane _query_lane(bool read_only, bool procedure_call) {
+	// Procedure calls, e.g. algorithms, are expected to be long running.
+	if(procedure_call) return THPOOL_LANE_HEAVY;
+	return (read_only) ? THPOOL_LANE_READ : THPOOL_LANE_WRITE;
+}
+
+/* Determine the thread pool lane a command is scheduled on,
+ * queries are classified lexically, read_only is set if
+ * none of the command's queries modify the graph. */
+static thpool_lane _command_lane(GRAPH_Commands cmd, RedisModuleString **queries, int count,
+								 bool *read_only) {
+	*read_only = true;
+	switch(cmd) {
+	case CMD_RO_QUERY:
+	case CMD_EXPLAIN:
+	case CMD_SLOWLOG:
+	case CMD_MEMORY:
+	case CMD_PREPARE:
+	case CMD_DEALLOCATE:
+		return THPOOL_LANE_READ;
+	case CMD_REORDER:
+		*read_only = false;
+		return THPOOL_LANE_HEAVY;
+	case CMD_QUERY:
+	case CMD_PROFILE:
+	case CMD_BATCH: {
+		// A batch is scheduled on the lane of its heaviest statement.
+		bool procedure_call = false;
+		for(int i = 0; i < count; i++) {
+			size_t len;
+			const char *query = RedisModule_StringPtrLen(queries[i], &len);
+			_classify_query(query, len, read_only, &procedure_call);
+		}
+		return _query_lane(*read_only, procedure_call);
+	}
+	default:
+		assert(false);
+	}
+	return THPOOL_LANE_READ;
+}
+
 // Convert from string representation to an enum.
 static GRAPH_Commands determine_command(const char *cmd_name) {
 	if(strcasecmp(cmd_name, "graph.QUERY") == 0) return CMD_QUERY;
@@ -97,23 +291,56 @@ static GRAPH_Commands determine_command(const char *cmd_name) {
 	if(strcasecmp(cmd_name, "graph.EXPLAIN") == 0) return CMD_EXPLAIN;
 	if(strcasecmp(cmd_name, "graph.PROFILE") == 0) return CMD_PROFILE;
 	if(strcasecmp(cmd_name, "graph.SLOWLOG") == 0) return CMD_SLOWLOG;
+	if(strcasecmp(cmd_name, "graph.REORDER") == 0) return CMD_REORDER;
+	if(strcasecmp(cmd_name, "graph.MEMORY") == 0) return CMD_MEMORY;
+	if(strcasecmp(cmd_name, "graph.BATCH") == 0) return CMD_BATCH;
+	if(strcasecmp(cmd_name, "graph.PREPARE") == 0) return CMD_PREPARE;
+	if(strcasecmp(cmd_name, "graph.EXECUTE") == 0) return CMD_EXECUTE;
+	if(strcasecmp(cmd_name, "graph.DEALLOCATE") == 0) return CMD_DEALLOCATE;
 
 	assert(false);
 	return CMD_UNKNOWN;
 }
 
+// Resolve a prepared statement handle to the statement's query, and the lane it is scheduled on,
+// emits an error and returns NULL if there's no such statement.
+static RedisModuleString *_resolve_statement(RedisModuleCtx *ctx, GraphContext *gc,
+											 RedisModuleString *handle, thpool_lane *lane) {
+	long long id;
+	bool read_only;
+	bool procedure_call;
+	char *query = NULL;
+	if(RedisModule_StringToLongLong(handle, &id) == REDISMODULE_OK && id >= 0) {
+		// Statements are classified once prepared.
+		query = PreparedStatements_Get(gc->prepared_statements, id, &read_only, &procedure_call);
+	}
+
+	if(!query) {
+		RedisModule_ReplyWithError(ctx, "ERR Unknown prepared statement handle");
+		return NULL;
+	}
+	*lane = _query_lane(read_only, procedure_call);
+	RedisModuleString *statement = RedisModule_CreateString(ctx, query, strlen(query));
+	rm_free(query);
+	return statement;
+}
+
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	CommandCtx *context;
 
 	RedisModuleString *graph_name = argv[1];
-	RedisModuleString *query = (argc > 2) ? argv[2] : NULL;
+	RedisModuleString *query = NULL;
 	const char *command_name = RedisModule_StringPtrLen(argv[0], NULL);
 	GRAPH_Commands cmd = determine_command(command_name);
 	// Parse additional query arguments.
 	char *errmsg;
 	bool compact;
+	bool mapping = false;
 	long long timeout;
-	int res = _read_flags(argv, argc, &compact, &timeout, &errmsg);
+	int res = REDISMODULE_OK;
+	if(cmd == CMD_REORDER) _read_reorder_flags(argv, &argc, &mapping);
+	if(cmd == CMD_BATCH) _read_batch_flags(argv, &argc, &compact, &timeout);
+	else res = _read_flags(argv, argc, (cmd == CMD_EXECUTE) ? 4 : 3, &compact, &timeout, &errmsg);
 	if(res == REDISMODULE_ERR) {
 		// Emit error and exit if argument parsing failed.
 		RedisModule_ReplyWithError(ctx, errmsg);
@@ -123,11 +350,30 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	}
 
 	if(_validate_command_arity(cmd, argc) == false) return RedisModule_WrongArity(ctx);
+	// Determined once flags are excluded.
+	if(argc > 2) query = argv[2];
 	Command_Handler handler = get_command_handler(cmd);
 	GraphContext *gc = GraphContext_Retrieve(ctx, graph_name, true, true);
 	// If the GraphContext is null, key access failed and an error has been emitted.
 	if(!gc) return REDISMODULE_ERR;
 
+	thpool_lane lane;
+	bool read_only = true;
+	RedisModuleString *statement = NULL;
+	if(cmd == CMD_EXECUTE) {
+		// Execute the prepared statement's query.
+		statement = _resolve_statement(ctx, gc, argv[2], &lane);
+		if(!statement) {
+			GraphContext_Release(gc);
+			return REDISMODULE_OK;
+		}
+		query = statement;
+	} else if(cmd == CMD_BATCH) {
+		lane = _command_lane(cmd, argv + 2, argc - 2, &read_only);
+	} else {
+		lane = _command_lane(cmd, &query, 1, &read_only);
+	}
+
 	/* Determin query execution context
 	 * queries issued within a LUA script or multi exec block must
 	 * run on Redis main thread, others can run on different threads. */
@@ -139,14 +385,37 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	if(execute_on_main_thread) {
 		// Run query on Redis main thread.
 		context = CommandCtx_New(ctx, NULL, argv[0], query, gc, is_replicated, compact, timeout);
-		handler(context);
+		if(cmd == CMD_EXECUTE) CommandCtx_SetParams(context, argv[3]);
+		void *args = context;
+		if(cmd == CMD_BATCH) {
+			args = BatchCtx_New(context, argv[0], argv + 2, argc - 2, read_only);
+		} else if(cmd == CMD_REORDER) {
+			args = ReorderCtx_New(context, mapping);
+		}
+		handler(args);
 	} else {
-		// Run query on a dedicated thread.
+		// Run query on a dedicated thread, queries of the same graph are
+		// grouped such that a busy graph does not starve other graphs.
 		RedisModuleBlockedClient *bc = RedisModule_BlockClient(ctx, NULL, NULL, NULL, 0);
 		context = CommandCtx_New(NULL, bc, argv[0], query, gc, is_replicated, compact, timeout);
-		thpool_add_work(_thpool, handler, context);
+		if(cmd == CMD_EXECUTE) CommandCtx_SetParams(context, argv[3]);
+		if((cmd == CMD_QUERY || cmd == CMD_EXECUTE) && lane == THPOOL_LANE_WRITE &&
+		   Config_GetGroupCommit()) {
+			// Commit alongside concurrent writes to the same graph.
+			GroupCommit_Enqueue(context);
+		} else if(cmd == CMD_BATCH) {
+			// Statements are copied while the client's arguments are still valid.
+			BatchCtx *batch = BatchCtx_New(context, argv[0], argv + 2, argc - 2, read_only);
+			thpool_add_work_lane(_thpool, handler, batch, lane, gc);
+		} else if(cmd == CMD_REORDER) {
+			ReorderCtx *reorder = ReorderCtx_New(context, mapping);
+			thpool_add_work_lane(_thpool, handler, reorder, lane, gc);
+		} else {
+			thpool_add_work_lane(_thpool, handler, context, lane, gc);
+		}
 	}
 
+	if(statement) RedisModule_FreeString(ctx, statement);
 	return REDISMODULE_OK;
 }
 
@@ -0,0 +1,53 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_effect.h"
+#include "../effects/effects.h"
+#include "../graph/graphcontext.h"
+
+/* GRAPH.EFFECT <graph> <effects>
+ * Applies the serialized effects of a write query, issued by the master
+ * in place of the query to its replicas and AOF. */
+int MGraph_Effect(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 3) return RedisModule_WrongArity(ctx);
+
+	/* Effects are applied on Redis main thread, waiting for the graph's writer,
+	 * which in turn might be waiting for the GIL, only the master's replication
+	 * stream and the AOF, which no worker writes concurrently with, are accepted. */
+	int flags = RedisModule_GetContextFlags(ctx);
+	if(!(flags & (REDISMODULE_CTX_FLAGS_REPLICATED | REDISMODULE_CTX_FLAGS_LOADING))) {
+		RedisModule_ReplyWithError(ctx, "ERR GRAPH.EFFECT is only accepted from the master or the AOF");
+		return REDISMODULE_OK;
+	}
+
+	size_t len;
+	const char *err = NULL;
+	const char *effects = RedisModule_StringPtrLen(argv[2], &len);
+
+	// The first effects applied to a graph create it.
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], false, true);
+	// If the GraphContext is null, key access failed and an error has been emitted.
+	if(!gc) return REDISMODULE_ERR;
+
+	// Acquire locks in the same order as a committing writer would.
+	Graph_WriterEnter(gc->g);
+	GraphContext_MarkWriter(ctx, gc);
+	Graph_AcquireWriteLock(gc->g);
+	bool applied = Effects_Apply(gc, effects, len, &err);
+	Graph_ReleaseLock(gc->g);
+	Graph_WriterLeave(gc->g);
+
+	if(applied) {
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+		// Chained replicas apply the same effects.
+		RedisModule_ReplicateVerbatim(ctx);
+	} else {
+		RedisModule_ReplyWithError(ctx, err);
+	}
+
+	GraphContext_Release(gc);
+	return REDISMODULE_OK;
+}
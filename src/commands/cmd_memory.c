@@ -0,0 +1,88 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_memory.h"
+#include "cmd_context.h"
+#include "../util/arr.h"
+#include "../graph/graph_memory.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline void _ReplyName(RedisModuleCtx *ctx, const char *name) {
+	RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name));
+}
+
+static void _ReplySize(RedisModuleCtx *ctx, const char *name, size_t size) {
+	_ReplyName(ctx, name);
+	RedisModule_ReplyWithLongLong(ctx, size);
+}
+
+// Reply with a schema name to size mapping, flattened into an array.
+static void _ReplySchemaSizes(RedisModuleCtx *ctx, GraphContext *gc, SchemaType t,
+							  size_t *sizes) {
+	uint count = array_len(sizes);
+	RedisModule_ReplyWithArray(ctx, count * 2);
+	for(uint i = 0; i < count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, i, t);
+		_ReplyName(ctx, Schema_GetName(s));
+		RedisModule_ReplyWithLongLong(ctx, sizes[i]);
+	}
+}
+
+/* GRAPH.MEMORY <graph> [samples]
+ * Replies with the number of bytes held by each of the graph's components,
+ * as name, value pairs. Attribute sets and multi-edge arrays are estimated
+ * by examining up to `samples` entities and matrix rows, 0 examines all of them. */
+void Graph_Memory(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	const char *samples_arg = CommandCtx_GetQuery(command_ctx);
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	long long samples = GRAPH_MEMORY_DEFAULT_SAMPLES;
+	if(samples_arg) {
+		char *end;
+		errno = 0;
+		samples = strtoll(samples_arg, &end, 10);
+		if(errno != 0 || *end != '\0' || end == samples_arg || samples < 0 ||
+		   samples > UINT32_MAX) {
+			RedisModule_ReplyWithError(ctx, "Failed to parse samples value");
+			goto cleanup;
+		}
+	}
+
+	GraphMemoryUsage usage;
+	Graph_AcquireReadLock(gc->g);
+	GraphMemory_Compute(gc, samples, &usage);
+
+	RedisModule_ReplyWithArray(ctx, 12 * 2);
+	_ReplySize(ctx, "total", usage.total);
+	_ReplySize(ctx, "nodes", usage.nodes);
+	_ReplySize(ctx, "edges", usage.edges);
+	_ReplySize(ctx, "node_attributes", usage.node_attributes);
+	_ReplySize(ctx, "edge_attributes", usage.edge_attributes);
+	_ReplySize(ctx, "adjacency_matrix", usage.adjacency_matrix);
+	_ReplyName(ctx, "label_matrices");
+	_ReplySchemaSizes(ctx, gc, SCHEMA_NODE, usage.label_matrices);
+	_ReplyName(ctx, "relation_matrices");
+	_ReplySchemaSizes(ctx, gc, SCHEMA_EDGE, usage.relation_matrices);
+	_ReplyName(ctx, "multi_edges");
+	_ReplySchemaSizes(ctx, gc, SCHEMA_EDGE, usage.multi_edges);
+	_ReplySize(ctx, "indices", usage.indices);
+	_ReplySize(ctx, "plan_caches", usage.plan_caches);
+	_ReplySize(ctx, "prepared_statements", usage.prepared_statements);
+
+	Graph_ReleaseLock(gc->g);
+	GraphMemory_Free(&usage);
+
+cleanup:
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
@@ -0,0 +1,76 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_prepare.h"
+#include "cmd_context.h"
+#include "../query_ctx.h"
+#include "execution_ctx.h"
+#include "prepared_statement.h"
+#include "../execution_plan/execution_plan.h"
+
+/* Validates and plans a query, caching its plan, and registers it as
+ * a prepared statement, replies with the statement's handle.
+ * Args:
+ * argv[1] graph name
+ * argv[2] query */
+void Graph_Prepare(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+
+	CommandCtx_TrackCtx(command_ctx);
+	ExecutionCtx exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+
+	if(!QueryCtx_EncounteredError()) {
+		if(exec_ctx.exec_type == EXECUTION_TYPE_INVALID) {
+			QueryCtx_SetError("Failed to parse query");
+		} else if(exec_ctx.exec_type != EXECUTION_TYPE_QUERY) {
+			QueryCtx_SetError("Index operations cannot be prepared");
+		} else if(raxSize(QueryCtx_GetParams()) > 0) {
+			QueryCtx_SetError("Prepared statement parameters are bound on execution");
+		}
+	}
+
+	if(QueryCtx_EncounteredError()) {
+		QueryCtx_EmitException();
+	} else {
+		const cypher_astnode_t *root = exec_ctx.ast->root;
+		uint64_t handle = PreparedStatements_Add(gc->prepared_statements, command_ctx->query,
+												 AST_ReadOnly(root),
+												 AST_TreeContainsType(root, CYPHER_AST_CALL));
+		RedisModule_ReplyWithLongLong(ctx, handle);
+	}
+
+	AST_Free(exec_ctx.ast);
+	ExecutionPlan_Free(exec_ctx.plan);
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+}
+
+/* Removes a prepared statement, its handle is not reused.
+ * Args:
+ * argv[1] graph name
+ * argv[2] statement handle */
+void Graph_Deallocate(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	char *end;
+	const char *handle = command_ctx->query;
+	unsigned long long id = strtoull(handle, &end, 10);
+	if(*handle != '\0' && *handle != '-' && *end == '\0' &&
+	   PreparedStatements_Remove(gc->prepared_statements, id)) {
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		RedisModule_ReplyWithError(ctx, "ERR Unknown prepared statement handle");
+	}
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
@@ -0,0 +1,13 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../redismodule.h"
+
+void Graph_Prepare(void *args);
+
+void Graph_Deallocate(void *args);
@@ -73,9 +73,11 @@ void Graph_Profile(void *args) {
 	QueryCtx_SetResultSet(result_set);
 
 	ExecutionPlan_PreparePlan(plan);
-	ExecutionPlan_Profile(plan);
+	ExecutionPlan_Profile(plan, true);
 	QueryCtx_ForceUnlockCommit();
-	ExecutionPlan_Print(plan, ctx);
+	// A compact profile is machine readable, a tree of operations and their statistics.
+	if(command_ctx->compact) ExecutionPlan_PrintTree(plan, ctx);
+	else ExecutionPlan_Print(plan, ctx);
 
 cleanup:
 	// Release the read-write lock
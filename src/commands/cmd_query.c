@@ -12,10 +12,15 @@
 #include "../util/cron.h"
 #include "../query_ctx.h"
 #include "../graph/graph.h"
+#include "../config.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
+#include "../util/thpool/thpool.h"
 #include "../util/cache/cache.h"
 #include "../execution_plan/execution_plan.h"
 #include "execution_ctx.h"
+#include "group_commit.h"
+#include "prepared_statement.h"
 
 static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 							 ExecutionType exec_type) {
@@ -25,28 +30,81 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 		// Retrieve strings from AST node
 		const char *label = cypher_ast_label_get_name(cypher_ast_create_node_props_index_get_label(
 														  index_op));
-		const char *prop = cypher_ast_prop_name_get_value(cypher_ast_create_node_props_index_get_prop_name(
-															  index_op, 0));
+		uint nprops = cypher_ast_create_node_props_index_nprops(index_op);
+		const char *props[nprops];
+		for(uint i = 0; i < nprops; i++) {
+			props[i] = cypher_ast_prop_name_get_value(cypher_ast_create_node_props_index_get_prop_name(
+														  index_op, i));
+		}
+
 		QueryCtx_LockForCommit();
-		if(GraphContext_AddIndex(&idx, gc, label, prop, IDX_EXACT_MATCH) == INDEX_OK) Index_Construct(idx);
+		// Multiple properties define a single composite key, e.g. CREATE INDEX ON :L(a, b).
+		int res = (nprops == 1) ?
+				  GraphContext_AddIndex(&idx, gc, label, props[0], IDX_EXACT_MATCH) :
+				  GraphContext_AddCompositeIndex(&idx, gc, label, props, nprops);
+		if(res == INDEX_OK) {
+			// Populating the index may take a while, don't hold the commit lock meanwhile.
+			Index_ConstructInBackground(idx);
+		}
 		QueryCtx_UnlockCommit(NULL);
 	} else if(exec_type == EXECUTION_TYPE_INDEX_DROP) {
 		// Retrieve strings from AST node
 		const char *label = cypher_ast_label_get_name(cypher_ast_drop_node_props_index_get_label(index_op));
-		const char *prop = cypher_ast_prop_name_get_value(cypher_ast_drop_node_props_index_get_prop_name(
-															  index_op, 0));
+		uint nprops = cypher_ast_drop_node_props_index_nprops(index_op);
+		const char *props[nprops];
+		for(uint i = 0; i < nprops; i++) {
+			props[i] = cypher_ast_prop_name_get_value(cypher_ast_drop_node_props_index_get_prop_name(
+														  index_op, i));
+		}
+
 		QueryCtx_LockForCommit();
-		int res = GraphContext_DeleteIndex(gc, label, prop, IDX_EXACT_MATCH);
+		int res = (nprops == 1) ?
+				  GraphContext_DeleteIndex(gc, label, props[0], IDX_EXACT_MATCH) :
+				  GraphContext_DeleteCompositeIndex(gc, label, props, nprops);
 		QueryCtx_UnlockCommit(NULL);
 
 		if(res != INDEX_OK) {
-			QueryCtx_SetError("ERR Unable to drop index on :%s(%s): no such index.", label, prop);
+			// Render properties, e.g. "a, b".
+			char prop_list[1024] = "";
+			size_t len = 0;
+			for(uint i = 0; i < nprops && len < sizeof(prop_list); i++) {
+				len += snprintf(prop_list + len, sizeof(prop_list) - len, "%s%s", i ? ", " : "", props[i]);
+			}
+			QueryCtx_SetError("ERR Unable to drop index on :%s(%s): no such index.", label, prop_list);
 		}
 	} else {
 		QueryCtx_SetError("ERR Encountered unknown query execution type.");
 	}
 }
 
+// Render the parameters bound to a prepared statement, e.g. "name: Alice, age: 30".
+// Rendered by the slowlog only if it logs the query.
+static char *_PreparedParamsToString(void) {
+	rax *params = QueryCtx_GetParams();
+	size_t len = 0;
+	char *str = rm_calloc(1, 1);
+
+	raxIterator it;
+	raxStart(&it, params);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		char *value = NULL;
+		AR_EXP_ToString(it.data, &value);
+		size_t value_len = strlen(value);
+		bool first = (len == 0);
+		str = rm_realloc(str, len + it.key_len + value_len + 5);
+		len += sprintf(str + len, "%s%.*s: %s", first ? "" : ", ", (int)it.key_len,
+					   (char *)it.key, value);
+		rm_free(value);
+	}
+	raxStop(&it);
+
+	return str;
+}
+
+// Number of queries executed by the calling thread, used to sample slowlog profiles.
+static __thread uint _profile_sample = 0;
+
 inline static bool _readonly_cmd_mode(CommandCtx *ctx) {
 	return strcasecmp(CommandCtx_GetCommandName(ctx), "graph.RO_QUERY") == 0;
 }
@@ -72,12 +130,10 @@ void Query_SetTimeOut(uint timeout, ExecutionPlan *plan) {
 	Cron_AddTask(timeout, QueryTimedOut, plan);
 }
 
-void Graph_Query(void *args) {
-	bool lockAcquired = false;
-	ResultSet *result_set = NULL;
-	CommandCtx *command_ctx = (CommandCtx *)args;
-	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
-	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+bool Query_Prepare(QueryExecution *query, CommandCtx *command_ctx) {
+	*query = (QueryExecution) {
+		.command_ctx = command_ctx, .exec_type = EXECUTION_TYPE_INVALID
+	};
 
 	CommandCtx_TrackCtx(command_ctx);
 	QueryCtx_SetGlobalExecutionCtx(command_ctx);
@@ -87,49 +143,89 @@ void Graph_Query(void *args) {
 	 * 1. AST
 	 * 2. Execution plan (if any)
 	 * 3. Whether these items were cached or not */
-	AST *ast = NULL;
-	bool cached = false;
-	ExecutionPlan *plan = NULL;
-	ExecutionCtx exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	query->profile_threshold = Config_GetSlowlogProfileThreshold();
+	// Slowlog profiles are sampled, one in every sample rate queries executed by this thread.
+	if(query->profile_threshold &&
+	   (++_profile_sample % Config_GetSlowlogProfileSampleRate()) != 0) {
+		query->profile_threshold = 0;
+	}
 
-	ast = exec_ctx.ast;
-	plan = exec_ctx.plan;
-	cached = exec_ctx.cached;
-	ExecutionType exec_type = exec_ctx.exec_type;
-	// See if there were any query compile time errors
-	if(QueryCtx_EncounteredError()) {
-		QueryCtx_EmitException();
+	// Bind the binary parameters of a prepared statement.
+	if(command_ctx->params &&
+	   !PreparedStatement_BindParams(command_ctx->params, command_ctx->params_len)) {
 		goto cleanup;
 	}
-	if(exec_type == EXECUTION_TYPE_INVALID) goto cleanup;
 
-	bool readonly = AST_ReadOnly(ast->root);
-	if(!readonly && _readonly_cmd_mode(command_ctx)) {
+	ExecutionCtx exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+
+	query->ast = exec_ctx.ast;
+	query->plan = exec_ctx.plan;
+	query->cached = exec_ctx.cached;
+	query->exec_type = exec_ctx.exec_type;
+	// See if there were any query compile time errors
+	if(QueryCtx_EncounteredError()) goto cleanup;
+	if(query->exec_type == EXECUTION_TYPE_INVALID) goto cleanup;
+
+	query->readonly = AST_ReadOnly(query->ast->root);
+	if(!query->readonly && _readonly_cmd_mode(command_ctx)) {
 		QueryCtx_SetError("graph.RO_QUERY is to be executed only on read-only queries");
-		QueryCtx_EmitException();
 		goto cleanup;
 	}
 
 	// Set the query timeout if one was specified.
 	if(command_ctx->timeout != 0) {
-		if(!readonly) {
+		if(!query->readonly) {
 			// Disallow timeouts on write operations to avoid leaving the graph in an inconsistent state.
 			QueryCtx_SetError("Query timeouts may only be specified on read-only queries");
-			QueryCtx_EmitException();
 			goto cleanup;
 		}
 
-		Query_SetTimeOut(command_ctx->timeout, plan);
+		Query_SetTimeOut(command_ctx->timeout, query->plan);
 	}
 
+	query->prepared = true;
+
+cleanup:
+	CommandCtx_UntrackCtx(command_ctx);
+	return query->prepared;
+}
+
+void Query_Execute(QueryExecution *query) {
+	CommandCtx *command_ctx = query->command_ctx;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	// Errors encountered while preparing are emitted in execution order.
+	if(!query->prepared) {
+		if(QueryCtx_EncounteredError()) QueryCtx_EmitException();
+		goto cleanup;
+	}
+
+	bool readonly = query->readonly;
+	ExecutionPlan *plan = query->plan;
+	ExecutionType exec_type = query->exec_type;
 	bool compact = command_ctx->compact;
 	ResultSetFormatterType resultset_format = (compact) ? FORMATTER_COMPACT : FORMATTER_VERBOSE;
 
-	// Acquire the appropriate lock.
-	if(readonly) {
-		Graph_AcquireReadLock(gc->g);
-	} else {
-		Graph_WriterEnter(gc->g);  // Single writer.
+	double timer[2];
+	QueryMetrics *metrics = QueryCtx_GetMetrics();
+	simple_tic(timer);
+
+	if(!readonly && GroupCommit_ReadOnly()) {
+		QueryCtx_SetError("Write queries cannot be executed as part of a read only group");
+		QueryCtx_EmitException();
+		goto cleanup;
+	}
+
+	// Acquire the appropriate lock, a group holds the graph's lock on our behalf.
+	if(!GroupCommit_InProgress()) {
+		if(readonly) Graph_AcquireReadLock(gc->g);
+		else Graph_WriterEnter(gc->g); // Single writer.
+		query->lock_acquired = true;
+	}
+	if(!readonly) {
 		/* If this is a writer query we need to re-open the graph key with write flag
 		* this notifies Redis that the key is "dirty" any watcher on that key will
 		* be notified. */
@@ -139,52 +235,105 @@ void Graph_Query(void *args) {
 		}
 		CommandCtx_ThreadSafeContextUnlock(command_ctx);
 	}
-	lockAcquired = true;
+	metrics->stages[METRIC_STAGE_LOCK] += simple_toc(timer) * 1000;
 
 	// Set policy after lock acquisition, avoid resetting policies between readers and writers.
 	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
-	result_set = NewResultSet(ctx, resultset_format);
+	ResultSet *result_set = NewResultSet(ctx, resultset_format);
 	// Indicate a cached execution.
-	if(cached) ResultSet_CachedExecution(result_set);
+	if(query->cached) ResultSet_CachedExecution(result_set);
+	query->result_set = result_set;
 
 	QueryCtx_SetResultSet(result_set);
+	// Locks acquired during execution, e.g. for commit, are accounted for as lock wait.
+	double lock_time = metrics->stages[METRIC_STAGE_LOCK];
+	simple_tic(timer);
 	if(exec_type == EXECUTION_TYPE_QUERY) {  // query operation
 		ExecutionPlan_PreparePlan(plan);
-		result_set = ExecutionPlan_Execute(plan);
+		// Profile sampled executions when slowlog entries carry a profile,
+		// operations are timed, allocations are not tracked.
+		if(query->profile_threshold) result_set = ExecutionPlan_Profile(plan, false);
+		else result_set = ExecutionPlan_Execute(plan);
 
 		// Emit error if query timed out.
 		if(ExecutionPlan_Drained(plan)) QueryCtx_SetError("Query timed out");
 
+		// Hold on to the profile of slow queries for the slowlog.
+		if(query->profile_threshold && QueryCtx_GetExecutionTime() >= query->profile_threshold) {
+			query->profile = ExecutionPlan_Describe(plan);
+		}
+
 		ExecutionPlan_Free(plan);
-		plan = NULL;
+		query->plan = NULL;
 	} else if(exec_type == EXECUTION_TYPE_INDEX_CREATE ||
 			  exec_type == EXECUTION_TYPE_INDEX_DROP) {
-		_index_operation(ctx, gc, ast, exec_type);
+		_index_operation(ctx, gc, query->ast, exec_type);
 	} else {
 		assert("Unhandled query type" && false);
 	}
 	QueryCtx_ForceUnlockCommit();
+	metrics->stages[METRIC_STAGE_EXECUTE] = simple_toc(timer) * 1000 -
+											(metrics->stages[METRIC_STAGE_LOCK] - lock_time);
+
+	simple_tic(timer);
 	ResultSet_Reply(result_set);    // Send result-set back to client.
+	metrics->stages[METRIC_STAGE_REPLY] = simple_toc(timer) * 1000;
 
-	// Clean up.
 cleanup:
 	// Release the read-write lock
-	if(lockAcquired) {
+	if(query->lock_acquired) {
 		// TODO In the case of a failing writing query, we may hold both locks:
 		// "CREATE (a {num: 1}) MERGE ({v: a.num})"
-		if(readonly) Graph_ReleaseLock(gc->g);
+		if(query->readonly) Graph_ReleaseLock(gc->g);
 		else Graph_WriterLeave(gc->g);
+		query->lock_acquired = false;
 	}
+	CommandCtx_UntrackCtx(command_ctx);
+}
+
+void Query_Complete(QueryExecution *query) {
+	CommandCtx *command_ctx = query->command_ctx;
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	QueryMetrics *query_metrics = QueryCtx_GetMetrics();
+	query_metrics->stages[METRIC_STAGE_QUEUE] = (command_ctx->bc) ? thpool_job_wait_time() : 0;
 
 	// Log query to slowlog.
+	SlowLogDetails details = {
+		.render_params = (command_ctx->params) ? _PreparedParamsToString : NULL,
+		.cached = query->cached,
+		.queue_wait = query_metrics->stages[METRIC_STAGE_QUEUE],
+		.lock_wait = query_metrics->stages[METRIC_STAGE_LOCK],
+		.profile = query->profile,
+	};
 	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
 	SlowLog_Add(slowlog, command_ctx->command_name, command_ctx->query,
-				QueryCtx_GetExecutionTime(), NULL);
-	if(plan) ExecutionPlan_Free(plan);
-	ResultSet_Free(result_set);
-	AST_Free(ast);
+				QueryCtx_GetExecutionTime(), NULL, &details);
+	if(query->profile) {
+		for(uint i = 0; i < array_len(query->profile); i++) rm_free(query->profile[i]);
+		array_free(query->profile);
+	}
+
+	// Record query metrics, both for the graph and module wide.
+	query_metrics->stages[METRIC_STAGE_TOTAL] = QueryCtx_GetExecutionTime();
+	query_metrics->rows = (query->result_set) ? query->result_set->recordCount : 0;
+	query_metrics->cached = query->cached;
+	query_metrics->failed = QueryCtx_EncounteredError();
+	Metrics_RecordQuery(gc->metrics, command_ctx->command_name, query_metrics);
+	if(Metrics_Global()) Metrics_RecordQuery(Metrics_Global(), command_ctx->command_name, query_metrics);
+	if(query->plan) ExecutionPlan_Free(query->plan);
+	ResultSet_Free(query->result_set);
+	AST_Free(query->ast);
 	GraphContext_Release(gc);
 	CommandCtx_Free(command_ctx);
 	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
 }
 
+void Graph_Query(void *args) {
+	QueryExecution query;
+	Query_Prepare(&query, (CommandCtx *)args);
+	Query_Execute(&query);
+	Query_Complete(&query);
+}
@@ -6,4 +6,39 @@
 
 #pragma once
 
+#include "cmd_context.h"
+#include "execution_ctx.h"
+#include "../query_ctx.h"
+
+/* A query is executed in three phases:
+ * 1. Prepare, parse and plan the query, no lock is held.
+ * 2. Execute, run the query under the graph's lock and reply.
+ * 3. Complete, record the query and release its resources.
+ * Graph_Query runs all three in turn, a group commit prepares all of its
+ * queries ahead of executing them within a single commit section. */
+typedef struct {
+	CommandCtx *command_ctx;    // Command context, replies to the client.
+	QueryCtx *query_ctx;        // Detached query context, while in between phases.
+	AST *ast;                   // Query AST, NULL if the query failed to parse.
+	ExecutionPlan *plan;        // Query execution plan, NULL unless EXECUTION_TYPE_QUERY.
+	ExecutionType exec_type;    // Query execution type.
+	ResultSet *result_set;      // Query result set, set during execution.
+	char **profile;             // Profile of a slow query, for the slowlog.
+	uint64_t profile_threshold; // Profile executions taking longer, 0 if not sampled.
+	bool cached;                // Whether the query's plan was retrieved from cache.
+	bool readonly;              // Whether the query doesn't modify the graph.
+	bool prepared;              // Whether the query was prepared successfully.
+	bool lock_acquired;         // Whether the query holds the graph's lock on its own.
+} QueryExecution;
+
+// Parse and plan query, errors are reported once the query executes.
+bool Query_Prepare(QueryExecution *query, CommandCtx *command_ctx);
+
+// Execute prepared query and reply to its client,
+// within a group commit the group holds the graph's lock.
+void Query_Execute(QueryExecution *query);
+
+// Log and record query metrics, free query and its QueryCtx.
+void Query_Complete(QueryExecution *query);
+
 void Graph_Query(void *args);
@@ -0,0 +1,105 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_reorder.h"
+#include "cmd_context.h"
+#include "../RG.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graph_reorder.h"
+#include "../graph/graphcontext.h"
+
+#include <string.h>
+
+// Indexed documents are keyed by node ID, rebuild each index.
+// Large labels are indexed in the background, their indices are unused until rebuilt.
+static void _RebuildIndices(GraphContext *gc) {
+	uint schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	for(uint i = 0; i < schema_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, i, SCHEMA_NODE);
+		if(s->index) Index_ConstructInBackground(s->index);
+		if(s->fulltextIdx) Index_ConstructInBackground(s->fulltextIdx);
+	}
+}
+
+ReorderCtx *ReorderCtx_New(CommandCtx *command_ctx, bool mapping) {
+	ASSERT(command_ctx != NULL);
+	ReorderCtx *reorder = rm_malloc(sizeof(ReorderCtx));
+	reorder->command_ctx = command_ctx;
+	reorder->mapping = mapping;
+	return reorder;
+}
+
+/* GRAPH.REORDER <graph> [BFS | DEGREE | RCM] [MAPPING]
+ * Assigns new IDs to the graph's nodes, placing connected nodes close to one another.
+ * Replies with the number of reordered nodes, if MAPPING is specified the reply
+ * also maps new IDs to previous ones: element i of the mapping holds the
+ * previous ID of the node now identified by i. */
+void Graph_Reorder(void *args) {
+	ReorderCtx *reorder = (ReorderCtx *)args;
+	CommandCtx *command_ctx = reorder->command_ctx;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	const char *strategy_name = CommandCtx_GetQuery(command_ctx);
+	char *strElapsed = NULL;
+
+	CommandCtx_TrackCtx(command_ctx);
+	QueryCtx_BeginTimer(); // Start reorder timing.
+	QueryCtx_SetGraphCtx(gc);
+
+	ReorderStrategy strategy = REORDER_RCM;
+	if(strategy_name && !GraphReorder_ParseStrategy(strategy_name, &strategy)) {
+		RedisModule_ReplyWithError(ctx, "Unknown reorder strategy, expecting one of BFS, DEGREE or RCM");
+		goto cleanup;
+	}
+
+	/* Node IDs held by a concurrent writer must remain valid,
+	 * exclude writers until the nodes are relabeled. */
+	Graph_WriterEnter(gc->g);
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	GraphContext_MarkWriter(ctx, gc);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+
+	// Computing the order only reads the graph, readers and Redis are not blocked meanwhile.
+	Graph_AcquireReadLock(gc->g);
+	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
+	NodeID *order = GraphReorder_ComputeOrder(gc->g, strategy);
+	uint64_t node_count = array_len(order);
+	Graph_ReleaseLock(gc->g);
+
+	// Commit, acquire locks in the same order as a committing writer would.
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	Graph_AcquireWriteLock(gc->g);
+	Graph_RelabelNodes(gc->g, order, node_count);
+	_RebuildIndices(gc);
+
+	// Reordering is deterministic, replicas reach the same order.
+	RedisModule_Replicate(ctx, "GRAPH.REORDER", "cc!", gc->graph_name,
+						  GraphReorder_StrategyName(strategy));
+
+	Graph_ReleaseLock(gc->g);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+	Graph_WriterLeave(gc->g);
+
+	RedisModule_ReplyWithArray(ctx, (reorder->mapping) ? 2 : 1);
+	asprintf(&strElapsed, "Nodes reordered: %lu, internal execution time: %.6f milliseconds",
+			 node_count, QueryCtx_GetExecutionTime());
+	RedisModule_ReplyWithStringBuffer(ctx, strElapsed, strlen(strElapsed));
+	if(reorder->mapping) {
+		RedisModule_ReplyWithArray(ctx, node_count);
+		for(uint64_t i = 0; i < node_count; i++) RedisModule_ReplyWithLongLong(ctx, order[i]);
+	}
+
+	array_free(order);
+
+cleanup:
+	if(strElapsed) free(strElapsed);
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	rm_free(reorder);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+}
@@ -0,0 +1,24 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "cmd_context.h"
+
+// Reorder command arguments.
+typedef struct {
+	CommandCtx *command_ctx;    // Reorder command context, the strategy is passed as its query.
+	bool mapping;               // Whether to reply with the mapping from new IDs to previous ones.
+} ReorderCtx;
+
+// Create a new reorder context, taking ownership of command_ctx.
+ReorderCtx *ReorderCtx_New
+(
+	CommandCtx *command_ctx,    // Reorder command context.
+	bool mapping                // Whether to reply with the ID mapping.
+);
+
+void Graph_Reorder(void *args);
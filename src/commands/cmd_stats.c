@@ -0,0 +1,44 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_stats.h"
+#include "../graph/graphcontext.h"
+#include "../metrics/metrics.h"
+
+#include <strings.h>
+
+/* GRAPH.STATS <graph> [RESET [ALL]]
+ * Replies with the graph's query metrics as name, value pairs.
+ * RESET discards the graph's metrics, RESET ALL discards module wide metrics as well. */
+int MGraph_Stats(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc < 2 || argc > 4) return RedisModule_WrongArity(ctx);
+
+	bool reset = false;
+	bool reset_all = false;
+	if(argc > 2) {
+		reset = strcasecmp(RedisModule_StringPtrLen(argv[2], NULL), "RESET") == 0;
+		if(argc == 4) reset_all = strcasecmp(RedisModule_StringPtrLen(argv[3], NULL), "ALL") == 0;
+		if(!reset || (argc == 4 && !reset_all)) {
+			RedisModule_ReplyWithError(ctx, "Unknown GRAPH.STATS subcommand, expected RESET [ALL]");
+			return REDISMODULE_OK;
+		}
+	}
+
+	// If the GraphContext is null, key access failed and an error has been emitted.
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	if(!gc) return REDISMODULE_OK;
+
+	if(reset) {
+		Metrics_Reset(gc->metrics);
+		if(reset_all && Metrics_Global()) Metrics_Reset(Metrics_Global());
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		Metrics_Reply(ctx, gc->metrics);
+	}
+
+	GraphContext_Release(gc);
+	return REDISMODULE_OK;
+}
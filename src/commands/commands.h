@@ -14,8 +14,14 @@
 #include "cmd_explain.h"
 #include "cmd_profile.h"
 #include "cmd_slowlog.h"
+#include "cmd_reorder.h"
+#include "cmd_memory.h"
 #include "cmd_dispatcher.h"
 #include "cmd_bulk_insert.h"
+#include "cmd_effect.h"
+#include "cmd_batch.h"
+#include "cmd_prepare.h"
+#include "cmd_stats.h"
 
 typedef enum {
 	CMD_UNKNOWN,
@@ -25,5 +31,11 @@ typedef enum {
 	CMD_EXPLAIN,
 	CMD_PROFILE,
 	CMD_BULK_INSERT,
-	CMD_SLOWLOG
+	CMD_SLOWLOG,
+	CMD_REORDER,
+	CMD_MEMORY,
+	CMD_BATCH,
+	CMD_PREPARE,
+	CMD_EXECUTE,
+	CMD_DEALLOCATE
 } GRAPH_Commands;
@@ -6,6 +6,8 @@
 
 #include "execution_ctx.h"
 #include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
 #include "../execution_plan/execution_plan_clone.h"
 
 static ExecutionType _GetExecutionTypeFromAST(AST *ast) {
@@ -16,11 +18,13 @@ static ExecutionType _GetExecutionTypeFromAST(AST *ast) {
 	assert(false && "Uknown execution type");
 }
 
-static ExecutionCtx *_ExecutionCtx_New(AST *ast, ExecutionPlan *plan, ExecutionType exec_type) {
+static ExecutionCtx *_ExecutionCtx_New(AST *ast, ExecutionPlan *plan, ExecutionType exec_type,
+									   uint plan_version) {
 	ExecutionCtx *exec_ctx = rm_calloc(1, sizeof(ExecutionCtx));
 	exec_ctx->ast = ast;
 	exec_ctx->plan = plan;
 	exec_ctx->exec_type = exec_type;
+	exec_ctx->plan_version = plan_version;
 	return exec_ctx;
 }
 
@@ -64,25 +68,41 @@ ExecutionCtx ExecutionCtx_FromQuery(const char *query) {
 	// Have an invalid ctx for errors.
 	ExecutionCtx invalid_ctx = {.ast = NULL, .plan = NULL, .cached = false, .exec_type = EXECUTION_TYPE_INVALID};
 	const char *query_string;
+	double timer[2];
+	QueryMetrics *metrics = QueryCtx_GetMetrics();
+	simple_tic(timer);
 	// Parse and validate parameters only. Extract query string.
 	cypher_parse_result_t *params_parse_result = parse_params(query, &query_string);
+	metrics->stages[METRIC_STAGE_PARSE] = simple_toc(timer) * 1000;
 	// Return invalid execution context if there isn't a parser result.
 	if(params_parse_result == NULL) return invalid_ctx;
 
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Cache *cache = GraphContext_GetCache(gc);
+	// Read version prior to planning, a concurrent change would invalidate the new plan.
+	uint plan_version = GraphContext_PlanVersion(gc);
 	// Check the cache to see if we already have a cached context for this query.
+	ExecutionCtx *stale_exec_ctx = NULL;
 	ExecutionCtx *cached_exec_ctx = _ExecutionCtx_FromCache(cache, query_string, params_parse_result);
+	if(cached_exec_ctx && cached_exec_ctx->plan_version != plan_version) {
+		// Indices changed since the plan was built, re-plan.
+		stale_exec_ctx = cached_exec_ctx;
+		cached_exec_ctx = NULL;
+	}
 	if(cached_exec_ctx) {
+		simple_tic(timer);
 		ExecutionCtx ctx = _ExecutionCtx_Clone(*cached_exec_ctx);
 		// Set parameters parse result in the execution ast.
 		AST_SetParamsParseResult(ctx.ast, params_parse_result);
 		ctx.cached = true;
+		metrics->stages[METRIC_STAGE_PLAN] = simple_toc(timer) * 1000;
 		return ctx;
 	}
 
 	// No cached execution plan, try to parse the query.
+	simple_tic(timer);
 	AST *ast = _ExecutionCtx_ParseAST(query_string, params_parse_result);
+	metrics->stages[METRIC_STAGE_PARSE] += simple_toc(timer) * 1000;
 	// Invalid query, return invalid execution context.
 	if(!ast) return invalid_ctx;
 
@@ -90,14 +110,29 @@ ExecutionCtx ExecutionCtx_FromQuery(const char *query) {
 	ExecutionType exec_type = _GetExecutionTypeFromAST(ast);
 	// In case of valid query, create execution plan, and cache it and the AST.
 	if(exec_type == EXECUTION_TYPE_QUERY) {
+		simple_tic(timer);
+		// Measure the plan's footprint, reported by graph memory usage.
+		Alloc_TrackBegin();
 		plan = NewExecutionPlan();
-		// Created new valid execution context.
-		ExecutionCtx *exec_ctx_to_cache = _ExecutionCtx_New(ast, plan, exec_type);
-		// Cache execution context.
-		Cache_SetValue(cache, query_string, exec_ctx_to_cache);
+		size_t plan_size = Alloc_TrackEnd();
+		if(stale_exec_ctx) {
+			/* Replace stale entry in place, plans are cloned prior to execution
+			 * such that the stale plan isn't referenced by running queries. */
+			ExecutionPlan_Free(stale_exec_ctx->plan);
+			AST_Free(stale_exec_ctx->ast);
+			stale_exec_ctx->ast = ast;
+			stale_exec_ctx->plan = plan;
+			stale_exec_ctx->plan_version = plan_version;
+		} else {
+			// Created new valid execution context.
+			ExecutionCtx *exec_ctx_to_cache = _ExecutionCtx_New(ast, plan, exec_type, plan_version);
+			// Cache execution context.
+			Cache_SetValue(cache, query_string, exec_ctx_to_cache, sizeof(ExecutionCtx) + plan_size);
+		}
 		// Clone execution plan and ast that will be used in the current execution.
 		plan = ExecutionPlan_Clone(plan);
 		ast = AST_ShallowCopy(ast);
+		metrics->stages[METRIC_STAGE_PLAN] = simple_toc(timer) * 1000;
 	}
 	ExecutionCtx ctx = {.ast = ast, .plan = plan, .exec_type = exec_type, .cached = false};
 	return ctx;
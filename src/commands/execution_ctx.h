@@ -27,6 +27,7 @@ typedef struct {
 	bool cached;                // Indicate if this struct was returned from cache.
 	ExecutionPlan *plan;        // Execution plan relevant for the current execution context.
 	ExecutionType exec_type;
+	uint plan_version;          // Graph plan version the cached plan was built against.
 } ExecutionCtx;
 
 /**
@@ -0,0 +1,201 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "group_commit.h"
+#include "cmd_query.h"
+#include "../ast/ast.h"
+#include "../RG.h"
+#include "../config.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/thpool/thpool.h"
+#include <string.h>
+#include <pthread.h>
+#include <sys/param.h>
+
+extern threadpool _thpool; // Declared in module.c
+
+struct GroupCommitQueue {
+	pthread_mutex_t mutex;      // Guards pending and leader.
+	CommandCtx **pending;       // Queued write queries, in arrival order.
+	bool leader;                // Whether a leader is draining the queue.
+};
+
+// Group being committed by the calling thread.
+typedef struct {
+	RedisModuleCtx *ctx;        // Context the GIL is locked and changes are replicated through.
+	bool main_thread;           // Group is executed on Redis main thread, which holds the GIL.
+	bool readonly;              // Group is made of read only queries.
+	bool multi;                 // Wrap replicated changes within MULTI/EXEC.
+	uint replicated;            // Number of queries replicated by the current section.
+} GroupCommit;
+
+static __thread GroupCommit *_group = NULL;
+
+GroupCommitQueue *GroupCommitQueue_New(void) {
+	GroupCommitQueue *queue = rm_malloc(sizeof(GroupCommitQueue));
+	int res = pthread_mutex_init(&queue->mutex, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+	queue->pending = array_new(CommandCtx *, 0);
+	queue->leader = false;
+	return queue;
+}
+
+void GroupCommitQueue_Free(GroupCommitQueue *queue) {
+	ASSERT(queue && array_len(queue->pending) == 0);
+	array_free(queue->pending);
+	pthread_mutex_destroy(&queue->mutex);
+	rm_free(queue);
+}
+
+// Returns true if query may change the graph's indices,
+// queries following it must be planned once it committed.
+static bool _GroupCommit_AltersIndices(const QueryExecution *query) {
+	if(!query->prepared) return false;
+	if(query->exec_type != EXECUTION_TYPE_QUERY) return true;
+	// Procedures may create or drop full-text indices.
+	return AST_TreeContainsType(query->ast->root, CYPHER_AST_CALL);
+}
+
+/* Execute prepared queries within a single commit section, a writing group
+ * holds Redis GIL and the graph's write lock throughout, each query observes
+ * the changes of the queries preceding it. */
+static void _GroupCommit_Section(GroupCommit *group, GraphContext *gc, QueryExecution *queries,
+								 uint count) {
+	if(group->readonly) {
+		Graph_AcquireReadLock(gc->g);
+	} else {
+		if(!group->main_thread) RedisModule_ThreadSafeContextLock(group->ctx);
+		Graph_AcquireWriteLock(gc->g);
+	}
+
+	group->replicated = 0;
+	_group = group;
+	for(uint i = 0; i < count; i++) {
+		QueryCtx_Attach(queries[i].query_ctx);
+		Query_Execute(queries + i);
+		queries[i].query_ctx = QueryCtx_Detach();
+	}
+	_group = NULL;
+
+	// Close the section's replication block while still holding the GIL.
+	if(group->multi && group->replicated > 0) RedisModule_Replicate(group->ctx, "EXEC", "");
+
+	Graph_ReleaseLock(gc->g);
+	if(!group->readonly && !group->main_thread) RedisModule_ThreadSafeContextUnlock(group->ctx);
+}
+
+void GroupCommit_Execute(RedisModuleCtx *ctx, GraphContext *gc, CommandCtx **batch, uint count,
+						 bool readonly) {
+	bool main_thread = (ctx != NULL);
+	GroupCommit group = {
+		.ctx = (main_thread) ? ctx : RedisModule_GetThreadSafeContext(NULL),
+		.main_thread = main_thread,
+		.readonly = readonly,
+		// Redis wraps replication issued by a command on its main thread on its own.
+		.multi = (!readonly && !main_thread && count > 1),
+		.replicated = 0
+	};
+	QueryExecution *queries = rm_malloc(sizeof(QueryExecution) * count);
+
+	// Writers outside of the group are not interleaved with its queries.
+	if(!readonly) Graph_WriterEnter(gc->g);
+
+	uint first = 0;
+	while(first < count) {
+		// Plan queries ahead of the commit section, no lock is held meanwhile.
+		uint last = first;
+		while(last < count) {
+			QueryExecution *query = queries + last;
+			Query_Prepare(query, batch[last]);
+			query->query_ctx = QueryCtx_Detach();
+			last++;
+			// Following queries are planned against the indices this query leaves.
+			if(_GroupCommit_AltersIndices(query)) break;
+		}
+
+		_GroupCommit_Section(&group, gc, queries + first, last - first);
+
+		// Each query releases its own resources and unblocks its client.
+		for(uint i = first; i < last; i++) {
+			QueryCtx_Attach(queries[i].query_ctx);
+			Query_Complete(queries + i);
+		}
+		first = last;
+	}
+
+	if(!readonly) Graph_WriterLeave(gc->g);
+	if(!main_thread) RedisModule_FreeThreadSafeContext(group.ctx);
+	rm_free(queries);
+}
+
+// Leader, drains graph's queue batch by batch.
+static void _GroupCommit_Drain(void *arg) {
+	GraphContext *gc = (GraphContext *)arg;
+	GroupCommitQueue *queue = gc->commit_queue;
+	uint max_batch = Config_GetGroupCommitMaxBatch();
+	CommandCtx **batch = array_new(CommandCtx *, max_batch);
+
+	while(true) {
+		pthread_mutex_lock(&queue->mutex);
+		uint pending = array_len(queue->pending);
+		if(pending == 0) {
+			// Queue drained, next writer schedules a new leader.
+			queue->leader = false;
+			pthread_mutex_unlock(&queue->mutex);
+			break;
+		}
+
+		// Take oldest queries, preserving arrival order.
+		uint count = MIN(pending, max_batch);
+		array_clear(batch);
+		for(uint i = 0; i < count; i++) batch = array_append(batch, queue->pending[i]);
+		memmove(queue->pending, queue->pending + count, sizeof(CommandCtx *) * (pending - count));
+		queue->pending = array_trimm_len(queue->pending, pending - count);
+		pthread_mutex_unlock(&queue->mutex);
+
+		GroupCommit_Execute(NULL, gc, batch, count, false);
+	}
+
+	array_free(batch);
+	// Release reference held by the leader.
+	GraphContext_Release(gc);
+}
+
+void GroupCommit_Enqueue(CommandCtx *command_ctx) {
+	ASSERT(command_ctx && command_ctx->bc);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	GroupCommitQueue *queue = gc->commit_queue;
+
+	pthread_mutex_lock(&queue->mutex);
+	queue->pending = array_append(queue->pending, command_ctx);
+	bool schedule_leader = !queue->leader;
+	queue->leader = true;
+	pthread_mutex_unlock(&queue->mutex);
+
+	if(schedule_leader) {
+		// Graph must outlive the leader.
+		GraphContext_Retain(gc);
+		thpool_add_work_lane(_thpool, _GroupCommit_Drain, gc, THPOOL_LANE_WRITE, gc);
+	}
+}
+
+bool GroupCommit_InProgress(void) {
+	return _group != NULL;
+}
+
+bool GroupCommit_ReadOnly(void) {
+	return _group != NULL && _group->readonly;
+}
+
+void GroupCommit_Replicate(const char *command_name, const char *graph_name,
+						   const char *payload, size_t len) {
+	ASSERT(_group && !_group->readonly);
+	if(_group->multi && _group->replicated == 0) RedisModule_Replicate(_group->ctx, "MULTI", "");
+	RedisModule_Replicate(_group->ctx, command_name, "cb!", graph_name, payload, len);
+	_group->replicated++;
+}
@@ -0,0 +1,48 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "cmd_context.h"
+
+/* Group commit batches write queries issued concurrently against a graph:
+ * queued writers are drained by a single leader which holds the graph's
+ * writer lock, plans each query ahead of time and then executes all of them
+ * within a single commit section, holding Redis GIL and the graph's write
+ * lock once for the entire group, and replicating the group's changes as a
+ * single MULTI/EXEC block. */
+
+// Write queries awaiting a group commit on a single graph.
+typedef struct GroupCommitQueue GroupCommitQueue;
+
+// Create a new, empty, queue.
+GroupCommitQueue *GroupCommitQueue_New(void);
+
+// Free queue, queue must be empty.
+void GroupCommitQueue_Free(GroupCommitQueue *queue);
+
+// Queue write query, a leader is scheduled if the graph has none.
+void GroupCommit_Enqueue(CommandCtx *command_ctx);
+
+// Execute queries in order, each query replies through its own context,
+// a writing group holds the graph's writer lock throughout.
+// A query which may change the graph's indices ends the commit section,
+// queries following it are planned once it committed.
+// ctx is NULL unless called from Redis main thread, which already holds the GIL.
+void GroupCommit_Execute(RedisModuleCtx *ctx, GraphContext *gc, CommandCtx **batch, uint count,
+						 bool readonly);
+
+// Returns true if the calling thread is within a group's commit section,
+// in which case the group holds the graph's lock, and a writing group holds Redis GIL.
+bool GroupCommit_InProgress(void);
+
+// Returns true if the group being committed is made of read only queries.
+bool GroupCommit_ReadOnly(void);
+
+// Replicate the changes of the group's current query,
+// the group's first replicated query opens a MULTI block, closed by the group.
+void GroupCommit_Replicate(const char *command_name, const char *graph_name,
+						   const char *payload, size_t len);
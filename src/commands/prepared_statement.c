@@ -0,0 +1,244 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "prepared_statement.h"
+#include "../RG.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../bulk_insert/bulk_insert.h"
+#include "../arithmetic/arithmetic_expression.h"
+#include "rax.h"
+
+#include <string.h>
+#include <pthread.h>
+
+#define PARAMS_MAX_DEPTH 32  // Maximum nesting of array parameters.
+
+typedef struct {
+	char *query;                // Statement's query.
+	bool read_only;             // Query doesn't modify the graph.
+	bool procedure_call;        // Query calls a procedure.
+} PreparedStatement;
+
+struct PreparedStatements {
+	pthread_mutex_t mutex;      // Guards statements and handles.
+	rax *statements;            // Maps a handle to its statement.
+	rax *handles;               // Maps a query to its handle.
+	uint64_t next_handle;       // Handle of the next registered statement.
+	size_t size;                // Number of bytes held by registered statements.
+};
+
+// Number of bytes held by a single statement, including its keys in both maps.
+static inline size_t _PreparedStatement_Size(const PreparedStatement *statement) {
+	return sizeof(PreparedStatement) + sizeof(uint64_t) + 2 * (strlen(statement->query) + 1);
+}
+
+static void _PreparedStatement_Free(void *statement) {
+	rm_free(((PreparedStatement *)statement)->query);
+	rm_free(statement);
+}
+
+PreparedStatements *PreparedStatements_New(void) {
+	PreparedStatements *statements = rm_malloc(sizeof(PreparedStatements));
+	int res = pthread_mutex_init(&statements->mutex, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+	statements->statements = raxNew();
+	statements->handles = raxNew();
+	statements->next_handle = 0;
+	statements->size = 0;
+	return statements;
+}
+
+uint64_t PreparedStatements_Add(PreparedStatements *statements, const char *query, bool read_only,
+								bool procedure_call) {
+	ASSERT(statements && query);
+	size_t len = strlen(query);
+
+	pthread_mutex_lock(&statements->mutex);
+	void *handle = raxFind(statements->handles, (unsigned char *)query, len);
+	if(handle == raxNotFound) {
+		uint64_t id = statements->next_handle++;
+		handle = (void *)(uintptr_t)id;
+		PreparedStatement *statement = rm_malloc(sizeof(PreparedStatement));
+		statement->query = rm_strdup(query);
+		statement->read_only = read_only;
+		statement->procedure_call = procedure_call;
+		raxInsert(statements->statements, (unsigned char *)&id, sizeof(id), statement, NULL);
+		raxInsert(statements->handles, (unsigned char *)query, len, handle, NULL);
+		statements->size += _PreparedStatement_Size(statement);
+	}
+	pthread_mutex_unlock(&statements->mutex);
+
+	return (uint64_t)(uintptr_t)handle;
+}
+
+char *PreparedStatements_Get(PreparedStatements *statements, uint64_t handle,
+							 bool *read_only, bool *procedure_call) {
+	ASSERT(statements && read_only && procedure_call);
+	char *query = NULL;
+
+	pthread_mutex_lock(&statements->mutex);
+	PreparedStatement *statement = raxFind(statements->statements, (unsigned char *)&handle,
+										   sizeof(handle));
+	if(statement != raxNotFound) {
+		// Copied, as the statement may be removed once the mutex is released.
+		query = rm_strdup(statement->query);
+		*read_only = statement->read_only;
+		*procedure_call = statement->procedure_call;
+	}
+	pthread_mutex_unlock(&statements->mutex);
+
+	return query;
+}
+
+bool PreparedStatements_Remove(PreparedStatements *statements, uint64_t handle) {
+	ASSERT(statements);
+	PreparedStatement *statement = NULL;
+
+	pthread_mutex_lock(&statements->mutex);
+	int removed = raxRemove(statements->statements, (unsigned char *)&handle, sizeof(handle),
+							(void **)&statement);
+	if(removed) {
+		raxRemove(statements->handles, (unsigned char *)statement->query,
+				  strlen(statement->query), NULL);
+		statements->size -= _PreparedStatement_Size(statement);
+	}
+	pthread_mutex_unlock(&statements->mutex);
+
+	if(removed) _PreparedStatement_Free(statement);
+	return removed;
+}
+
+size_t PreparedStatements_MemoryUsage(PreparedStatements *statements) {
+	ASSERT(statements);
+	pthread_mutex_lock(&statements->mutex);
+	size_t size = sizeof(PreparedStatements) + statements->size;
+	pthread_mutex_unlock(&statements->mutex);
+	return size;
+}
+
+void PreparedStatements_Free(PreparedStatements *statements) {
+	ASSERT(statements);
+	raxFreeWithCallback(statements->statements, _PreparedStatement_Free);
+	raxFree(statements->handles);
+	pthread_mutex_destroy(&statements->mutex);
+	rm_free(statements);
+}
+
+//------------------------------------------------------------------------------
+// Parameters decoding
+//------------------------------------------------------------------------------
+
+typedef struct {
+	const char *data;           // Binary parameters.
+	size_t len;                 // Number of bytes.
+	size_t pos;                 // Read position.
+	bool error;                 // Parameters are malformed.
+} ParamsReader;
+
+static bool _Params_Read(ParamsReader *r, void *dest, size_t n) {
+	if(r->error || r->len - r->pos < n) {
+		r->error = true;
+		return false;
+	}
+	memcpy(dest, r->data + r->pos, n);
+	r->pos += n;
+	return true;
+}
+
+// Returns the next null-terminated string, pointing into the parameters buffer.
+static const char *_Params_ReadString(ParamsReader *r) {
+	if(r->error) return NULL;
+	const char *s = r->data + r->pos;
+	const char *end = memchr(s, '\0', r->len - r->pos);
+	if(!end) {
+		r->error = true;
+		return NULL;
+	}
+	r->pos += end - s + 1;
+	return s;
+}
+
+static SIValue _Params_ReadValue(ParamsReader *r, uint depth) {
+	uint8_t t = BI_NULL;
+	if(!_Params_Read(r, &t, 1)) return SI_NullVal();
+
+	switch(t) {
+	case BI_NULL:
+		return SI_NullVal();
+	case BI_BOOL: {
+		uint8_t b = 0;
+		_Params_Read(r, &b, 1);
+		return SI_BoolVal(b);
+	}
+	case BI_DOUBLE: {
+		double d = 0;
+		_Params_Read(r, &d, sizeof(double));
+		return SI_DoubleVal(d);
+	}
+	case BI_LONG: {
+		int64_t l = 0;
+		_Params_Read(r, &l, sizeof(int64_t));
+		return SI_LongVal(l);
+	}
+	case BI_STRING: {
+		const char *s = _Params_ReadString(r);
+		if(!s) return SI_NullVal();
+		return SI_DuplicateStringVal(s);
+	}
+	case BI_ARRAY: {
+		int64_t len = 0;
+		_Params_Read(r, &len, sizeof(int64_t));
+		// Every element takes at least a single byte.
+		if(depth >= PARAMS_MAX_DEPTH || len < 0 || (uint64_t)len > r->len - r->pos) {
+			r->error = true;
+		}
+		if(r->error) return SI_NullVal();
+
+		SIValue list = SIArray_New(len);
+		for(int64_t i = 0; i < len && !r->error; i++) {
+			SIValue v = _Params_ReadValue(r, depth + 1);
+			SIArray_Append(&list, v);
+			SIValue_Free(v);
+		}
+		return list;
+	}
+	default:
+		r->error = true;
+		return SI_NullVal();
+	}
+}
+
+bool PreparedStatement_BindParams(const char *params, size_t len) {
+	ParamsReader r = {.data = params, .len = len, .pos = 0, .error = false};
+	rax *map = QueryCtx_GetParams();
+
+	uint32_t count = 0;
+	_Params_Read(&r, &count, sizeof(uint32_t));
+	for(uint32_t i = 0; i < count && !r.error; i++) {
+		const char *name = _Params_ReadString(&r);
+		SIValue v = _Params_ReadValue(&r, 0);
+		if(r.error) {
+			SIValue_Free(v);
+			break;
+		}
+
+		// A parameter specified more than once takes its last value.
+		AR_ExpNode *prev = NULL;
+		AR_ExpNode *exp = AR_EXP_NewConstOperandNode(v);
+		raxInsert(map, (unsigned char *)name, strlen(name), exp, (void **)&prev);
+		if(prev) AR_EXP_Free(prev);
+	}
+
+	// Parameters must be consumed in their entirety.
+	if(r.error || r.pos != r.len) {
+		QueryCtx_SetError("Malformed prepared statement parameters");
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,52 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Prepared statements are queries registered once through GRAPH.PREPARE
+ * and executed by handle through GRAPH.EXECUTE, with parameters bound from
+ * a compact binary encoding rather than parsed from a CYPHER prefix.
+ *
+ * Parameters format:
+ * parameter count : 4-byte unsigned integer
+ * (name : null-terminated C string, value) X parameter count
+ *
+ * Values are encoded as bulk insert properties: a 1-byte BulkInsertType
+ * followed by the value, numbers are native endian. */
+
+// Statements prepared against a single graph.
+typedef struct PreparedStatements PreparedStatements;
+
+// Create a new, empty, set of statements.
+PreparedStatements *PreparedStatements_New(void);
+
+// Register query, returning its handle, a query is registered once.
+// read_only and procedure_call classify the query, as reported by its AST.
+// Handles are never reused, not even once their statement is removed.
+uint64_t PreparedStatements_Add(PreparedStatements *statements, const char *query, bool read_only,
+								bool procedure_call);
+
+// Returns a copy of the query of the statement identified by handle, NULL if there's no
+// such statement, along with the query's classification. Returned query should be freed by the caller.
+char *PreparedStatements_Get(PreparedStatements *statements, uint64_t handle,
+							 bool *read_only, bool *procedure_call);
+
+// Remove the statement identified by handle, returns false if there's no such statement.
+bool PreparedStatements_Remove(PreparedStatements *statements, uint64_t handle);
+
+// Returns the number of bytes held by the statements.
+size_t PreparedStatements_MemoryUsage(PreparedStatements *statements);
+
+// Free statements.
+void PreparedStatements_Free(PreparedStatements *statements);
+
+// Decode binary parameters into the query parameters map of the current query.
+// Returns false and sets the query error if parameters are malformed.
+bool PreparedStatement_BindParams(const char *params, size_t len);
@@ -16,9 +16,22 @@
 #define OMP_THREAD_COUNT "OMP_THREAD_COUNT" // Config param, max number of OpenMP threads
 #define VKEY_MAX_ENTITY_COUNT "VKEY_MAX_ENTITY_COUNT" // Config param, max number of entities in each virtual key
 #define MAINTAIN_TRANSPOSED_MATRICES "MAINTAIN_TRANSPOSED_MATRICES" // Whether the module should maintain transposed relationship matrices
+#define READ_LANE_WEIGHT "READ_LANE_WEIGHT" // Config param, thread pool weight of read queries
+#define WRITE_LANE_WEIGHT "WRITE_LANE_WEIGHT" // Config param, thread pool weight of write queries
+#define HEAVY_LANE_WEIGHT "HEAVY_LANE_WEIGHT" // Config param, thread pool weight of heavy queries
+#define GROUP_COMMIT "GROUP_COMMIT" // Whether concurrent write queries are committed in groups
+#define GROUP_COMMIT_MAX_BATCH "GROUP_COMMIT_MAX_BATCH" // Config param, max number of write queries in a group
+#define REPLICATE_EFFECTS "REPLICATE_EFFECTS" // Whether write queries are replicated by their effects
+#define SLOWLOG_PROFILE_THRESHOLD "SLOWLOG_PROFILE_THRESHOLD" // Config param, latency above which slowlog entries are profiled
+#define SLOWLOG_PROFILE_SAMPLE_RATE "SLOWLOG_PROFILE_SAMPLE_RATE" // Config param, one in how many queries is profiled
 
 #define CACHE_SIZE_DEFAULT 25
 #define VKEY_MAX_ENTITY_COUNT_DEFAULT 100000
+#define READ_LANE_WEIGHT_DEFAULT 8
+#define WRITE_LANE_WEIGHT_DEFAULT 4
+#define HEAVY_LANE_WEIGHT_DEFAULT 1
+#define GROUP_COMMIT_MAX_BATCH_DEFAULT 64
+#define SLOWLOG_PROFILE_SAMPLE_RATE_DEFAULT 10
 
 extern RG_Config config; // Global module configuration.
 
@@ -137,6 +150,118 @@ static int _Config_SetCacheSize(RedisModuleCtx *ctx, RedisModuleString *cache_si
 	return REDISMODULE_OK;
 }
 
+static int _Config_SetGroupCommit(RedisModuleCtx *ctx, RedisModuleString *group_commit_str) {
+	const char *group_commit = RedisModule_StringPtrLen(group_commit_str, NULL);
+	if(!strcasecmp(group_commit, "yes")) {
+		config.group_commit = true;
+		RedisModule_Log(ctx, "notice", "Committing concurrent write queries in groups.");
+	} else if(!strcasecmp(group_commit, "no")) {
+		config.group_commit = false;
+	} else {
+		// Exit with error if argument was not "yes" or "no".
+		RedisModule_Log(ctx, "warning",
+						"Invalid argument '%s' for group_commit, expected 'yes' or 'no'", group_commit);
+		return REDISMODULE_ERR;
+	}
+	return REDISMODULE_OK;
+}
+
+static int _Config_SetReplicateEffects(RedisModuleCtx *ctx, RedisModuleString *effects_str) {
+	const char *effects = RedisModule_StringPtrLen(effects_str, NULL);
+	if(!strcasecmp(effects, "yes")) {
+		config.replicate_effects = true;
+	} else if(!strcasecmp(effects, "no")) {
+		config.replicate_effects = false;
+		RedisModule_Log(ctx, "notice", "Replicating write queries verbatim.");
+	} else {
+		// Exit with error if argument was not "yes" or "no".
+		RedisModule_Log(ctx, "warning",
+						"Invalid argument '%s' for replicate_effects, expected 'yes' or 'no'", effects);
+		return REDISMODULE_ERR;
+	}
+	return REDISMODULE_OK;
+}
+
+// If the user has specified the group commit batch size, update the configuration.
+// Returns REDISMODULE_OK on success and REDISMODULE_ERR if the argument was invalid.
+static int _Config_SetGroupCommitMaxBatch(RedisModuleCtx *ctx, RedisModuleString *batch_str) {
+	long long max_batch;
+	int res = _Config_ParsePositiveInteger(batch_str, &max_batch);
+	// Exit with error if integer parsing fails.
+	if(res != REDISMODULE_OK || max_batch > UINT_MAX) {
+		const char *invalid_arg = RedisModule_StringPtrLen(batch_str, NULL);
+		RedisModule_Log(ctx, "warning", "Could not parse group commit batch size argument '%s'",
+						invalid_arg);
+		return REDISMODULE_ERR;
+	}
+
+	// Update the batch size in the configuration.
+	config.group_commit_max_batch = max_batch;
+
+	return REDISMODULE_OK;
+}
+
+// If the user has specified a slowlog profiling threshold, update the configuration.
+// Returns REDISMODULE_OK on success and REDISMODULE_ERR if the argument was invalid.
+static int _Config_SetSlowlogProfileThreshold(RedisModuleCtx *ctx, RedisModuleString *threshold_str) {
+	long long threshold;
+	int res = _Config_ParsePositiveInteger(threshold_str, &threshold);
+	// Exit with error if integer parsing fails.
+	if(res != REDISMODULE_OK) {
+		const char *invalid_arg = RedisModule_StringPtrLen(threshold_str, NULL);
+		RedisModule_Log(ctx, "warning", "Could not parse slowlog profile threshold argument '%s'",
+						invalid_arg);
+		return REDISMODULE_ERR;
+	}
+
+	RedisModule_Log(ctx, "notice", "Profiling queries, slowlog entries above %lld ms include their profile.",
+					threshold);
+
+	// Update the threshold in the configuration.
+	config.slowlog_profile_threshold = threshold;
+
+	return REDISMODULE_OK;
+}
+
+// If the user has specified a slowlog profiling sample rate, update the configuration.
+// Returns REDISMODULE_OK on success and REDISMODULE_ERR if the argument was invalid.
+static int _Config_SetSlowlogProfileSampleRate(RedisModuleCtx *ctx, RedisModuleString *rate_str) {
+	long long rate;
+	int res = _Config_ParsePositiveInteger(rate_str, &rate);
+	// Exit with error if integer parsing fails.
+	if(res != REDISMODULE_OK || rate > UINT_MAX) {
+		const char *invalid_arg = RedisModule_StringPtrLen(rate_str, NULL);
+		RedisModule_Log(ctx, "warning", "Could not parse slowlog profile sample rate argument '%s'",
+						invalid_arg);
+		return REDISMODULE_ERR;
+	}
+
+	// Update the sample rate in the configuration.
+	config.slowlog_profile_sample_rate = rate;
+
+	return REDISMODULE_OK;
+}
+
+// If the user has specified a thread pool lane weight, update the configuration.
+// Returns REDISMODULE_OK on success and REDISMODULE_ERR if the argument was invalid.
+static int _Config_SetLaneWeight(RedisModuleCtx *ctx, const char *param,
+								 RedisModuleString *weight_str, int *weight) {
+	long long lane_weight;
+	int res = _Config_ParsePositiveInteger(weight_str, &lane_weight);
+	// Exit with error if integer parsing fails or weight is outside of the valid range 1-INT_MAX.
+	if(res != REDISMODULE_OK || lane_weight > INT_MAX) {
+		const char *invalid_arg = RedisModule_StringPtrLen(weight_str, NULL);
+		RedisModule_Log(ctx, "warning", "Received invalid value '%s' as %s argument",
+						invalid_arg, param);
+		return REDISMODULE_ERR;
+	}
+
+	// Set the lane weight in the configuration.
+	*weight = lane_weight;
+
+	return REDISMODULE_OK;
+}
+
 // Initialize every module-level configuration to its default value.
 static void _Config_SetToDefaults(RedisModuleCtx *ctx) {
 	// The thread pool's default size is equal to the system's number of cores.
@@ -167,6 +292,18 @@ static void _Config_SetToDefaults(RedisModuleCtx *ctx) {
 	// Always build transposed matrices by default.
 	config.maintain_transposed_matrices = true;
 	config.cache_size = CACHE_SIZE_DEFAULT;
+	// Favor read queries over writes and both over heavy queries.
+	config.read_lane_weight = READ_LANE_WEIGHT_DEFAULT;
+	config.write_lane_weight = WRITE_LANE_WEIGHT_DEFAULT;
+	config.heavy_lane_weight = HEAVY_LANE_WEIGHT_DEFAULT;
+	// Commit each write query on its own by default.
+	config.group_commit = false;
+	config.group_commit_max_batch = GROUP_COMMIT_MAX_BATCH_DEFAULT;
+	// Replicate write queries verbatim by default.
+	config.replicate_effects = false;
+	// Don't profile queries by default.
+	config.slowlog_profile_threshold = 0;
+	config.slowlog_profile_sample_rate = SLOWLOG_PROFILE_SAMPLE_RATE_DEFAULT;
 }
 
 int Config_Init(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
@@ -200,6 +337,22 @@ int Config_Init(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 			res = _Config_BuildTransposedMatrices(ctx, val);
 		} else if(!(strcasecmp(param, CACHE_SIZE))) {
 			res = _Config_SetCacheSize(ctx, val);
+		} else if(!strcasecmp(param, READ_LANE_WEIGHT)) {
+			res = _Config_SetLaneWeight(ctx, READ_LANE_WEIGHT, val, &config.read_lane_weight);
+		} else if(!strcasecmp(param, WRITE_LANE_WEIGHT)) {
+			res = _Config_SetLaneWeight(ctx, WRITE_LANE_WEIGHT, val, &config.write_lane_weight);
+		} else if(!strcasecmp(param, HEAVY_LANE_WEIGHT)) {
+			res = _Config_SetLaneWeight(ctx, HEAVY_LANE_WEIGHT, val, &config.heavy_lane_weight);
+		} else if(!strcasecmp(param, GROUP_COMMIT)) {
+			res = _Config_SetGroupCommit(ctx, val);
+		} else if(!strcasecmp(param, GROUP_COMMIT_MAX_BATCH)) {
+			res = _Config_SetGroupCommitMaxBatch(ctx, val);
+		} else if(!strcasecmp(param, REPLICATE_EFFECTS)) {
+			res = _Config_SetReplicateEffects(ctx, val);
+		} else if(!strcasecmp(param, SLOWLOG_PROFILE_THRESHOLD)) {
+			res = _Config_SetSlowlogProfileThreshold(ctx, val);
+		} else if(!strcasecmp(param, SLOWLOG_PROFILE_SAMPLE_RATE)) {
+			res = _Config_SetSlowlogProfileSampleRate(ctx, val);
 		} else {
 			RedisModule_Log(ctx, "warning", "Encountered unknown module argument '%s'", param);
 			return REDISMODULE_ERR;
@@ -235,3 +388,35 @@ uint64_t Config_GetCacheSize() {
 bool Config_GetAsyncDelete(void) {
 	return config.async_delete;
 }
+
+int Config_GetReadLaneWeight(void) {
+	return config.read_lane_weight;
+}
+
+int Config_GetWriteLaneWeight(void) {
+	return config.write_lane_weight;
+}
+
+int Config_GetHeavyLaneWeight(void) {
+	return config.heavy_lane_weight;
+}
+
+bool Config_GetGroupCommit(void) {
+	return config.group_commit;
+}
+
+uint64_t Config_GetGroupCommitMaxBatch(void) {
+	return config.group_commit_max_batch;
+}
+
+bool Config_GetReplicateEffects(void) {
+	return config.replicate_effects;
+}
+
+uint64_t Config_GetSlowlogProfileThreshold(void) {
+	return config.slowlog_profile_threshold;
+}
+
+uint Config_GetSlowlogProfileSampleRate(void) {
+	return config.slowlog_profile_sample_rate;
+}
@@ -17,6 +17,14 @@ typedef struct {
 	int omp_thread_count;              // Maximum number of OpenMP threads.
 	uint64_t vkey_entity_count;        // The limit of number of entities encoded at once for each RDB key.
 	bool maintain_transposed_matrices; // If true, maintain a transposed version of each relationship matrix.
+	int read_lane_weight;              // Thread pool share of read queries.
+	int write_lane_weight;             // Thread pool share of write queries.
+	int heavy_lane_weight;             // Thread pool share of heavy queries and background work.
+	bool group_commit;                 // If true, concurrent write queries are committed in groups.
+	uint64_t group_commit_max_batch;   // Maximum number of write queries committed as a group.
+	bool replicate_effects;            // If true, write queries are replicated as GRAPH.EFFECT commands.
+	uint64_t slowlog_profile_threshold; // Latency, in ms, above which slowlog entries are profiled.
+	uint slowlog_profile_sample_rate;   // One in how many queries is profiled for the slowlog.
 } RG_Config;
 
 // Set module-level configurations to defaults or to user arguments where provided.
@@ -40,3 +48,27 @@ uint64_t Config_GetCacheSize(void);
 
 // Return true if graph deletion is done asynchronously.
 bool Config_GetAsyncDelete(void);
+
+// Return the thread pool weight of read queries.
+int Config_GetReadLaneWeight(void);
+
+// Return the thread pool weight of write queries.
+int Config_GetWriteLaneWeight(void);
+
+// Return the thread pool weight of heavy queries.
+int Config_GetHeavyLaneWeight(void);
+
+// Return true if concurrent write queries are committed in groups.
+bool Config_GetGroupCommit(void);
+
+// Return the maximum number of write queries committed as a group.
+uint64_t Config_GetGroupCommitMaxBatch(void);
+
+// Return true if write queries are replicated by their effects rather than verbatim.
+bool Config_GetReplicateEffects(void);
+
+// Return the latency, in milliseconds, above which slowlog entries include the query's profile, 0 if disabled.
+uint64_t Config_GetSlowlogProfileThreshold(void);
+
+// Return one in how many queries is profiled for the slowlog.
+uint Config_GetSlowlogProfileSampleRate(void);
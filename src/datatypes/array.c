@@ -12,6 +12,8 @@ SIValue SIArray_New(uint32_t initialCapacity) {
 }
 
 void SIArray_Append(SIValue *siarray, SIValue value) {
+	// ref-counted arrays are immutable
+	assert(!(siarray->allocation & M_SHARED));
 	// clone and persist incase of pointer values
 	SIValue clone = SI_CloneValue(value);
 	// append
@@ -30,11 +32,29 @@ uint32_t SIArray_Length(SIValue siarray) {
 }
 
 SIValue SIArray_Clone(SIValue siarray) {
+	// ref-counted arrays are immutable, add a reference
+	if(siarray.allocation & M_SHARED) {
+		SI_RefRetain(array_hdr(siarray.array));
+		siarray.allocation = M_SHARED;
+		return siarray;
+	}
+
+	// lay out the clone as an arr.h array within a ref-counted allocation
 	uint arrayLen = SIArray_Length(siarray);
-	SIValue newArray = SIArray_New(arrayLen);
+	array_hdr_t *hdr = SI_RefAlloc(sizeof(array_hdr_t) + arrayLen * sizeof(SIValue));
+	hdr->len = arrayLen;
+	hdr->cap = arrayLen;
+	hdr->elem_sz = sizeof(SIValue);
+
+	SIValue *elements = (SIValue *)hdr->buf;
 	for(uint i = 0; i < arrayLen; i++) {
-		SIArray_Append(&newArray, SIArray_Get(siarray, i));
+		elements[i] = SI_CloneValue(siarray.array[i]);
 	}
+
+	SIValue newArray;
+	newArray.array = elements;
+	newArray.type = T_ARRAY;
+	newArray.allocation = M_SHARED;
 	return newArray;
 }
 
@@ -74,14 +94,21 @@ XXH64_hash_t SIArray_HashCode(SIValue siarray) {
 }
 
 void SIArray_Reverse(SIValue siarray) {
+	assert(!(siarray.allocation & M_SHARED));
 	array_reverse(siarray.array);
 }
 
 void SIArray_Free(SIValue siarray) {
+	bool shared = (siarray.allocation & M_SHARED);
+	// release elements only once the last reference is dropped
+	if(shared && !SI_RefRelease(array_hdr(siarray.array))) return;
+
 	uint arrayLen = SIArray_Length(siarray);
 	for(uint i = 0; i < arrayLen; i++) {
 		SIValue value = siarray.array[i];
 		SIValue_Free(value);
 	}
-	array_free(siarray.array);
+
+	if(shared) SI_RefFree(array_hdr(siarray.array));
+	else array_free(siarray.array);
 }
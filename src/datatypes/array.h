@@ -35,8 +35,9 @@ SIValue SIArray_Get(SIValue siarray, u_int32_t index);
 u_int32_t SIArray_Length(SIValue siarray);
 
 /**
-  * @brief  Returns a copy of the array
-  * @note   The caller needs to free the array
+  * @brief  Returns an immutable, ref-counted copy of the array
+  * @note   The caller needs to free the array, cloning a ref-counted array
+  *         only adds a reference
   * @param  siarray:
   * @retval A clone of the given array
   */
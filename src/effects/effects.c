@@ -0,0 +1,702 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "effects.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "rax.h"
+
+#include <string.h>
+#include <limits.h>
+
+#define EFFECTS_VERSION 1
+#define EFFECTS_INITIAL_CAP 256
+
+typedef enum {
+	EFFECT_DECLARE_LABEL = 1,   // Label ID, name.
+	EFFECT_DECLARE_RELATION,    // Relationship type ID, name.
+	EFFECT_DECLARE_ATTRIBUTE,   // Attribute ID, name.
+	EFFECT_CREATE_NODE,         // Node ID, label ID + 1 (0 if unlabeled), properties.
+	EFFECT_CREATE_EDGE,         // Edge ID, source ID, destination ID, relationship type ID, properties.
+	EFFECT_UPDATE,              // Entity type, entity ID, attribute ID, value.
+	EFFECT_DELETE,              // #nodes, node IDs, #edges, (edge ID, source ID, destination ID, relationship type ID).
+} EffectType;
+
+typedef enum {
+	EFFECT_VALUE_NULL,
+	EFFECT_VALUE_FALSE,
+	EFFECT_VALUE_TRUE,
+	EFFECT_VALUE_INT64,         // Zigzag varint.
+	EFFECT_VALUE_DOUBLE,        // 8 bytes.
+	EFFECT_VALUE_STRING,        // Length, bytes.
+	EFFECT_VALUE_ARRAY,         // Length, values.
+} EffectValueType;
+
+struct EffectsBuffer {
+	GraphContext *gc;           // Graph being modified.
+	char *data;                 // Serialized effects.
+	size_t len;                 // Number of bytes used.
+	size_t cap;                 // Number of bytes allocated.
+	uint record_count;          // Number of changes recorded.
+	bool *declared_labels;      // Labels declared so far, indexed by ID.
+	bool *declared_relations;   // Relationship types declared so far, indexed by ID.
+	bool *declared_attributes;  // Attributes declared so far, indexed by ID.
+};
+
+//------------------------------------------------------------------------------
+// Encoding
+//------------------------------------------------------------------------------
+
+static void _Effects_Reserve(EffectsBuffer *eb, size_t n) {
+	if(eb->len + n <= eb->cap) return;
+	while(eb->len + n > eb->cap) eb->cap *= 2;
+	eb->data = rm_realloc(eb->data, eb->cap);
+}
+
+static inline void _Effects_WriteByte(EffectsBuffer *eb, uint8_t b) {
+	_Effects_Reserve(eb, 1);
+	eb->data[eb->len++] = b;
+}
+
+// Unsigned integers are encoded as varints, 7 bits per byte.
+static void _Effects_WriteUnsigned(EffectsBuffer *eb, uint64_t v) {
+	_Effects_Reserve(eb, 10);
+	while(v >= 0x80) {
+		eb->data[eb->len++] = (v & 0x7F) | 0x80;
+		v >>= 7;
+	}
+	eb->data[eb->len++] = v;
+}
+
+static void _Effects_WriteBytes(EffectsBuffer *eb, const char *bytes, size_t n) {
+	_Effects_Reserve(eb, n);
+	memcpy(eb->data + eb->len, bytes, n);
+	eb->len += n;
+}
+
+static void _Effects_WriteString(EffectsBuffer *eb, const char *s) {
+	size_t n = strlen(s);
+	_Effects_WriteUnsigned(eb, n);
+	_Effects_WriteBytes(eb, s, n);
+}
+
+static void _Effects_WriteValue(EffectsBuffer *eb, SIValue v) {
+	switch(SI_TYPE(v)) {
+	case T_NULL:
+		_Effects_WriteByte(eb, EFFECT_VALUE_NULL);
+		return;
+	case T_BOOL:
+		_Effects_WriteByte(eb, v.longval ? EFFECT_VALUE_TRUE : EFFECT_VALUE_FALSE);
+		return;
+	case T_INT64:
+		_Effects_WriteByte(eb, EFFECT_VALUE_INT64);
+		// Zigzag encode, small negative numbers remain short.
+		_Effects_WriteUnsigned(eb, ((uint64_t)v.longval << 1) ^ (uint64_t)(v.longval >> 63));
+		return;
+	case T_DOUBLE:
+		_Effects_WriteByte(eb, EFFECT_VALUE_DOUBLE);
+		_Effects_WriteBytes(eb, (const char *)&v.doubleval, sizeof(double));
+		return;
+	case T_STRING:
+		_Effects_WriteByte(eb, EFFECT_VALUE_STRING);
+		_Effects_WriteString(eb, v.stringval);
+		return;
+	case T_ARRAY: {
+		uint len = SIArray_Length(v);
+		_Effects_WriteByte(eb, EFFECT_VALUE_ARRAY);
+		_Effects_WriteUnsigned(eb, len);
+		for(uint i = 0; i < len; i++) _Effects_WriteValue(eb, SIArray_Get(v, i));
+		return;
+	}
+	default:
+		ASSERT(false && "Attempted to record value of invalid type.");
+	}
+}
+
+// Returns true if id is referenced for the first time, marking it as declared.
+static bool _Effects_Declare(bool **declared, uint id) {
+	while(array_len(*declared) <= id) *declared = array_append(*declared, false);
+	if((*declared)[id]) return false;
+	(*declared)[id] = true;
+	return true;
+}
+
+static void _Effects_DeclareSchema(EffectsBuffer *eb, int id, SchemaType t) {
+	bool **declared = (t == SCHEMA_NODE) ? &eb->declared_labels : &eb->declared_relations;
+	if(!_Effects_Declare(declared, id)) return;
+
+	Schema *s = GraphContext_GetSchemaByID(eb->gc, id, t);
+	_Effects_WriteByte(eb, (t == SCHEMA_NODE) ? EFFECT_DECLARE_LABEL : EFFECT_DECLARE_RELATION);
+	_Effects_WriteUnsigned(eb, id);
+	_Effects_WriteString(eb, Schema_GetName(s));
+}
+
+static void _Effects_DeclareAttribute(EffectsBuffer *eb, Attribute_ID id) {
+	if(!_Effects_Declare(&eb->declared_attributes, id)) return;
+
+	_Effects_WriteByte(eb, EFFECT_DECLARE_ATTRIBUTE);
+	_Effects_WriteUnsigned(eb, id);
+	_Effects_WriteString(eb, GraphContext_GetAttributeString(eb->gc, id));
+}
+
+// Attributes must be declared prior to the record referring to them.
+static void _Effects_DeclareProperties(EffectsBuffer *eb, const Entity *en) {
+	for(int i = 0; i < en->prop_count; i++) _Effects_DeclareAttribute(eb, en->properties[i].id);
+}
+
+static void _Effects_WriteProperties(EffectsBuffer *eb, const Entity *en) {
+	_Effects_WriteUnsigned(eb, en->prop_count);
+	for(int i = 0; i < en->prop_count; i++) {
+		_Effects_WriteUnsigned(eb, en->properties[i].id);
+		_Effects_WriteValue(eb, en->properties[i].value);
+	}
+}
+
+EffectsBuffer *EffectsBuffer_New(GraphContext *gc) {
+	EffectsBuffer *eb = rm_malloc(sizeof(EffectsBuffer));
+	eb->gc = gc;
+	eb->len = 0;
+	eb->cap = EFFECTS_INITIAL_CAP;
+	eb->data = rm_malloc(eb->cap);
+	eb->record_count = 0;
+	eb->declared_labels = array_new(bool, 0);
+	eb->declared_relations = array_new(bool, 0);
+	eb->declared_attributes = array_new(bool, 0);
+	_Effects_WriteByte(eb, EFFECTS_VERSION);
+	return eb;
+}
+
+void EffectsBuffer_AddCreateNode(EffectsBuffer *eb, const Node *n) {
+	const Entity *en = GraphEntity_GetEntity((const GraphEntity *)n);
+	if(en->label != GRAPH_NO_LABEL) _Effects_DeclareSchema(eb, en->label, SCHEMA_NODE);
+	_Effects_DeclareProperties(eb, en);
+
+	_Effects_WriteByte(eb, EFFECT_CREATE_NODE);
+	_Effects_WriteUnsigned(eb, ENTITY_GET_ID(n));
+	_Effects_WriteUnsigned(eb, en->label + 1);
+	_Effects_WriteProperties(eb, en);
+	eb->record_count++;
+}
+
+void EffectsBuffer_AddCreateEdge(EffectsBuffer *eb, const Edge *e) {
+	const Entity *en = GraphEntity_GetEntity((const GraphEntity *)e);
+	_Effects_DeclareSchema(eb, e->relationID, SCHEMA_EDGE);
+	_Effects_DeclareProperties(eb, en);
+
+	_Effects_WriteByte(eb, EFFECT_CREATE_EDGE);
+	_Effects_WriteUnsigned(eb, ENTITY_GET_ID(e));
+	_Effects_WriteUnsigned(eb, e->srcNodeID);
+	_Effects_WriteUnsigned(eb, e->destNodeID);
+	_Effects_WriteUnsigned(eb, e->relationID);
+	_Effects_WriteProperties(eb, en);
+	eb->record_count++;
+}
+
+void EffectsBuffer_AddUpdate(EffectsBuffer *eb, GraphEntityType t, EntityID id,
+							 Attribute_ID attr_id, SIValue value) {
+	_Effects_DeclareAttribute(eb, attr_id);
+
+	_Effects_WriteByte(eb, EFFECT_UPDATE);
+	_Effects_WriteByte(eb, t);
+	_Effects_WriteUnsigned(eb, id);
+	_Effects_WriteUnsigned(eb, attr_id);
+	_Effects_WriteValue(eb, value);
+	eb->record_count++;
+}
+
+void EffectsBuffer_AddDelete(EffectsBuffer *eb, const Node *nodes, uint node_count,
+							 const Edge *edges, uint edge_count) {
+	for(uint i = 0; i < edge_count; i++) {
+		_Effects_DeclareSchema(eb, Edge_GetRelationID(edges + i), SCHEMA_EDGE);
+	}
+
+	_Effects_WriteByte(eb, EFFECT_DELETE);
+	_Effects_WriteUnsigned(eb, node_count);
+	for(uint i = 0; i < node_count; i++) _Effects_WriteUnsigned(eb, ENTITY_GET_ID(nodes + i));
+	_Effects_WriteUnsigned(eb, edge_count);
+	for(uint i = 0; i < edge_count; i++) {
+		const Edge *e = edges + i;
+		_Effects_WriteUnsigned(eb, ENTITY_GET_ID(e));
+		_Effects_WriteUnsigned(eb, Edge_GetSrcNodeID(e));
+		_Effects_WriteUnsigned(eb, Edge_GetDestNodeID(e));
+		_Effects_WriteUnsigned(eb, Edge_GetRelationID(e));
+	}
+	eb->record_count++;
+}
+
+uint EffectsBuffer_RecordCount(const EffectsBuffer *eb) {
+	return eb->record_count;
+}
+
+const char *EffectsBuffer_Data(const EffectsBuffer *eb, size_t *len) {
+	*len = eb->len;
+	return eb->data;
+}
+
+void EffectsBuffer_Free(EffectsBuffer *eb) {
+	array_free(eb->declared_labels);
+	array_free(eb->declared_relations);
+	array_free(eb->declared_attributes);
+	rm_free(eb->data);
+	rm_free(eb);
+}
+
+//------------------------------------------------------------------------------
+// Decoding
+//------------------------------------------------------------------------------
+
+typedef struct {
+	const char *data;           // Serialized effects.
+	size_t len;                 // Number of bytes.
+	size_t pos;                 // Read position.
+	bool error;                 // Read past the end of data.
+} EffectsReader;
+
+// Maps declared IDs to the IDs of the graph effects are applied to.
+typedef struct {
+	int *labels;
+	int *relations;
+	Attribute_ID *attributes;
+} EffectsMapping;
+
+// Marks an entity ID as existing while validating effects, deleted IDs map to NULL.
+#define EFFECTS_ENTITY_EXISTS ((void *)1)
+
+/* Effects are applied in two passes over the buffer, the first validates every
+ * record without modifying the graph, tracking the entities created and deleted
+ * by preceding records, the second applies them. */
+typedef struct {
+	GraphContext *gc;           // Graph effects are applied to.
+	EffectsReader r;            // Effects reader.
+	EffectsMapping m;           // Declared IDs mapping.
+	bool apply;                 // Records are applied, otherwise only validated.
+	rax *nodes;                 // Validation, node IDs created or deleted by preceding records.
+	rax *edges;                 // Validation, edge IDs created or deleted by preceding records.
+	uint64_t node_end;          // Validation, position following the last node slot.
+	uint64_t edge_end;          // Validation, position following the last edge slot.
+} EffectsApplier;
+
+static uint8_t _Effects_ReadByte(EffectsReader *r) {
+	if(r->pos >= r->len) {
+		r->error = true;
+		return 0;
+	}
+	return r->data[r->pos++];
+}
+
+static uint64_t _Effects_ReadUnsigned(EffectsReader *r) {
+	uint64_t v = 0;
+	for(uint shift = 0; shift < 64; shift += 7) {
+		uint8_t b = _Effects_ReadByte(r);
+		v |= (uint64_t)(b & 0x7F) << shift;
+		if(!(b & 0x80)) return v;
+	}
+	r->error = true;
+	return 0;
+}
+
+// Returns a heap allocated, NULL terminated, copy of the next string.
+static char *_Effects_ReadString(EffectsReader *r) {
+	uint64_t n = _Effects_ReadUnsigned(r);
+	if(r->error || n > r->len - r->pos) {
+		r->error = true;
+		return NULL;
+	}
+	char *s = rm_malloc(n + 1);
+	memcpy(s, r->data + r->pos, n);
+	s[n] = '\0';
+	r->pos += n;
+	return s;
+}
+
+static SIValue _Effects_ReadValue(EffectsReader *r) {
+	switch(_Effects_ReadByte(r)) {
+	case EFFECT_VALUE_NULL:
+		return SI_NullVal();
+	case EFFECT_VALUE_FALSE:
+		return SI_BoolVal(false);
+	case EFFECT_VALUE_TRUE:
+		return SI_BoolVal(true);
+	case EFFECT_VALUE_INT64: {
+		uint64_t v = _Effects_ReadUnsigned(r);
+		return SI_LongVal((int64_t)(v >> 1) ^ -(int64_t)(v & 1));
+	}
+	case EFFECT_VALUE_DOUBLE: {
+		double d = 0;
+		if(r->len - r->pos < sizeof(double)) {
+			r->error = true;
+			return SI_NullVal();
+		}
+		memcpy(&d, r->data + r->pos, sizeof(double));
+		r->pos += sizeof(double);
+		return SI_DoubleVal(d);
+	}
+	case EFFECT_VALUE_STRING: {
+		char *s = _Effects_ReadString(r);
+		if(!s) return SI_NullVal();
+		return SI_TransferStringVal(s);
+	}
+	case EFFECT_VALUE_ARRAY: {
+		uint64_t len = _Effects_ReadUnsigned(r);
+		SIValue list = SI_Array(0);
+		for(uint64_t i = 0; i < len && !r->error; i++) {
+			SIValue v = _Effects_ReadValue(r);
+			SIArray_Append(&list, v);
+			SIValue_Free(v);
+		}
+		return list;
+	}
+	default:
+		r->error = true;
+		return SI_NullVal();
+	}
+}
+
+// Graph_GetNode and Graph_GetEdge expect IDs within the datablock's bounds.
+static bool _Effects_GetNode(Graph *g, NodeID id, Node *n) {
+	if(id >= Graph_NodeCount(g) + Graph_DeletedNodeCount(g)) return false;
+	return Graph_GetNode(g, id, n);
+}
+
+static bool _Effects_GetEdge(Graph *g, EdgeID id, Edge *e) {
+	if(id >= Graph_EdgeCount(g) + Graph_DeletedEdgeCount(g)) return false;
+	return Graph_GetEdge(g, id, e);
+}
+
+// Returns true if entity id exists once the records preceding the current one are applied.
+static bool _Effects_Exists(EffectsApplier *a, GraphEntityType t, EntityID id) {
+	rax *ids = (t == GETYPE_NODE) ? a->nodes : a->edges;
+	void *state = raxFind(ids, (unsigned char *)&id, sizeof(id));
+	if(state != raxNotFound) return state == EFFECTS_ENTITY_EXISTS;
+
+	if(t == GETYPE_NODE) {
+		Node n = GE_NEW_NODE();
+		return _Effects_GetNode(a->gc->g, id, &n);
+	}
+	Edge e = {0};
+	return _Effects_GetEdge(a->gc->g, id, &e);
+}
+
+static void _Effects_SetExists(EffectsApplier *a, GraphEntityType t, EntityID id, bool exists) {
+	rax *ids = (t == GETYPE_NODE) ? a->nodes : a->edges;
+	raxInsert(ids, (unsigned char *)&id, sizeof(id), exists ? EFFECTS_ENTITY_EXISTS : NULL, NULL);
+}
+
+// Validates entity id can be created, the same way DataBlock_AllocateItemAt would.
+static bool _Effects_ValidateCreate(EffectsApplier *a, GraphEntityType t, EntityID id) {
+	uint64_t *end = (t == GETYPE_NODE) ? &a->node_end : &a->edge_end;
+	if(id > *end + DATABLOCK_ALLOCATE_AT_SLACK) return false;
+	if(_Effects_Exists(a, t, id)) return false;
+
+	if(id >= *end) *end = id + 1;
+	_Effects_SetExists(a, t, id, true);
+	return true;
+}
+
+static bool _Effects_MapSchema(int *mapping, uint64_t id, int *local_id) {
+	if(id >= array_len(mapping) || mapping[id] == -1) return false;
+	*local_id = mapping[id];
+	return true;
+}
+
+static void _Effects_SetMapping(int **mapping, uint64_t id, int local_id) {
+	while(array_len(*mapping) <= id) *mapping = array_append(*mapping, -1);
+	(*mapping)[id] = local_id;
+}
+
+// Declarations are only mapped to the graph's schemas and attributes once applied.
+static bool _Effects_ReadDeclaration(EffectsApplier *a, EffectType type) {
+	GraphContext *gc = a->gc;
+	EffectsMapping *m = &a->m;
+	uint64_t id = _Effects_ReadUnsigned(&a->r);
+	char *name = _Effects_ReadString(&a->r);
+	if(!name || id > USHRT_MAX) {
+		if(name) rm_free(name);
+		return false;
+	}
+
+	if(type == EFFECT_DECLARE_ATTRIBUTE) {
+		while(array_len(m->attributes) <= id) m->attributes = array_append(m->attributes,
+																			   ATTRIBUTE_NOTFOUND);
+		m->attributes[id] = a->apply ? GraphContext_FindOrAddAttribute(gc, name) : 0;
+	} else {
+		SchemaType t = (type == EFFECT_DECLARE_LABEL) ? SCHEMA_NODE : SCHEMA_EDGE;
+		int local_id = 0;
+		if(a->apply) {
+			Schema *s = GraphContext_GetSchema(gc, name, t);
+			if(!s) s = GraphContext_AddSchema(gc, name, t);
+			local_id = s->id;
+		}
+		_Effects_SetMapping((t == SCHEMA_NODE) ? &m->labels : &m->relations, id, local_id);
+	}
+
+	rm_free(name);
+	return true;
+}
+
+static bool _Effects_MapAttribute(EffectsMapping *m, uint64_t id, Attribute_ID *local_id) {
+	if(id >= array_len(m->attributes) || m->attributes[id] == ATTRIBUTE_NOTFOUND) return false;
+	*local_id = m->attributes[id];
+	return true;
+}
+
+// Reads properties, adding them to ge unless it is NULL.
+static bool _Effects_ReadProperties(EffectsApplier *a, GraphEntity *ge) {
+	EffectsReader *r = &a->r;
+	uint64_t prop_count = _Effects_ReadUnsigned(r);
+	for(uint64_t i = 0; i < prop_count && !r->error; i++) {
+		Attribute_ID attr_id;
+		bool mapped = _Effects_MapAttribute(&a->m, _Effects_ReadUnsigned(r), &attr_id);
+		SIValue v = _Effects_ReadValue(r);
+		if(ge && mapped && !r->error) GraphEntity_AddProperty(ge, attr_id, v);
+		SIValue_Free(v);
+		if(!mapped) return false;
+	}
+	return !r->error;
+}
+
+static void _Effects_UpdateIndices(GraphContext *gc, Node *n) {
+	int label_id = GraphEntity_GetEntity((const GraphEntity *)n)->label;
+	if(label_id == GRAPH_NO_LABEL) return;
+	Schema *s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
+	if(Schema_HasIndices(s)) Schema_AddNodeToIndices(s, n);
+}
+
+static bool _Effects_CreateNode(EffectsApplier *a) {
+	GraphContext *gc = a->gc;
+	EffectsReader *r = &a->r;
+	Node n = GE_NEW_NODE();
+	NodeID id = _Effects_ReadUnsigned(r);
+	uint64_t label = _Effects_ReadUnsigned(r);
+	int label_id = GRAPH_NO_LABEL;
+	if(r->error) return false;
+	if(label != 0 && !_Effects_MapSchema(a->m.labels, label - 1, &label_id)) return false;
+
+	if(!a->apply) {
+		// Node ID must be free and close to the graph's node count.
+		return _Effects_ValidateCreate(a, GETYPE_NODE, id) && _Effects_ReadProperties(a, NULL);
+	}
+
+	if(!Graph_CreateNodeWithID(gc->g, id, label_id, &n)) return false;
+	n.labelID = label_id;
+	if(!_Effects_ReadProperties(a, (GraphEntity *)&n)) return false;
+	_Effects_UpdateIndices(gc, &n);
+	return true;
+}
+
+static bool _Effects_CreateEdge(EffectsApplier *a) {
+	GraphContext *gc = a->gc;
+	EffectsReader *r = &a->r;
+	Node src = GE_NEW_NODE();
+	Node dest = GE_NEW_NODE();
+	Edge e = {0};
+	EdgeID id = _Effects_ReadUnsigned(r);
+	NodeID src_id = _Effects_ReadUnsigned(r);
+	NodeID dest_id = _Effects_ReadUnsigned(r);
+	int relation_id;
+	if(!_Effects_MapSchema(a->m.relations, _Effects_ReadUnsigned(r), &relation_id)) return false;
+	if(r->error) return false;
+
+	if(!a->apply) {
+		// Endpoints must exist, edge ID must be free and close to the graph's edge count.
+		return _Effects_Exists(a, GETYPE_NODE, src_id) && _Effects_Exists(a, GETYPE_NODE, dest_id) &&
+			   _Effects_ValidateCreate(a, GETYPE_EDGE, id) && _Effects_ReadProperties(a, NULL);
+	}
+
+	if(!_Effects_GetNode(gc->g, src_id, &src) || !_Effects_GetNode(gc->g, dest_id, &dest)) {
+		return false;
+	}
+	if(!Graph_ConnectNodesWithID(gc->g, id, src_id, dest_id, relation_id, &e)) return false;
+	return _Effects_ReadProperties(a, (GraphEntity *)&e);
+}
+
+static bool _Effects_Update(EffectsApplier *a) {
+	GraphContext *gc = a->gc;
+	EffectsReader *r = &a->r;
+	Node n = GE_NEW_NODE();
+	Edge e = {0};
+	GraphEntity *ge = NULL;
+	GraphEntityType t = _Effects_ReadByte(r);
+	EntityID id = _Effects_ReadUnsigned(r);
+	Attribute_ID attr_id;
+	bool mapped = _Effects_MapAttribute(&a->m, _Effects_ReadUnsigned(r), &attr_id);
+	SIValue v = _Effects_ReadValue(r);
+	bool found = false;
+
+	if(t != GETYPE_NODE && t != GETYPE_EDGE) {
+		found = false;
+	} else if(!a->apply) {
+		found = _Effects_Exists(a, t, id);
+	} else if(t == GETYPE_NODE) {
+		found = _Effects_GetNode(gc->g, id, &n);
+		ge = (GraphEntity *)&n;
+	} else {
+		found = _Effects_GetEdge(gc->g, id, &e);
+		ge = (GraphEntity *)&e;
+	}
+
+	if(!found || !mapped || r->error || !a->apply) {
+		SIValue_Free(v);
+		return found && mapped && !r->error;
+	}
+
+	/* Same semantics as the update which produced this record,
+	 * NULL removes the property, nothing to remove if it is missing. */
+	if(GraphEntity_GetProperty(ge, attr_id) != PROPERTY_NOTFOUND) {
+		GraphEntity_SetProperty(ge, attr_id, v);
+	} else if(!SIValue_IsNull(v)) {
+		GraphEntity_AddProperty(ge, attr_id, v);
+	}
+	SIValue_Free(v);
+
+	if(t == GETYPE_NODE) _Effects_UpdateIndices(gc, &n);
+	return true;
+}
+
+static bool _Effects_Delete(EffectsApplier *a) {
+	bool res = false;
+	GraphContext *gc = a->gc;
+	EffectsReader *r = &a->r;
+	Graph *g = gc->g;
+	Node *nodes = array_new(Node, 0);
+	Edge *edges = array_new(Edge, 0);
+
+	/* Entities already removed are skipped,
+	 * e.g. a node deleted twice by the same query. */
+	uint64_t node_count = _Effects_ReadUnsigned(r);
+	for(uint64_t i = 0; i < node_count && !r->error; i++) {
+		Node n = GE_NEW_NODE();
+		NodeID id = _Effects_ReadUnsigned(r);
+		if(!a->apply) {
+			if(_Effects_Exists(a, GETYPE_NODE, id)) _Effects_SetExists(a, GETYPE_NODE, id, false);
+		} else if(_Effects_GetNode(g, id, &n)) {
+			nodes = array_append(nodes, n);
+		}
+	}
+
+	uint64_t edge_count = _Effects_ReadUnsigned(r);
+	for(uint64_t i = 0; i < edge_count && !r->error; i++) {
+		Edge e = {0};
+		EdgeID id = _Effects_ReadUnsigned(r);
+		e.srcNodeID = _Effects_ReadUnsigned(r);
+		e.destNodeID = _Effects_ReadUnsigned(r);
+		if(!_Effects_MapSchema(a->m.relations, _Effects_ReadUnsigned(r), &e.relationID)) goto cleanup;
+		if(!a->apply) {
+			if(_Effects_Exists(a, GETYPE_EDGE, id)) _Effects_SetExists(a, GETYPE_EDGE, id, false);
+		} else if(_Effects_GetEdge(g, id, &e)) {
+			edges = array_append(edges, e);
+		}
+	}
+	if(r->error) goto cleanup;
+
+	node_count = array_len(nodes);
+	edge_count = array_len(edges);
+	if(GraphContext_HasIndices(gc)) {
+		for(uint i = 0; i < node_count; i++) GraphContext_DeleteNodeFromIndices(gc, nodes + i);
+	}
+
+	uint node_deleted = 0;
+	uint edge_deleted = 0;
+	if(node_count + edge_count > 0) {
+		Graph_BulkDelete(g, nodes, node_count, edges, edge_count, &node_deleted, &edge_deleted);
+	}
+	// Release memory of fully deleted blocks in the background.
+	if(node_deleted + edge_deleted > 0) GraphContext_ScheduleCompaction(gc);
+	res = true;
+
+cleanup:
+	array_free(nodes);
+	array_free(edges);
+	return res;
+}
+
+// Passes over every record, validating or applying it.
+static bool _Effects_Pass(EffectsApplier *a) {
+	bool res = true;
+	EffectsReader *r = &a->r;
+	// Skip version.
+	r->pos = 1;
+	r->error = false;
+	array_clear(a->m.labels);
+	array_clear(a->m.relations);
+	array_clear(a->m.attributes);
+
+	while(res && r->pos < r->len) {
+		EffectType type = _Effects_ReadByte(r);
+		switch(type) {
+		case EFFECT_DECLARE_LABEL:
+		case EFFECT_DECLARE_RELATION:
+		case EFFECT_DECLARE_ATTRIBUTE:
+			res = _Effects_ReadDeclaration(a, type);
+			break;
+		case EFFECT_CREATE_NODE:
+			res = _Effects_CreateNode(a);
+			break;
+		case EFFECT_CREATE_EDGE:
+			res = _Effects_CreateEdge(a);
+			break;
+		case EFFECT_UPDATE:
+			res = _Effects_Update(a);
+			break;
+		case EFFECT_DELETE:
+			res = _Effects_Delete(a);
+			break;
+		default:
+			res = false;
+		}
+	}
+
+	return res;
+}
+
+bool Effects_Apply(GraphContext *gc, const char *effects, size_t len, const char **err) {
+	Graph *g = gc->g;
+	EffectsApplier a = {
+		.gc = gc,
+		.r = {.data = effects, .len = len, .pos = 0, .error = false},
+		.m = {
+			.labels = array_new(int, 0),
+			.relations = array_new(int, 0),
+			.attributes = array_new(Attribute_ID, 0),
+		},
+		.apply = false,
+		.nodes = raxNew(),
+		.edges = raxNew(),
+		.node_end = Graph_NodeCount(g) + Graph_DeletedNodeCount(g),
+		.edge_end = Graph_EdgeCount(g) + Graph_DeletedEdgeCount(g),
+	};
+
+	bool res = (_Effects_ReadByte(&a.r) == EFFECTS_VERSION);
+	if(!res) {
+		*err = "ERR Unsupported effects version";
+		goto cleanup;
+	}
+
+	// Validate every record before making any change.
+	res = _Effects_Pass(&a);
+	if(!res) {
+		*err = "ERR Effects are malformed or do not match the graph";
+		goto cleanup;
+	}
+
+	// Matrices are resized to capacity as nodes are introduced.
+	MATRIX_POLICY policy = Graph_GetMatrixPolicy(g);
+	Graph_SetMatrixPolicy(g, RESIZE_TO_CAPACITY);
+	a.apply = true;
+	res = _Effects_Pass(&a);
+	Graph_SetMatrixPolicy(g, policy);
+	if(!res) *err = "ERR Effects do not match the graph";
+
+cleanup:
+	raxFree(a.nodes);
+	raxFree(a.edges);
+	array_free(a.m.labels);
+	array_free(a.m.relations);
+	array_free(a.m.attributes);
+	return res;
+}
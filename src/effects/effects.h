@@ -0,0 +1,58 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../graph/graphcontext.h"
+
+/* Effects are the changes a write query introduced to the graph,
+ * serialized as they are committed: created nodes and edges (including their IDs),
+ * property updates and deletions.
+ * Replicas and AOF apply effects through GRAPH.EFFECT rather than re-executing
+ * the query, at a cost proportional to the number of changes.
+ *
+ * Format:
+ * version
+ * (record type, record) X N
+ *
+ * Label, relationship type and attribute IDs are declared by name
+ * the first time they're referenced, on apply they are mapped to
+ * the IDs of the graph the effects are applied to. */
+
+// Changes made by a single write query.
+typedef struct EffectsBuffer EffectsBuffer;
+
+// Create a new, empty, effects buffer for changes made to gc.
+EffectsBuffer *EffectsBuffer_New(GraphContext *gc);
+
+// Record the creation of node n, including its properties.
+void EffectsBuffer_AddCreateNode(EffectsBuffer *eb, const Node *n);
+
+// Record the creation of edge e, including its properties.
+void EffectsBuffer_AddCreateEdge(EffectsBuffer *eb, const Edge *e);
+
+// Record entity's attribute update, a NULL value removes the attribute.
+void EffectsBuffer_AddUpdate(EffectsBuffer *eb, GraphEntityType t, EntityID id,
+							 Attribute_ID attr_id, SIValue value);
+
+// Record a bulk deletion of nodes and edges.
+void EffectsBuffer_AddDelete(EffectsBuffer *eb, const Node *nodes, uint node_count,
+							 const Edge *edges, uint edge_count);
+
+// Returns the number of changes recorded.
+uint EffectsBuffer_RecordCount(const EffectsBuffer *eb);
+
+// Returns the serialized effects.
+const char *EffectsBuffer_Data(const EffectsBuffer *eb, size_t *len);
+
+// Free effects buffer.
+void EffectsBuffer_Free(EffectsBuffer *eb);
+
+// Apply serialized effects to gc, caller is expected to hold the graph's write lock.
+// Returns false and sets err if effects are malformed or do not match the graph,
+// every record is validated before any of them is applied, in which case the
+// graph is left unmodified.
+bool Effects_Apply(GraphContext *gc, const char *effects, size_t len, const char **err);
@@ -441,19 +441,81 @@ int ExecutionPlan_DecRefCount(ExecutionPlan *plan) {
 // Execution plan profiling
 //------------------------------------------------------------------------------
 
-static void _ExecutionPlan_InitProfiling(OpBase *root) {
+// Estimate the number of records op will produce, from the graph's node and edge counts,
+// returns -1 if unknown. Estimates disregard filters and are upper bounds for most operations.
+static int64_t _ExecutionPlan_EstimateRecords(const OpBase *op, const Graph *g) {
+	int64_t children[op->childCount];
+	for(int i = 0; i < op->childCount; i++) {
+		children[i] = op->children[i]->stats->profileEstimatedRecords;
+		if(children[i] < 0) return -1;
+	}
+	int64_t child = (op->childCount > 0) ? children[0] : 1;
+	int64_t node_count = Graph_NodeCount(g);
+	int64_t avg_degree = (node_count > 0) ? ((int64_t)Graph_EdgeCount(g) + node_count - 1) / node_count : 0;
+
+	switch(op->type) {
+	case OPType_ALL_NODE_SCAN:
+		return child * node_count;
+	case OPType_NODE_BY_LABEL_SCAN:
+	case OPType_NODE_BY_LABEL_AND_ID_SCAN: {
+		int label_id = ((const NodeByLabelScan *)op)->n.label_id;
+		return (label_id == GRAPH_UNKNOWN_LABEL) ? 0 : child * Graph_LabeledNodeCount(g, label_id);
+	}
+	case OPType_INDEX_SCAN: {
+		int label_id = ((const IndexScan *)op)->n.label_id;
+		return child * Graph_LabeledNodeCount(g, label_id);
+	}
+	case OPType_NODE_BY_ID_SEEK: {
+		const NodeByIdSeek *seek = (const NodeByIdSeek *)op;
+		int64_t range = (seek->maxId >= seek->minId) ? seek->maxId - seek->minId + 1 : 0;
+		return child * MIN(range, node_count);
+	}
+	case OPType_CONDITIONAL_TRAVERSE:
+	case OPType_CONDITIONAL_VAR_LEN_TRAVERSE:
+		return child * avg_degree;
+	case OPType_LIMIT:
+		return MIN(child, ((const OpLimit *)op)->limit);
+	case OPType_SKIP:
+		return MAX(child - (int64_t)((const OpSkip *)op)->skip, 0);
+	case OPType_AGGREGATE:
+		return (((const OpAggregate *)op)->key_count == 0) ? 1 : child;
+	case OPType_CARTESIAN_PRODUCT:
+	case OPType_APPLY:
+	case OPType_JOIN:
+	case OPType_VALUE_HASH_JOIN: {
+		int64_t product = 1;
+		for(int i = 0; i < op->childCount; i++) product *= children[i];
+		return product;
+	}
+	case OPType_UNWIND:
+	case OPType_PROC_CALL:
+		// Number of records depends on runtime values.
+		return -1;
+	default:
+		// Operations producing at most a record per input record.
+		return child;
+	}
+}
+
+static void _ExecutionPlan_InitProfiling(OpBase *root, const Graph *g, bool track_memory) {
 	root->profile = root->consume;
 	root->consume = OpBase_Profile;
 	root->stats = rm_malloc(sizeof(OpStats));
 	root->stats->profileExecTime = 0;
 	root->stats->profileRecordCount = 0;
+	root->stats->profileRecordsConsumed = 0;
+	root->stats->profileMemory = (track_memory) ? 0 : -1;
+	root->stats->profileThreads = (ThreadBudgetStats) {0};
 
 	if(root->childCount) {
 		for(int i = 0; i < root->childCount; i++) {
 			OpBase *child = root->children[i];
-			_ExecutionPlan_InitProfiling(child);
+			_ExecutionPlan_InitProfiling(child, g, track_memory);
 		}
 	}
+
+	// Children are estimated first, estimates are made prior to execution.
+	root->stats->profileEstimatedRecords = _ExecutionPlan_EstimateRecords(root, g);
 }
 
 static void _ExecutionPlan_FinalizeProfiling(OpBase *root) {
@@ -461,15 +523,23 @@ static void _ExecutionPlan_FinalizeProfiling(OpBase *root) {
 		for(int i = 0; i < root->childCount; i++) {
 			OpBase *child = root->children[i];
 			root->stats->profileExecTime -= child->stats->profileExecTime;
+			root->stats->profileRecordsConsumed += child->stats->profileRecordCount;
+			if(root->stats->profileMemory >= 0) {
+				root->stats->profileMemory -= child->stats->profileMemory;
+				if(root->stats->profileMemory < 0) root->stats->profileMemory = 0;
+			}
 			_ExecutionPlan_FinalizeProfiling(child);
 		}
 	}
 	root->stats->profileExecTime *= 1000;   // Milliseconds.
 }
 
-ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan) {
-	_ExecutionPlan_InitProfiling(plan->root);
+ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan, bool track_memory) {
+	// Track allocations to attribute memory to operations.
+	if(track_memory) track_memory = Alloc_TrackBegin();
+	_ExecutionPlan_InitProfiling(plan->root, QueryCtx_GetGraph(), track_memory);
 	ResultSet *rs = ExecutionPlan_Execute(plan);
+	if(track_memory) Alloc_TrackEnd();
 	_ExecutionPlan_FinalizeProfiling(plan->root);
 	return rs;
 }
@@ -59,6 +59,15 @@ void ExecutionPlan_ReturnRecord(ExecutionPlan *plan, Record r);
 /* Prints execution plan. */
 void ExecutionPlan_Print(const ExecutionPlan *plan, RedisModuleCtx *ctx);
 
+/* Prints execution plan as nested arrays, each operation is a list of name, value pairs:
+ * its description, profiling statistics if gathered and its children. */
+void ExecutionPlan_PrintTree(const ExecutionPlan *plan, RedisModuleCtx *ctx);
+
+/* Returns an array of strings describing the plan's operations, one per operation,
+ * indented by depth, profiling statistics included if gathered.
+ * Caller is responsible for freeing the array and its strings. */
+char **ExecutionPlan_Describe(const ExecutionPlan *plan);
+
 /* Initialize all operations in an ExecutionPlan. */
 void ExecutionPlan_Init(ExecutionPlan *plan);
 
@@ -71,8 +80,9 @@ bool ExecutionPlan_Drained(ExecutionPlan *plan);
 /* Drains execution plan */
 void ExecutionPlan_Drain(ExecutionPlan *plan);
 
-/* Profile executes plan */
-ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan);
+/* Profile executes plan, timing each operation,
+ * track_memory additionally attributes allocations to operations. */
+ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan, bool track_memory);
 
 /* Increase execution plan reference count */
 void ExecutionPlan_IncreaseRefCount(ExecutionPlan *plan);
@@ -7,6 +7,8 @@
 #include "execution_plan.h"
 #include "../RG.h"
 #include "./ops/ops.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
 
 void _ExecutionPlan_Print(const OpBase *op, RedisModuleCtx *ctx, char *buffer, int buffer_len,
 						  int ident, int *op_count) {
@@ -16,9 +18,10 @@ void _ExecutionPlan_Print(const OpBase *op, RedisModuleCtx *ctx, char *buffer, i
 
 	// Construct operation string representation.
 	int bytes_written = snprintf(buffer, buffer_len, "%*s", ident, "");
+	bytes_written = MIN(bytes_written, buffer_len - 1);
 	bytes_written += OpBase_ToString(op, buffer + bytes_written, buffer_len - bytes_written);
 
-	RedisModule_ReplyWithStringBuffer(ctx, buffer, bytes_written);
+	RedisModule_ReplyWithStringBuffer(ctx, buffer, MIN(bytes_written, buffer_len - 1));
 
 	// Recurse over child operations.
 	for(int i = 0; i < op->childCount; i++) {
@@ -40,3 +43,86 @@ void ExecutionPlan_Print(const ExecutionPlan *plan, RedisModuleCtx *ctx) {
 	RedisModule_ReplySetArrayLength(ctx, op_count);
 }
 
+static inline void _ReplyName(RedisModuleCtx *ctx, const char *name) {
+	RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name));
+}
+
+static void _ExecutionPlan_PrintTree(const OpBase *op, RedisModuleCtx *ctx, char *buffer,
+									 int buffer_len) {
+	const OpStats *stats = op->stats;
+	int pairs = (stats) ? 10 : 2;
+	RedisModule_ReplyWithArray(ctx, pairs * 2);
+
+	// Operation string representation, excluding statistics.
+	int bytes_written = (op->toString) ? op->toString(op, buffer, buffer_len) :
+						snprintf(buffer, buffer_len, "%s", op->name);
+	_ReplyName(ctx, "operation");
+	RedisModule_ReplyWithStringBuffer(ctx, buffer, MIN(bytes_written, buffer_len - 1));
+
+	if(stats) {
+		_ReplyName(ctx, "records_produced");
+		RedisModule_ReplyWithLongLong(ctx, stats->profileRecordCount);
+		_ReplyName(ctx, "records_consumed");
+		RedisModule_ReplyWithLongLong(ctx, stats->profileRecordsConsumed);
+		_ReplyName(ctx, "estimated_records");
+		if(stats->profileEstimatedRecords >= 0) {
+			RedisModule_ReplyWithLongLong(ctx, stats->profileEstimatedRecords);
+		} else {
+			RedisModule_ReplyWithNull(ctx);
+		}
+		_ReplyName(ctx, "execution_time_ms");
+		RedisModule_ReplyWithDouble(ctx, stats->profileExecTime);
+		_ReplyName(ctx, "graphblas_time_ms");
+		RedisModule_ReplyWithDouble(ctx, stats->profileThreads.time * 1000);
+		_ReplyName(ctx, "graphblas_operations");
+		RedisModule_ReplyWithLongLong(ctx, stats->profileThreads.calls);
+		_ReplyName(ctx, "graphblas_threads_min");
+		RedisModule_ReplyWithLongLong(ctx, stats->profileThreads.min_threads);
+		_ReplyName(ctx, "graphblas_threads_max");
+		RedisModule_ReplyWithLongLong(ctx, stats->profileThreads.max_threads);
+		_ReplyName(ctx, "memory_bytes");
+		if(stats->profileMemory >= 0) RedisModule_ReplyWithLongLong(ctx, stats->profileMemory);
+		else RedisModule_ReplyWithNull(ctx);
+	}
+
+	// Recurse over child operations.
+	_ReplyName(ctx, "children");
+	RedisModule_ReplyWithArray(ctx, op->childCount);
+	for(int i = 0; i < op->childCount; i++) {
+		_ExecutionPlan_PrintTree(op->children[i], ctx, buffer, buffer_len);
+	}
+}
+
+// Reply with a nested array representation of given execution plan.
+void ExecutionPlan_PrintTree(const ExecutionPlan *plan, RedisModuleCtx *ctx) {
+	ASSERT(plan && ctx);
+
+	char buffer[1024];
+	_ExecutionPlan_PrintTree(plan->root, ctx, buffer, 1024);
+}
+
+static void _ExecutionPlan_Describe(const OpBase *op, char ***lines, char *buffer, int buffer_len,
+									int ident) {
+	if(!op) return;
+
+	// Construct operation string representation.
+	int bytes_written = snprintf(buffer, buffer_len, "%*s", ident, "");
+	OpBase_ToString(op, buffer + bytes_written, buffer_len - bytes_written);
+	array_append(*lines, rm_strdup(buffer));
+
+	// Recurse over child operations.
+	for(int i = 0; i < op->childCount; i++) {
+		_ExecutionPlan_Describe(op->children[i], lines, buffer, buffer_len, ident + 4);
+	}
+}
+
+// Returns the lines ExecutionPlan_Print would reply with.
+char **ExecutionPlan_Describe(const ExecutionPlan *plan) {
+	ASSERT(plan);
+
+	char buffer[1024];
+	char **lines = array_new(char *, 1);
+	_ExecutionPlan_Describe(plan->root, &lines, buffer, 1024, 0);
+	return lines;
+}
+
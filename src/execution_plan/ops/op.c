@@ -9,6 +9,7 @@
 #include "../../util/simple_timer.h"
 
 #include <assert.h>
+#include <inttypes.h>
 
 /* Forward declarations */
 Record ExecutionPlan_BorrowRecord(struct ExecutionPlan *plan);
@@ -93,18 +94,60 @@ void OpBase_PropagateReset(OpBase *op) {
 	for(int i = 0; i < op->childCount; i++) OpBase_PropagateReset(op->children[i]);
 }
 
+// snprintf reports the length of its untruncated output,
+// clamp it to the bytes actually written into a buffer of buff_len bytes.
+#define _OP_CLAMP_WRITTEN(bytes_written, buff_len) MIN((bytes_written), (int)(buff_len) - 1)
+
 static int _OpBase_StatsToString(const OpBase *op, char *buff, uint buff_len) {
-	return snprintf(buff, buff_len,
-					" | Records produced: %d, Execution time: %f ms",
-					op->stats->profileRecordCount,
-					op->stats->profileExecTime);
+	if(buff_len == 0) return 0;
+	int bytes_written = snprintf(buff, buff_len,
+								 " | Records produced: %d, Execution time: %f ms, Records consumed: %d",
+								 op->stats->profileRecordCount,
+								 op->stats->profileExecTime,
+								 op->stats->profileRecordsConsumed);
+	bytes_written = _OP_CLAMP_WRITTEN(bytes_written, buff_len);
+
+	if(op->stats->profileEstimatedRecords >= 0) {
+		bytes_written += snprintf(buff + bytes_written, buff_len - bytes_written,
+								  ", Estimated records: %" PRId64, op->stats->profileEstimatedRecords);
+		bytes_written = _OP_CLAMP_WRITTEN(bytes_written, buff_len);
+	}
+
+	if(op->stats->profileMemory >= 0) {
+		bytes_written += snprintf(buff + bytes_written, buff_len - bytes_written,
+								  ", Memory: %" PRId64 " bytes", op->stats->profileMemory);
+		bytes_written = _OP_CLAMP_WRITTEN(bytes_written, buff_len);
+	}
+
+	// Report time spent within GraphBLAS and threads granted to its operations, if any.
+	const ThreadBudgetStats *threads = &op->stats->profileThreads;
+	if(threads->time > 0) {
+		bytes_written += snprintf(buff + bytes_written, buff_len - bytes_written,
+								  ", GraphBLAS time: %f ms", threads->time * 1000);
+		bytes_written = _OP_CLAMP_WRITTEN(bytes_written, buff_len);
+	}
+	if(threads->calls > 0 && threads->min_threads == threads->max_threads) {
+		bytes_written += snprintf(buff + bytes_written, buff_len - bytes_written,
+								  ", GraphBLAS operations: %u, threads: %d",
+								  threads->calls, threads->max_threads);
+		bytes_written = _OP_CLAMP_WRITTEN(bytes_written, buff_len);
+	} else if(threads->calls > 0) {
+		bytes_written += snprintf(buff + bytes_written, buff_len - bytes_written,
+								  ", GraphBLAS operations: %u, threads: %d-%d",
+								  threads->calls, threads->min_threads, threads->max_threads);
+		bytes_written = _OP_CLAMP_WRITTEN(bytes_written, buff_len);
+	}
+
+	return bytes_written;
 }
 
 int OpBase_ToString(const OpBase *op, char *buff, uint buff_len) {
 	int bytes_written = 0;
+	if(buff_len == 0) return 0;
 
 	if(op->toString) bytes_written = op->toString(op, buff, buff_len);
 	else bytes_written = snprintf(buff, buff_len, "%s", op->name);
+	bytes_written = _OP_CLAMP_WRITTEN(bytes_written, buff_len);
 
 	if(op->stats) {
 		bytes_written += _OpBase_StatsToString(op,
@@ -119,9 +162,14 @@ Record OpBase_Profile(OpBase *op) {
 	double tic [2];
 	// Start timer.
 	simple_tic(tic);
+	// Attribute thread budget decisions to op, children record their own.
+	ThreadBudgetStats *parent_threads = ThreadBudget_SetStats(&op->stats->profileThreads);
+	size_t allocated = Alloc_TrackAllocated();
 	Record r = op->profile(op);
+	ThreadBudget_SetStats(parent_threads);
 	// Stop timer and accumulate.
 	op->stats->profileExecTime += simple_toc(tic);
+	if(op->stats->profileMemory >= 0) op->stats->profileMemory += Alloc_TrackAllocated() - allocated;
 	if(r) op->stats->profileRecordCount++;
 	return r;
 }
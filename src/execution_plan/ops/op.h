@@ -9,6 +9,7 @@
 #include "../record.h"
 #include "../../util/arr.h"
 #include "../../redismodule.h"
+#include "../../util/thread_budget.h"
 #include "../../schema/schema.h"
 #include "../../graph/query_graph.h"
 #include "../../graph/entities/node.h"
@@ -91,7 +92,11 @@ typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpB
 // Execution plan operation statistics.
 typedef struct {
 	int profileRecordCount;     // Number of records generated.
+	int profileRecordsConsumed; // Number of records consumed from child operations.
+	int64_t profileEstimatedRecords; // Estimated number of records generated, -1 if unknown.
 	double profileExecTime;     // Operation total execution time in ms.
+	int64_t profileMemory;      // Bytes allocated by operation, -1 if not tracked.
+	ThreadBudgetStats profileThreads; // GraphBLAS threads granted to operation and time spent within GraphBLAS.
 }  OpStats;
 
 struct OpBase {
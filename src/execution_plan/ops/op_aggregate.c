@@ -13,6 +13,7 @@
 #include "../../arithmetic/aggregate.h"
 
 /* Forward declarations. */
+static OpResult AggregateInit(OpBase *opBase);
 static Record AggregateConsume(OpBase *opBase);
 static OpResult AggregateReset(OpBase *opBase);
 static OpBase *AggregateClone(const ExecutionPlan *plan, const OpBase *opBase);
@@ -79,8 +80,9 @@ static Group *_CreateGroup(OpAggregate *op, Record r) {
 
 static void _ComputeGroupKey(OpAggregate *op, Record r) {
 	for(uint i = 0; i < op->key_count; i++) {
-		AR_ExpNode *exp = op->key_exps[i];
-		op->group_keys[i] = AR_EXP_Evaluate(exp, r);
+		AR_Program *program = (op->key_programs) ? op->key_programs[i] : NULL;
+		if(program) op->group_keys[i] = AR_Program_Evaluate(program, r);
+		else op->group_keys[i] = AR_EXP_Evaluate(op->key_exps[i], r);
 	}
 }
 
@@ -185,6 +187,7 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 	op->group = NULL;
 	op->group_iter = NULL;
 	op->group_keys = NULL;
+	op->key_programs = NULL;
 	op->groups = CacheGroupNew();
 	op->should_cache_records = should_cache_records;
 
@@ -195,7 +198,7 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 	// Allocate memory for group keys if we have any non-aggregate expressions.
 	if(op->key_count) op->group_keys = rm_malloc(op->key_count * sizeof(SIValue));
 
-	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", NULL, AggregateConsume,
+	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", AggregateInit, AggregateConsume,
 				AggregateReset, NULL, AggregateClone, AggregateFree, false, plan);
 
 	// The projected record will associate values with their resolved name
@@ -215,6 +218,27 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 	return (OpBase *)op;
 }
 
+static void _FreeKeyPrograms(OpAggregate *op) {
+	if(!op->key_programs) return;
+	for(uint i = 0; i < op->key_count; i++) AR_Program_Free(op->key_programs[i]);
+	rm_free(op->key_programs);
+	op->key_programs = NULL;
+}
+
+/* Compile key expressions once query parameters are known,
+ * aggregating expressions are cloned per group and remain trees. */
+static OpResult AggregateInit(OpBase *opBase) {
+	OpAggregate *op = (OpAggregate *)opBase;
+	_FreeKeyPrograms(op);
+	if(op->key_count == 0) return OP_OK;
+
+	op->key_programs = rm_malloc(op->key_count * sizeof(AR_Program *));
+	for(uint i = 0; i < op->key_count; i++) {
+		op->key_programs[i] = AR_Program_FromExpression(op->key_exps[i]);
+	}
+	return OP_OK;
+}
+
 static Record AggregateConsume(OpBase *opBase) {
 	OpAggregate *op = (OpAggregate *)opBase;
 	if(op->group_iter) return _handoff(op);
@@ -277,6 +301,8 @@ static void AggregateFree(OpBase *opBase) {
 		op->group_iter = NULL;
 	}
 
+	_FreeKeyPrograms(op);
+
 	if(op->key_exps) {
 		for(uint i = 0; i < op->key_count; i ++) AR_EXP_Free(op->key_exps[i]);
 		array_free(op->key_exps);
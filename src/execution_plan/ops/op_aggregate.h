@@ -11,12 +11,14 @@
 #include "../../redismodule.h"
 #include "../../graph/query_graph.h"
 #include "../../grouping/group_cache.h"
+#include "../../arithmetic/arithmetic_program.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
 typedef struct {
 	OpBase op;
 	uint *record_offsets;               /* Record IDs for key and aggregate exps. */
 	AR_ExpNode **key_exps;              /* Array of expressions used to calculate the group key. */
+	AR_Program **key_programs;          /* Compiled key expressions, NULL entries are evaluated as trees. */
 	AR_ExpNode **aggregate_exps;        /* Array of expressions that aggregate data for each key. */
 	rax *groups;                        /* Map of all groups built by this operation. */
 	Group *group;                       /* Last accessed group. */
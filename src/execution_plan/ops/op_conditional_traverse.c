@@ -6,6 +6,7 @@
 
 #include "op_conditional_traverse.h"
 #include "shared/print_functions.h"
+#include "../../RG.h"
 #include "../../query_ctx.h"
 
 // default number of records to accumulate before traversing
@@ -33,18 +34,82 @@ static void _populate_filter_matrix(OpCondTraverse *op) {
 	}
 }
 
+/* Determine if the traversed edge IDs can be carried into the result matrix,
+ * rather than looked up for every pair of endpoints.
+ * This is the case for a single relation type traversed in a single direction,
+ * where the optimized expression is a flat multiplication of the filter matrix,
+ * label matrices and the relation matrix. */
+static bool _can_carry_edges(const OpCondTraverse *op) {
+	EdgeTraverseCtx *edge_ctx = op->edge_ctx;
+	if(edge_ctx == NULL) return false;
+	if(edge_ctx->direction == GRAPH_EDGE_DIR_BOTH) return false;
+	if(array_len(edge_ctx->edgeRelationTypes) != 1) return false;
+	if(edge_ctx->edgeRelationTypes[0] < 0) return false;
+
+	const AlgebraicExpression *ae = op->ae;
+	if(ae->type != AL_OPERATION || ae->operation.op != AL_EXP_MUL) return false;
+
+	uint relation_count = 0;
+	uint child_count = AlgebraicExpression_ChildCount(ae);
+	// Skip the filter matrix, the left-most operand.
+	for(uint i = 1; i < child_count; i++) {
+		const AlgebraicExpression *child = ae->operation.children[i];
+		if(child->type != AL_OPERAND) return false;
+		if(child->operand.diagonal || child->operand.matrix == IDENTITY_MATRIX) continue;
+
+		// The relation matrix must hold edge IDs.
+		GrB_Type type;
+		GxB_Matrix_type(&type, child->operand.matrix);
+		if(type != GrB_UINT64) return false;
+		relation_count++;
+	}
+
+	return relation_count == 1;
+}
+
+// Extract M's entries, along with their edge IDs if these are carried.
+static void _extract_tuples(OpCondTraverse *op) {
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, op->M);
+	if(nvals > op->tuple_cap) {
+		op->tuple_cap = nvals;
+		op->rows = rm_realloc(op->rows, sizeof(GrB_Index) * nvals);
+		op->cols = rm_realloc(op->cols, sizeof(GrB_Index) * nvals);
+		if(op->carry_edges) op->entries = rm_realloc(op->entries, sizeof(EdgeID) * nvals);
+		if(op->materialize_dest) op->dest_entities = rm_realloc(op->dest_entities, sizeof(Entity *) * nvals);
+	}
+
+	op->tuple_idx = 0;
+	op->tuple_count = nvals;
+	if(nvals == 0) return;
+
+	GrB_Info res;
+	if(op->carry_edges) {
+		res = GrB_Matrix_extractTuples_UINT64(op->rows, op->cols, op->entries, &op->tuple_count, op->M);
+	} else {
+		res = GrB_Matrix_extractTuples_BOOL(op->rows, op->cols, NULL, &op->tuple_count, op->M);
+	}
+	UNUSED(res);
+	ASSERT(res == GrB_SUCCESS);
+
+	/* Fetch all destination entities up front, rather than one at a time
+	 * as records are emitted, such that fetches are prefetched and overlap. */
+	if(op->materialize_dest) {
+		Graph_GetNodesBatch(op->graph, op->cols, op->tuple_count, op->dest_entities);
+	}
+}
+
 /* Evaluate algebraic expression:
  * prepends filter matrix as the left most operand
  * perform multiplications
- * set iterator over result matrix
+ * extract result matrix tuples
  * removed filter matrix from original expression
  * clears filter matrix. */
 void _traverse(OpCondTraverse *op) {
 	// If op->F is null, this is the first time we are traversing.
 	if(op->F == GrB_NULL) {
-		// Create both filter and result matrices.
+		// Create filter matrix.
 		size_t required_dim = Graph_RequiredMatrixDim(op->graph);
-		GrB_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
 		GrB_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
 
 		// Prepend the filter matrix to algebraic expression as the leftmost operand.
@@ -52,16 +117,20 @@ void _traverse(OpCondTraverse *op) {
 
 		// Optimize the expression tree.
 		AlgebraicExpression_Optimize(&op->ae);
+
+		// Create result matrix, holding edge IDs if these can be carried.
+		op->carry_edges = _can_carry_edges(op);
+		GrB_Type type = (op->carry_edges) ? GrB_UINT64 : GrB_BOOL;
+		GrB_Matrix_new(&op->M, type, op->record_cap, required_dim);
 	}
 
 	// Populate filter matrix.
 	_populate_filter_matrix(op);
 
 	// Evaluate expression.
-	AlgebraicExpression_Eval(op->ae, op->M);
-
-	if(op->iter == NULL) GxB_MatrixTupleIter_new(&op->iter, op->M);
-	else GxB_MatrixTupleIter_reuse(op->iter, op->M);
+	if(op->carry_edges) AlgebraicExpression_EvalCarry(op->ae, op->M);
+	else AlgebraicExpression_Eval(op->ae, op->M);
+	_extract_tuples(op);
 
 	// Clear filter matrix.
 	GrB_Matrix_clear(op->F);
@@ -72,7 +141,14 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	op->graph = g;
 	op->ae = ae;
 	op->r = NULL;
-	op->iter = NULL;
+	op->rows = NULL;
+	op->cols = NULL;
+	op->entries = NULL;
+	op->dest_entities = NULL;
+	op->tuple_cap = 0;
+	op->tuple_idx = 0;
+	op->tuple_count = 0;
+	op->carry_edges = false;
 	op->F = GrB_NULL;
 	op->M = GrB_NULL;
 	op->records = NULL;
@@ -94,6 +170,8 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	QGNode *dest_node = QueryGraph_GetNodeByAlias(plan->query_graph, dest);
 	op->dest_label = dest_node->label;
 	op->dest_label_id = dest_node->labelID;
+	// Destination node is only fetched from the graph if its attributes are accessed.
+	op->materialize_dest = AST_AliasRequiresMaterialization(QueryCtx_GetAST(), dest);
 
 	const char *edge = AlgebraicExpression_Edge(ae);
 	if(edge) {
@@ -129,15 +207,14 @@ static Record CondTraverseConsume(OpBase *opBase) {
 	 * Otherwise, try to get a new pair of source and destination nodes. */
 	if(op->edge_ctx && Traverse_SetEdge(op->edge_ctx, op->r)) return OpBase_CloneRecord(op->r);
 
-	bool depleted = true;
-	NodeID src_id = INVALID_ENTITY_ID;
-	NodeID dest_id = INVALID_ENTITY_ID;
+	GrB_Index tuple_idx;
 
 	while(true) {
-		if(op->iter) GxB_MatrixTupleIter_next(op->iter, &src_id, &dest_id, &depleted);
-
 		// Managed to get a tuple, break.
-		if(!depleted) break;
+		if(op->tuple_idx < op->tuple_count) {
+			tuple_idx = op->tuple_idx++;
+			break;
+		}
 
 		/* Run out of tuples, try to get new data.
 		 * Free old records. */
@@ -169,18 +246,25 @@ static Record CondTraverseConsume(OpBase *opBase) {
 	}
 
 	/* Get node from current column. */
-	op->r = op->records[src_id];
+	op->r = op->records[op->rows[tuple_idx]];
 	/* Populate the destination node and add it to the Record.
 	 * Note that if the node's label is unknown, this will correctly
 	 * create an unlabeled node. */
 	Node destNode = GE_NEW_LABELED_NODE(op->dest_label, op->dest_label_id);
-	Graph_GetNode(op->graph, dest_id, &destNode);
+	destNode.id = op->cols[tuple_idx];
+	if(op->materialize_dest) destNode.entity = op->dest_entities[tuple_idx];
 	Record_AddNode(op->r, op->destNodeIdx, destNode);
 
 	if(op->edge_ctx) {
 		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
 		// Collect all appropriate edges connecting the current pair of endpoints.
-		Traverse_CollectEdges(op->edge_ctx, ENTITY_GET_ID(srcNode), ENTITY_GET_ID(&destNode));
+		if(op->carry_edges) {
+			// Edge IDs were carried through the traversal.
+			Traverse_CollectEdgesFromEntry(op->edge_ctx, ENTITY_GET_ID(srcNode),
+										   ENTITY_GET_ID(&destNode), op->entries[tuple_idx]);
+		} else {
+			Traverse_CollectEdges(op->edge_ctx, ENTITY_GET_ID(srcNode), ENTITY_GET_ID(&destNode));
+		}
 		// We're guaranteed to have at least one edge.
 		Traverse_SetEdge(op->edge_ctx, op->r);
 	}
@@ -199,10 +283,8 @@ static OpResult CondTraverseReset(OpBase *ctx) {
 
 	if(op->edge_ctx) Traverse_ResetEdgeCtx(op->edge_ctx);
 
-	if(op->iter) {
-		GxB_MatrixTupleIter_free(op->iter);
-		op->iter = NULL;
-	}
+	op->tuple_idx = 0;
+	op->tuple_count = 0;
 	if(op->F != GrB_NULL) GrB_Matrix_clear(op->F);
 	return OP_OK;
 }
@@ -210,15 +292,30 @@ static OpResult CondTraverseReset(OpBase *ctx) {
 static inline OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	assert(opBase->type == OPType_CONDITIONAL_TRAVERSE);
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
-	return NewCondTraverseOp(plan, QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
+	OpCondTraverse *clone = (OpCondTraverse *)NewCondTraverseOp(plan, QueryCtx_GetGraph(),
+																  AlgebraicExpression_Clone(op->ae));
+	clone->materialize_dest = op->materialize_dest;
+	return (OpBase *)clone;
 }
 
 /* Frees CondTraverse */
 static void CondTraverseFree(OpBase *ctx) {
 	OpCondTraverse *op = (OpCondTraverse *)ctx;
-	if(op->iter) {
-		GxB_MatrixTupleIter_free(op->iter);
-		op->iter = NULL;
+	if(op->rows) {
+		rm_free(op->rows);
+		rm_free(op->cols);
+		op->rows = NULL;
+		op->cols = NULL;
+	}
+
+	if(op->entries) {
+		rm_free(op->entries);
+		op->entries = NULL;
+	}
+
+	if(op->dest_entities) {
+		rm_free(op->dest_entities);
+		op->dest_entities = NULL;
 	}
 
 	if(op->F != GrB_NULL) {
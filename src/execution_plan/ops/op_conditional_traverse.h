@@ -22,9 +22,17 @@ typedef struct {
 	NodeID dest_label_id;       // ID of destination node label if known.
 	const char *dest_label;     // Label of destination node if known.
 	EdgeTraverseCtx *edge_ctx;  // Edge collection data if the edge needs to be set.
-	GxB_MatrixTupleIter *iter;  // Iterator over M.
+	bool carry_edges;           // M holds the traversed edge IDs.
+	GrB_Index *rows;            // Row indices of M's entries.
+	GrB_Index *cols;            // Column indices of M's entries.
+	EdgeID *entries;            // Edge IDs held by M's entries, when carrying edges.
+	Entity **dest_entities;     // Destination node entities, when materializing destination.
+	GrB_Index tuple_count;      // Number of extracted tuples.
+	GrB_Index tuple_cap;        // Capacity of the tuple arrays.
+	GrB_Index tuple_idx;        // Position of the next tuple.
 	int srcNodeIdx;             // Source node index into record.
 	int destNodeIdx;            // Destination node index into record.
+	bool materialize_dest;      // Fetch destination node entity, otherwise only its ID is set.
 	uint record_count;          // Number of held records.
 	uint record_cap;            // Max number of records to process.
 	Record *records;            // Array of records.
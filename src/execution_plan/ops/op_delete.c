@@ -36,6 +36,10 @@ void _DeleteEntities(OpDelete *op) {
 		}
 	}
 
+	EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
+	if(effects) EffectsBuffer_AddDelete(effects, op->deleted_nodes, node_count, op->deleted_edges,
+											edge_count);
+
 	Graph_BulkDelete(g, op->deleted_nodes, node_count, op->deleted_edges,
 					 edge_count, &node_deleted, &relationships_deleted);
 
@@ -44,6 +48,9 @@ void _DeleteEntities(OpDelete *op) {
 		op->stats->relationships_deleted += relationships_deleted;
 	}
 
+	// Release memory of fully deleted blocks in the background.
+	if(node_deleted + relationships_deleted > 0) GraphContext_ScheduleCompaction(op->gc);
+
 cleanup:
 	/* Release lock, no harm in trying to release an unlocked lock. */
 	QueryCtx_UnlockCommit(&op->op);
@@ -7,6 +7,7 @@
 #include "op_filter.h"
 
 /* Forward declarations. */
+static OpResult FilterInit(OpBase *opBase);
 static Record FilterConsume(OpBase *opBase);
 static OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void FilterFree(OpBase *opBase);
@@ -14,14 +15,28 @@ static void FilterFree(OpBase *opBase);
 OpBase *NewFilterOp(const ExecutionPlan *plan, FT_FilterNode *filterTree) {
 	OpFilter *op = rm_malloc(sizeof(OpFilter));
 	op->filterTree = filterTree;
+	op->program = NULL;
 
 	// Set our Op operations
-	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", NULL, FilterConsume,
+	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", FilterInit, FilterConsume,
 				NULL, NULL, FilterClone, FilterFree, false, plan);
 
 	return (OpBase *)op;
 }
 
+/* Compile filter tree once query parameters are known. */
+static OpResult FilterInit(OpBase *opBase) {
+	OpFilter *filter = (OpFilter *)opBase;
+	if(filter->program) AR_Program_Free(filter->program);
+	filter->program = FilterTree_Compile(filter->filterTree);
+	return OP_OK;
+}
+
+static inline int _FilterPass(OpFilter *filter, Record r) {
+	if(filter->program) return AR_Program_Evaluate(filter->program, r).longval;
+	return FilterTree_applyFilters(filter->filterTree, r);
+}
+
 /* FilterConsume next operation
  * returns OP_OK when graph passes filter tree. */
 static Record FilterConsume(OpBase *opBase) {
@@ -34,7 +49,7 @@ static Record FilterConsume(OpBase *opBase) {
 		if(!r) break;
 
 		/* Pass graph through filter tree */
-		if(FilterTree_applyFilters(filter->filterTree, r) == FILTER_PASS) break;
+		if(_FilterPass(filter, r) == FILTER_PASS) break;
 		else OpBase_DeleteRecord(r);
 	}
 
@@ -50,6 +65,11 @@ static inline OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBas
 /* Frees OpFilter*/
 static void FilterFree(OpBase *ctx) {
 	OpFilter *filter = (OpFilter *)ctx;
+	if(filter->program) {
+		AR_Program_Free(filter->program);
+		filter->program = NULL;
+	}
+
 	if(filter->filterTree) {
 		FilterTree_Free(filter->filterTree);
 		filter->filterTree = NULL;
@@ -15,6 +15,7 @@
 typedef struct {
 	OpBase op;
 	FT_FilterNode *filterTree;
+	AR_Program *program;    /* Compiled filter tree, NULL if tree couldn't be compiled. */
 } OpFilter;
 
 /* Creates a new Filter operation */
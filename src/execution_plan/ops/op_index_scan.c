@@ -28,6 +28,8 @@ OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n, RSInd
 	op->iter = NULL;
 	op->child_record = NULL;
 	op->rs_query_node = rs_query_node;
+	op->batch_count = 0;
+	op->batch_idx = 0;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_INDEX_SCAN, "Index Scan", IndexScanInit, IndexScanConsume,
@@ -42,14 +44,43 @@ static OpResult IndexScanInit(OpBase *opBase) {
 	return OP_OK;
 }
 
-static inline void _UpdateRecord(IndexScan *op, Record r, EntityID node_id) {
+static inline void _UpdateRecord(IndexScan *op, Record r, EntityID node_id, Entity *entity) {
 	// Populate the Record with the graph entity data.
 	Node n = GE_NEW_LABELED_NODE(op->n.label, op->n.label_id);
-	assert(Graph_GetNode(op->g, node_id, &n));
+	n.id = node_id;
+	n.entity = entity;
+	assert(n.entity != NULL);
 	// Get a pointer to the node's allocated space within the Record.
 	Record_AddNode(r, op->nodeRecIdx, n);
 }
 
+// Discard buffered index results.
+static inline void _IndexScan_ResetBatch(IndexScan *op) {
+	op->batch_count = 0;
+	op->batch_idx = 0;
+}
+
+/* Retrieves the next index result, index results are consumed and
+ * fetched from the graph in batches, such that entity fetches overlap.
+ * Returns false once the index iterator is depleted. */
+static bool _IndexScan_Next(IndexScan *op, NodeID *node_id, Entity **entity) {
+	if(op->batch_idx == op->batch_count) {
+		_IndexScan_ResetBatch(op);
+		while(op->batch_count < INDEX_SCAN_BATCH_SIZE) {
+			const EntityID *id = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL);
+			if(!id) break;
+			op->batch_ids[op->batch_count++] = *id;
+		}
+		if(op->batch_count == 0) return false;
+		Graph_GetNodesBatch(op->g, op->batch_ids, op->batch_count, op->batch_entities);
+	}
+
+	*node_id = op->batch_ids[op->batch_idx];
+	*entity = op->batch_entities[op->batch_idx];
+	op->batch_idx++;
+	return true;
+}
+
 static Record IndexScanConsumeFromChild(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
@@ -64,11 +95,13 @@ static Record IndexScanConsumeFromChild(OpBase *opBase) {
 	if(op->child_record == NULL) {
 		op->child_record = OpBase_Consume(op->op.children[0]);
 		if(op->child_record == NULL) return NULL;
-		else RediSearch_ResultsIteratorReset(op->iter);
+		RediSearch_ResultsIteratorReset(op->iter);
+		_IndexScan_ResetBatch(op);
 	}
 
-	const EntityID *nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL);
-	if(!nodeId) { // Index scan depleted.
+	NodeID nodeId;
+	Entity *entity;
+	if(!_IndexScan_Next(op, &nodeId, &entity)) { // Index scan depleted.
 		OpBase_DeleteRecord(op->child_record); // Free old record.
 		// Pull a new record from child.
 		op->child_record = OpBase_Consume(op->op.children[0]);
@@ -76,15 +109,15 @@ static Record IndexScanConsumeFromChild(OpBase *opBase) {
 
 		// Reset iterator and evaluate again.
 		RediSearch_ResultsIteratorReset(op->iter);
-		nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL);
-		if(!nodeId) return NULL; // Empty iterator, return immediately.
+		_IndexScan_ResetBatch(op);
+		if(!_IndexScan_Next(op, &nodeId, &entity)) return NULL; // Empty iterator, return immediately.
 	}
 
 	// Clone the held Record, as it will be freed upstream.
 	Record r = OpBase_CloneRecord(op->child_record);
 
 	// Populate the Record with the actual node.
-	_UpdateRecord(op, r, *nodeId);
+	_UpdateRecord(op, r, nodeId, entity);
 
 	return r;
 }
@@ -99,13 +132,14 @@ static Record IndexScanConsume(OpBase *opBase) {
 		op->rs_query_node = NULL;
 	}
 
-	const EntityID *nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL);
-	if(!nodeId) return NULL;
+	NodeID nodeId;
+	Entity *entity;
+	if(!_IndexScan_Next(op, &nodeId, &entity)) return NULL;
 
 	Record r = OpBase_CreateRecord((OpBase *)op);
 
 	// Populate the Record with the actual node.
-	_UpdateRecord(op, r, *nodeId);
+	_UpdateRecord(op, r, nodeId, entity);
 
 	return r;
 }
@@ -113,6 +147,7 @@ static Record IndexScanConsume(OpBase *opBase) {
 static OpResult IndexScanReset(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 	RediSearch_ResultsIteratorReset(op->iter);
+	_IndexScan_ResetBatch(op);
 	return OP_OK;
 }
 
@@ -13,6 +13,9 @@
 #include "shared/scan_functions.h"
 #include "redisearch_api.h"
 
+// Number of index results fetched from the graph at once.
+#define INDEX_SCAN_BATCH_SIZE 64
+
 typedef struct {
 	OpBase op;
 	Graph *g;
@@ -22,6 +25,10 @@ typedef struct {
 	RSQNode *rs_query_node;     /* RediSearch query node used to construct iterator. */
 	RSResultsIterator *iter;    /* RediSearch iterator over an index with the appropriate filters. */
 	Record child_record;        /* The Record this op acts on if it is not a tap. */
+	NodeID batch_ids[INDEX_SCAN_BATCH_SIZE];        /* IDs of buffered index results. */
+	Entity *batch_entities[INDEX_SCAN_BATCH_SIZE];  /* Entities of buffered index results. */
+	uint batch_count;           /* Number of buffered index results. */
+	uint batch_idx;             /* Position of the next buffered index result. */
 } IndexScan;
 
 /* Creates a new IndexScan operation */
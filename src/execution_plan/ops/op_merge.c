@@ -33,7 +33,8 @@ static void _UpdateIndices(GraphContext *gc, Node *n) {
 }
 
 // Update the appropriate property on a graph entity.
-static void _UpdateProperty(Record r, GraphEntity *ge, EntityUpdateEvalCtx *update_ctx) {
+static void _UpdateProperty(Record r, GraphEntity *ge, GraphEntityType t,
+							EntityUpdateEvalCtx *update_ctx, EffectsBuffer *effects) {
 	SIValue new_value = AR_EXP_Evaluate(update_ctx->exp, r);
 
 	// Try to get current property value.
@@ -46,6 +47,9 @@ static void _UpdateProperty(Record r, GraphEntity *ge, EntityUpdateEvalCtx *upda
 		// Update property.
 		GraphEntity_SetProperty(ge, update_ctx->attribute_id, new_value);
 	}
+
+	if(effects) EffectsBuffer_AddUpdate(effects, t, ENTITY_GET_ID(ge), update_ctx->attribute_id,
+										new_value);
 }
 
 // Apply a set of updates to the given records.
@@ -56,6 +60,7 @@ static void _UpdateProperties(ResultSetStatistics *stats, EntityUpdateEvalCtx *u
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	// Lock everything.
 	QueryCtx_LockForCommit();
+	EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
 
 	for(uint i = 0; i < record_count; i ++) {  // For each record to update
 		Record r = records[i];
@@ -67,7 +72,8 @@ static void _UpdateProperties(ResultSetStatistics *stats, EntityUpdateEvalCtx *u
 			assert(t == REC_TYPE_NODE || t == REC_TYPE_EDGE);
 			GraphEntity *ge = Record_GetGraphEntity(r, update_ctx->record_idx);
 
-			_UpdateProperty(r, ge, update_ctx); // Update the entity.
+			GraphEntityType ge_type = (t == REC_TYPE_NODE) ? GETYPE_NODE : GETYPE_EDGE;
+			_UpdateProperty(r, ge, ge_type, update_ctx, effects); // Update the entity.
 			if(t == REC_TYPE_NODE) _UpdateIndices(gc, (Node *)ge); // Update indices if necessary.
 		}
 	}
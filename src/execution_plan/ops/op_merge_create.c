@@ -34,8 +34,9 @@ static void _IncrementalHashEntity(XXH64_state_t *state, const char *label,
 	}
 }
 
-// Revert the most recent set of buffered creations and free any allocations.
-static void _RollbackPendingCreations(OpMergeCreate *op) {
+// Revert the most recent set of buffered creations and free any allocations,
+// property containers allocated since mark are returned to the query's arena.
+static void _RollbackPendingCreations(OpMergeCreate *op, ArenaMark mark) {
 	uint nodes_to_create_count = array_len(op->pending.nodes_to_create);
 	for(uint i = 0; i < nodes_to_create_count; i++) {
 		array_pop(op->pending.created_nodes);
@@ -49,6 +50,8 @@ static void _RollbackPendingCreations(OpMergeCreate *op) {
 		PendingProperties *props = array_pop(op->pending.edge_properties);
 		PendingPropertiesFree(props);
 	}
+
+	Arena_Rewind(QueryCtx_GetArena(), mark);
 }
 
 OpBase *NewMergeCreateOp(const ExecutionPlan *plan, NodeCreateCtx *nodes, EdgeCreateCtx *edges) {
@@ -87,6 +90,8 @@ OpBase *NewMergeCreateOp(const ExecutionPlan *plan, NodeCreateCtx *nodes, EdgeCr
  * has been created in a previous call. */
 static bool _CreateEntities(OpMergeCreate *op, Record r) {
 	assert(XXH64_reset(op->hash_state, 0) != XXH_ERROR); // Reset hash state
+	// Converted properties are allocated from the query's arena, mark where they start.
+	ArenaMark mark = Arena_Mark(QueryCtx_GetArena());
 
 	uint nodes_to_create_count = array_len(op->pending.nodes_to_create);
 	for(uint i = 0; i < nodes_to_create_count; i++) {
@@ -145,16 +150,16 @@ static bool _CreateEntities(OpMergeCreate *op, Record r) {
 		/* Update the hash code with this entity, an edge is represented by its
 		 * relation, properties and nodes.
 		 * Note that unbounded nodes were already presented to the hash.
-		 * Incase node has its internal entity set, this means the node has been retrieved from the graph
+		 * Incase node has its ID set, this means the node has been retrieved from the graph
 		 * i.e. bounded node. */
 		_IncrementalHashEntity(op->hash_state, e->relation, converted_properties);
-		if(src_node->entity != NULL) {
+		if(ENTITY_GET_ID(src_node) != INVALID_ENTITY_ID) {
 			EntityID id = ENTITY_GET_ID(src_node);
 			void *data = &id;
 			size_t len = sizeof(id);
 			assert(XXH64_update(op->hash_state, data, len) != XXH_ERROR);
 		}
-		if(dest_node->entity != NULL) {
+		if(ENTITY_GET_ID(dest_node) != INVALID_ENTITY_ID) {
 			EntityID id = ENTITY_GET_ID(dest_node);
 			void *data = &id;
 			size_t len = sizeof(id);
@@ -174,7 +179,7 @@ static bool _CreateEntities(OpMergeCreate *op, Record r) {
 	bool should_create_entities = raxTryInsert(op->unique_entities, (unsigned char *)&hash,
 											   sizeof(hash), NULL, NULL);
 	// If no entity to be created is unique, roll back all the creations that have just been prepared.
-	if(!should_create_entities) _RollbackPendingCreations(op);
+	if(!should_create_entities) _RollbackPendingCreations(op, mark);
 
 	return should_create_entities;
 }
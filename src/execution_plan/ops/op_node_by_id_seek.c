@@ -42,6 +42,8 @@ OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const char *alias, Unsigned
 	op->maxId = id_range->include_max ? id_range->max : id_range->max - 1;
 
 	op->currentId = op->minId;
+	op->batch_count = 0;
+	op->batch_idx = 0;
 
 	OpBase_Init((OpBase *)op, OPType_NODE_BY_ID_SEEK, "NodeByIdSeek", NodeByIdSeekInit,
 				NodeByIdSeekConsume, NodeByIdSeekReset, NodeByIdSeekToString, NodeByIdSeekClone, NodeByIdSeekFree,
@@ -61,19 +63,34 @@ static OpResult NodeByIdSeekInit(OpBase *opBase) {
 	return OP_OK;
 }
 
+// Fetch the entities of the next batch of IDs within range bounds.
+static inline void _FetchBatch(NodeByIdSeek *op) {
+	op->batch_idx = 0;
+	op->batch_count = 0;
+	while(!_outOfBounds(op) && op->batch_count < NODE_BY_ID_SEEK_BATCH_SIZE) {
+		op->batch_ids[op->batch_count++] = op->currentId++;
+	}
+	Graph_GetNodesBatch(op->g, op->batch_ids, op->batch_count, op->batch_entities);
+}
+
 static inline Node _SeekNextNode(NodeByIdSeek *op) {
 	Node n = GE_NEW_NODE();
 
-	/* As long as we're within range bounds
-	 * and we've yet to get a node. */
-	while(!_outOfBounds(op)) {
-		if(Graph_GetNode(op->g, op->currentId, &n)) break;
-		op->currentId++;
+	// As long as we've yet to get a node.
+	while(true) {
+		if(op->batch_idx == op->batch_count) {
+			_FetchBatch(op);
+			if(op->batch_count == 0) break; // Out of range bounds.
+		}
+
+		uint i = op->batch_idx++;
+		if(op->batch_entities[i] != NULL) {
+			n.id = op->batch_ids[i];
+			n.entity = op->batch_entities[i];
+			break;
+		}
 	}
 
-	// Advance id for next consume call.
-	op->currentId++;
-
 	return n;
 }
 
@@ -127,6 +144,8 @@ static Record NodeByIdSeekConsume(OpBase *opBase) {
 static OpResult NodeByIdSeekReset(OpBase *ctx) {
 	NodeByIdSeek *op = (NodeByIdSeek *)ctx;
 	op->currentId = op->minId;
+	op->batch_count = 0;
+	op->batch_idx = 0;
 	return OP_OK;
 }
 
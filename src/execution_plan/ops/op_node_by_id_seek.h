@@ -13,6 +13,9 @@
 
 #define ID_RANGE_UNBOUND -1
 
+// Number of IDs fetched from the graph at once.
+#define NODE_BY_ID_SEEK_BATCH_SIZE 64
+
 /* Node by ID seek locates an entity by its ID */
 typedef struct {
 	OpBase op;
@@ -23,6 +26,10 @@ typedef struct {
 	NodeID minId;           // Min ID to fetch.
 	NodeID maxId;           // Max ID to fetch.
 	int nodeRecIdx;         // Position of entity within record.
+	uint batch_count;       // Number of IDs in current batch.
+	uint batch_idx;         // Position of the next ID in current batch.
+	NodeID batch_ids[NODE_BY_ID_SEEK_BATCH_SIZE];       // Current batch of IDs.
+	Entity *batch_entities[NODE_BY_ID_SEEK_BATCH_SIZE]; // Entities of current batch, NULL if missing.
 } NodeByIdSeek;
 
 OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const char *alias, UnsignedRange *id_range);
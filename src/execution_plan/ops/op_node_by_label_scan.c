@@ -39,6 +39,7 @@ OpBase *NewNodeByLabelScanOp(const ExecutionPlan *plan, NodeScanCtx n) {
 				NodeByLabelScanFree, false, plan);
 
 	op->nodeRecIdx = OpBase_Modifies((OpBase *)op, n.alias);
+	op->materialize = AST_AliasRequiresMaterialization(QueryCtx_GetAST(), n.alias);
 
 	return (OpBase *)op;
 }
@@ -92,9 +93,11 @@ static OpResult NodeByLabelScanInit(OpBase *opBase) {
 }
 
 static inline void _UpdateRecord(NodeByLabelScan *op, Record r, GrB_Index node_id) {
-	// Populate the Record with the graph entity data.
+	// Populate the Record with the graph entity data,
+	// unless it isn't accessed, in which case it is fetched lazily if at all.
 	Node n = GE_NEW_LABELED_NODE(op->n.label, op->n.label_id);
-	Graph_GetNode(op->g, node_id, &n);
+	if(op->materialize) Graph_GetNode(op->g, node_id, &n);
+	else n.id = node_id;
 	Record_AddNode(r, op->nodeRecIdx, n);
 }
 
@@ -184,6 +187,7 @@ static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opB
 	assert(opBase->type == OPType_NODE_BY_LABEL_SCAN);
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 	OpBase *clone = NewNodeByLabelScanOp(plan, op->n);
+	((NodeByLabelScan *)clone)->materialize = op->materialize;
 	return clone;
 }
 
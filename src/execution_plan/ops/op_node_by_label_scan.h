@@ -21,6 +21,7 @@ typedef struct {
 	Graph *g;
 	NodeScanCtx n;           /* Label data of node being scanned. */
 	unsigned int nodeRecIdx;    /* Node position within record. */
+	bool materialize;           /* Fetch node entity when populating record, otherwise only its ID is set. */
 	UnsignedRange *id_range;    /* ID range to iterate over. */
 	GxB_MatrixTupleIter *iter;
 	Record child_record;        /* The Record this op acts on if it is not a tap. */
@@ -11,6 +11,7 @@
 #include "../../util/rmalloc.h"
 
 /* Forward declarations. */
+static OpResult ProjectInit(OpBase *opBase);
 static Record ProjectConsume(OpBase *opBase);
 static OpBase *ProjectClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ProjectFree(OpBase *opBase);
@@ -18,6 +19,7 @@ static void ProjectFree(OpBase *opBase);
 OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 	OpProject *op = rm_malloc(sizeof(OpProject));
 	op->exps = exps;
+	op->programs = NULL;
 	op->singleResponse = false;
 	op->exp_count = array_len(exps);
 	op->record_offsets = array_new(uint, op->exp_count);
@@ -25,7 +27,7 @@ OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 	op->projection = NULL;
 
 	// Set our Op operations
-	OpBase_Init((OpBase *)op, OPType_PROJECT, "Project", NULL, ProjectConsume,
+	OpBase_Init((OpBase *)op, OPType_PROJECT, "Project", ProjectInit, ProjectConsume,
 				NULL, NULL, ProjectClone, ProjectFree, false, plan);
 
 	for(uint i = 0; i < op->exp_count; i ++) {
@@ -38,6 +40,29 @@ OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 	return (OpBase *)op;
 }
 
+static void _FreePrograms(OpProject *op) {
+	if(!op->programs) return;
+	for(uint i = 0; i < op->exp_count; i++) AR_Program_Free(op->programs[i]);
+	rm_free(op->programs);
+	op->programs = NULL;
+}
+
+/* Compile projected expressions once query parameters are known. */
+static OpResult ProjectInit(OpBase *opBase) {
+	OpProject *op = (OpProject *)opBase;
+	_FreePrograms(op);
+	op->programs = rm_malloc(op->exp_count * sizeof(AR_Program *));
+	for(uint i = 0; i < op->exp_count; i++) {
+		op->programs[i] = AR_Program_FromExpression(op->exps[i]);
+	}
+	return OP_OK;
+}
+
+static inline SIValue _ProjectEvaluate(OpProject *op, uint i) {
+	if(op->programs && op->programs[i]) return AR_Program_Evaluate(op->programs[i], op->r);
+	return AR_EXP_Evaluate(op->exps[i], op->r);
+}
+
 static Record ProjectConsume(OpBase *opBase) {
 	OpProject *op = (OpProject *)opBase;
 
@@ -56,8 +81,7 @@ static Record ProjectConsume(OpBase *opBase) {
 	op->projection = OpBase_CreateRecord(opBase);
 
 	for(uint i = 0; i < op->exp_count; i++) {
-		AR_ExpNode *exp = op->exps[i];
-		SIValue v = AR_EXP_Evaluate(exp, op->r);
+		SIValue v = _ProjectEvaluate(op, i);
 		int rec_idx = op->record_offsets[i];
 		/* Persisting a value is only necessary here if 'v' refers to a scalar held in Record 'r'.
 		 * Graph entities don't need to be persisted here as Record_Add will copy them internally.
@@ -92,6 +116,8 @@ static OpBase *ProjectClone(const ExecutionPlan *plan, const OpBase *opBase) {
 static void ProjectFree(OpBase *ctx) {
 	OpProject *op = (OpProject *)ctx;
 
+	_FreePrograms(op);
+
 	if(op->exps) {
 		for(uint i = 0; i < op->exp_count; i ++) AR_EXP_Free(op->exps[i]);
 		array_free(op->exps);
@@ -8,6 +8,7 @@
 
 #include "op.h"
 #include "../execution_plan.h"
+#include "../../arithmetic/arithmetic_program.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
 typedef struct {
@@ -15,6 +16,7 @@ typedef struct {
 	Record r;                       // Input Record being read from (stored to free if we encounter an error).
 	Record projection;              // Record projected by this operation (stored to free if we encounter an error).
 	AR_ExpNode **exps;              // Projected expressions (including order exps).
+	AR_Program **programs;          // Compiled expressions, NULL entries are evaluated as trees.
 	uint *record_offsets;           // Record IDs corresponding to each projection (including order exps).
 	bool singleResponse;            // When no child operations, return NULL after a first response.
 	uint exp_count;                 // Number of projected expressions.
@@ -19,7 +19,7 @@ static OpResult UpdateReset(OpBase *opBase);
 static OpBase *UpdateClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void UpdateFree(OpBase *opBase);
 
-static int _UpdateEntity(GraphEntity *ge, PendingUpdateCtx *update) {
+static int _UpdateEntity(GraphEntity *ge, PendingUpdateCtx *update, EffectsBuffer *effects) {
 	int res = 1;
 	SIValue new_value = update->new_value;
 	Attribute_ID attr_id = update->attr_id;
@@ -39,6 +39,9 @@ static int _UpdateEntity(GraphEntity *ge, PendingUpdateCtx *update) {
 		GraphEntity_SetProperty(ge, attr_id, new_value);
 	}
 
+	if(effects) EffectsBuffer_AddUpdate(effects, update->entity_type, ENTITY_GET_ID(ge), attr_id,
+										new_value);
+
 cleanup:
 	SIValue_Free(new_value);
 	return res;
@@ -58,10 +61,11 @@ static int _UpdateEdge(OpUpdate *op, PendingUpdateCtx *updates,
 	 * hold our entity. */
 	int attributes_set = 0;
 	GraphEntity *ge = (GraphEntity *)&updates->e;
+	EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
 
 	for(uint i = 0; i < update_count; i++) {
 		PendingUpdateCtx *update = updates + i;
-		attributes_set += _UpdateEntity(ge, update);
+		attributes_set += _UpdateEntity(ge, update, effects);
 	}
 
 	return attributes_set;
@@ -84,10 +88,11 @@ static int _UpdateNode(OpUpdate *op, PendingUpdateCtx *updates,
 	bool update_index = false;
 	Node *node = &updates->n;
 	GraphEntity *ge = (GraphEntity *)node;
+	EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
 
 	for(uint i = 0; i < update_count; i++) {
 		PendingUpdateCtx *update = updates + i;
-		attributes_set += _UpdateEntity(ge, update);
+		attributes_set += _UpdateEntity(ge, update, effects);
 		// Do we need to update an index for this property?
 		update_index |= update->update_index;
 	}
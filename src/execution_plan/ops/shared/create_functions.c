@@ -42,6 +42,7 @@ static void _CommitNodes(PendingCreations *pending) {
 
 	uint node_count = array_len(pending->created_nodes);
 	Graph_AllocateNodes(g, node_count);
+	EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
 
 	for(uint i = 0; i < node_count; i++) {
 		n = pending->created_nodes[i];
@@ -63,6 +64,8 @@ static void _CommitNodes(PendingCreations *pending) {
 														   pending->node_properties[i]);
 
 		if(s && Schema_HasIndices(s)) Schema_AddNodeToIndices(s, n);
+
+		if(effects) EffectsBuffer_AddCreateNode(effects, n);
 	}
 }
 
@@ -89,6 +92,7 @@ static void _CommitEdges(PendingCreations *pending) {
 
 	uint edge_count = array_len(pending->created_edges);
 	Graph_AllocateEdges(g, edge_count);
+	EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
 
 	for(uint i = 0; i < edge_count; i++) {
 		e = pending->created_edges[i];
@@ -112,6 +116,8 @@ static void _CommitEdges(PendingCreations *pending) {
 
 		if(pending->edge_properties[i]) _AddProperties(pending->stats, (GraphEntity *)e,
 														   pending->edge_properties[i]);
+
+		if(effects) EffectsBuffer_AddCreateEdge(effects, e);
 	}
 }
 
@@ -155,11 +161,12 @@ void CommitNewEntities(OpBase *op, PendingCreations *pending) {
 }
 
 // Resolve the properties specified in the query into constant values.
+// Containers are allocated from the query's arena, committed values are cloned into the graph.
 PendingProperties *ConvertPropertyMap(Record r, const PropertyMap *map) {
-	PendingProperties *converted = rm_malloc(sizeof(PendingProperties));
+	PendingProperties *converted = rm_query_malloc(sizeof(PendingProperties));
 	converted->property_count = map->property_count;
 	converted->attr_keys = map->keys; // This pointer can be copied directly.
-	converted->values = rm_malloc(sizeof(SIValue) * map->property_count);
+	converted->values = rm_query_malloc(sizeof(SIValue) * map->property_count);
 	for(int i = 0; i < map->property_count; i++) {
 		converted->values[i] = AR_EXP_Evaluate(map->values[i], r);
 	}
@@ -174,8 +181,7 @@ void PendingPropertiesFree(PendingProperties *props) {
 	for(uint j = 0; j < props->property_count; j ++) {
 		SIValue_Free(props->values[j]);
 	}
-	rm_free(props->values);
-	rm_free(props);
+	// Containers are released along with the query's arena.
 }
 
 // Free all data associated with a completed create operation.
@@ -76,6 +76,21 @@ void Traverse_CollectEdges(EdgeTraverseCtx *edge_ctx, NodeID src, NodeID dest) {
 	}
 }
 
+void Traverse_CollectEdgesFromEntry(EdgeTraverseCtx *edge_ctx, NodeID src, NodeID dest,
+									EdgeID entry) {
+	assert(array_len(edge_ctx->edgeRelationTypes) == 1 &&
+		   edge_ctx->direction != GRAPH_EDGE_DIR_BOTH);
+
+	Graph *g = QueryCtx_GetGraph();
+	int r = edge_ctx->edgeRelationTypes[0];
+	// If we're traversing incoming edges, swap the source and destination.
+	if(edge_ctx->direction == GRAPH_EDGE_DIR_INCOMING) {
+		Graph_GetEdgesFromEntry(g, dest, src, r, entry, &edge_ctx->edges);
+	} else {
+		Graph_GetEdgesFromEntry(g, src, dest, r, entry, &edge_ctx->edges);
+	}
+}
+
 bool Traverse_SetEdge(EdgeTraverseCtx *edge_ctx, Record r) {
 	// Return false if all edges have been consumed.
 	if(!array_len(edge_ctx->edges)) return false;
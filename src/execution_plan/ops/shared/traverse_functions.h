@@ -24,6 +24,11 @@ EdgeTraverseCtx *Traverse_NewEdgeCtx(AlgebraicExpression *ae, QGEdge *e, int idx
 // Collect all appropriate edges between the given endpoints.
 void Traverse_CollectEdges(EdgeTraverseCtx *edge_ctx, NodeID src, NodeID dest);
 
+/* Collect edges held by a relation matrix entry connecting the given endpoints,
+ * edge_ctx is expected to traverse a single relation type in a single direction. */
+void Traverse_CollectEdgesFromEntry(EdgeTraverseCtx *edge_ctx, NodeID src, NodeID dest,
+									EdgeID entry);
+
 // Remove a matching edge from the edges array if one is available and set it in the Record.
 bool Traverse_SetEdge(EdgeTraverseCtx *edge_ctx, Record r);
 
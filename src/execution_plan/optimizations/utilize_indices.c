@@ -372,9 +372,17 @@ cleanup:
 	return res;
 }
 
+static bool _containsFilter(OpFilter **filters, const OpFilter *filter) {
+	uint filters_count = array_len(filters);
+	for(uint i = 0; i < filters_count; i++) {
+		if(filters[i] == filter) return true;
+	}
+	return false;
+}
+
 /* Returns an array of filter operation which can be
- * reduced into a single index scan operation. */
-OpFilter **_applicableFilters(NodeByLabelScan *scanOp, Index *idx) {
+ * reduced into a single index scan operation, skipping filters in exclude. */
+OpFilter **_applicableFilters(NodeByLabelScan *scanOp, Index *idx, OpFilter **exclude) {
 	OpFilter **filters = array_new(OpFilter *, 0);
 
 	/* We begin with a LabelScan, and want to find predicate filters that modify
@@ -383,7 +391,7 @@ OpFilter **_applicableFilters(NodeByLabelScan *scanOp, Index *idx) {
 	while(current->type == OPType_FILTER) {
 		OpFilter *filter = (OpFilter *)current;
 
-		if(_applicableFilter(idx, &filter->filterTree)) {
+		if(!_containsFilter(exclude, filter) && _applicableFilter(idx, &filter->filterTree)) {
 			// Make sure all predicates are of type n.v = CONST.
 			filters = array_append(filters, filter);
 		}
@@ -431,6 +439,176 @@ void _predicateTreeToRange(const FT_FilterNode *tree, rax *string_ranges, rax *n
 	}
 }
 
+//------------------------------------------------------------------------------
+// Composite keys
+//------------------------------------------------------------------------------
+
+/* Checks to see if filter is a single predicate a composite key can resolve,
+ * e.g. n.v > 1, normalizing it if so. */
+static bool _compositeKeyFilter(FT_FilterNode **filter) {
+	FT_FilterNode *filter_tree = *filter;
+	if(filter_tree->t != FT_N_PRED || filter_tree->pred.op == OP_NEQUAL) return false;
+	if(!_simple_predicates(filter_tree)) return false;
+
+	_normalize_filter(filter);
+	return true;
+}
+
+static inline bool _isPointRange(const NumericRange *nr, const StringRange *sr) {
+	if(nr) return nr->include_min && nr->include_max && nr->min == nr->max;
+	return sr->include_min && sr->include_max && sr->min && sr->max && strcmp(sr->min, sr->max) == 0;
+}
+
+/* Returns the number of leading key properties resolved by the filtered ranges,
+ * an equality prefix optionally followed by a single range. */
+static uint _compositeKeyCoverage(const CompositeKey *key, rax *string_ranges, rax *numeric_ranges) {
+	for(uint i = 0; i < key->fields_count; i++) {
+		const char *field = key->fields[i];
+		size_t len = strlen(field);
+		NumericRange *nr = raxFind(numeric_ranges, (unsigned char *)field, len);
+		StringRange *sr = raxFind(string_ranges, (unsigned char *)field, len);
+		nr = (nr == raxNotFound) ? NULL : nr;
+		sr = (sr == raxNotFound) ? NULL : sr;
+
+		/* Property isn't filtered, or bound to both numeric and string values
+		 * or to an empty range, in which case leave it to the filter. */
+		if((nr == NULL) == (sr == NULL)) return i;
+		if(nr && !NumericRange_IsValid(nr)) return i;
+		if(sr && !StringRange_IsValid(sr)) return i;
+
+		// Range suffix, the following properties aren't ordered within the range.
+		if(!_isPointRange(nr, sr)) return i + 1;
+	}
+	return key->fields_count;
+}
+
+/* Create a RediSearch query node out of the ranges over the key's leading
+ * coverage properties, a single lexicographic range over the key. */
+static RSQNode *_compositeKeyToQueryNode(RSIndex *idx, const CompositeKey *key, uint coverage,
+										 rax *string_ranges, rax *numeric_ranges) {
+	char *min = array_new(char, 64);
+	char *max = NULL;
+	bool include_max = true;
+
+	for(uint i = 0; i < coverage; i++) {
+		const char *field = key->fields[i];
+		size_t len = strlen(field);
+		NumericRange *nr = raxFind(numeric_ranges, (unsigned char *)field, len);
+		StringRange *sr = raxFind(string_ranges, (unsigned char *)field, len);
+		nr = (nr == raxNotFound) ? NULL : nr;
+
+		SIValue lower;
+		SIValue upper;
+		bool lower_bound;
+		bool upper_bound;
+		bool include_min;
+		char type;
+		if(nr) {
+			type = COMPOSITE_KEY_NUMERIC;
+			lower = SI_DoubleVal(nr->min);
+			upper = SI_DoubleVal(nr->max);
+			lower_bound = (nr->min != -INFINITY);
+			upper_bound = (nr->max != INFINITY);
+			include_min = nr->include_min;
+			include_max = nr->include_max;
+		} else {
+			type = COMPOSITE_KEY_STRING;
+			lower = SI_ConstStringVal(sr->min);
+			upper = SI_ConstStringVal(sr->max);
+			lower_bound = (sr->min != NULL);
+			upper_bound = (sr->max != NULL);
+			include_min = sr->include_min;
+			include_max = sr->include_max;
+		}
+
+		// Equality prefix.
+		if(i + 1 < coverage) {
+			CompositeKey_AppendValue(&min, lower);
+			continue;
+		}
+
+		// Last covered property, both bounds share the prefix.
+		max = array_new(char, array_len(min) + 32);
+		for(uint j = 0; j < array_len(min); j++) max = array_append(max, min[j]);
+		CompositeKey_AppendLowerBound(&min, type, lower_bound ? &lower : NULL, include_min);
+		include_max = CompositeKey_AppendUpperBound(&max, type, upper_bound ? &upper : NULL,
+													include_max);
+	}
+
+	min = array_append(min, '\0');
+	max = array_append(max, '\0');
+
+	RSQNode *root = RediSearch_CreateTagNode(idx, key->name);
+	RSQNode *child = RediSearch_CreateLexRangeNode(idx, key->name, min, max, true, include_max);
+	RediSearch_QueryNodeAddChild(root, child);
+
+	array_free(min);
+	array_free(max);
+	return root;
+}
+
+/* Reduce filters into a single RediSearch query node over the composite key
+ * resolving the greatest number of filtered properties.
+ * Filters resolved by the key are added to consumed. */
+static RSQNode *_compositeKeysToQueryNode(NodeByLabelScan *scan, Index *idx, OpFilter ***consumed) {
+	uint composites_count = Index_CompositeKeysCount(idx);
+	if(composites_count == 0) return NULL;
+
+	RSQNode *root = NULL;
+	OpFilter **candidates = array_new(OpFilter *, 0);
+	rax *string_ranges = raxNew();
+	rax *numeric_ranges = raxNew();
+
+	// Collect single predicate filters, reduced into ranges.
+	OpBase *current = scan->op.parent;
+	while(current->type == OPType_FILTER) {
+		OpFilter *filter = (OpFilter *)current;
+		if(_compositeKeyFilter(&filter->filterTree)) {
+			candidates = array_append(candidates, filter);
+			_predicateTreeToRange(filter->filterTree, string_ranges, numeric_ranges);
+		}
+		current = current->parent;
+	}
+
+	// Pick the key covering the greatest number of properties.
+	uint coverage = 0;
+	const CompositeKey *key = NULL;
+	const CompositeKey **composites = Index_GetCompositeKeys(idx);
+	for(uint i = 0; i < composites_count; i++) {
+		uint c = _compositeKeyCoverage(composites[i], string_ranges, numeric_ranges);
+		if(c > coverage) {
+			coverage = c;
+			key = composites[i];
+		}
+	}
+
+	// A single property is served just as well by its own index.
+	if(coverage == 0 || (coverage == 1 && Index_ContainsAttribute(idx, key->fields_ids[0]))) {
+		goto cleanup;
+	}
+
+	root = _compositeKeyToQueryNode(idx->idx, key, coverage, string_ranges, numeric_ranges);
+
+	// Filters over covered properties are resolved by the key.
+	uint candidates_count = array_len(candidates);
+	for(uint i = 0; i < candidates_count; i++) {
+		char *field;
+		AR_EXP_IsAttribute(candidates[i]->filterTree->pred.lhs, &field);
+		for(uint j = 0; j < coverage; j++) {
+			if(strcmp(field, key->fields[j]) == 0) {
+				*consumed = array_append(*consumed, candidates[i]);
+				break;
+			}
+		}
+	}
+
+cleanup:
+	raxFreeWithCallback(string_ranges, (void(*)(void *))StringRange_Free);
+	raxFreeWithCallback(numeric_ranges, (void(*)(void *))NumericRange_Free);
+	array_free(candidates);
+	return root;
+}
+
 /* Try to replace given Label Scan operation and a set of Filter operations with
  * a single Index Scan operation. */
 void reduce_scan_op(ExecutionPlan *plan, NodeByLabelScan *scan) {
@@ -444,20 +622,28 @@ void reduce_scan_op(ExecutionPlan *plan, NodeByLabelScan *scan) {
 	const char *label = scan->n.label;
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Index *idx = GraphContext_GetIndex(gc, label, NULL, IDX_EXACT_MATCH);
-	if(idx == NULL) return;
+	// Index is still being populated.
+	if(idx == NULL || !Index_IsOnline(idx)) return;
 
-	// Get all applicable filter for index.
 	RSIndex *rs_idx = idx->idx;
-	OpFilter **filters = _applicableFilters(scan, idx);
+	/* Composite keys first, resolving predicates over several properties
+	 * with a single range lookup. */
+	OpFilter **composite_filters = array_new(OpFilter *, 0);
+	RSQNode *composite_root = _compositeKeysToQueryNode(scan, idx, &composite_filters);
+
+	// Get all remaining applicable filter for index.
+	OpFilter **filters = _applicableFilters(scan, idx, composite_filters);
 
 	// No filters, return.
 	uint filters_count = array_len(filters);
-	if(filters_count == 0) goto cleanup;
+	if(filters_count == 0 && composite_root == NULL) goto cleanup;
 
 	/* Reduce filters into ranges.
 	* we differentiate between between numeric filters
 	* and string filters. */
 	rsqnodes = array_new(RSQNode *, 1);
+	// Composite key results are intersected with those of the remaining filters.
+	if(composite_root) rsqnodes = array_append(rsqnodes, composite_root);
 
 	string_ranges = raxNew();
 	numeric_ranges = raxNew();
@@ -575,6 +761,14 @@ cleanup:
 		OpBase_Free((OpBase *)filter);
 	}
 	array_free(filters);
+
+	uint composite_filters_count = array_len(composite_filters);
+	for(uint i = 0; i < composite_filters_count; i++) {
+		OpFilter *filter = composite_filters[i];
+		ExecutionPlan_RemoveOp(plan, (OpBase *)filter);
+		OpBase_Free((OpBase *)filter);
+	}
+	array_free(composite_filters);
 }
 
 void utilizeIndices(ExecutionPlan *plan) {
@@ -231,6 +231,52 @@ int FilterTree_applyFilters(const FT_FilterNode *root, const Record r) {
 	return 0;
 }
 
+// Emits instructions setting 'dst' to the outcome of filter node.
+static bool _FilterTree_Emit(const FT_FilterNode *node, AR_Program *p, uint dst) {
+	switch(node->t) {
+	case FT_N_COND: {
+		if(node->cond.op != OP_AND && node->cond.op != OP_OR) return false;
+		if(!_FilterTree_Emit(LeftChild(node), p, dst)) return false;
+
+		// Short-circuit, skip right subtree once the outcome is known.
+		uint jump = AR_Program_EmitJump(p, dst, node->cond.op == OP_OR);
+		uint scope = AR_Program_ScopeBegin(p);
+		if(!_FilterTree_Emit(RightChild(node), p, dst)) return false;
+		AR_Program_ScopeEnd(p, scope);
+		AR_Program_PatchJump(p, jump);
+		return true;
+	}
+	case FT_N_PRED: {
+		uint lhs = AR_Program_EmitExpression(p, node->pred.lhs);
+		if(lhs == AR_PROGRAM_INVALID_REG) return false;
+		uint rhs = AR_Program_EmitExpression(p, node->pred.rhs);
+		if(rhs == AR_PROGRAM_INVALID_REG) return false;
+		AR_Program_EmitCompare(p, node->pred.op, lhs, rhs, dst);
+		return true;
+	}
+	case FT_N_EXP: {
+		uint src = AR_Program_EmitExpression(p, node->exp.exp);
+		if(src == AR_PROGRAM_INVALID_REG) return false;
+		AR_Program_EmitTruthy(p, src, dst);
+		return true;
+	}
+	default:
+		assert(false);
+		return false;
+	}
+}
+
+AR_Program *FilterTree_Compile(const FT_FilterNode *root) {
+	AR_Program *p = AR_Program_New();
+	uint dst = AR_Program_NewRegister(p);
+	if(!_FilterTree_Emit(root, p, dst)) {
+		AR_Program_Free(p);
+		return NULL;
+	}
+	AR_Program_SetResult(p, dst);
+	return p;
+}
+
 void _FilterTree_CollectModified(const FT_FilterNode *root, rax *modified) {
 	if(root == NULL) return;
 
@@ -11,6 +11,7 @@
 #include "rax.h"
 #include "../execution_plan/record.h"
 #include "../arithmetic/arithmetic_expression.h"
+#include "../arithmetic/arithmetic_program.h"
 
 #define FILTER_FAIL 0
 #define FILTER_PASS 1
@@ -84,6 +85,10 @@ FT_FilterNode *FilterTree_CreateConditionFilter(AST_Operator op);
 /* Runs val through the filter tree. */
 int FilterTree_applyFilters(const FT_FilterNode *root, const Record r);
 
+/* Compiles filter tree into an arithmetic program evaluating to a boolean,
+ * returns NULL if the tree can't be compiled. */
+AR_Program *FilterTree_Compile(const FT_FilterNode *root);
+
 /* Extract every modified record ID mentioned in the tree
  * without duplications. */
 rax *FilterTree_CollectModified(const FT_FilterNode *root);
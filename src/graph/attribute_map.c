@@ -0,0 +1,141 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "attribute_map.h"
+#include "../RG.h"
+#include "xxhash.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+#include <string.h>
+
+static inline uint _AttributeMap_Hash(const char *name) {
+	return (uint)XXH64(name, strlen(name), 0);
+}
+
+static AttributeMapTable *_AttributeMapTable_New(uint cap) {
+	// Keep load factor below 0.5
+	uint bucket_count = 16;
+	while(bucket_count < cap * 2) bucket_count <<= 1;
+
+	AttributeMapTable *table = rm_malloc(sizeof(AttributeMapTable));
+	table->count = 0;
+	table->cap = cap;
+	table->mask = bucket_count - 1;
+	table->names = rm_malloc(sizeof(char *) * cap);
+	table->buckets = rm_calloc(bucket_count, sizeof(uint));
+	return table;
+}
+
+static void _AttributeMapTable_Free(AttributeMapTable *table) {
+	rm_free(table->names);
+	rm_free(table->buckets);
+	rm_free(table);
+}
+
+// Place attribute ID within table's buckets, visible to readers once stored.
+static void _AttributeMapTable_Index(AttributeMapTable *table, const char *name, uint id) {
+	uint i = _AttributeMap_Hash(name) & table->mask;
+	while(table->buckets[i] != 0) i = (i + 1) & table->mask;
+	__atomic_store_n(table->buckets + i, id + 1, __ATOMIC_RELEASE);
+}
+
+AttributeMap *AttributeMap_New(uint cap) {
+	AttributeMap *map = rm_malloc(sizeof(AttributeMap));
+	map->table = _AttributeMapTable_New(cap > 0 ? cap : 1);
+	map->retired = array_new(AttributeMapTable *, 0);
+	int res = pthread_mutex_init(&map->lock, NULL);
+	UNUSED(res);
+	ASSERT(res == 0);
+	return map;
+}
+
+uint AttributeMap_Count(const AttributeMap *map) {
+	AttributeMapTable *table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+	return __atomic_load_n(&table->count, __ATOMIC_ACQUIRE);
+}
+
+static Attribute_ID _AttributeMapTable_Find(const AttributeMapTable *table, const char *name) {
+	uint count = __atomic_load_n(&table->count, __ATOMIC_ACQUIRE);
+	uint i = _AttributeMap_Hash(name) & table->mask;
+
+	while(true) {
+		uint slot = __atomic_load_n(table->buckets + i, __ATOMIC_ACQUIRE);
+		if(slot == 0) return ATTRIBUTE_NOTFOUND;
+		uint id = slot - 1;
+		// Skip attributes which are yet to be published.
+		if(id < count && strcmp(table->names[id], name) == 0) return id;
+		i = (i + 1) & table->mask;
+	}
+}
+
+Attribute_ID AttributeMap_GetID(const AttributeMap *map, const char *name) {
+	AttributeMapTable *table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+	return _AttributeMapTable_Find(table, name);
+}
+
+const char *AttributeMap_GetName(const AttributeMap *map, Attribute_ID id) {
+	AttributeMapTable *table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+	ASSERT(id < __atomic_load_n(&table->count, __ATOMIC_ACQUIRE));
+	return table->names[id];
+}
+
+// Replace a full table with a table twice its size.
+static AttributeMapTable *_AttributeMap_Grow(AttributeMap *map) {
+	AttributeMapTable *table = map->table;
+	AttributeMapTable *grown = _AttributeMapTable_New(table->cap * 2);
+
+	memcpy(grown->names, table->names, sizeof(char *) * table->count);
+	for(uint i = 0; i < table->count; i++) {
+		_AttributeMapTable_Index(grown, grown->names[i], i);
+	}
+	grown->count = table->count;
+
+	// Readers might still be accessing the replaced table.
+	__atomic_store_n(&map->table, grown, __ATOMIC_RELEASE);
+	map->retired = array_append(map->retired, table);
+	return grown;
+}
+
+Attribute_ID AttributeMap_FindOrAdd(AttributeMap *map, const char *name) {
+	// Optimistic lock free lookup.
+	Attribute_ID id = AttributeMap_GetID(map, name);
+	if(id != ATTRIBUTE_NOTFOUND) return id;
+
+	pthread_mutex_lock(&map->lock);
+
+	// Lookup the attribute again now that we are in a critical region.
+	AttributeMapTable *table = map->table;
+	id = _AttributeMapTable_Find(table, name);
+	if(id == ATTRIBUTE_NOTFOUND) {
+		if(table->count == table->cap) table = _AttributeMap_Grow(map);
+		// New attribute is assigned an ID equal to the current mapping size.
+		id = table->count;
+		table->names[id] = rm_strdup(name);
+		_AttributeMapTable_Index(table, name, id);
+		// Publish.
+		__atomic_store_n(&table->count, id + 1, __ATOMIC_RELEASE);
+	}
+
+	pthread_mutex_unlock(&map->lock);
+	return id;
+}
+
+void AttributeMap_Free(AttributeMap *map) {
+	if(map == NULL) return;
+
+	AttributeMapTable *table = map->table;
+	for(uint i = 0; i < table->count; i++) rm_free(table->names[i]);
+	_AttributeMapTable_Free(table);
+
+	uint retired_count = array_len(map->retired);
+	for(uint i = 0; i < retired_count; i++) _AttributeMapTable_Free(map->retired[i]);
+	array_free(map->retired);
+
+	pthread_mutex_destroy(&map->lock);
+	rm_free(map);
+}
+
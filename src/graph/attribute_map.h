@@ -0,0 +1,51 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <pthread.h>
+#include "entities/graph_entity.h"
+
+/* AttributeMap maps attribute names to attribute IDs and back.
+ * Attributes are never removed, as such the map is append only:
+ * lookups are lock free while additions are serialized by a mutex.
+ *
+ * Names and their hash buckets live in a table which is replaced
+ * by a larger copy once full, replaced tables are retained until
+ * the map is freed as readers might still be accessing them. */
+
+typedef struct {
+	uint count;         // Number of published attributes.
+	uint cap;           // Number of attributes table can hold.
+	uint mask;          // Number of buckets - 1.
+	char **names;       // Attribute names indexed by attribute ID.
+	uint *buckets;      // Open addressing hash buckets, holds attribute ID + 1, 0 if empty.
+} AttributeMapTable;
+
+typedef struct {
+	AttributeMapTable *table;       // Current table.
+	AttributeMapTable **retired;    // Replaced tables.
+	pthread_mutex_t lock;           // Serializes additions.
+} AttributeMap;
+
+// Create a new attribute map.
+AttributeMap *AttributeMap_New(uint cap);
+
+// Number of attributes in map.
+uint AttributeMap_Count(const AttributeMap *map);
+
+// Retrieve an attribute ID given its name, ATTRIBUTE_NOTFOUND if missing.
+Attribute_ID AttributeMap_GetID(const AttributeMap *map, const char *name);
+
+// Retrieve an attribute name given its ID.
+const char *AttributeMap_GetName(const AttributeMap *map, Attribute_ID id);
+
+// Retrieve an attribute ID given its name, adding the attribute if missing.
+Attribute_ID AttributeMap_FindOrAdd(AttributeMap *map, const char *name);
+
+// Free map.
+void AttributeMap_Free(AttributeMap *map);
+
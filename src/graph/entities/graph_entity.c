@@ -23,22 +23,23 @@ static void _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_
 	if(GraphEntity_GetProperty(e, attr_id) == PROPERTY_NOTFOUND) return;
 
 	// Locate attribute position.
-	int prop_count = e->entity->prop_count;
+	Entity *entity = GraphEntity_GetEntity(e);
+	int prop_count = entity->prop_count;
 	for(int i = 0; i < prop_count; i++) {
-		if(attr_id == e->entity->properties[i].id) {
-			SIValue_Free(e->entity->properties[i].value);
-			e->entity->prop_count--;
+		if(attr_id == entity->properties[i].id) {
+			SIValue_Free(entity->properties[i].value);
+			entity->prop_count--;
 
-			if(e->entity->prop_count == 0) {
+			if(entity->prop_count == 0) {
 				/* Only attribute removed, free properties bag. */
-				rm_free(e->entity->properties);
-				e->entity->properties = NULL;
+				rm_free(entity->properties);
+				entity->properties = NULL;
 			} else {
 				/* Overwrite deleted attribute with the last
 				 * attribute and shrink properties bag. */
-				e->entity->properties[i] = e->entity->properties[prop_count - 1];
-				e->entity->properties = rm_realloc(e->entity->properties,
-												   sizeof(EntityProperty) * e->entity->prop_count);
+				entity->properties[i] = entity->properties[prop_count - 1];
+				entity->properties = rm_realloc(entity->properties,
+												sizeof(EntityProperty) * entity->prop_count);
 			}
 
 			break;
@@ -46,30 +47,44 @@ static void _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_
 	}
 }
 
+Entity *GraphEntity_GetEntity(const GraphEntity *e) {
+	if(!ENTITY_IS_RESOLVED(e)) {
+		/* Only nodes are left unresolved, see AST_AliasRequiresMaterialization.
+		 * Cache the resolved entity within the node, which is owned by a record. */
+		assert(e->id != INVALID_ENTITY_ID);
+		Node n;
+		Graph_GetNode(QueryCtx_GetGraph(), e->id, &n);
+		((GraphEntity *)e)->entity = n.entity;
+	}
+	return e->entity;
+}
+
 /* Add a new property to entity */
 SIValue *GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value) {
-	if(e->entity->properties == NULL) {
-		e->entity->properties = rm_malloc(sizeof(EntityProperty));
+	Entity *entity = GraphEntity_GetEntity(e);
+	if(entity->properties == NULL) {
+		entity->properties = rm_malloc(sizeof(EntityProperty));
 	} else {
-		e->entity->properties = rm_realloc(e->entity->properties,
-										   sizeof(EntityProperty) * (e->entity->prop_count + 1));
+		entity->properties = rm_realloc(entity->properties,
+										sizeof(EntityProperty) * (entity->prop_count + 1));
 	}
 
-	int prop_idx = e->entity->prop_count;
-	e->entity->properties[prop_idx].id = attr_id;
-	e->entity->properties[prop_idx].value = SI_CloneValue(value);
-	e->entity->prop_count++;
+	int prop_idx = entity->prop_count;
+	entity->properties[prop_idx].id = attr_id;
+	entity->properties[prop_idx].value = SI_CloneValue(value);
+	entity->prop_count++;
 
-	return &(e->entity->properties[prop_idx].value);
+	return &(entity->properties[prop_idx].value);
 }
 
 SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id) {
 	if(attr_id == ATTRIBUTE_NOTFOUND) return PROPERTY_NOTFOUND;
 
-	for(int i = 0; i < e->entity->prop_count; i++) {
-		if(attr_id == e->entity->properties[i].id) {
+	Entity *entity = GraphEntity_GetEntity(e);
+	for(int i = 0; i < entity->prop_count; i++) {
+		if(attr_id == entity->properties[i].id) {
 			// Note, unsafe as entity properties can get reallocated.
-			return &(e->entity->properties[i].value);
+			return &(entity->properties[i].value);
 		}
 	}
 
@@ -16,8 +16,9 @@
 #define INVALID_ENTITY_ID -1l
 
 #define ENTITY_GET_ID(graphEntity) (graphEntity)->id
-#define ENTITY_PROP_COUNT(graphEntity) ((graphEntity)->entity->prop_count)
-#define ENTITY_PROPS(graphEntity) ((graphEntity)->entity->properties)
+#define ENTITY_PROP_COUNT(graphEntity) (GraphEntity_GetEntity((const GraphEntity *)(graphEntity))->prop_count)
+#define ENTITY_PROPS(graphEntity) (GraphEntity_GetEntity((const GraphEntity *)(graphEntity))->properties)
+#define ENTITY_IS_RESOLVED(graphEntity) ((graphEntity)->entity != NULL)
 
 // Defined in graph_entity.c
 extern SIValue *PROPERTY_NOTFOUND;
@@ -52,6 +53,7 @@ typedef struct {
 // TODO: see if pragma pack 0 will cause memory access violation on ARM.
 typedef struct {
 	int prop_count;             // Number of properties.
+	int label;                  // Node's label ID, GRAPH_NO_LABEL if unlabeled, unused by edges.
 	EntityProperty *properties; // Key value pair of attributes.
 } Entity;
 
@@ -61,6 +63,11 @@ typedef struct {
 	EntityID id;
 } GraphEntity;
 
+/* Retrieves entity's attribute set.
+ * Nodes may be carried through the execution plan by ID alone,
+ * in which case the entity is fetched from the graph on first access. */
+Entity *GraphEntity_GetEntity(const GraphEntity *e);
+
 /* Adds property to entity
  * returns - reference to newly added property. */
 SIValue *GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value);
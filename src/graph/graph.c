@@ -12,6 +12,9 @@
 #include "../util/qsort.h"
 #include "../GraphBLASExt/GxB_Delete.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
+#include "../metrics/metrics.h"
+#include "../util/thread_budget.h"
 #include "../util/datablock/oo_datablock.h"
 
 static GrB_BinaryOp _graph_edge_accum = NULL;
@@ -120,6 +123,123 @@ static void RG_Matrix_Free(RG_Matrix matrix) {
 	rm_free(matrix);
 }
 
+/* Estimated number of bytes held by a synchronized matrix.
+ * Matrices are stored in CSR form and are never hypersparse:
+ * an offset per row, a column index and a value per entry. */
+static size_t _MatrixMemoryUsage(GrB_Matrix m) {
+	if(m == GrB_NULL) return 0;
+
+	GrB_Type type;
+	size_t type_size;
+	GrB_Index nrows;
+	GrB_Index nvals;
+	GrB_Matrix_nrows(&nrows, m);
+	GrB_Matrix_nvals(&nvals, m);
+	GxB_Matrix_type(&type, m);
+	GxB_Type_size(&type_size, type);
+
+	return sizeof(_RG_Matrix) + (nrows + 1) * sizeof(int64_t) +
+		   nvals * (sizeof(int64_t) + type_size);
+}
+
+/* ===================== Transposed relation matrices cache ===================== */
+
+/* When transposed relation matrices are not maintained, transposes are computed
+ * on demand by readers and cached. Writers record the relation entries they modify,
+ * the next reader patches these into the cached transpose, once too many entries
+ * are pending the transpose is dropped and recomputed instead. */
+
+// Number of pending (src, dest) entries above which a cached transpose is recomputed.
+#define TRANSPOSE_CACHE_MAX_PENDING 4096
+
+// Patch pending relation entries into the cached transpose TR of R.
+static void _Graph_PatchTransposedRelation(GrB_Matrix TR, GrB_Matrix R, GrB_Index *pending) {
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Index t_nrows;
+	GrB_Matrix_nrows(&nrows, R);
+	GrB_Matrix_ncols(&ncols, R);
+	GrB_Matrix_nrows(&t_nrows, TR);
+	// Relation matrix might have grown since its transpose was computed.
+	if(t_nrows != ncols) assert(GxB_Matrix_resize(TR, ncols, nrows) == GrB_SUCCESS);
+
+	uint count = array_len(pending);
+	for(uint i = 0; i < count; i += 2) {
+		uint64_t x;
+		GrB_Index src = pending[i];
+		GrB_Index dest = pending[i + 1];
+		if(GrB_Matrix_extractElement_UINT64(&x, R, src, dest) == GrB_SUCCESS) {
+			GrB_Matrix_setElement_UINT64(TR, x, dest, src);
+		} else {
+			GxB_Matrix_Delete(TR, dest, src);
+		}
+	}
+
+	// Force execution of pending operations before readers iterate the matrix.
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, TR);
+}
+
+// Retrieve the transposed relation matrix r, computing or patching it if required.
+static GrB_Matrix _Graph_GetCachedTransposedRelationMatrix(const Graph *g, int r) {
+	RG_Matrix cache = g->_t_relations_cache[r];
+	GrB_Index *pending = g->_t_relations_pending[r];
+
+	// Concurrent readers may race to compute the same transpose.
+	RG_Matrix_Lock(cache);
+	GrB_Matrix R = Graph_GetRelationMatrix(g, r);
+	if(cache->grb_matrix == GrB_NULL) {
+		GrB_Index nrows;
+		GrB_Index ncols;
+		GrB_Matrix_nrows(&nrows, R);
+		GrB_Matrix_ncols(&ncols, R);
+
+		GrB_Matrix TR;
+		GrB_Info info = GrB_Matrix_new(&TR, GrB_UINT64, ncols, nrows);
+		assert(info == GrB_SUCCESS);
+		info = GrB_transpose(TR, GrB_NULL, GrB_NULL, R, GrB_NULL);
+		assert(info == GrB_SUCCESS);
+		cache->grb_matrix = TR;
+	} else if(array_len(pending) > 0) {
+		_Graph_PatchTransposedRelation(cache->grb_matrix, R, pending);
+	}
+	array_clear(pending);
+	_RG_Matrix_Unlock(cache);
+
+	return RG_Matrix_Get_GrB_Matrix(cache);
+}
+
+// Drop the cached transpose of relation r, GRAPH_NO_RELATION drops all cached transposes.
+// Called by writers, which have exclusive access to the graph.
+static void _Graph_InvalidateTransposedRelation(Graph *g, int r) {
+	if(g->_t_relations_cache == NULL) return;
+
+	uint count = array_len(g->_t_relations_cache);
+	for(uint i = 0; i < count; i++) {
+		if(r != GRAPH_NO_RELATION && r != i) continue;
+		RG_Matrix cache = g->_t_relations_cache[i];
+		if(cache->grb_matrix != GrB_NULL) GrB_Matrix_free(&cache->grb_matrix);
+		array_clear(g->_t_relations_pending[i]);
+	}
+}
+
+// Record that entry (src, dest) of relation r was modified, called by writers.
+static void _Graph_MarkTransposedRelationEntry(Graph *g, int r, NodeID src, NodeID dest) {
+	if(g->_t_relations_cache == NULL) return;
+	// Transpose isn't cached, it will be computed from scratch.
+	if(g->_t_relations_cache[r]->grb_matrix == GrB_NULL) return;
+
+	GrB_Index *pending = g->_t_relations_pending[r];
+	if(array_len(pending) >= TRANSPOSE_CACHE_MAX_PENDING * 2) {
+		_Graph_InvalidateTransposedRelation(g, r);
+		return;
+	}
+
+	pending = array_append(pending, src);
+	pending = array_append(pending, dest);
+	g->_t_relations_pending[r] = pending;
+}
+
 /* ========================= Synchronization functions ========================= */
 
 /* Acquire a lock that does not restrict access from additional reader threads */
@@ -133,6 +253,13 @@ void Graph_AcquireWriteLock(Graph *g) {
 	g->_writelocked = true;
 }
 
+/* Acquire a lock for exclusive access to this graph's data, without waiting */
+bool Graph_TryAcquireWriteLock(Graph *g) {
+	if(pthread_rwlock_trywrlock(&g->_rwlock) != 0) return false;
+	g->_writelocked = true;
+	return true;
+}
+
 /* Release the held lock */
 void Graph_ReleaseLock(Graph *g) {
 	/* Set _writelocked to false BEFORE unlocking
@@ -151,6 +278,11 @@ void Graph_WriterEnter(Graph *g) {
 	pthread_mutex_lock(&g->_writers_mutex);
 }
 
+/* Writer request access to graph, returns false rather than waiting on an active writer. */
+bool Graph_TryWriterEnter(Graph *g) {
+	return pthread_mutex_trylock(&g->_writers_mutex) == 0;
+}
+
 /* Writer release access to graph. */
 void Graph_WriterLeave(Graph *g) {
 	pthread_mutex_unlock(&g->_writers_mutex);
@@ -175,26 +307,17 @@ size_t _Graph_EdgeCap(const Graph *g) {
 }
 
 // Locates edges connecting src to destination.
-void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int r, Edge **edges) {
-	assert(g && src < Graph_RequiredMatrixDim(g) && dest < Graph_RequiredMatrixDim(g) &&
-		   r < Graph_RelationTypeCount(g));
-
+void Graph_GetEdgesFromEntry(const Graph *g, NodeID src, NodeID dest, int r, EdgeID entry,
+							 Edge **edges) {
 	Edge e;
 	EdgeID edgeId;
 	e.relationID = r;
 	e.srcNodeID = src;
 	e.destNodeID = dest;
 
-	// relation map, maps (src, dest, r) to edge IDs.
-	GrB_Matrix relation = Graph_GetRelationMatrix(g, r);
-	GrB_Info res = GrB_Matrix_extractElement_UINT64(&edgeId, relation, src, dest);
-
-	// No entry at [dest, src], src is not connected to dest with relation R.
-	if(res == GrB_NO_VALUE) return;
-
-	if(SINGLE_EDGE(edgeId)) {
+	if(SINGLE_EDGE(entry)) {
 		// Discard most significate bit.
-		edgeId = SINGLE_EDGE_ID(edgeId);
+		edgeId = SINGLE_EDGE_ID(entry);
 		e.entity = DataBlock_GetItem(g->edges, edgeId);
 		e.id = edgeId;
 		assert(e.entity);
@@ -202,7 +325,7 @@ void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int
 	} else {
 		/* Multiple edges connecting src to dest,
 		 * entry is a pointer to an array of edge IDs. */
-		EdgeID *edgeIds = (EdgeID *)edgeId;
+		EdgeID *edgeIds = (EdgeID *)entry;
 		int edgeCount = array_len(edgeIds);
 
 		for(int i = 0; i < edgeCount; i++) {
@@ -215,6 +338,21 @@ void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int
 	}
 }
 
+void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int r, Edge **edges) {
+	assert(g && src < Graph_RequiredMatrixDim(g) && dest < Graph_RequiredMatrixDim(g) &&
+		   r < Graph_RelationTypeCount(g));
+
+	EdgeID entry;
+	// relation map, maps (src, dest, r) to edge IDs.
+	GrB_Matrix relation = Graph_GetRelationMatrix(g, r);
+	GrB_Info res = GrB_Matrix_extractElement_UINT64(&entry, relation, src, dest);
+
+	// No entry at [dest, src], src is not connected to dest with relation R.
+	if(res == GrB_NO_VALUE) return;
+
+	Graph_GetEdgesFromEntry(g, src, dest, r, entry, edges);
+}
+
 // Tests if there's an edge of type r between src and dest nodes.
 bool Graph_EdgeExists(const Graph *g, NodeID srcID, NodeID destID, int r) {
 	assert(g);
@@ -259,6 +397,8 @@ void _MatrixSynchronize(const Graph *g, RG_Matrix rg_matrix) {
 	// If the matrix has pending operations or requires
 	// a resize, enter critical section.
 	if(pending || (n_rows != dims) || (n_cols != dims)) {
+		double timer[2];
+		simple_tic(timer);
 		// Double-check if resize is necessary.
 		GrB_Matrix_nrows(&n_rows, m);
 		GrB_Matrix_ncols(&n_cols, m);
@@ -268,6 +408,10 @@ void _MatrixSynchronize(const Graph *g, RG_Matrix rg_matrix) {
 		}
 		// Flush changes to matrix.
 		_Graph_ApplyPending(m);
+		double elapsed = simple_toc(timer);
+		// Attribute synchronization to the profiled operation, if any.
+		ThreadBudget_AddTime(elapsed);
+		Metrics_RecordMatrixSync(Metrics_Global(), elapsed * 1000);
 	}
 	// Unlock matrix mutex.
 	_RG_Matrix_Unlock(rg_matrix);
@@ -315,6 +459,12 @@ void Graph_SetMatrixPolicy(Graph *g, MATRIX_POLICY policy) {
 	}
 }
 
+MATRIX_POLICY Graph_GetMatrixPolicy(const Graph *g) {
+	if(g->SynchronizeMatrix == _MatrixResizeToCapacity) return RESIZE_TO_CAPACITY;
+	if(g->SynchronizeMatrix == _MatrixNOP) return DISABLED;
+	return SYNC_AND_MINIMIZE_SPACE;
+}
+
 /* Synchronize and resize all matrices in graph. */
 void Graph_ApplyAllPending(Graph *g) {
 	RG_Matrix M;
@@ -353,6 +503,11 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 	// If we're maintaining transposed relation matrices, allocate a new array, otherwise NULL-set the pointer.
 	g->t_relations = Config_MaintainTranspose() ?
 					 array_new(RG_Matrix, GRAPH_DEFAULT_RELATION_TYPE_CAP) : NULL;
+	// Otherwise, transposed relation matrices are computed on demand.
+	g->_t_relations_cache = Config_MaintainTranspose() ?
+							NULL : array_new(RG_Matrix, GRAPH_DEFAULT_RELATION_TYPE_CAP);
+	g->_t_relations_pending = Config_MaintainTranspose() ?
+							  NULL : array_new(GrB_Index *, GRAPH_DEFAULT_RELATION_TYPE_CAP);
 
 	// Initialize a read-write lock scoped to the individual graph
 	assert(pthread_rwlock_init(&g->_rwlock, NULL) == 0);
@@ -379,7 +534,7 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 size_t Graph_RequiredMatrixDim(const Graph *g) {
 	// Matrix dimensions should be at least:
 	// Number of nodes + number of deleted nodes.
-	return g->nodes->itemCount + array_len(g->nodes->deletedIdx);
+	return g->nodes->itemCount + DataBlock_DeletedItemsCount(g->nodes);
 }
 
 size_t Graph_NodeCount(const Graph *g) {
@@ -434,6 +589,16 @@ int Graph_GetNode(const Graph *g, NodeID id, Node *n) {
 	return (n->entity != NULL);
 }
 
+void Graph_GetNodesBatch(const Graph *g, const NodeID *ids, uint64_t count, Entity **entities) {
+	assert(g);
+	DataBlock_GetItemsBatch(g->nodes, ids, count, (void **)entities);
+
+	// Entities are now cached, prefetch their attribute sets which are likely to be accessed next.
+	for(uint64_t i = 0; i < count; i++) {
+		if(entities[i] && entities[i]->properties) __builtin_prefetch(entities[i]->properties, 0, 1);
+	}
+}
+
 int Graph_GetEdge(const Graph *g, EdgeID id, Edge *e) {
 	assert(g && id < _Graph_EdgeCap(g));
 	e->entity = _Graph_GetEntity(g->edges, id);
@@ -443,18 +608,10 @@ int Graph_GetEdge(const Graph *g, EdgeID id, Edge *e) {
 
 int Graph_GetNodeLabel(const Graph *g, NodeID nodeID) {
 	assert(g);
-	int label = GRAPH_NO_LABEL;
-	for(int i = 0; i < array_len(g->labels); i++) {
-		bool x = false;
-		GrB_Matrix M = Graph_GetLabelMatrix(g, i);
-		GrB_Info res = GrB_Matrix_extractElement_BOOL(&x, M, nodeID, nodeID);
-		if(res == GrB_SUCCESS && x == true) {
-			label = i;
-			break;
-		}
-	}
-
-	return label;
+	// Label is stored within the node entity.
+	Entity *en = _Graph_GetEntity(g->nodes, nodeID);
+	if(en == NULL) return GRAPH_NO_LABEL;
+	return en->label;
 }
 
 int Graph_GetEdgeRelation(const Graph *g, Edge *e) {
@@ -521,14 +678,12 @@ void Graph_GetEdgesConnectingNodes(const Graph *g, NodeID srcID, NodeID destID,
 	}
 }
 
-void Graph_CreateNode(Graph *g, int label, Node *n) {
-	assert(g);
-
-	NodeID id;
-	Entity *en = DataBlock_AllocateItem(g->nodes, &id);
+// Initialize node n, stored at position id, and label it accordingly.
+static void _Graph_InitNode(Graph *g, int label, NodeID id, Entity *en, Node *n) {
 	n->id = id;
 	n->entity = en;
 	en->prop_count = 0;
+	en->label = label;
 	en->properties = NULL;
 
 	if(label != GRAPH_NO_LABEL) {
@@ -544,7 +699,25 @@ void Graph_CreateNode(Graph *g, int label, Node *n) {
 	}
 }
 
+void Graph_CreateNode(Graph *g, int label, Node *n) {
+	assert(g);
+
+	NodeID id;
+	Entity *en = DataBlock_AllocateItem(g->nodes, &id);
+	_Graph_InitNode(g, label, id, en, n);
+}
+
+bool Graph_CreateNodeWithID(Graph *g, NodeID id, int label, Node *n) {
+	assert(g);
+
+	Entity *en = DataBlock_AllocateItemAt(g->nodes, id);
+	if(en == NULL) return false;
+	_Graph_InitNode(g, label, id, en, n);
+	return true;
+}
+
 void Graph_FormConnection(Graph *g, NodeID src, NodeID dest, EdgeID edge_id, int r) {
+	_Graph_MarkTransposedRelationEntry(g, r, src, dest);
 	GrB_Matrix adj = Graph_GetAdjacencyMatrix(g);
 	GrB_Matrix tadj = Graph_GetTransposedAdjacencyMatrix(g);
 	GrB_Matrix relationMat = Graph_GetRelationMatrix(g, r);
@@ -610,6 +783,60 @@ int Graph_ConnectNodes(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
 	return 1;
 }
 
+bool Graph_ConnectNodesWithID(Graph *g, EdgeID id, NodeID src, NodeID dest, int r, Edge *e) {
+	assert(g && r < Graph_RelationTypeCount(g));
+
+	Entity *en = DataBlock_AllocateItemAt(g->edges, id);
+	if(en == NULL) return false;
+	en->prop_count = 0;
+	en->properties = NULL;
+	e->id = id;
+	e->entity = en;
+	e->relationID = r;
+	e->srcNodeID = src;
+	e->destNodeID = dest;
+	Graph_FormConnection(g, src, dest, id, r);
+	return true;
+}
+
+/* Collects edges of type r held by row 'id' of relation matrix M,
+ * if M is transposed rows represent destination nodes. */
+static void _Graph_CollectRowEdges(const Graph *g, GrB_Matrix M, NodeID id, int r, bool transposed,
+								   Edge **edges) {
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Matrix_nrows(&nrows, M);
+	GrB_Matrix_ncols(&ncols, M);
+	// Row out of matrix bounds, no edges.
+	if(id >= nrows) return;
+
+	// Extract the entire row at once, w = M(id,:).
+	GrB_Vector w;
+	GrB_Info info = GrB_Vector_new(&w, GrB_UINT64, ncols);
+	assert(info == GrB_SUCCESS);
+	info = GrB_Col_extract(w, GrB_NULL, GrB_NULL, M, GrB_ALL, ncols, id, GrB_DESC_T0);
+	assert(info == GrB_SUCCESS);
+
+	GrB_Index nvals;
+	GrB_Vector_nvals(&nvals, w);
+	if(nvals > 0) {
+		GrB_Index *neighbors = rm_malloc(sizeof(GrB_Index) * nvals);
+		uint64_t *entries = rm_malloc(sizeof(uint64_t) * nvals);
+		info = GrB_Vector_extractTuples_UINT64(neighbors, entries, &nvals, w);
+		assert(info == GrB_SUCCESS);
+
+		for(GrB_Index i = 0; i < nvals; i++) {
+			NodeID neighbor = neighbors[i];
+			if(transposed) Graph_GetEdgesFromEntry(g, neighbor, id, r, entries[i], edges);
+			else Graph_GetEdgesFromEntry(g, id, neighbor, r, entries[i], edges);
+		}
+
+		rm_free(neighbors);
+		rm_free(entries);
+	}
+	GrB_Vector_free(&w);
+}
+
 /* Retrieves all either incoming or outgoing edges
  * to/from given node N, depending on given direction. */
 void Graph_GetNodeEdges(const Graph *g, const Node *n, GRAPH_EDGE_DIR dir, int edgeType,
@@ -624,50 +851,52 @@ void Graph_GetNodeEdges(const Graph *g, const Node *n, GRAPH_EDGE_DIR dir, int e
 
 	// Outgoing.
 	if(dir == GRAPH_EDGE_DIR_OUTGOING || dir == GRAPH_EDGE_DIR_BOTH) {
-		/* If a relationship type is specified, retrieve the appropriate relation matrix;
-		 * otherwise use the overall adjacency matrix. */
-		if(edgeType == GRAPH_NO_RELATION) M = Graph_GetAdjacencyMatrix(g);
-		else M = Graph_GetRelationMatrix(g, edgeType);
-
-		/* Construct an iterator to traverse the source node's row, which contains
-		 * all outgoing edges. */
-		GxB_MatrixTupleIter_new(&tupleIter, M);
 		srcNodeID = ENTITY_GET_ID(n);
-		GxB_MatrixTupleIter_iterate_row(tupleIter, srcNodeID);
-		while(true) {
-			bool depleted = false;
-			GxB_MatrixTupleIter_next(tupleIter, NULL, &destNodeID, &depleted);
-			if(depleted) break;
-			// Collect all edges connecting this source node to each of its destinations.
-			Graph_GetEdgesConnectingNodes(g, srcNodeID, destNodeID, edgeType, edges);
+		if(edgeType != GRAPH_NO_RELATION) {
+			// Scan the source node's row within the relation matrix.
+			M = Graph_GetRelationMatrix(g, edgeType);
+			_Graph_CollectRowEdges(g, M, srcNodeID, edgeType, false, edges);
+		} else {
+			/* Construct an iterator to traverse the source node's row
+			 * in the adjacency matrix, which contains all outgoing edges. */
+			M = Graph_GetAdjacencyMatrix(g);
+			GxB_MatrixTupleIter_new(&tupleIter, M);
+			GxB_MatrixTupleIter_iterate_row(tupleIter, srcNodeID);
+			while(true) {
+				bool depleted = false;
+				GxB_MatrixTupleIter_next(tupleIter, NULL, &destNodeID, &depleted);
+				if(depleted) break;
+				// Collect all edges connecting this source node to each of its destinations.
+				Graph_GetEdgesConnectingNodes(g, srcNodeID, destNodeID, edgeType, edges);
+			}
+			GxB_MatrixTupleIter_free(tupleIter);
 		}
-		GxB_MatrixTupleIter_free(tupleIter);
 	}
 
 	// Incoming.
 	if(dir == GRAPH_EDGE_DIR_INCOMING || dir == GRAPH_EDGE_DIR_BOTH) {
-		/* Retrieve the transposed adjacency matrix, regardless of whether or not
-		 * a relationship type is specified. */
-		M = Graph_GetTransposedAdjacencyMatrix(g);
-
-		/* Construct an iterator to traverse the node's row, which in the transposed
-		 * adjacency matrix contains all incoming edges. */
-		GxB_MatrixTupleIter_new(&tupleIter, M);
 		destNodeID = ENTITY_GET_ID(n);
-		GxB_MatrixTupleIter_iterate_row(tupleIter, destNodeID);
-
-		while(true) {
-			bool depleted = false;
-			GxB_MatrixTupleIter_next(tupleIter, NULL, &srcNodeID, &depleted);
-			if(depleted) break;
-			/* Collect all edges connecting this destination node to each of its sources.
-			 * This call will only collect edges of the appropriate relationship type,
-			 * if one is specified. */
-			Graph_GetEdgesConnectingNodes(g, srcNodeID, destNodeID, edgeType, edges);
+		if(edgeType != GRAPH_NO_RELATION) {
+			/* Scan the node's row within the transposed relation matrix,
+			 * either maintained or computed on demand. */
+			if(Config_MaintainTranspose()) M = Graph_GetTransposedRelationMatrix(g, edgeType);
+			else M = _Graph_GetCachedTransposedRelationMatrix(g, edgeType);
+			_Graph_CollectRowEdges(g, M, destNodeID, edgeType, true, edges);
+		} else {
+			/* Construct an iterator to traverse the node's row, which in the transposed
+			 * adjacency matrix contains all incoming edges. */
+			M = Graph_GetTransposedAdjacencyMatrix(g);
+			GxB_MatrixTupleIter_new(&tupleIter, M);
+			GxB_MatrixTupleIter_iterate_row(tupleIter, destNodeID);
+			while(true) {
+				bool depleted = false;
+				GxB_MatrixTupleIter_next(tupleIter, NULL, &srcNodeID, &depleted);
+				if(depleted) break;
+				// Collect all edges connecting this destination node to each of its sources.
+				Graph_GetEdgesConnectingNodes(g, srcNodeID, destNodeID, edgeType, edges);
+			}
+			GxB_MatrixTupleIter_free(tupleIter);
 		}
-
-		// Clean up
-		GxB_MatrixTupleIter_free(tupleIter);
 	}
 }
 
@@ -683,6 +912,7 @@ int Graph_DeleteEdge(Graph *g, Edge *e) {
 	NodeID src_id = Edge_GetSrcNodeID(e);
 	NodeID dest_id = Edge_GetDestNodeID(e);
 
+	_Graph_MarkTransposedRelationEntry(g, r, src_id, dest_id);
 	R = Graph_GetRelationMatrix(g, r);
 	if(Config_MaintainTranspose()) TR = Graph_GetTransposedRelationMatrix(g, r);
 
@@ -775,9 +1005,9 @@ void Graph_DeleteNode(Graph *g, Node *n) {
 	assert(g && n);
 
 	// Clear label matrix at position node ID.
-	uint32_t label_count = array_len(g->labels);
-	for(int i = 0; i < label_count; i++) {
-		GrB_Matrix M = Graph_GetLabelMatrix(g, i);
+	int label = Graph_GetNodeLabel(g, ENTITY_GET_ID(n));
+	if(label != GRAPH_NO_LABEL) {
+		GrB_Matrix M = Graph_GetLabelMatrix(g, label);
 		GxB_Matrix_Delete(M, ENTITY_GET_ID(n), ENTITY_GET_ID(n));
 	}
 
@@ -1000,6 +1230,7 @@ static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 		GrB_Matrix R = Graph_GetRelationMatrix(g, r);  // Relation matrix.
 		GrB_Matrix TR = Config_MaintainTranspose() ? Graph_GetTransposedRelationMatrix(g, r) : NULL;
 		GrB_Matrix_extractElement(&edge_id, R, src_id, dest_id);
+		_Graph_MarkTransposedRelationEntry(g, r, src_id, dest_id);
 
 		if(SINGLE_EDGE(edge_id)) {
 			update_adj_matrices = true;
@@ -1116,6 +1347,8 @@ static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 void Graph_BulkDelete(Graph *g, Node *nodes, uint node_count, Edge *edges, uint edge_count,
 					  uint *node_deleted, uint *edge_deleted) {
 	assert(g);
+	// Implicitly deleted edges aren't tracked, explicit edge deletions are.
+	if(node_count) _Graph_InvalidateTransposedRelation(g, GRAPH_NO_RELATION);
 
 	*edge_deleted = 0;
 	*node_deleted = 0;
@@ -1166,6 +1399,166 @@ void Graph_BulkDelete(Graph *g, Node *nodes, uint node_count, Edge *edges, uint
 	*edge_deleted += edge_count;
 }
 
+// Permute matrix rows and columns, such that M'[i,j] = M[order[i], order[j]].
+static void _Graph_PermuteMatrix(Graph *g, RG_Matrix matrix, const GrB_Index *order,
+								 GrB_Index n) {
+	g->SynchronizeMatrix(g, matrix);
+	GrB_Matrix M = RG_Matrix_Get_GrB_Matrix(matrix);
+
+	GrB_Type type;
+	GrB_Matrix P;
+	GrB_Info info = GxB_Matrix_type(&type, M);
+	assert(info == GrB_SUCCESS);
+	info = GrB_Matrix_new(&P, type, n, n);
+	assert(info == GrB_SUCCESS);
+	// Multi-edge arrays are referenced by the permuted matrix.
+	info = GrB_Matrix_extract(P, GrB_NULL, GrB_NULL, M, order, n, order, n, GrB_NULL);
+	assert(info == GrB_SUCCESS);
+
+	GrB_Matrix_free(&matrix->grb_matrix);
+	matrix->grb_matrix = P;
+}
+
+void Graph_RelabelNodes(Graph *g, const NodeID *order, uint64_t count) {
+	assert(g && order);
+	assert(count == Graph_NodeCount(g));
+
+	// Permute matrices, prior to compacting the nodes datablock
+	// as synchronization depends on the current matrix dimensions.
+	_Graph_PermuteMatrix(g, g->adjacency_matrix, order, count);
+	_Graph_PermuteMatrix(g, g->_t_adjacency_matrix, order, count);
+
+	uint label_count = array_len(g->labels);
+	for(uint i = 0; i < label_count; i++) {
+		_Graph_PermuteMatrix(g, g->labels[i], order, count);
+	}
+
+	uint relation_count = array_len(g->relations);
+	for(uint i = 0; i < relation_count; i++) {
+		_Graph_PermuteMatrix(g, g->relations[i], order, count);
+		if(Config_MaintainTranspose()) {
+			_Graph_PermuteMatrix(g, g->t_relations[i], order, count);
+		}
+	}
+	_Graph_InvalidateTransposedRelation(g, GRAPH_NO_RELATION);
+
+	// Relocate node entities in their new order, leaving no deleted slots.
+	DataBlock *nodes = DataBlock_New(g->nodes->itemCap, sizeof(Entity),
+									 (fpDestructor)FreeEntity);
+	for(uint64_t i = 0; i < count; i++) {
+		Entity *en = DataBlock_GetItem(g->nodes, order[i]);
+		assert(en);
+		Entity *relocated = DataBlock_AllocateItem(nodes, NULL);
+		*relocated = *en;
+	}
+
+	// Entities moved, free blocks without freeing entities.
+	DataBlock_Free(g->nodes);
+	g->nodes = nodes;
+
+	g->SynchronizeMatrix(g, g->_zero_matrix);
+}
+
+bool Graph_Compact(Graph *g, uint budget) {
+	assert(g);
+	bool nodes_done = DataBlock_Compact(g->nodes, budget);
+	bool edges_done = DataBlock_Compact(g->edges, budget);
+	return nodes_done && edges_done;
+}
+
+size_t Graph_LabelMatrixMemoryUsage(const Graph *g, int label) {
+	assert(g);
+	return _MatrixMemoryUsage(Graph_GetLabelMatrix(g, label));
+}
+
+size_t Graph_RelationMatrixMemoryUsage(const Graph *g, int relation) {
+	assert(g);
+	size_t size = _MatrixMemoryUsage(Graph_GetRelationMatrix(g, relation));
+
+	if(relation == GRAPH_NO_RELATION || g->t_relations) {
+		size += _MatrixMemoryUsage(Graph_GetTransposedRelationMatrix(g, relation));
+	} else {
+		// Cached transposes are computed by readers under the matrix lock.
+		RG_Matrix cache = g->_t_relations_cache[relation];
+		RG_Matrix_Lock(cache);
+		size += _MatrixMemoryUsage(RG_Matrix_Get_GrB_Matrix(cache));
+		_RG_Matrix_Unlock(cache);
+	}
+
+	return size;
+}
+
+size_t Graph_MultiEdgeMemoryUsage(const Graph *g, int relation, uint samples) {
+	assert(g && relation != GRAPH_NO_RELATION);
+
+	GrB_Index nrows;
+	GrB_Index nvals;
+	GrB_Matrix R = Graph_GetRelationMatrix(g, relation);
+	GrB_Matrix_nrows(&nrows, R);
+	GrB_Matrix_nvals(&nvals, R);
+	if(nvals == 0) return 0;
+
+	// Examine evenly spaced rows, every row when samples is 0.
+	GrB_Index rows = (samples == 0) ? nrows : MIN(samples, nrows);
+	GrB_Index seen = 0;
+	size_t size = 0;
+
+	GxB_MatrixTupleIter *it;
+	GxB_MatrixTupleIter_new(&it, R);
+	for(GrB_Index k = 0; k < rows; k++) {
+		GrB_Index row = k * nrows / rows;
+		GxB_MatrixTupleIter_iterate_row(it, row);
+
+		GrB_Index col;
+		bool depleted;
+		while(true) {
+			GxB_MatrixTupleIter_next(it, NULL, &col, &depleted);
+			if(depleted) break;
+			seen++;
+
+			EdgeID edge;
+			GrB_Matrix_extractElement_UINT64(&edge, R, row, col);
+			if(SINGLE_EDGE(edge)) continue;
+			EdgeID *edges = (EdgeID *)edge;
+			size += array_sizeof(array_hdr(edges));
+		}
+	}
+	GxB_MatrixTupleIter_free(it);
+
+	if(seen == 0) return 0;
+	// Extrapolate from the examined entries to the entire matrix.
+	return (size_t)((double)size * nvals / seen);
+}
+
+size_t Graph_AttributeSetsMemoryUsage(const Graph *g, GraphEntityType t, uint samples) {
+	assert(g && (t == GETYPE_NODE || t == GETYPE_EDGE));
+
+	DataBlock *entities = (t == GETYPE_NODE) ? g->nodes : g->edges;
+	uint64_t count = entities->itemCount;
+	if(count == 0) return 0;
+
+	// Examine evenly spaced entities, every entity when samples is 0.
+	uint64_t end = count + DataBlock_DeletedItemsCount(entities);
+	uint step = (samples == 0 || samples >= end) ? 1 : end / samples;
+
+	Entity *entity;
+	uint64_t seen = 0;
+	size_t size = 0;
+	DataBlockIterator *it = DataBlockIterator_New(entities, 0, end, step);
+	while((entity = DataBlockIterator_Next(it, NULL))) {
+		seen++;
+		size += entity->prop_count * sizeof(EntityProperty);
+		for(int i = 0; i < entity->prop_count; i++) {
+			size += SIValue_HeapSize(entity->properties[i].value);
+		}
+	}
+	DataBlockIterator_Free(it);
+
+	if(seen == 0) return 0;
+	// Extrapolate from the examined entities to the entire datablock.
+	return (size_t)((double)size * count / seen);
+}
+
 DataBlockIterator *Graph_ScanNodes(const Graph *g) {
 	assert(g);
 	return DataBlock_Scan(g->nodes);
@@ -1192,6 +1585,12 @@ int Graph_AddRelationType(Graph *g) {
 	if(Config_MaintainTranspose()) {
 		RG_Matrix tm = RG_Matrix_New(GrB_UINT64, dims, dims);
 		g->t_relations = array_append(g->t_relations, tm);
+	} else {
+		// Transpose is computed once required.
+		RG_Matrix tm = RG_Matrix_New(GrB_UINT64, dims, dims);
+		GrB_Matrix_free(&tm->grb_matrix);
+		g->_t_relations_cache = array_append(g->_t_relations_cache, tm);
+		g->_t_relations_pending = array_append(g->_t_relations_pending, array_new(GrB_Index, 0));
 	}
 
 	int relationID = Graph_RelationTypeCount(g) - 1;
@@ -1271,6 +1670,16 @@ void Graph_Free(Graph *g) {
 	array_free(g->relations);
 	array_free(g->t_relations);
 
+	if(g->_t_relations_cache) {
+		uint32_t cacheCount = array_len(g->_t_relations_cache);
+		for(int i = 0; i < cacheCount; i++) {
+			RG_Matrix_Free(g->_t_relations_cache[i]);
+			array_free(g->_t_relations_pending[i]);
+		}
+		array_free(g->_t_relations_cache);
+		array_free(g->_t_relations_pending);
+	}
+
 	uint32_t labelCount = array_len(g->labels);
 	for(int i = 0; i < labelCount; i++) {
 		RG_Matrix_Free(g->labels[i]);
@@ -71,6 +71,8 @@ struct Graph {
 	RG_Matrix *labels;                  // Label matrices.
 	RG_Matrix *relations;               // Relation matrices.
 	RG_Matrix *t_relations;             // Transposed relation matrices.
+	RG_Matrix *_t_relations_cache;      // On demand transposed relation matrices, when transposes aren't maintained.
+	GrB_Index **_t_relations_pending;   // Per relation, (src, dest) entries modified since its transpose was cached.
 	RG_Matrix _zero_matrix;             // Zero matrix.
 	pthread_mutex_t _writers_mutex;     // Mutex restrict single writer.
 	pthread_rwlock_t _rwlock;           // Read-write lock scoped to this specific graph
@@ -87,18 +89,28 @@ void Graph_AcquireReadLock(Graph *g);
 /* Acquire a lock for exclusive access to this graph's data */
 void Graph_AcquireWriteLock(Graph *g);
 
+/* Acquire a lock for exclusive access to this graph's data,
+ * returns false rather than waiting on active readers or writer. */
+bool Graph_TryAcquireWriteLock(Graph *g);
+
 /* Release the held lock */
 void Graph_ReleaseLock(Graph *g);
 
 /* Writer request access to graph. */
 void Graph_WriterEnter(Graph *g);
 
+/* Writer request access to graph, returns false rather than waiting on an active writer. */
+bool Graph_TryWriterEnter(Graph *g);
+
 /* Writer release access to graph. */
 void Graph_WriterLeave(Graph *g);
 
 /* Choose the current matrix synchronization policy. */
 void Graph_SetMatrixPolicy(Graph *g, MATRIX_POLICY policy);
 
+/* Returns the current matrix synchronization policy. */
+MATRIX_POLICY Graph_GetMatrixPolicy(const Graph *g);
+
 /* Synchronize and resize all matrices in graph. */
 void Graph_ApplyAllPending(Graph *g);
 
@@ -138,6 +150,16 @@ void Graph_CreateNode(
 	Node *n
 );
 
+// Create a single node at position id and labels it accordingly,
+// used to replay another graph's node creation.
+// Returns false if id is in use or out of range.
+bool Graph_CreateNodeWithID(
+	Graph *g,
+	NodeID id,
+	int label,
+	Node *n
+);
+
 // Connects source node to destination node.
 // Returns 1 if connection is formed, 0 otherwise.
 int Graph_ConnectNodes(
@@ -148,6 +170,18 @@ int Graph_ConnectNodes(
 	Edge *e
 );
 
+// Connects source node to destination node using edge id,
+// used to replay another graph's edge creation.
+// Returns false if id is in use or out of range.
+bool Graph_ConnectNodesWithID(
+	Graph *g,           // Graph on which to operate.
+	EdgeID id,          // Edge ID.
+	NodeID src,         // Source node ID.
+	NodeID dest,        // Destination node ID.
+	int r,              // Edge type.
+	Edge *e
+);
+
 // Removes node and all of its connections within the graph.
 void Graph_DeleteNode(
 	Graph *g,
@@ -171,6 +205,53 @@ void Graph_BulkDelete(
 	uint *edge_deleted  // Number of edges removed.
 );
 
+// Assigns new IDs to graph nodes, node order[i] is assigned ID i.
+// order must list every node in the graph exactly once,
+// deleted node IDs are discarded.
+void Graph_RelabelNodes(
+	Graph *g,               // Graph to relabel.
+	const NodeID *order,    // Current node IDs in their new order.
+	uint64_t count          // Number of nodes in order, equals Graph_NodeCount.
+);
+
+// Release memory held by deleted entities, examining at most
+// `budget` blocks of each datablock, resuming where the previous call stopped.
+// Returns true once both node and edge datablocks were fully examined.
+bool Graph_Compact(
+	Graph *g,
+	uint budget
+);
+
+// Returns the estimated number of bytes held by the matrix of the given label.
+size_t Graph_LabelMatrixMemoryUsage(
+	const Graph *g,
+	int label
+);
+
+// Returns the estimated number of bytes held by the matrix of the given
+// relation and its transpose, GRAPH_NO_RELATION refers to the adjacency matrix.
+size_t Graph_RelationMatrixMemoryUsage(
+	const Graph *g,
+	int relation
+);
+
+// Returns the estimated number of bytes held by arrays of edges connecting
+// the same pair of nodes with the given relation.
+// Entries of up to `samples` rows are examined, 0 examines every row.
+size_t Graph_MultiEdgeMemoryUsage(
+	const Graph *g,
+	int relation,
+	uint samples
+);
+
+// Returns the estimated number of bytes held by the attribute sets of
+// nodes or edges, up to `samples` entities are examined, 0 examines every entity.
+size_t Graph_AttributeSetsMemoryUsage(
+	const Graph *g,
+	GraphEntityType t,
+	uint samples
+);
+
 // All graph matrices are required to be squared NXN
 // where N is Graph_RequiredMatrixDim.
 size_t Graph_RequiredMatrixDim(
@@ -233,6 +314,15 @@ int Graph_GetNode(
 	Node *n
 );
 
+// Retrieves the entities of nodes ids[0..count) from graph,
+// entities[i] is set to NULL if node ids[i] wasn't found.
+void Graph_GetNodesBatch(
+	const Graph *g,
+	const NodeID *ids,
+	uint64_t count,
+	Entity **entities
+);
+
 // Retrieves node label
 // Returns GRAPH_NO_LABEL if node has no label.
 int Graph_GetNodeLabel(
@@ -266,6 +356,17 @@ void Graph_GetEdgesConnectingNodes(
 	Edge **edges        // array_t of edges connecting src to dest of type r.
 );
 
+// Retrieves edges held by a relation matrix entry,
+// e.g. an entry carried into a traversal's result matrix.
+void Graph_GetEdgesFromEntry(
+	const Graph *g,     // Graph to get edges from.
+	NodeID srcID,       // Source node of edge
+	NodeID destID,      // Destination node of edge
+	int r,              // Edge type.
+	EdgeID entry,       // Relation matrix entry, edge ID or edge IDs array.
+	Edge **edges        // array_t of edges connecting src to dest of type r.
+);
+
 // Checks if src is connected to dest via edge of type r
 // set r to GRAPH_NO_RELATION if you do not care
 // about edge type.
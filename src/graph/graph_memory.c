@@ -0,0 +1,75 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "graph_memory.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../commands/prepared_statement.h"
+
+#include <string.h>
+
+static size_t _SchemaIndicesMemoryUsage(const Schema *s) {
+	size_t size = 0;
+	if(s->index) size += Index_MemoryUsage(s->index);
+	if(s->fulltextIdx) size += Index_MemoryUsage(s->fulltextIdx);
+	return size;
+}
+
+void GraphMemory_Compute(GraphContext *gc, uint samples, GraphMemoryUsage *usage) {
+	ASSERT(gc && usage);
+
+	Graph *g = gc->g;
+	memset(usage, 0, sizeof(GraphMemoryUsage));
+
+	usage->nodes = DataBlock_MemoryUsage(g->nodes);
+	usage->edges = DataBlock_MemoryUsage(g->edges);
+	usage->node_attributes = Graph_AttributeSetsMemoryUsage(g, GETYPE_NODE, samples);
+	usage->edge_attributes = Graph_AttributeSetsMemoryUsage(g, GETYPE_EDGE, samples);
+	usage->adjacency_matrix = Graph_RelationMatrixMemoryUsage(g, GRAPH_NO_RELATION);
+	usage->total = sizeof(GraphContext) + sizeof(Graph) + usage->nodes + usage->edges +
+				   usage->node_attributes + usage->edge_attributes + usage->adjacency_matrix;
+
+	uint label_count = Graph_LabelTypeCount(g);
+	usage->label_matrices = array_new(size_t, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		size_t size = Graph_LabelMatrixMemoryUsage(g, i);
+		usage->label_matrices = array_append(usage->label_matrices, size);
+		usage->total += size;
+	}
+
+	uint relation_count = Graph_RelationTypeCount(g);
+	usage->relation_matrices = array_new(size_t, relation_count);
+	usage->multi_edges = array_new(size_t, relation_count);
+	for(uint i = 0; i < relation_count; i++) {
+		size_t matrix_size = Graph_RelationMatrixMemoryUsage(g, i);
+		size_t multi_edge_size = Graph_MultiEdgeMemoryUsage(g, i, samples);
+		usage->relation_matrices = array_append(usage->relation_matrices, matrix_size);
+		usage->multi_edges = array_append(usage->multi_edges, multi_edge_size);
+		usage->total += matrix_size + multi_edge_size;
+	}
+
+	uint schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	for(uint i = 0; i < schema_count; i++) {
+		usage->indices += _SchemaIndicesMemoryUsage(GraphContext_GetSchemaByID(gc, i, SCHEMA_NODE));
+	}
+	usage->total += usage->indices;
+
+	uint cache_count = (gc->cache_pool) ? array_len(gc->cache_pool) : 0;
+	for(uint i = 0; i < cache_count; i++) {
+		usage->plan_caches += Cache_MemoryUsage(gc->cache_pool[i]);
+	}
+	usage->total += usage->plan_caches;
+
+	usage->prepared_statements = PreparedStatements_MemoryUsage(gc->prepared_statements);
+	usage->total += usage->prepared_statements;
+}
+
+void GraphMemory_Free(GraphMemoryUsage *usage) {
+	ASSERT(usage);
+	array_free(usage->label_matrices);
+	array_free(usage->relation_matrices);
+	array_free(usage->multi_edges);
+}
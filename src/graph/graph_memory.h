@@ -0,0 +1,39 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "graphcontext.h"
+
+// Default number of entities and matrix rows examined when estimating memory usage.
+#define GRAPH_MEMORY_DEFAULT_SAMPLES 256
+
+/* Breakdown of the memory held by a graph, in bytes.
+ * Sizes of datablocks, matrices, indices and cached plans are derived from the
+ * structures themselves, attribute sets and multi-edge arrays are estimated by
+ * examining a sample of entities and matrix rows, as done by Redis' MEMORY USAGE. */
+typedef struct {
+	size_t nodes;               // Node datablock.
+	size_t edges;               // Edge datablock.
+	size_t node_attributes;     // Node attribute sets.
+	size_t edge_attributes;     // Edge attribute sets.
+	size_t adjacency_matrix;    // Adjacency matrix and its transpose.
+	size_t *label_matrices;     // Per label matrix, array_t.
+	size_t *relation_matrices;  // Per relation matrix and its transpose, array_t.
+	size_t *multi_edges;        // Per relation multi-edge arrays, array_t.
+	size_t indices;             // Exact-match and full-text indices.
+	size_t plan_caches;         // Cached execution plans of every thread.
+	size_t prepared_statements; // Statements registered through GRAPH.PREPARE.
+	size_t total;               // Sum of all of the above and graph bookkeeping.
+} GraphMemoryUsage;
+
+// Computes the memory held by gc, examining up to `samples` entities and
+// matrix rows of each kind, 0 examines all of them.
+// The caller is expected to hold the graph's read lock.
+void GraphMemory_Compute(GraphContext *gc, uint samples, GraphMemoryUsage *usage);
+
+// Free breakdown's internal arrays.
+void GraphMemory_Free(GraphMemoryUsage *usage);
@@ -0,0 +1,185 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "graph_reorder.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+
+#include <string.h>
+#include <strings.h>
+
+// Undirected view of graph connections, in compressed sparse row form.
+typedef struct {
+	GrB_Index n;            // Number of rows.
+	GrB_Index *offsets;     // Neighbors of i are neighbors[offsets[i]..offsets[i+1]).
+	NodeID *neighbors;      // Concatenated neighbor lists.
+} _Neighborhood;
+
+#define _DEGREE(nb, i) ((nb)->offsets[(i) + 1] - (nb)->offsets[(i)])
+
+static void _Neighborhood_Build(const Graph *g, _Neighborhood *nb) {
+	GrB_Index nvals;
+	GrB_Index n = Graph_RequiredMatrixDim(g);
+	GrB_Matrix A = Graph_GetAdjacencyMatrix(g);
+	GrB_Matrix_nvals(&nvals, A);
+
+	GrB_Index *rows = rm_malloc(sizeof(GrB_Index) * MAX(nvals, 1));
+	GrB_Index *cols = rm_malloc(sizeof(GrB_Index) * MAX(nvals, 1));
+	GrB_Info info = GrB_Matrix_extractTuples_BOOL(rows, cols, NULL, &nvals, A);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+
+	// Count each connection at both of its endpoints, self loops are discarded.
+	GrB_Index *offsets = rm_calloc(n + 1, sizeof(GrB_Index));
+	for(GrB_Index k = 0; k < nvals; k++) {
+		if(rows[k] == cols[k]) continue;
+		offsets[rows[k] + 1]++;
+		offsets[cols[k] + 1]++;
+	}
+	for(GrB_Index i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+
+	NodeID *neighbors = rm_malloc(sizeof(NodeID) * MAX(offsets[n], 1));
+	GrB_Index *pos = rm_malloc(sizeof(GrB_Index) * MAX(n, 1));
+	memcpy(pos, offsets, sizeof(GrB_Index) * n);
+	for(GrB_Index k = 0; k < nvals; k++) {
+		if(rows[k] == cols[k]) continue;
+		neighbors[pos[rows[k]]++] = cols[k];
+		neighbors[pos[cols[k]]++] = rows[k];
+	}
+
+	rm_free(pos);
+	rm_free(rows);
+	rm_free(cols);
+
+	nb->n = n;
+	nb->offsets = offsets;
+	nb->neighbors = neighbors;
+}
+
+static void _Neighborhood_Free(_Neighborhood *nb) {
+	rm_free(nb->offsets);
+	rm_free(nb->neighbors);
+}
+
+// Collect the IDs of every node in the graph in ascending order.
+static NodeID *_LiveNodes(const Graph *g) {
+	NodeID id;
+	NodeID *nodes = array_new(NodeID, Graph_NodeCount(g));
+	DataBlockIterator *it = Graph_ScanNodes(g);
+	while(DataBlockIterator_Next(it, &id)) nodes = array_append(nodes, id);
+	DataBlockIterator_Free(it);
+	return nodes;
+}
+
+// Sort IDs by ascending degree, ties broken by ID.
+static void _SortByDegree(const _Neighborhood *nb, NodeID *ids, uint64_t count) {
+#define DEGREE_LT(a, b) (_DEGREE(nb, *(a)) < _DEGREE(nb, *(b)) || \
+						 (_DEGREE(nb, *(a)) == _DEGREE(nb, *(b)) && *(a) < *(b)))
+	QSORT(NodeID, ids, count, DEGREE_LT);
+#undef DEGREE_LT
+}
+
+/* Breadth first search order, a search starts from each
+ * root yet to be visited, roots are considered in order.
+ * If by_degree is set, newly discovered nodes are visited
+ * by ascending degree, which is the Cuthill-McKee order. */
+static NodeID *_BFSOrder(const _Neighborhood *nb, const NodeID *roots, uint64_t count,
+						 bool by_degree) {
+	NodeID *order = array_new(NodeID, count);
+	bool *visited = rm_calloc(MAX(nb->n, 1), sizeof(bool));
+
+	for(uint64_t r = 0; r < count; r++) {
+		NodeID root = roots[r];
+		if(visited[root]) continue;
+
+		// Order array doubles as the search queue.
+		visited[root] = true;
+		uint64_t head = array_len(order);
+		order = array_append(order, root);
+
+		while(head < array_len(order)) {
+			NodeID v = order[head++];
+			uint64_t discovered = array_len(order);
+			for(GrB_Index k = nb->offsets[v]; k < nb->offsets[v + 1]; k++) {
+				NodeID u = nb->neighbors[k];
+				if(visited[u]) continue;
+				visited[u] = true;
+				order = array_append(order, u);
+			}
+			if(by_degree) {
+				_SortByDegree(nb, order + discovered, array_len(order) - discovered);
+			}
+		}
+	}
+
+	rm_free(visited);
+	return order;
+}
+
+bool GraphReorder_ParseStrategy(const char *name, ReorderStrategy *strategy) {
+	ASSERT(name && strategy);
+	if(strcasecmp(name, "BFS") == 0) *strategy = REORDER_BFS;
+	else if(strcasecmp(name, "DEGREE") == 0) *strategy = REORDER_DEGREE;
+	else if(strcasecmp(name, "RCM") == 0) *strategy = REORDER_RCM;
+	else return false;
+	return true;
+}
+
+const char *GraphReorder_StrategyName(ReorderStrategy strategy) {
+	switch(strategy) {
+	case REORDER_BFS:
+		return "BFS";
+	case REORDER_DEGREE:
+		return "DEGREE";
+	case REORDER_RCM:
+		return "RCM";
+	default:
+		ASSERT(false);
+		return NULL;
+	}
+}
+
+NodeID *GraphReorder_ComputeOrder(const Graph *g, ReorderStrategy strategy) {
+	ASSERT(g);
+
+	_Neighborhood nb;
+	_Neighborhood_Build(g, &nb);
+	NodeID *nodes = _LiveNodes(g);
+	uint64_t count = array_len(nodes);
+	NodeID *order = NULL;
+
+	switch(strategy) {
+	case REORDER_BFS:
+		order = _BFSOrder(&nb, nodes, count, false);
+		break;
+	case REORDER_DEGREE:
+		// Hubs first, sort ascending and reverse.
+		_SortByDegree(&nb, nodes, count);
+		order = array_new(NodeID, count);
+		for(uint64_t i = count; i > 0; i--) order = array_append(order, nodes[i - 1]);
+		break;
+	case REORDER_RCM:
+		// Start each component from its lowest degree node, reverse the Cuthill-McKee order.
+		_SortByDegree(&nb, nodes, count);
+		order = _BFSOrder(&nb, nodes, count, true);
+		for(uint64_t i = 0; i < count / 2; i++) {
+			NodeID tmp = order[i];
+			order[i] = order[count - 1 - i];
+			order[count - 1 - i] = tmp;
+		}
+		break;
+	default:
+		ASSERT(false);
+	}
+
+	ASSERT(array_len(order) == count);
+	array_free(nodes);
+	_Neighborhood_Free(&nb);
+	return order;
+}
+
@@ -0,0 +1,33 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "graph.h"
+
+/* Node IDs are assigned in insertion order, with deleted IDs being reused,
+ * as such connected nodes are scattered across the ID space.
+ * A reordering assigns nodes new IDs such that nodes which are traversed
+ * together are placed close to one another, both within matrices and
+ * within the nodes datablock. */
+
+typedef enum {
+	REORDER_BFS,        // Breadth first search order.
+	REORDER_DEGREE,     // Descending degree order.
+	REORDER_RCM,        // Reverse Cuthill-McKee order.
+} ReorderStrategy;
+
+// Resolve strategy by name, returns false if name is unknown.
+bool GraphReorder_ParseStrategy(const char *name, ReorderStrategy *strategy);
+
+// Returns strategy name.
+const char *GraphReorder_StrategyName(ReorderStrategy strategy);
+
+// Computes a new order of g's nodes,
+// returns an array_t where element i is the ID of the node to be assigned ID i.
+// Each node in the graph appears exactly once.
+NodeID *GraphReorder_ComputeOrder(const Graph *g, ReorderStrategy strategy);
+
@@ -10,12 +10,18 @@
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../redismodule.h"
+#include "../util/cron.h"
 #include "../util/rmalloc.h"
 #include "../util/thpool/thpool.h"
 #include "../serializers/graphcontext_type.h"
 #include "../commands/execution_ctx.h"
+#include "../commands/group_commit.h"
+#include "../commands/prepared_statement.h"
 
 extern threadpool _thpool; // Declared in module.c
+
+#define COMPACTION_INTERVAL 1000   // Milliseconds between compaction steps.
+#define COMPACTION_STEP_BLOCKS 16  // Number of blocks examined by a compaction step.
 // Global array tracking all extant GraphContexts (defined in module.c)
 extern GraphContext **graphs_in_keyspace;
 extern uint aux_field_counter;
@@ -53,6 +59,10 @@ GraphContext *GraphContext_New(const char *graph_name, size_t node_cap, size_t e
 
 	gc->ref_count = 0;      // No refences.
 	gc->index_count = 0;    // No indicies.
+	gc->compaction_scheduled = false;
+	gc->plan_version = 0;
+	gc->commit_queue = GroupCommitQueue_New();
+	gc->prepared_statements = PreparedStatements_New();
 
 	// Initialize the graph's matrices and datablock storage
 	gc->g = Graph_New(node_cap, edge_cap);
@@ -61,15 +71,12 @@ GraphContext *GraphContext_New(const char *graph_name, size_t node_cap, size_t e
 	gc->node_schemas = array_new(Schema *, GRAPH_DEFAULT_LABEL_CAP);
 	gc->relation_schemas = array_new(Schema *, GRAPH_DEFAULT_RELATION_TYPE_CAP);
 
-	gc->string_mapping = array_new(char *, 64);
-	gc->attributes = raxNew();
+	gc->attributes = AttributeMap_New(64);
 	gc->slowlog = SlowLog_New();
+	gc->metrics = Metrics_New();
 	gc->encoding_context = GraphEncodeContext_New();
 	gc->decoding_context = GraphDecodeContext_New();
 
-	// Initialize the read-write lock to protect access to the attributes rax.
-	assert(pthread_rwlock_init(&gc->_attribute_rwlock, NULL) == 0);
-
 	/* Build the cache pool. The cache pool contains a cache for each thread in the thread pool, to avoid congestion.
 	 * Each thread is getting its cache by its thread id. */
 	uint64_t thread_count = Config_GetThreadCount() + 1; // Add 1 for redis main thread.
@@ -153,6 +160,11 @@ void GraphContext_Release(GraphContext *gc) {
 	_GraphContext_DecreaseRefCount(gc);
 }
 
+void GraphContext_Retain(GraphContext *gc) {
+	assert(gc);
+	_GraphContext_IncreaseRefCount(gc);
+}
+
 void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc) {
 	RedisModuleString *graphID = RedisModule_CreateString(ctx, gc->graph_name, strlen(gc->graph_name));
 
@@ -248,64 +260,20 @@ const char *GraphContext_GetEdgeRelationType(const GraphContext *gc, Edge *e) {
 }
 
 uint GraphContext_AttributeCount(GraphContext *gc) {
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-	uint size = raxSize(gc->attributes);
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-	return size;
+	return AttributeMap_Count(gc->attributes);
 }
 
 Attribute_ID GraphContext_FindOrAddAttribute(GraphContext *gc, const char *attribute) {
-	// Acquire a read lock for looking up the attribute.
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-
-	// See if attribute already exists.
-	void *attribute_id = raxFind(gc->attributes, (unsigned char *)attribute, strlen(attribute));
-
-	if(attribute_id == raxNotFound) {
-		// We are writing to the shared GraphContext; release the held lock and re-acquire as a writer.
-		pthread_rwlock_unlock(&gc->_attribute_rwlock);
-		pthread_rwlock_wrlock(&gc->_attribute_rwlock);
-
-		// Lookup the attribute again now that we are in a critical region.
-		attribute_id = raxFind(gc->attributes, (unsigned char *)attribute, strlen(attribute));
-		// If it has been set by another thread, use the retrieved value.
-		if(attribute_id == raxNotFound) {
-			// Otherwise, it will be assigned an ID equal to the current mapping size.
-			attribute_id = (void *)raxSize(gc->attributes);
-			// Insert the new attribute key and ID.
-			raxInsert(gc->attributes,
-					  (unsigned char *)attribute,
-					  strlen(attribute),
-					  attribute_id,
-					  NULL);
-			gc->string_mapping = array_append(gc->string_mapping, rm_strdup(attribute));
-		}
-	}
-
-	// Release the lock.
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-	return (uintptr_t)attribute_id;
+	return AttributeMap_FindOrAdd(gc->attributes, attribute);
 }
 
 const char *GraphContext_GetAttributeString(GraphContext *gc, Attribute_ID id) {
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-	assert(id < array_len(gc->string_mapping));
-	const char *name = gc->string_mapping[id];
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-	return name;
+	return AttributeMap_GetName(gc->attributes, id);
 }
 
 Attribute_ID GraphContext_GetAttributeID(GraphContext *gc, const char *attribute) {
-	// Acquire a read lock for looking up the attribute.
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-	// Look up the attribute ID.
-	void *id = raxFind(gc->attributes, (unsigned char *)attribute, strlen(attribute));
-	// Release the lock.
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-
-	if(id == raxNotFound) return ATTRIBUTE_NOTFOUND;
-
-	return (uintptr_t)id;
+	// Lock free, attributes are never removed.
+	return AttributeMap_GetID(gc->attributes, attribute);
 }
 
 //------------------------------------------------------------------------------
@@ -336,6 +304,23 @@ int GraphContext_AddIndex(Index **idx, GraphContext *gc, const char *label, cons
 	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
 	if(s == NULL) s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
 	int res = Schema_AddIndex(idx, s, field, type);
+	// Plans might refer to the RediSearch index about to be re-constructed.
+	if(res == INDEX_OK) GraphContext_InvalidatePlans(gc);
+	ResultSet *result_set = QueryCtx_GetResultSet();
+	ResultSet_IndexCreated(result_set, res);
+	return res;
+}
+
+int GraphContext_AddCompositeIndex(Index **idx, GraphContext *gc, const char *label,
+								   const char **fields, uint count) {
+	assert(idx && gc && label && fields);
+
+	// Retrieve the schema for this label
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
+	int res = Schema_AddCompositeIndex(idx, s, fields, count);
+	// Plans might refer to the RediSearch index about to be re-constructed.
+	if(res == INDEX_OK) GraphContext_InvalidatePlans(gc);
 	ResultSet *result_set = QueryCtx_GetResultSet();
 	ResultSet_IndexCreated(result_set, res);
 	return res;
@@ -347,6 +332,19 @@ int GraphContext_DeleteIndex(GraphContext *gc, const char *label, const char *fi
 	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
 	int res = INDEX_FAIL;
 	if(s != NULL) res = Schema_RemoveIndex(s, field, type);
+	if(res == INDEX_OK) GraphContext_InvalidatePlans(gc);
+	ResultSet *result_set = QueryCtx_GetResultSet();
+	ResultSet_IndexDeleted(result_set, res);
+	return res;
+}
+
+int GraphContext_DeleteCompositeIndex(GraphContext *gc, const char *label, const char **fields,
+									  uint count) {
+	// Retrieve the schema for this label
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	int res = INDEX_FAIL;
+	if(s != NULL) res = Schema_RemoveCompositeIndex(s, fields, count);
+	if(res == INDEX_OK) GraphContext_InvalidatePlans(gc);
 	ResultSet *result_set = QueryCtx_GetResultSet();
 	ResultSet_IndexDeleted(result_set, res);
 	return res;
@@ -375,6 +373,16 @@ void GraphContext_DeleteNodeFromIndices(GraphContext *gc, Node *n) {
 	if(idx) Index_RemoveNode(idx, n);
 }
 
+void GraphContext_InvalidatePlans(GraphContext *gc) {
+	assert(gc);
+	__atomic_add_fetch(&gc->plan_version, 1, __ATOMIC_RELEASE);
+}
+
+uint GraphContext_PlanVersion(const GraphContext *gc) {
+	assert(gc);
+	return __atomic_load_n(&gc->plan_version, __ATOMIC_ACQUIRE);
+}
+
 //------------------------------------------------------------------------------
 // Functions for globally tracking GraphContexts
 //------------------------------------------------------------------------------
@@ -436,6 +444,53 @@ Cache *GraphContext_GetCache(const GraphContext *gc) {
 	return gc->cache_pool[thread_id];
 }
 
+//------------------------------------------------------------------------------
+// Compaction API
+//------------------------------------------------------------------------------
+
+/* Compaction step, executed by CRON.
+ * Each step holds the graph's write lock briefly, examining a bounded number of blocks,
+ * the task reschedules itself until a full pass over the graph is completed.
+ * CRON is never blocked: a step which can't lock the graph right away is retried. */
+static void _GraphContext_CompactionStep(void *pdata) {
+	GraphContext *gc = (GraphContext *)pdata;
+	Graph *g = gc->g;
+	bool done = false;
+
+	/* Active writers might hold references to deleted entities,
+	 * rather than waiting on them or on readers retry on the next step. */
+	if(Graph_TryWriterEnter(g)) {
+		if(Graph_TryAcquireWriteLock(g)) {
+			/* Compaction alters the deleted entities list, which an RDB save
+			 * encodes in between chunks, retry once the save is done. */
+			if(GraphEncodeContext_GetEncodeState(gc->encoding_context) == ENCODE_STATE_INIT) {
+				done = Graph_Compact(g, COMPACTION_STEP_BLOCKS);
+			}
+			Graph_ReleaseLock(g);
+		}
+		Graph_WriterLeave(g);
+	}
+
+	if(!done) {
+		Cron_AddTask(COMPACTION_INTERVAL, _GraphContext_CompactionStep, gc);
+		return;
+	}
+
+	__atomic_store_n(&gc->compaction_scheduled, false, __ATOMIC_RELAXED);
+	// Release reference held by the task.
+	GraphContext_Release(gc);
+}
+
+void GraphContext_ScheduleCompaction(GraphContext *gc) {
+	assert(gc);
+	// Only a single compaction task per graph.
+	if(__atomic_exchange_n(&gc->compaction_scheduled, true, __ATOMIC_RELAXED)) return;
+
+	// Graph must outlive the task.
+	_GraphContext_IncreaseRefCount(gc);
+	Cron_AddTask(COMPACTION_INTERVAL, _GraphContext_CompactionStep, gc);
+}
+
 //------------------------------------------------------------------------------
 // Free routine
 //------------------------------------------------------------------------------
@@ -468,17 +523,10 @@ static void _GraphContext_Free(void *arg) {
 	}
 
 	// Free attribute mappings
-	if(gc->attributes) raxFree(gc->attributes);
-	if(gc->string_mapping) {
-		len = array_len(gc->string_mapping);
-		for(uint32_t i = 0; i < len; i ++) {
-			rm_free(gc->string_mapping[i]);
-		}
-		array_free(gc->string_mapping);
-	}
-	assert(pthread_rwlock_destroy(&gc->_attribute_rwlock) == 0);
+	AttributeMap_Free(gc->attributes);
 
 	if(gc->slowlog) SlowLog_Free(gc->slowlog);
+	if(gc->metrics) Metrics_Free(gc->metrics);
 
 	// Clear cache
 	if(gc->cache_pool) {
@@ -489,6 +537,8 @@ static void _GraphContext_Free(void *arg) {
 
 	GraphEncodeContext_Free(gc->encoding_context);
 	GraphDecodeContext_Free(gc->decoding_context);
+	GroupCommitQueue_Free(gc->commit_queue);
+	PreparedStatements_Free(gc->prepared_statements);
 	rm_free(gc->graph_name);
 	rm_free(gc);
 }
@@ -12,7 +12,9 @@
 #include "../index/index.h"
 #include "../schema/schema.h"
 #include "../slow_log/slow_log.h"
+#include "../metrics/metrics.h"
 #include "graph.h"
+#include "attribute_map.h"
 #include "../serializers/encode_context.h"
 #include "../serializers/decode_context.h"
 #include "../util/cache/cache.h"
@@ -20,17 +22,20 @@
 typedef struct {
 	Graph *g;                               // Container for all matrices and entity properties
 	int ref_count;                          // Number of active references.
-	rax *attributes;                        // From strings to attribute IDs
-	pthread_rwlock_t _attribute_rwlock;     // Read-write lock to protect access to the attribute maps.
+	AttributeMap *attributes;               // Attribute names to IDs and back, lock free lookups.
 	char *graph_name;                       // String associated with graph
-	char **string_mapping;                  // From attribute IDs to strings
 	Schema **node_schemas;                  // Array of schemas for each node label
 	Schema **relation_schemas;              // Array of schemas for each relation type
 	unsigned short index_count;             // Number of indicies.
 	SlowLog *slowlog;                       // Slowlog associated with graph.
+	Metrics *metrics;                       // Query metrics associated with graph.
 	GraphEncodeContext *encoding_context;   // Encode context of the graph.
 	GraphDecodeContext *decoding_context;   // Decode context of the graph.
 	Cache **cache_pool;                     // Pool of execution plan caches, one per thread.
+	bool compaction_scheduled;              // Whether a compaction task is pending.
+	uint plan_version;                      // Bumped to invalidate cached execution plans.
+	struct GroupCommitQueue *commit_queue;  // Write queries awaiting a group commit.
+	struct PreparedStatements *prepared_statements;  // Statements prepared through GRAPH.PREPARE.
 } GraphContext;
 
 /* GraphContext API */
@@ -42,6 +47,8 @@ GraphContext *GraphContext_Retrieve(RedisModuleCtx *ctx, RedisModuleString *grap
 									bool shouldCreate);
 // GraphContext_Retrieve counterpart, releases a retrieved GraphContext.
 void GraphContext_Release(GraphContext *gc);
+// Acquire an additional reference to an already retrieved GraphContext.
+void GraphContext_Retain(GraphContext *gc);
 // Mark graph key as "dirty" for Redis to pick up on.
 void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc);
 
@@ -81,8 +88,18 @@ int GraphContext_AddIndex(Index **idx, GraphContext *gc, const char *label, cons
 // Remove and free an index
 int GraphContext_DeleteIndex(GraphContext *gc, const char *label, const char *field,
 							 IndexType type);
+// Create an exact-match composite index for the given label over fields[0..count), in key order
+int GraphContext_AddCompositeIndex(Index **idx, GraphContext *gc, const char *label,
+								   const char **fields, uint count);
+// Remove a composite index
+int GraphContext_DeleteCompositeIndex(GraphContext *gc, const char *label, const char **fields,
+									  uint count);
 // Remove a single node from all indices that refer to it
 void GraphContext_DeleteNodeFromIndices(GraphContext *gc, Node *n);
+// Invalidate cached execution plans, following a change to the indices usable by the planner
+void GraphContext_InvalidatePlans(GraphContext *gc);
+// Returns the version cached execution plans are validated against
+uint GraphContext_PlanVersion(const GraphContext *gc);
 
 // Add GraphContext to global array
 void GraphContext_RegisterWithModule(GraphContext *gc);
@@ -102,5 +119,8 @@ SlowLog *GraphContext_GetSlowLog(const GraphContext *gc);
 /* Cache API - Return cache associated with graph context and current thread id. */
 Cache *GraphContext_GetCache(const GraphContext *gc);
 
+/* Compaction API - Schedule a background release of memory held by deleted entities. */
+void GraphContext_ScheduleCompaction(GraphContext *gc);
+
 #endif
 
@@ -0,0 +1,163 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "composite_key.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+#include <string.h>
+
+#define COMPOSITE_KEY_END '\x01'     // Terminates a component, sorts before any component content.
+#define COMPOSITE_KEY_ESCAPE '\x02'  // Prefixes escaped string bytes.
+#define COMPOSITE_KEY_FIELD_PREFIX "__composite__"
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+static void _AppendString(char **buf, const char *s) {
+	for(; *s; s++) {
+		char c = *s;
+		/* Escaped bytes keep their relative order,
+		 * both sort before any byte greater than the escape character. */
+		if(c == COMPOSITE_KEY_END || c == COMPOSITE_KEY_ESCAPE) {
+			*buf = array_append(*buf, COMPOSITE_KEY_ESCAPE);
+			c += COMPOSITE_KEY_ESCAPE;
+		}
+		*buf = array_append(*buf, c);
+	}
+}
+
+static void _AppendNumeric(char **buf, double d) {
+	uint64_t bits;
+	// -0.0 equals 0.0, key them the same.
+	if(d == 0) d = 0;
+	memcpy(&bits, &d, sizeof(bits));
+	/* Flip the sign bit of positive numbers and every bit of negative ones,
+	 * unsigned order of the result matches numeric order. */
+	if(bits >> 63) bits = ~bits;
+	else bits |= (1ULL << 63);
+
+	for(int shift = 60; shift >= 0; shift -= 4) {
+		*buf = array_append(*buf, hex_digits[(bits >> shift) & 0xF]);
+	}
+}
+
+CompositeKey *CompositeKey_New(const char **fields, const Attribute_ID *fields_ids, uint count) {
+	assert(fields && fields_ids && count > 1);
+	CompositeKey *key = rm_malloc(sizeof(CompositeKey));
+	key->fields_count = count;
+	key->fields = array_new(char *, count);
+	key->fields_ids = array_new(Attribute_ID, count);
+
+	// Field name, e.g. __composite__(a,b,c)
+	size_t name_len = strlen(COMPOSITE_KEY_FIELD_PREFIX) + 2;
+	for(uint i = 0; i < count; i++) name_len += strlen(fields[i]) + 1;
+	key->name = rm_malloc(name_len);
+	char *name = key->name + sprintf(key->name, "%s(", COMPOSITE_KEY_FIELD_PREFIX);
+
+	for(uint i = 0; i < count; i++) {
+		key->fields = array_append(key->fields, rm_strdup(fields[i]));
+		key->fields_ids = array_append(key->fields_ids, fields_ids[i]);
+		name += sprintf(name, "%s%c", fields[i], (i + 1 < count) ? ',' : ')');
+	}
+
+	return key;
+}
+
+bool CompositeKey_Equals(const CompositeKey *key, const char **fields, uint count) {
+	assert(key && fields);
+	if(key->fields_count != count) return false;
+	for(uint i = 0; i < count; i++) {
+		if(strcmp(key->fields[i], fields[i]) != 0) return false;
+	}
+	return true;
+}
+
+bool CompositeKey_ContainsAttribute(const CompositeKey *key, Attribute_ID attribute_id) {
+	assert(key);
+	if(attribute_id == ATTRIBUTE_NOTFOUND) return false;
+	for(uint i = 0; i < key->fields_count; i++) {
+		if(key->fields_ids[i] == attribute_id) return true;
+	}
+	return false;
+}
+
+bool CompositeKey_AppendValue(char **buf, SIValue v) {
+	// Types are keyed the same way exact-match indices treat them.
+	if(SI_TYPE(v) == T_STRING) {
+		*buf = array_append(*buf, COMPOSITE_KEY_STRING);
+		_AppendString(buf, v.stringval);
+	} else if(SI_TYPE(v) & (SI_NUMERIC | T_BOOL)) {
+		*buf = array_append(*buf, COMPOSITE_KEY_NUMERIC);
+		_AppendNumeric(buf, SI_GET_NUMERIC(v));
+	} else {
+		return false;
+	}
+
+	*buf = array_append(*buf, COMPOSITE_KEY_END);
+	return true;
+}
+
+void CompositeKey_AppendLowerBound(char **buf, char type, const SIValue *v, bool inclusive) {
+	// Every key of the type extends its prefix.
+	if(v == NULL) {
+		*buf = array_append(*buf, type);
+		return;
+	}
+
+	CompositeKey_AppendValue(buf, *v);
+	// Skip keys extending v, no key continues with COMPOSITE_KEY_MAX.
+	if(!inclusive) *buf = array_append(*buf, COMPOSITE_KEY_MAX);
+}
+
+bool CompositeKey_AppendUpperBound(char **buf, char type, const SIValue *v, bool inclusive) {
+	// Greater than any key of the type, less than keys of the following type.
+	if(v == NULL) {
+		*buf = array_append(*buf, type + 1);
+		return true;
+	}
+
+	CompositeKey_AppendValue(buf, *v);
+	// Keys extending v are greater than v itself.
+	if(inclusive) *buf = array_append(*buf, COMPOSITE_KEY_MAX);
+	return inclusive;
+}
+
+char *CompositeKey_Encode(const CompositeKey *key, const GraphEntity *e) {
+	assert(key && e);
+	char *buf = array_new(char, 32);
+
+	for(uint i = 0; i < key->fields_count; i++) {
+		SIValue *v = GraphEntity_GetProperty(e, key->fields_ids[i]);
+		if(v == PROPERTY_NOTFOUND || !CompositeKey_AppendValue(&buf, *v)) {
+			array_free(buf);
+			return NULL;
+		}
+	}
+
+	uint len = array_len(buf);
+	char *encoded = rm_malloc(len + 1);
+	memcpy(encoded, buf, len);
+	encoded[len] = '\0';
+	array_free(buf);
+	return encoded;
+}
+
+size_t CompositeKey_MemoryUsage(const CompositeKey *key) {
+	assert(key);
+	size_t size = sizeof(CompositeKey) + strlen(key->name) + 1;
+	for(uint i = 0; i < key->fields_count; i++) size += strlen(key->fields[i]) + 1;
+	size += key->fields_count * (sizeof(char *) + sizeof(Attribute_ID));
+	return size;
+}
+
+void CompositeKey_Free(CompositeKey *key) {
+	assert(key);
+	for(uint i = 0; i < key->fields_count; i++) rm_free(key->fields[i]);
+	array_free(key->fields);
+	array_free(key->fields_ids);
+	rm_free(key->name);
+	rm_free(key);
+}
@@ -0,0 +1,68 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../value.h"
+#include "../graph/entities/graph_entity.h"
+
+/* A composite key indexes the values of several properties as a single
+ * string, ordered lexicographically by the first property, then by the
+ * second and so on, such that an equality match on leading properties
+ * followed by a range over the next one maps to a single range of keys.
+ *
+ * Key format:
+ * (type, encoded value, terminator) X number of properties
+ *
+ * type: COMPOSITE_KEY_NUMERIC or COMPOSITE_KEY_STRING.
+ * numeric values: 16 hex digits of the double's bits, transformed such
+ * that their order matches numeric order.
+ * string values: the string itself, escaping bytes that collide with the
+ * terminator or the escape character. */
+
+#define COMPOSITE_KEY_NUMERIC 'n'  // Numeric component prefix.
+#define COMPOSITE_KEY_STRING 's'   // String component prefix.
+#define COMPOSITE_KEY_MAX 't'      // Greater than any component prefix.
+
+typedef struct {
+	char *name;                 // RediSearch field holding the key.
+	char **fields;              // Key properties, in key order.
+	Attribute_ID *fields_ids;   // Key properties IDs.
+	uint fields_count;          // Number of key properties.
+} CompositeKey;
+
+// Create a new composite key over fields[0..count).
+CompositeKey *CompositeKey_New(const char **fields, const Attribute_ID *fields_ids, uint count);
+
+// Returns true if key is made of fields[0..count), in that order.
+bool CompositeKey_Equals(const CompositeKey *key, const char **fields, uint count);
+
+// Returns true if attribute is one of the key's properties.
+bool CompositeKey_ContainsAttribute(const CompositeKey *key, Attribute_ID attribute_id);
+
+// Appends the encoding of v to buf, an arr of chars,
+// returns false if v can't be part of a key.
+bool CompositeKey_AppendValue(char **buf, SIValue v);
+
+// Appends to buf the smallest key whose next component, of given type,
+// is greater than (or equal to, if inclusive) v, any value of the type if v is NULL.
+// The returned bound is inclusive.
+void CompositeKey_AppendLowerBound(char **buf, char type, const SIValue *v, bool inclusive);
+
+// Appends to buf the bound of keys whose next component, of given type,
+// is less than (or equal to, if inclusive) v, any value of the type if v is NULL.
+// Returns true if the bound is inclusive.
+bool CompositeKey_AppendUpperBound(char **buf, char type, const SIValue *v, bool inclusive);
+
+// Returns the key of entity, NULL if one of the key's properties is missing
+// or of a type which can't be keyed. Returned string should be freed by the caller.
+char *CompositeKey_Encode(const CompositeKey *key, const GraphEntity *e);
+
+// Returns the number of bytes held by the key.
+size_t CompositeKey_MemoryUsage(const CompositeKey *key);
+
+// Free key.
+void CompositeKey_Free(CompositeKey *key);
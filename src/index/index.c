@@ -3,9 +3,24 @@
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
+#include "../util/thpool/thpool.h"
 #include "../graph/graphcontext.h"
 #include "../graph/entities/node.h"
 
+#define INDEX_BUILD_THRESHOLD 10000  // Labels up to this size are indexed right away.
+#define INDEX_BUILD_CHUNK 1000       // Number of nodes indexed by a single build step.
+
+extern threadpool _thpool; // Declared in module.c
+
+// State of a background index build.
+typedef struct IndexBuild {
+	Index *idx;                 // Index being built, NULL once the build is cancelled.
+	GraphContext *gc;           // Graph holding the indexed nodes.
+	int label_id;               // Indexed label ID.
+	GrB_Matrix snapshot;        // Label matrix at the time the build started.
+	GxB_MatrixTupleIter *iter;  // Position within the snapshot.
+} IndexBuild;
+
 static int _getNodeAttribute(void *ctx, const char *fieldName, const void *id, char **strVal,
 							 double *doubleVal) {
 	Node n = GE_NEW_NODE();
@@ -63,11 +78,14 @@ static void _populateIndex(Index *idx) {
 Index *Index_New(const char *label, IndexType type) {
 	Index *idx = rm_malloc(sizeof(Index));
 	idx->idx = NULL;
+	idx->build = NULL;
+	idx->state = IDX_BUILDING;
 	idx->fields_count = 0;
 	idx->type = type;
 	idx->label = rm_strdup(label);
 	idx->fields = array_new(char *, 0);
 	idx->fields_ids = array_new(Attribute_ID, 0);
+	idx->composites = array_new(CompositeKey *, 0);
 	return idx;
 }
 
@@ -101,6 +119,50 @@ void Index_RemoveField(Index *idx, const char *field) {
 	}
 }
 
+// Adds composite key to index.
+void Index_AddCompositeKey(Index *idx, const char **fields, uint count) {
+	assert(idx && idx->type == IDX_EXACT_MATCH);
+	if(Index_GetCompositeKey(idx, fields, count)) return;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Attribute_ID fields_ids[count];
+	for(uint i = 0; i < count; i++) fields_ids[i] = GraphContext_FindOrAddAttribute(gc, fields[i]);
+
+	idx->composites = array_append(idx->composites, CompositeKey_New(fields, fields_ids, count));
+}
+
+// Removes composite key from index.
+void Index_RemoveCompositeKey(Index *idx, const char **fields, uint count) {
+	assert(idx);
+	uint composites_count = array_len(idx->composites);
+	for(uint i = 0; i < composites_count; i++) {
+		if(CompositeKey_Equals(idx->composites[i], fields, count)) {
+			CompositeKey_Free(idx->composites[i]);
+			array_del_fast(idx->composites, i);
+			break;
+		}
+	}
+}
+
+const CompositeKey *Index_GetCompositeKey(const Index *idx, const char **fields, uint count) {
+	assert(idx);
+	uint composites_count = array_len(idx->composites);
+	for(uint i = 0; i < composites_count; i++) {
+		if(CompositeKey_Equals(idx->composites[i], fields, count)) return idx->composites[i];
+	}
+	return NULL;
+}
+
+uint Index_CompositeKeysCount(const Index *idx) {
+	assert(idx);
+	return array_len(idx->composites);
+}
+
+const CompositeKey **Index_GetCompositeKeys(const Index *idx) {
+	assert(idx);
+	return (const CompositeKey **)idx->composites;
+}
+
 void Index_IndexNode(Index *idx, const Node *n) {
 	double score = 0;           // Default score.
 	const char *lang = NULL;    // Default language.
@@ -139,6 +201,18 @@ void Index_IndexNode(Index *idx, const Node *n) {
 		}
 	}
 
+	// Add document field for each composite key all of its properties are set for.
+	uint composites_count = array_len(idx->composites);
+	for(uint i = 0; i < composites_count; i++) {
+		const CompositeKey *key = idx->composites[i];
+		char *encoded = CompositeKey_Encode(key, (GraphEntity *)n);
+		if(encoded == NULL) continue;
+
+		doc_field_count++;
+		RediSearch_DocumentAddFieldString(doc, key->name, encoded, strlen(encoded), RSFLDTYPE_TAG);
+		rm_free(encoded);
+	}
+
 	if(doc_field_count > 0) RediSearch_SpecAddDocument(rsIdx, doc);
 	else RediSearch_FreeDocument(doc);
 }
@@ -149,9 +223,21 @@ void Index_RemoveNode(Index *idx, const Node *n) {
 	RediSearch_DeleteDocument(idx->idx, &node_id, sizeof(EntityID));
 }
 
-// Constructs index.
-void Index_Construct(Index *idx) {
-	assert(idx);
+// Detach index from its pending background build, the build is disposed on its next step.
+static void _Index_CancelBuild(Index *idx) {
+	if(idx->build == NULL) return;
+	idx->build->idx = NULL;
+	idx->build = NULL;
+}
+
+static void _Index_SetOnline(Index *idx) {
+	__atomic_store_n(&idx->state, IDX_ONLINE, __ATOMIC_RELEASE);
+}
+
+// Create an empty RediSearch index, dropping the current one if exists.
+static void _Index_CreateRSIndex(Index *idx) {
+	_Index_CancelBuild(idx);
+	__atomic_store_n(&idx->state, IDX_BUILDING, __ATOMIC_RELEASE);
 
 	/* RediSearch index already exists
 	 * re-construct */
@@ -186,10 +272,134 @@ void Index_Construct(Index *idx) {
 			RediSearch_TagFieldSetSeparator(rsIdx, fieldID, '\0');
 			RediSearch_TagFieldSetCaseSensitive(rsIdx, fieldID, 1);
 		}
+
+		// Composite keys are queried by lexicographic ranges, as tags.
+		uint composites_count = array_len(idx->composites);
+		for(uint i = 0; i < composites_count; i++) {
+			RSFieldID fieldID = RediSearch_CreateField(rsIdx, idx->composites[i]->name, RSFLDTYPE_TAG,
+													   RSFLDOPT_NONE);
+			RediSearch_TagFieldSetSeparator(rsIdx, fieldID, '\0');
+			RediSearch_TagFieldSetCaseSensitive(rsIdx, fieldID, 1);
+		}
 	}
 
 	idx->idx = rsIdx;
+}
+
+// Constructs index.
+void Index_Construct(Index *idx) {
+	assert(idx);
+	_Index_CreateRSIndex(idx);
 	_populateIndex(idx);
+	_Index_SetOnline(idx);
+}
+
+static void _IndexBuild_Free(IndexBuild *build) {
+	GxB_MatrixTupleIter_free(build->iter);
+	GrB_Matrix_free(&build->snapshot);
+	// Release reference held by the build.
+	GraphContext_Release(build->gc);
+	rm_free(build);
+}
+
+/* Index up to INDEX_BUILD_CHUNK nodes of the snapshot,
+ * returns true once the snapshot is depleted. */
+static bool _IndexBuild_PopulateChunk(IndexBuild *build) {
+	Node node = GE_NEW_NODE();
+	NodeID node_id;
+	Graph *g = build->gc->g;
+
+	for(uint i = 0; i < INDEX_BUILD_CHUNK; i++) {
+		bool depleted = false;
+		GxB_MatrixTupleIter_next(build->iter, NULL, &node_id, &depleted);
+		if(depleted) return true;
+
+		/* Node might have been deleted since the snapshot was taken,
+		 * its ID possibly reused by a node of a different label. */
+		if(Graph_GetNodeLabel(g, node_id) != build->label_id) continue;
+		Graph_GetNode(g, node_id, &node);
+		Index_IndexNode(build->idx, &node);
+	}
+
+	return false;
+}
+
+/* Build step, executed by a worker thread as a heavy job.
+ * Each step holds Redis GIL and the graph's read lock while indexing a single
+ * chunk, writers are free to update the index in between steps, the job
+ * requeues itself until the snapshot is depleted, such that queued queries
+ * are served in between steps. */
+static void _IndexBuild_Step(void *pdata) {
+	IndexBuild *build = (IndexBuild *)pdata;
+	Graph *g = build->gc->g;
+	bool done = true;
+
+	// Lock order matches that of a writer: GIL, graph's lock.
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	RedisModule_ThreadSafeContextLock(ctx);
+	Graph_AcquireReadLock(g);
+	// Index was dropped or re-constructed since the last step.
+	if(build->idx) {
+		done = _IndexBuild_PopulateChunk(build);
+		if(done) {
+			build->idx->build = NULL;
+			_Index_SetOnline(build->idx);
+			// Plans cached while the index was building do not utilize it.
+			GraphContext_InvalidatePlans(build->gc);
+		}
+	}
+	Graph_ReleaseLock(g);
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	RedisModule_FreeThreadSafeContext(ctx);
+
+	if(!done) {
+		thpool_add_work_lane(_thpool, _IndexBuild_Step, build, THPOOL_LANE_HEAVY, build->gc);
+		return;
+	}
+
+	_IndexBuild_Free(build);
+}
+
+/* Constructs index without populating it within the caller's critical section.
+ * The RediSearch index is created right away, such that writers maintain it
+ * as they would an online index, while nodes present at the time of the call
+ * are indexed in chunks off a snapshot of the label matrix. */
+void Index_ConstructInBackground(Index *idx) {
+	assert(idx);
+	_Index_CreateRSIndex(idx);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
+	GrB_Index nvals = 0;
+	GrB_Matrix label_matrix = NULL;
+	if(s) {
+		label_matrix = Graph_GetLabelMatrix(gc->g, s->id);
+		GrB_Matrix_nvals(&nvals, label_matrix);
+	}
+
+	// Small labels are not worth a background build.
+	if(nvals <= INDEX_BUILD_THRESHOLD) {
+		_populateIndex(idx);
+		_Index_SetOnline(idx);
+		return;
+	}
+
+	IndexBuild *build = rm_malloc(sizeof(IndexBuild));
+	build->idx = idx;
+	build->gc = gc;
+	build->label_id = s->id;
+	GrB_Matrix_dup(&build->snapshot, label_matrix);
+	GxB_MatrixTupleIter_new(&build->iter, build->snapshot);
+	idx->build = build;
+
+	// Graph must outlive the build.
+	GraphContext_Retain(gc);
+	thpool_add_work_lane(_thpool, _IndexBuild_Step, build, THPOOL_LANE_HEAVY, gc);
+}
+
+bool Index_IsOnline(const Index *idx) {
+	assert(idx);
+	return __atomic_load_n(&idx->state, __ATOMIC_ACQUIRE) == IDX_ONLINE;
 }
 
 // Query index.
@@ -226,9 +436,36 @@ bool Index_ContainsAttribute(const Index *idx, Attribute_ID attribute_id) {
 	return false;
 }
 
+bool Index_CoversAttribute(const Index *idx, Attribute_ID attribute_id) {
+	assert(idx);
+	if(Index_ContainsAttribute(idx, attribute_id)) return true;
+
+	uint composites_count = array_len(idx->composites);
+	for(uint i = 0; i < composites_count; i++) {
+		if(CompositeKey_ContainsAttribute(idx->composites[i], attribute_id)) return true;
+	}
+
+	return false;
+}
+
 // Free index.
+size_t Index_MemoryUsage(const Index *idx) {
+	assert(idx);
+	size_t size = sizeof(Index) + strlen(idx->label) + 1;
+	for(uint i = 0; i < idx->fields_count; i++) size += strlen(idx->fields[i]) + 1;
+	size += idx->fields_count * (sizeof(char *) + sizeof(Attribute_ID));
+	uint composites_count = array_len(idx->composites);
+	for(uint i = 0; i < composites_count; i++) {
+		size += sizeof(CompositeKey *) + CompositeKey_MemoryUsage(idx->composites[i]);
+	}
+	// Index is NULL until constructed.
+	if(idx->idx) size += RediSearch_MemUsage(idx->idx);
+	return size;
+}
+
 void Index_Free(Index *idx) {
 	assert(idx);
+	_Index_CancelBuild(idx);
 	if(idx->idx) RediSearch_DropIndex(idx->idx);
 
 	rm_free(idx->label);
@@ -240,6 +477,10 @@ void Index_Free(Index *idx) {
 	array_free(idx->fields);
 	array_free(idx->fields_ids);
 
+	uint composites_count = array_len(idx->composites);
+	for(uint i = 0; i < composites_count; i++) CompositeKey_Free(idx->composites[i]);
+	array_free(idx->composites);
+
 	rm_free(idx);
 }
 
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "composite_key.h"
 #include "../graph/entities/node.h"
 #include "../graph/entities/graph_entity.h"
 #include "redisearch_api.h"
@@ -19,13 +20,21 @@ typedef enum {
 	IDX_FULLTEXT,
 } IndexType;
 
+typedef enum {
+	IDX_BUILDING,   // Index is being populated, ignored by the planner.
+	IDX_ONLINE,     // Index is fully populated.
+} IndexState;
+
 typedef struct {
 	char *label;                // Indexed label.
 	char **fields;              // Indexed fields.
 	Attribute_ID *fields_ids;   // Indexed field IDs.
 	uint fields_count;          // Number of fields.
+	CompositeKey **composites;  // Composite keys, exact-match indices only.
 	RSIndex *idx;               // RediSearch index.
 	IndexType type;             // Index type exact-match / fulltext.
+	IndexState state;           // Index state building / online.
+	struct IndexBuild *build;   // Pending background build, NULL if there's none.
 } Index;
 
 /**
@@ -50,6 +59,46 @@ void Index_AddField(Index *idx, const char *field);
  */
 void Index_RemoveField(Index *idx, const char *field);
 
+/**
+ * @brief  Adds composite key to index.
+ * @param  *idx: Index
+ * @param  **fields: Key fields, in key order.
+ * @param  count: Number of key fields.
+ */
+void Index_AddCompositeKey(Index *idx, const char **fields, uint count);
+
+/**
+ * @brief  Removes composite key from index.
+ * @param  *idx: Index
+ * @param  **fields: Key fields, in key order.
+ * @param  count: Number of key fields.
+ */
+void Index_RemoveCompositeKey(Index *idx, const char **fields, uint count);
+
+/**
+ * @brief  Retrieves composite key made of given fields.
+ * @param  *idx: Index
+ * @param  **fields: Key fields, in key order.
+ * @param  count: Number of key fields.
+ * @retval Composite key, NULL if there's no such key.
+ */
+const CompositeKey *Index_GetCompositeKey(const Index *idx, const char **fields, uint count);
+
+/**
+ * @brief  Returns number of composite keys.
+ * @param  *idx: Index.
+ * @retval Number of composite keys.
+ */
+uint Index_CompositeKeysCount(const Index *idx);
+
+/**
+ * @brief  Returns composite keys.
+ * @note   Returns a shallow copy.
+ * @param  *idx: Index to extract composite keys from.
+ * @retval Array with the composite keys.
+ */
+const CompositeKey **Index_GetCompositeKeys(const Index *idx);
+
 /**
  * @brief  Index node.
  * @param  *idx: Index
@@ -70,6 +119,20 @@ void Index_RemoveNode(Index *idx, const Node *n);
  */
 void Index_Construct(Index *idx);
 
+/**
+ * @brief  Constructs index, populating it on the CRON thread in chunks.
+ * @note   Index is ignored by the planner until it is online.
+ * @param  *idx: Index to construct.
+ */
+void Index_ConstructInBackground(Index *idx);
+
+/**
+ * @brief  Checks if index is fully populated.
+ * @param  *idx: Index.
+ * @retval True if the index is online.
+ */
+bool Index_IsOnline(const Index *idx);
+
 /**
  * @brief  Query an index.
  * @param  *idx: Index.
@@ -109,6 +172,21 @@ const char **Index_GetFields(const Index *idx);
  */
 bool Index_ContainsAttribute(const Index *idx, Attribute_ID attribute_id);
 
+/**
+ * @brief  Checks if given attribute is indexed, either as a field or as part of a composite key.
+ * @param  *idx: Index to perform the check.
+ * @param  attribute_id: Attribute id to search.
+ * @retval True if updating the attribute requires reindexing.
+ */
+bool Index_CoversAttribute(const Index *idx, Attribute_ID attribute_id);
+
+/**
+ * @brief  Returns the number of bytes held by the index.
+ * @param  *idx: Index.
+ * @retval Index's memory usage in bytes, including its RediSearch index.
+ */
+size_t Index_MemoryUsage(const Index *idx);
+
 /**
  * @brief  Free fulltext index.
  * @param  *idx: Index to drop.
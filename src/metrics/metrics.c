@@ -0,0 +1,308 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "metrics.h"
+#include "../RG.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+#include <strings.h>
+
+#define METRICS_SHARDS 8        // Number of counter shards.
+#define METRICS_CACHE_LINE 64
+
+// Counters of a single command.
+typedef struct {
+	uint64_t queries;           // Number of queries issued.
+	uint64_t errors;            // Number of queries which emitted an error.
+	uint64_t rows;              // Number of records returned.
+	uint64_t cache_hits;        // Number of queries executed by a cached plan.
+	uint64_t cache_misses;      // Number of queries which required planning.
+} CommandCounters;
+
+// Counters updated by a subset of threads, aligned to avoid false sharing.
+typedef struct {
+	CommandCounters commands[METRIC_COMMAND_COUNT];
+	uint64_t matrix_syncs;      // Number of matrix synchronizations.
+	uint64_t matrix_sync_time;  // Time spent synchronizing matrices, in microseconds.
+} __attribute__((aligned(METRICS_CACHE_LINE))) MetricsShard;
+
+struct Metrics {
+	MetricsShard shards[METRICS_SHARDS];
+	Histogram stages[METRIC_COMMAND_COUNT][METRIC_STAGE_COUNT];  // Stage durations, in microseconds.
+};
+
+static const char *_command_names[METRIC_COMMAND_COUNT] = {
+	[METRIC_COMMAND_QUERY] = "query",
+	[METRIC_COMMAND_RO_QUERY] = "ro_query",
+	[METRIC_COMMAND_EXECUTE] = "execute",
+	[METRIC_COMMAND_BATCH] = "batch",
+};
+
+static const char *_stage_names[METRIC_STAGE_COUNT] = {
+	[METRIC_STAGE_QUEUE] = "queue",
+	[METRIC_STAGE_PARSE] = "parse",
+	[METRIC_STAGE_PLAN] = "plan",
+	[METRIC_STAGE_LOCK] = "lock",
+	[METRIC_STAGE_EXECUTE] = "execute",
+	[METRIC_STAGE_REPLY] = "reply",
+	[METRIC_STAGE_TOTAL] = "total",
+};
+
+static Metrics *_global = NULL;
+
+// Shard assigned to the calling thread, threads are assigned shards round robin.
+static __thread int _shard = -1;
+static uint _next_shard = 0;
+
+static inline MetricsShard *_Metrics_Shard(Metrics *m) {
+	if(_shard == -1) _shard = __atomic_fetch_add(&_next_shard, 1, __ATOMIC_RELAXED) % METRICS_SHARDS;
+	return &m->shards[_shard];
+}
+
+static inline void _Metrics_Add(uint64_t *counter, uint64_t v) {
+	__atomic_fetch_add(counter, v, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t _Metrics_Load(const uint64_t *counter) {
+	return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t _Metrics_ToMicroseconds(double ms) {
+	return (ms > 0) ? (uint64_t)(ms * 1000) : 0;
+}
+
+static inline double _Metrics_ToMilliseconds(uint64_t us) {
+	return us / 1000.0;
+}
+
+static int _Metrics_CommandFromName(const char *name) {
+	// Command names are prefixed by the module name, e.g. graph.QUERY.
+	const char *dot = strchr(name, '.');
+	if(dot) name = dot + 1;
+	for(int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+		if(strcasecmp(name, _command_names[i]) == 0) return i;
+	}
+	return -1;
+}
+
+// Sum command counters across shards.
+static CommandCounters _Metrics_CommandTotals(const Metrics *m, int command) {
+	CommandCounters totals = {0};
+	for(int i = 0; i < METRICS_SHARDS; i++) {
+		const CommandCounters *c = &m->shards[i].commands[command];
+		totals.queries += _Metrics_Load(&c->queries);
+		totals.errors += _Metrics_Load(&c->errors);
+		totals.rows += _Metrics_Load(&c->rows);
+		totals.cache_hits += _Metrics_Load(&c->cache_hits);
+		totals.cache_misses += _Metrics_Load(&c->cache_misses);
+	}
+	return totals;
+}
+
+static CommandCounters _Metrics_Totals(const Metrics *m) {
+	CommandCounters totals = {0};
+	for(int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+		CommandCounters c = _Metrics_CommandTotals(m, i);
+		totals.queries += c.queries;
+		totals.errors += c.errors;
+		totals.rows += c.rows;
+		totals.cache_hits += c.cache_hits;
+		totals.cache_misses += c.cache_misses;
+	}
+	return totals;
+}
+
+// Merge a stage's histograms across commands.
+static void _Metrics_StageTotals(const Metrics *m, int stage, Histogram *h) {
+	memset(h, 0, sizeof(Histogram));
+	for(int i = 0; i < METRIC_COMMAND_COUNT; i++) Histogram_Merge(h, &m->stages[i][stage]);
+}
+
+Metrics *Metrics_New(void) {
+	return rm_calloc(1, sizeof(Metrics));
+}
+
+void Metrics_RecordQuery(Metrics *m, const char *command, const QueryMetrics *qm) {
+	ASSERT(m && command && qm);
+	int cmd = _Metrics_CommandFromName(command);
+	if(cmd == -1) return;
+
+	CommandCounters *c = &_Metrics_Shard(m)->commands[cmd];
+	_Metrics_Add(&c->queries, 1);
+	_Metrics_Add(&c->rows, qm->rows);
+	if(qm->failed) _Metrics_Add(&c->errors, 1);
+	if(qm->cached) _Metrics_Add(&c->cache_hits, 1);
+	else _Metrics_Add(&c->cache_misses, 1);
+
+	for(int i = 0; i < METRIC_STAGE_COUNT; i++) {
+		Histogram_Record(&m->stages[cmd][i], _Metrics_ToMicroseconds(qm->stages[i]));
+	}
+}
+
+void Metrics_RecordMatrixSync(Metrics *m, double ms) {
+	if(!m) return;
+	MetricsShard *shard = _Metrics_Shard(m);
+	_Metrics_Add(&shard->matrix_syncs, 1);
+	_Metrics_Add(&shard->matrix_sync_time, _Metrics_ToMicroseconds(ms));
+}
+
+void Metrics_Reset(Metrics *m) {
+	ASSERT(m);
+	for(int i = 0; i < METRICS_SHARDS; i++) {
+		MetricsShard *shard = &m->shards[i];
+		for(int j = 0; j < METRIC_COMMAND_COUNT; j++) {
+			CommandCounters *c = &shard->commands[j];
+			__atomic_store_n(&c->queries, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&c->errors, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&c->rows, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&c->cache_hits, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&c->cache_misses, 0, __ATOMIC_RELAXED);
+		}
+		__atomic_store_n(&shard->matrix_syncs, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&shard->matrix_sync_time, 0, __ATOMIC_RELAXED);
+	}
+
+	for(int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+		for(int j = 0; j < METRIC_STAGE_COUNT; j++) Histogram_Reset(&m->stages[i][j]);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Reporting
+//------------------------------------------------------------------------------
+
+static inline void _ReplyName(RedisModuleCtx *ctx, const char *name) {
+	RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name));
+}
+
+static void _ReplyCount(RedisModuleCtx *ctx, const char *name, uint64_t count) {
+	_ReplyName(ctx, name);
+	RedisModule_ReplyWithLongLong(ctx, count);
+}
+
+static void _ReplyDuration(RedisModuleCtx *ctx, const char *name, uint64_t us) {
+	_ReplyName(ctx, name);
+	RedisModule_ReplyWithDouble(ctx, _Metrics_ToMilliseconds(us));
+}
+
+static void _ReplyCounters(RedisModuleCtx *ctx, const CommandCounters *c) {
+	_ReplyCount(ctx, "queries", c->queries);
+	_ReplyCount(ctx, "errors", c->errors);
+	_ReplyCount(ctx, "rows_returned", c->rows);
+	_ReplyCount(ctx, "plan_cache_hits", c->cache_hits);
+	_ReplyCount(ctx, "plan_cache_misses", c->cache_misses);
+}
+
+static void _ReplyHistogram(RedisModuleCtx *ctx, const Histogram *h) {
+	RedisModule_ReplyWithArray(ctx, 7 * 2);
+	_ReplyCount(ctx, "count", Histogram_Count(h));
+	_ReplyName(ctx, "mean_ms");
+	RedisModule_ReplyWithDouble(ctx, Histogram_Mean(h) / 1000.0);
+	_ReplyDuration(ctx, "p50_ms", Histogram_Percentile(h, 50));
+	_ReplyDuration(ctx, "p90_ms", Histogram_Percentile(h, 90));
+	_ReplyDuration(ctx, "p99_ms", Histogram_Percentile(h, 99));
+	_ReplyDuration(ctx, "p999_ms", Histogram_Percentile(h, 99.9));
+	_ReplyDuration(ctx, "max_ms", Histogram_Max(h));
+}
+
+static void _ReplyStages(RedisModuleCtx *ctx, const Histogram *stages) {
+	RedisModule_ReplyWithArray(ctx, METRIC_STAGE_COUNT * 2);
+	for(int i = 0; i < METRIC_STAGE_COUNT; i++) {
+		_ReplyName(ctx, _stage_names[i]);
+		_ReplyHistogram(ctx, &stages[i]);
+	}
+}
+
+void Metrics_Reply(RedisModuleCtx *ctx, Metrics *m) {
+	ASSERT(m);
+	RedisModule_ReplyWithArray(ctx, 7 * 2);
+
+	CommandCounters totals = _Metrics_Totals(m);
+	_ReplyCounters(ctx, &totals);
+
+	// Per command counters and stage durations.
+	_ReplyName(ctx, "commands");
+	RedisModule_ReplyWithArray(ctx, METRIC_COMMAND_COUNT * 2);
+	for(int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+		CommandCounters c = _Metrics_CommandTotals(m, i);
+		_ReplyName(ctx, _command_names[i]);
+		RedisModule_ReplyWithArray(ctx, 6 * 2);
+		_ReplyCounters(ctx, &c);
+		_ReplyName(ctx, "stages");
+		_ReplyStages(ctx, m->stages[i]);
+	}
+
+	// Stage durations across all commands.
+	Histogram stages[METRIC_STAGE_COUNT];
+	for(int i = 0; i < METRIC_STAGE_COUNT; i++) _Metrics_StageTotals(m, i, &stages[i]);
+	_ReplyName(ctx, "stages");
+	_ReplyStages(ctx, stages);
+}
+
+void Metrics_Info(RedisModuleInfoCtx *ctx, Metrics *m) {
+	ASSERT(m);
+	uint64_t matrix_syncs = 0;
+	uint64_t matrix_sync_time = 0;
+	for(int i = 0; i < METRICS_SHARDS; i++) {
+		matrix_syncs += _Metrics_Load(&m->shards[i].matrix_syncs);
+		matrix_sync_time += _Metrics_Load(&m->shards[i].matrix_sync_time);
+	}
+
+	CommandCounters totals = _Metrics_Totals(m);
+	RedisModule_InfoAddFieldULongLong(ctx, "queries", totals.queries);
+	RedisModule_InfoAddFieldULongLong(ctx, "errors", totals.errors);
+	RedisModule_InfoAddFieldULongLong(ctx, "rows_returned", totals.rows);
+	RedisModule_InfoAddFieldULongLong(ctx, "plan_cache_hits", totals.cache_hits);
+	RedisModule_InfoAddFieldULongLong(ctx, "plan_cache_misses", totals.cache_misses);
+	RedisModule_InfoAddFieldULongLong(ctx, "matrix_syncs", matrix_syncs);
+	RedisModule_InfoAddFieldDouble(ctx, "matrix_sync_time_ms",
+								   _Metrics_ToMilliseconds(matrix_sync_time));
+
+	char field[64];
+	for(int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+		CommandCounters c = _Metrics_CommandTotals(m, i);
+		const Histogram *latency = &m->stages[i][METRIC_STAGE_TOTAL];
+		snprintf(field, sizeof(field), "command_%s", _command_names[i]);
+		RedisModule_InfoBeginDictField(ctx, field);
+		RedisModule_InfoAddFieldULongLong(ctx, "queries", c.queries);
+		RedisModule_InfoAddFieldULongLong(ctx, "errors", c.errors);
+		RedisModule_InfoAddFieldDouble(ctx, "p50_ms",
+									   _Metrics_ToMilliseconds(Histogram_Percentile(latency, 50)));
+		RedisModule_InfoAddFieldDouble(ctx, "p99_ms",
+									   _Metrics_ToMilliseconds(Histogram_Percentile(latency, 99)));
+		RedisModule_InfoAddFieldDouble(ctx, "max_ms",
+									   _Metrics_ToMilliseconds(Histogram_Max(latency)));
+		RedisModule_InfoEndDictField(ctx);
+	}
+
+	Histogram h;
+	for(int i = 0; i < METRIC_STAGE_COUNT; i++) {
+		_Metrics_StageTotals(m, i, &h);
+		snprintf(field, sizeof(field), "stage_%s", _stage_names[i]);
+		RedisModule_InfoBeginDictField(ctx, field);
+		RedisModule_InfoAddFieldULongLong(ctx, "count", Histogram_Count(&h));
+		RedisModule_InfoAddFieldDouble(ctx, "mean_ms", Histogram_Mean(&h) / 1000.0);
+		RedisModule_InfoAddFieldDouble(ctx, "p50_ms",
+									   _Metrics_ToMilliseconds(Histogram_Percentile(&h, 50)));
+		RedisModule_InfoAddFieldDouble(ctx, "p99_ms",
+									   _Metrics_ToMilliseconds(Histogram_Percentile(&h, 99)));
+		RedisModule_InfoAddFieldDouble(ctx, "max_ms", _Metrics_ToMilliseconds(Histogram_Max(&h)));
+		RedisModule_InfoEndDictField(ctx);
+	}
+}
+
+void Metrics_Free(Metrics *m) {
+	rm_free(m);
+}
+
+Metrics *Metrics_Global(void) {
+	return _global;
+}
+
+void Metrics_InitGlobal(void) {
+	ASSERT(_global == NULL);
+	_global = Metrics_New();
+}
@@ -0,0 +1,77 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../redismodule.h"
+#include "../util/histogram.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Runtime metrics, kept for each graph and for the module as a whole:
+ * per command counters and, for each stage of query processing,
+ * latency histograms. Counters are sharded by thread and histograms
+ * are updated atomically, recording never blocks.
+ * Exposed through GRAPH.STATS and the module's INFO section. */
+
+// Commands metrics are kept for.
+typedef enum {
+	METRIC_COMMAND_QUERY,
+	METRIC_COMMAND_RO_QUERY,
+	METRIC_COMMAND_EXECUTE,
+	METRIC_COMMAND_BATCH,
+	METRIC_COMMAND_COUNT
+} MetricCommand;
+
+// Stages of query processing.
+typedef enum {
+	METRIC_STAGE_QUEUE,         // Waiting for a worker thread.
+	METRIC_STAGE_PARSE,         // Parsing and validating the query.
+	METRIC_STAGE_PLAN,          // Constructing, or cloning a cached, execution plan.
+	METRIC_STAGE_LOCK,          // Waiting for the graph's locks.
+	METRIC_STAGE_EXECUTE,       // Evaluating the execution plan.
+	METRIC_STAGE_REPLY,         // Serializing the result set.
+	METRIC_STAGE_TOTAL,         // End to end, queue wait excluded.
+	METRIC_STAGE_COUNT
+} MetricStage;
+
+// Measurements of a single query.
+typedef struct {
+	double stages[METRIC_STAGE_COUNT];  // Milliseconds spent in each stage.
+	uint64_t rows;                      // Number of records returned.
+	bool cached;                        // Whether the execution plan was cached.
+	bool failed;                        // Whether the query emitted an error.
+} QueryMetrics;
+
+typedef struct Metrics Metrics;
+
+// Create a new metrics collection.
+Metrics *Metrics_New(void);
+
+// Record query issued through command, commands metrics aren't kept for are ignored.
+void Metrics_RecordQuery(Metrics *m, const char *command, const QueryMetrics *qm);
+
+// Record a synchronization of a matrix's pending changes,
+// matrices are unaware of their graph, these are kept module wide.
+void Metrics_RecordMatrixSync(Metrics *m, double ms);
+
+// Discard all recorded metrics.
+void Metrics_Reset(Metrics *m);
+
+// Reply with query metrics as name, value pairs.
+void Metrics_Reply(RedisModuleCtx *ctx, Metrics *m);
+
+// Add metrics to an INFO section.
+void Metrics_Info(RedisModuleInfoCtx *ctx, Metrics *m);
+
+// Free metrics collection.
+void Metrics_Free(Metrics *m);
+
+// Module wide metrics, covering all graphs, NULL until initialized.
+Metrics *Metrics_Global(void);
+
+// Initialize module wide metrics.
+void Metrics_InitGlobal(void);
@@ -16,6 +16,7 @@
 #include "arithmetic/funcs.h"
 #include "commands/commands.h"
 #include "util/thpool/thpool.h"
+#include "util/thread_budget.h"
 #include "graph/graphcontext.h"
 #include "ast/cypher_whitelist.h"
 #include "arithmetic/agg_funcs.h"
@@ -26,6 +27,7 @@
 #include "serializers/graphmeta_type.h"
 #include "redisearch_api.h"
 #include "util/redis_version.h"
+#include "metrics/metrics.h"
 
 //------------------------------------------------------------------------------
 // Minimal supported Redis version
@@ -57,6 +59,13 @@ static int _Setup_ThreadPOOL(int threadCount) {
 	_thpool = thpool_init(threadCount);
 	if(_thpool == NULL) return 0;
 
+	// Set each lane's share of the pool.
+	int weights[THPOOL_LANE_COUNT];
+	weights[THPOOL_LANE_READ] = Config_GetReadLaneWeight();
+	weights[THPOOL_LANE_WRITE] = Config_GetWriteLaneWeight();
+	weights[THPOOL_LANE_HEAVY] = Config_GetHeavyLaneWeight();
+	thpool_set_lane_weights(_thpool, weights);
+
 	return 1;
 }
 
@@ -73,6 +82,13 @@ static int _RegisterDataTypes(RedisModuleCtx *ctx) {
 	return REDISMODULE_OK;
 }
 
+// Report module wide metrics as part of INFO.
+static void _InfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
+	if(!Metrics_Global()) return;
+	RedisModule_InfoAddSection(ctx, "metrics");
+	Metrics_Info(ctx, Metrics_Global());
+}
+
 static void _PrepareModuleGlobals(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	graphs_in_keyspace = array_new(GraphContext *, 1);
 	process_is_child = false;
@@ -135,6 +151,11 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 	}
 	RedisModule_Log(ctx, "notice", "Maximum number of OpenMP threads set to %d", ompThreadCount);
 
+	// Share OpenMP threads among queries running on the thread pool.
+	ThreadBudget_Init(ompThreadCount, _thpool);
+
+	Metrics_InitGlobal();
+
 	if(_RegisterDataTypes(ctx) != REDISMODULE_OK) return REDISMODULE_ERR;
 
 	if(RedisModule_CreateCommand(ctx, "graph.QUERY", CommandDispatch, "write deny-oom", 1, 1,
@@ -167,11 +188,54 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.EFFECT", MGraph_Effect, "write deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.SLOWLOG", CommandDispatch, "readonly", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.REORDER", CommandDispatch, "write", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.MEMORY", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.BATCH", CommandDispatch, "write deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.PREPARE", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.EXECUTE", CommandDispatch, "write deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.DEALLOCATE", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.STATS", MGraph_Stats, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	// Report module wide metrics under INFO, available as of Redis 6.0.
+	if(RedisModule_RegisterInfoFunc) RedisModule_RegisterInfoFunc(ctx, _InfoFunc);
+
 	setupCrashHandlers(ctx);
 
 	return REDISMODULE_OK;
@@ -9,12 +9,16 @@
 #include "util/simple_timer.h"
 #include "arithmetic/arithmetic_expression.h"
 #include "serializers/graphcontext_type.h"
+#include "commands/group_commit.h"
+#include "config.h"
 
 // GraphContext type as it is registered at Redis.
 extern RedisModuleType *GraphContextRedisModuleType;
 
 pthread_key_t _tlsQueryCtxKey;  // Thread local storage query context key.
 
+#define QUERY_ARENA_BLOCK_SIZE 4096 // Size of a query arena block.
+
 static inline QueryCtx *_QueryCtx_GetCtx(void) {
 	QueryCtx *ctx = pthread_getspecific(_tlsQueryCtxKey);
 	if(!ctx) {
@@ -78,6 +82,7 @@ void QueryCtx_SetGlobalExecutionCtx(CommandCtx *cmd_ctx) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	ctx->gc = CommandCtx_GetGraphContext(cmd_ctx);
 	ctx->query_data.query = CommandCtx_GetQuery(cmd_ctx);
+	ctx->query_data.prepared = (cmd_ctx->params != NULL);
 	ctx->global_exec_ctx.bc = CommandCtx_GetBlockingClient(cmd_ctx);
 	ctx->global_exec_ctx.redis_ctx = CommandCtx_GetRedisCtx(cmd_ctx);
 	ctx->global_exec_ctx.command_name = CommandCtx_GetCommandName(cmd_ctx);
@@ -152,22 +157,103 @@ ResultSetStatistics *QueryCtx_GetResultSetStatistics(void) {
 	return &ctx->internal_exec_ctx.result_set->stats;
 }
 
+QueryMetrics *QueryCtx_GetMetrics(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return &ctx->internal_exec_ctx.metrics;
+}
+
+Arena *QueryCtx_GetArena(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(!ctx->internal_exec_ctx.arena) {
+		ctx->internal_exec_ctx.arena = Arena_New(QUERY_ARENA_BLOCK_SIZE);
+	}
+	return ctx->internal_exec_ctx.arena;
+}
+
+EffectsBuffer *QueryCtx_GetEffectsBuffer(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(!Config_GetReplicateEffects() && !ctx->query_data.prepared) return NULL;
+	if(!ctx->internal_exec_ctx.effects) {
+		ctx->internal_exec_ctx.effects = EffectsBuffer_New(ctx->gc);
+	}
+	return ctx->internal_exec_ctx.effects;
+}
+
+void *rm_query_malloc(size_t n) {
+	return Arena_Alloc(QueryCtx_GetArena(), n);
+}
+
+void *rm_query_calloc(size_t nelem, size_t elemsz) {
+	return Arena_Calloc(QueryCtx_GetArena(), nelem, elemsz);
+}
+
+char *rm_query_strdup(const char *s) {
+	return Arena_Strdup(QueryCtx_GetArena(), s);
+}
+
 void QueryCtx_PrintQuery(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	printf("%s\n", ctx->query_data.query);
 }
 
+/* A group commit holds the GIL and the graph's write lock throughout its
+ * commit section, on behalf of its queries.
+ * Batched statements have no client of their own. */
 static void _QueryCtx_ThreadSafeContextLock(QueryCtx *ctx) {
+	if(GroupCommit_InProgress()) return;
 	if(ctx->global_exec_ctx.bc) RedisModule_ThreadSafeContextLock(ctx->global_exec_ctx.redis_ctx);
 }
 
 static void _QueryCtx_ThreadSafeContextUnlock(QueryCtx *ctx) {
+	if(GroupCommit_InProgress()) return;
 	if(ctx->global_exec_ctx.bc) RedisModule_ThreadSafeContextUnlock(ctx->global_exec_ctx.redis_ctx);
 }
 
+static void _QueryCtx_AcquireWriteLock(QueryCtx *ctx) {
+	if(GroupCommit_InProgress()) return;
+	Graph_AcquireWriteLock(ctx->gc->g);
+}
+
+static void _QueryCtx_ReleaseLock(QueryCtx *ctx) {
+	if(GroupCommit_InProgress()) return;
+	Graph_ReleaseLock(ctx->gc->g);
+}
+
+// Replicate query if it modified the graph.
+// Recorded effects are replicated in place of the query, changes which aren't
+// recorded as effects, e.g. index creation, are replicated by the query itself.
+static void _QueryCtx_Replicate(QueryCtx *ctx) {
+	// Replicate only in case of changes.
+	if(!ResultSetStat_IndicateModification(ctx->internal_exec_ctx.result_set->stats)) return;
+
+	const char *command_name = ctx->global_exec_ctx.command_name;
+	const char *payload = ctx->query_data.query;
+	size_t len = strlen(payload);
+	EffectsBuffer *effects = ctx->internal_exec_ctx.effects;
+	if(effects && EffectsBuffer_RecordCount(effects) > 0) {
+		command_name = "GRAPH.EFFECT";
+		payload = EffectsBuffer_Data(effects, &len);
+	} else if(ctx->query_data.prepared) {
+		// A prepared statement's parameters can't be replicated alongside its query,
+		// all of its changes are recorded as effects.
+		return;
+	}
+
+	// Queries of a group are replicated together, within a single MULTI/EXEC block.
+	if(GroupCommit_InProgress()) {
+		GroupCommit_Replicate(command_name, ctx->gc->graph_name, payload, len);
+		return;
+	}
+
+	RedisModule_Replicate(ctx->global_exec_ctx.redis_ctx, command_name, "cb!",
+						  ctx->gc->graph_name, payload, len);
+}
+
 bool QueryCtx_LockForCommit(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	if(ctx->internal_exec_ctx.locked_for_commit) return true;
+	double timer[2];
+	simple_tic(timer);
 	// Lock GIL.
 	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
 	GraphContext *gc = ctx->gc;
@@ -192,8 +278,9 @@ bool QueryCtx_LockForCommit(void) {
 	}
 	ctx->internal_exec_ctx.key = key;
 	// Acquire graph write lock.
-	Graph_AcquireWriteLock(gc->g);
+	_QueryCtx_AcquireWriteLock(ctx);
 	ctx->internal_exec_ctx.locked_for_commit = true;
+	ctx->internal_exec_ctx.metrics.stages[METRIC_STAGE_LOCK] += simple_toc(timer) * 1000;
 
 	return true;
 
@@ -213,15 +300,10 @@ void QueryCtx_UnlockCommit(OpBase *writer_op) {
 	// Check that the writer_op is entitled to release the lock.
 	if(ctx->internal_exec_ctx.last_writer != writer_op) return;
 	if(!ctx->internal_exec_ctx.locked_for_commit) return;
-	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
-	GraphContext *gc = ctx->gc;
-	if(ResultSetStat_IndicateModification(ctx->internal_exec_ctx.result_set->stats))
-		// Replicate only in case of changes.
-		RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name, "cc!", gc->graph_name,
-							  ctx->query_data.query);
+	_QueryCtx_Replicate(ctx);
 	ctx->internal_exec_ctx.locked_for_commit = false;
 	// Release graph R/W lock.
-	Graph_ReleaseLock(gc->g);
+	_QueryCtx_ReleaseLock(ctx);
 	// Close Key.
 	RedisModule_CloseKey(ctx->internal_exec_ctx.key);
 	// Unlock GIL.
@@ -232,17 +314,13 @@ void QueryCtx_ForceUnlockCommit() {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	if(!ctx->internal_exec_ctx.locked_for_commit) return;
 	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
-	GraphContext *gc = ctx->gc;
 	RedisModule_Log(redis_ctx, "warning",
 					"RedisGraph used forced unlocking commit flow for the query %s",
 					ctx->query_data.query);
-	if(ResultSetStat_IndicateModification(ctx->internal_exec_ctx.result_set->stats))
-		// Replicate only in case of changes.
-		RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name, "cc!", gc->graph_name,
-							  ctx->query_data.query);
+	_QueryCtx_Replicate(ctx);
 	ctx->internal_exec_ctx.locked_for_commit = false;
 	// Release graph R/W lock.
-	Graph_ReleaseLock(gc->g);
+	_QueryCtx_ReleaseLock(ctx);
 	// Close Key.
 	RedisModule_CloseKey(ctx->internal_exec_ctx.key);
 	// Unlock GIL.
@@ -277,7 +355,28 @@ void QueryCtx_Free(void) {
 		ctx->query_data.params = NULL;
 	}
 
+	if(ctx->internal_exec_ctx.arena) {
+		Arena_Free(ctx->internal_exec_ctx.arena);
+		ctx->internal_exec_ctx.arena = NULL;
+	}
+
+	if(ctx->internal_exec_ctx.effects) {
+		EffectsBuffer_Free(ctx->internal_exec_ctx.effects);
+		ctx->internal_exec_ctx.effects = NULL;
+	}
+
 	rm_free(ctx);
 	// NULL-set the context for reuse the next time this thread receives a query
 	pthread_setspecific(_tlsQueryCtxKey, NULL);
 }
+
+QueryCtx *QueryCtx_Detach(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	pthread_setspecific(_tlsQueryCtxKey, NULL);
+	return ctx;
+}
+
+void QueryCtx_Attach(QueryCtx *ctx) {
+	ASSERT(ctx && pthread_getspecific(_tlsQueryCtxKey) == NULL);
+	pthread_setspecific(_tlsQueryCtxKey, ctx);
+}
@@ -8,6 +8,7 @@
 
 #include "ast/ast.h"
 #include "redismodule.h"
+#include "util/arena.h"
 #include "util/rmalloc.h"
 #include "graph/graphcontext.h"
 #include <setjmp.h>
@@ -15,6 +16,7 @@
 #include "commands/cmd_context.h"
 #include "resultset/resultset.h"
 #include "execution_plan/ops/op.h"
+#include "effects/effects.h"
 
 extern pthread_key_t _tlsQueryCtxKey;  // Thread local storage query context key.
 
@@ -22,6 +24,7 @@ typedef struct {
 	AST *ast;       // The scoped AST associated with this query.
 	rax *params;    // Query parameters.
 	const char *query;    // Query string.
+	bool prepared;        // Parameters are bound in binary, changes replicate as effects alone.
 } QueryCtx_QueryData;
 
 typedef struct {
@@ -32,6 +35,9 @@ typedef struct {
 	ResultSet *result_set;      // Save the execution result set.
 	bool locked_for_commit;     // Indicates if a call for QueryCtx_LockForCommit issued before.
 	OpBase *last_writer;        // The last writer operation which indicates the need for commit.
+	Arena *arena;               // Transient allocations released once the query is done.
+	EffectsBuffer *effects;     // Changes committed by this query, replicated in place of the query.
+	QueryMetrics metrics;       // Time spent in each stage of the query.
 } QueryCtx_InternalExecCtx;
 
 typedef struct {
@@ -98,6 +104,30 @@ ResultSet *QueryCtx_GetResultSet(void);
 /* Retrive the resultset statistics. */
 ResultSetStatistics *QueryCtx_GetResultSetStatistics(void);
 
+/* Retrieve the buffer recording the query's committed changes, created on first use.
+ * Returns NULL if write queries are replicated verbatim. */
+EffectsBuffer *QueryCtx_GetEffectsBuffer(void);
+
+/* Retrieve the query's stage measurements. */
+QueryMetrics *QueryCtx_GetMetrics(void);
+
+/* Retrieve the query's arena, created on first use. */
+Arena *QueryCtx_GetArena(void);
+
+/* Query scoped allocations, all released at once by QueryCtx_Free.
+ * Memory obtained here must not be passed to rm_free nor outlive the query,
+ * values which escape into the graph (SET/CREATE) are cloned to the heap.
+ *
+ * Records are not served from the arena: they are recycled by the plan's
+ * record pool, and a timed out plan is freed by the timer thread,
+ * possibly after QueryCtx_Free.
+ * Persisted SIValues are not served from the arena either: persisted strings
+ * are ref-counted and may be retained by graph properties, and every
+ * persisted value is released individually through SIValue_Free. */
+void *rm_query_malloc(size_t n);
+void *rm_query_calloc(size_t nelem, size_t elemsz);
+char *rm_query_strdup(const char *s);
+
 /* Print the current query. */
 void QueryCtx_PrintQuery(void);
 
@@ -110,7 +140,8 @@ void QueryCtx_PrintQuery(void);
  * locks in this call or a previous call. In case that the locks are already locked, there will
  * be no attempt to lock them again.
  * This method returns false if the key has changed from the current graph,
- * and sets the relevant error message. */
+ * and sets the relevant error message.
+ * Queries of a group commit skip steps 1 and 3, the group holds both locks. */
 bool QueryCtx_LockForCommit(void);
 
 /* Starts an ulocking flow and notifies Redis after commiting changes in the graph and Redis keyspace.
@@ -118,10 +149,11 @@ bool QueryCtx_LockForCommit(void);
  * The method get an OpBase and compares it to the last writer, if they are equal then the commit
  * and unlock flow will start.
  * Unlocking flow is:
- * 1. Replicate.
+ * 1. Replicate, as a GRAPH.EFFECT command if the query's effects were recorded.
  * 2. Unlock graph R/W lock
  * 3. Close key
- * 4. Unlock GIL */
+ * 4. Unlock GIL
+ * Queries of a group commit skip steps 2 and 4, and replicate through the group. */
 void QueryCtx_UnlockCommit(OpBase *writer_op);
 
 /*
@@ -137,4 +169,9 @@ double QueryCtx_GetExecutionTime(void);
 bool QueryCtx_EncounteredError(void);
 /* Free the allocations within the QueryCtx and reset it for the next query. */
 void QueryCtx_Free(void);
+/* Detach the calling thread's QueryCtx, the thread's next query gets a new context.
+ * Used by a group commit, which plans all of its queries ahead of executing them. */
+QueryCtx *QueryCtx_Detach(void);
+/* Attach a detached QueryCtx to the calling thread, which must have none. */
+void QueryCtx_Attach(QueryCtx *ctx);
 
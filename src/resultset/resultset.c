@@ -9,12 +9,13 @@
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
+#include "../util/thpool/thpool.h"
 #include "../grouping/group_cache.h"
 #include "../arithmetic/aggregate.h"
 
 static void _ResultSet_ReplayStats(RedisModuleCtx *ctx, ResultSet *set) {
 	char buff[512] = {0};
-	size_t resultset_size = 2; /* query execution time and cached execution. */
+	size_t resultset_size = 3; /* query execution time, queue wait time and cached execution. */
 	int buflen;
 
 	if(set->stats.labels_added > 0) resultset_size++;
@@ -71,6 +72,10 @@ static void _ResultSet_ReplayStats(RedisModuleCtx *ctx, ResultSet *set) {
 	buflen = sprintf(buff, "Cached execution: %d", set->stats.cached ? 1 : 0);
 	RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
 
+	// Emit time spent waiting for a thread.
+	buflen = sprintf(buff, "Query queue wait time: %.6f milliseconds", thpool_job_wait_time());
+	RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
+
 	// Emit query execution time.
 	ResultSet_ReportQueryRuntime(ctx);
 }
@@ -34,7 +34,7 @@ unsigned short Schema_IndexCount(const Schema *s) {
 	assert(s);
 	unsigned short n = 0;
 
-	if(s->index) n += Index_FieldsCount(s->index);
+	if(s->index) n += Index_FieldsCount(s->index) + Index_CompositeKeysCount(s->index);
 	if(s->fulltextIdx) n += Index_FieldsCount(s->fulltextIdx);
 
 	return n;
@@ -56,7 +56,7 @@ Index *Schema_GetIndex(const Schema *s, Attribute_ID *attribute_id, IndexType ty
 
 	// Make sure field is indexed.
 	if(attribute_id) {
-		if(!Index_ContainsAttribute(idx, *attribute_id)) return NULL;
+		if(!Index_CoversAttribute(idx, *attribute_id)) return NULL;
 	}
 
 	return idx;
@@ -88,11 +88,33 @@ int Schema_AddIndex(Index **idx, Schema *s, const char *field, IndexType type) {
 	return INDEX_OK;
 }
 
+int Schema_AddCompositeIndex(Index **idx, Schema *s, const char **fields, uint count) {
+	assert(fields && count > 1);
+
+	*idx = NULL;
+	Index *_idx = s->index;
+
+	// Index exists, make sure key isn't already indexed.
+	if(_idx != NULL && Index_GetCompositeKey(_idx, fields, count)) return INDEX_FAIL;
+
+	// Index doesn't exists, create it.
+	if(!_idx) {
+		_idx = Index_New(s->name, IDX_EXACT_MATCH);
+		s->index = _idx;
+	}
+
+	Index_AddCompositeKey(_idx, fields, count);
+
+	*idx = _idx;
+	return INDEX_OK;
+}
+
 int Schema_RemoveIndex(Schema *s, const char *field, IndexType type) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Attribute_ID attribute_id = GraphContext_GetAttributeID(gc, field);
-	Index *idx = Schema_GetIndex(s, &attribute_id, type);
-	if(idx == NULL) return INDEX_FAIL;
+	Index *idx = Schema_GetIndex(s, NULL, type);
+	// Attribute might be part of a composite key, but not indexed on its own.
+	if(idx == NULL || !Index_ContainsAttribute(idx, attribute_id)) return INDEX_FAIL;
 
 	type = idx->type;
 
@@ -107,7 +129,7 @@ int Schema_RemoveIndex(Schema *s, const char *field, IndexType type) {
 		Index_RemoveField(idx, field);
 
 		// If index field count dropped to 0, remove index from schema.
-		if(Index_FieldsCount(idx) == 0) {
+		if(Index_FieldsCount(idx) == 0 && Index_CompositeKeysCount(idx) == 0) {
 			Index_Free(idx);
 			s->index = NULL;
 		}
@@ -116,6 +138,21 @@ int Schema_RemoveIndex(Schema *s, const char *field, IndexType type) {
 	return INDEX_OK;
 }
 
+int Schema_RemoveCompositeIndex(Schema *s, const char **fields, uint count) {
+	Index *idx = s->index;
+	if(idx == NULL || !Index_GetCompositeKey(idx, fields, count)) return INDEX_FAIL;
+
+	Index_RemoveCompositeKey(idx, fields, count);
+
+	// Remove index from schema once it holds no fields and no keys.
+	if(Index_FieldsCount(idx) == 0 && Index_CompositeKeysCount(idx) == 0) {
+		Index_Free(idx);
+		s->index = NULL;
+	}
+
+	return INDEX_OK;
+}
+
 // Index node under all shcema indicies.
 void Schema_AddNodeToIndices(const Schema *s, const Node *n) {
 	if(!s) return;
@@ -49,6 +49,12 @@ int Schema_AddIndex(Index **idx, Schema *s, const char *field, IndexType type);
 /* Removes index. */
 int Schema_RemoveIndex(Schema *s, const char *field, IndexType type);
 
+/* Assign a new exact-match composite index to fields[0..count), in key order. */
+int Schema_AddCompositeIndex(Index **idx, Schema *s, const char **fields, uint count);
+
+/* Removes composite index. */
+int Schema_RemoveCompositeIndex(Schema *s, const char **fields, uint count);
+
 /* Introduce node schema indicies */
 void Schema_AddNodeToIndices(const Schema *s, const Node *n);
 
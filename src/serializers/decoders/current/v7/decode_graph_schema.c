@@ -11,7 +11,7 @@ static Schema *_RdbLoadSchema(RedisModuleIO *rdb, SchemaType type) {
 	 * id
 	 * name
 	 * #indices
-	 * (index type, indexed property) X M */
+	 * (index type, indexed property or composite key properties) X M */
 
 	int id = RedisModule_LoadUnsigned(rdb);
 	char *name = RedisModule_LoadStringBuffer(rdb, NULL);
@@ -21,10 +21,21 @@ static Schema *_RdbLoadSchema(RedisModuleIO *rdb, SchemaType type) {
 	Index *idx = NULL;
 	uint index_count = RedisModule_LoadUnsigned(rdb);
 	for(uint i = 0; i < index_count; i++) {
+		size_t len;
 		IndexType type = RedisModule_LoadUnsigned(rdb);
-		char *field = RedisModule_LoadStringBuffer(rdb, NULL);
+		char *field = RedisModule_LoadStringBuffer(rdb, &len);
 
-		Schema_AddIndex(&idx, s, field, type);
+		if(strlen(field) + 1 == len) {
+			Schema_AddIndex(&idx, s, field, type);
+		} else {
+			// Composite key, buffer holds a null terminated string per key property.
+			const char **fields = array_new(const char *, 2);
+			for(size_t offset = 0; offset < len; offset += strlen(field + offset) + 1) {
+				fields = array_append(fields, field + offset);
+			}
+			Schema_AddCompositeIndex(&idx, s, fields, array_len(fields));
+			array_free(fields);
+		}
 		RedisModule_Free(field);
 	}
 
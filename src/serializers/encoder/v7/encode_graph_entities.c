@@ -117,15 +117,14 @@ static void _RdbSaveNode_v7(RedisModuleIO *rdb, GraphContext *gc, GraphEntity *n
 }
 
 static void _RdbSaveDeletedEntities_v7(RedisModuleIO *rdb, GraphContext *gc,
-									   uint64_t deleted_entities_to_encode, uint64_t *deleted_id_list) {
-	// Get deleted entities count.
-	uint64_t deleted_entities = array_len(deleted_id_list);
+									   uint64_t deleted_entities_to_encode,
+									   uint64_t (*deleted_id)(Graph *, uint64_t)) {
 	// Get the number of deleted entities already encoded.
 	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
 
 	// Iterated over the required range in the datablock deleted items.
 	for(uint64_t i = offset; i < offset + deleted_entities_to_encode; i++) {
-		RedisModule_SaveUnsigned(rdb, deleted_id_list[i]);
+		RedisModule_SaveUnsigned(rdb, deleted_id(gc->g, i));
 	}
 }
 
@@ -135,9 +134,7 @@ void RdbSaveDeletedNodes_v7(RedisModuleIO *rdb, GraphContext *gc,
 	 * node id X N */
 
 	if(deleted_nodes_to_encode == 0) return;
-	// Get deleted nodes list.
-	uint64_t *deleted_nodes_list = Serializer_Graph_GetDeletedNodesList(gc->g);
-	_RdbSaveDeletedEntities_v7(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
+	_RdbSaveDeletedEntities_v7(rdb, gc, deleted_nodes_to_encode, Serializer_Graph_GetDeletedNodeID);
 }
 
 void RdbSaveDeletedEdges_v7(RedisModuleIO *rdb, GraphContext *gc,
@@ -146,9 +143,7 @@ void RdbSaveDeletedEdges_v7(RedisModuleIO *rdb, GraphContext *gc,
 	 * edge id X N */
 
 	if(deleted_edges_to_encode == 0) return;
-	// Get deleted edges list.
-	uint64_t *deleted_edges_list = Serializer_Graph_GetDeletedEdgesList(gc->g);
-	_RdbSaveDeletedEntities_v7(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
+	_RdbSaveDeletedEntities_v7(rdb, gc, deleted_edges_to_encode, Serializer_Graph_GetDeletedEdgeID);
 }
 
 void RdbSaveNodes_v7(RedisModuleIO *rdb, GraphContext *gc, uint64_t nodes_to_encode) {
@@ -15,7 +15,7 @@ static void _RdbSaveAttributeKeys(RedisModuleIO *rdb, GraphContext *gc) {
 	uint count = GraphContext_AttributeCount(gc);
 	RedisModule_SaveUnsigned(rdb, count);
 	for(uint i = 0; i < count; i ++) {
-		char *key = gc->string_mapping[i];
+		const char *key = GraphContext_GetAttributeString(gc, i);
 		RedisModule_SaveStringBuffer(rdb, key, strlen(key) + 1);
 	}
 }
@@ -29,6 +29,26 @@ static inline void _RdbSaveIndexData(RedisModuleIO *rdb, Index *idx) {
 		// Indexed property
 		RedisModule_SaveStringBuffer(rdb, idx->fields[i], strlen(idx->fields[i]) + 1);
 	}
+
+	/* Composite keys are saved as their properties, each null terminated,
+	 * within a single buffer. Decoders unaware of composite keys read such
+	 * a buffer as an index over the key's first property. */
+	uint composites_count = Index_CompositeKeysCount(idx);
+	const CompositeKey **composites = Index_GetCompositeKeys(idx);
+	for(uint i = 0; i < composites_count; i++) {
+		const CompositeKey *key = composites[i];
+		size_t len = 0;
+		for(uint j = 0; j < key->fields_count; j++) len += strlen(key->fields[j]) + 1;
+
+		char buf[len];
+		char *field = buf;
+		for(uint j = 0; j < key->fields_count; j++) field = stpcpy(field, key->fields[j]) + 1;
+
+		// Index type
+		RedisModule_SaveUnsigned(rdb, idx->type);
+		// Key properties
+		RedisModule_SaveStringBuffer(rdb, buf, len);
+	}
 }
 
 static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
@@ -36,7 +56,7 @@ static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 	 * id
 	 * name
 	 * #indices
-	 * (index type, indexed property) X M */
+	 * (index type, indexed property or composite key properties) X M */
 
 	// Schema ID.
 	RedisModule_SaveUnsigned(rdb, s->id);
@@ -24,6 +24,7 @@ void Serializer_Graph_SetNode(Graph *g, NodeID id, int label, Node *n) {
 
 	Entity *en = DataBlock_AllocateItemOutOfOrder(g->nodes, id);
 	en->prop_count = 0;
+	en->label = label;
 	en->properties = NULL;
 	n->id = id;
 	n->entity = en;
@@ -50,12 +51,12 @@ void Serializer_Graph_SetEdge(Graph *g, EdgeID edge_id, NodeID src, NodeID dest,
 }
 
 
-// Returns the graph deleted nodes list.
-uint64_t *Serializer_Graph_GetDeletedNodesList(Graph *g) {
-	return g->nodes->deletedIdx;
+// Returns the graph i'th deleted node ID.
+uint64_t Serializer_Graph_GetDeletedNodeID(Graph *g, uint64_t i) {
+	return DataBlock_DeletedItem(g->nodes, i);
 }
 
-// Returns the graph deleted nodes list.
-uint64_t *Serializer_Graph_GetDeletedEdgesList(Graph *g) {
-	return g->edges->deletedIdx;
+// Returns the graph i'th deleted edge ID.
+uint64_t Serializer_Graph_GetDeletedEdgeID(Graph *g, uint64_t i) {
+	return DataBlock_DeletedItem(g->edges, i);
 }
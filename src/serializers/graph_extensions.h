@@ -20,8 +20,8 @@ void Serializer_Graph_MarkNodeDeleted(Graph *g, NodeID ID);
 // Marks a edge ID as deleted.
 void Serializer_Graph_MarkEdgeDeleted(Graph *g, EdgeID ID);
 
-// Returns the graph deleted nodes list.
-uint64_t *Serializer_Graph_GetDeletedNodesList(Graph *g);
+// Returns the graph i'th deleted node ID, i < Graph_DeletedNodeCount.
+uint64_t Serializer_Graph_GetDeletedNodeID(Graph *g, uint64_t i);
 
-// Returns the graph deleted nodes list.
-uint64_t *Serializer_Graph_GetDeletedEdgesList(Graph *g);
+// Returns the graph i'th deleted edge ID, i < Graph_DeletedEdgeCount.
+uint64_t Serializer_Graph_GetDeletedEdgeID(Graph *g, uint64_t i);
@@ -11,6 +11,7 @@
 #include "decoders/decode_graph.h"
 #include "decoders/decode_previous.h"
 #include "../util/redis_version.h"
+#include "../graph/graph_memory.h"
 
 // Forward declerations of the module event handler functions
 void ModuleEventHandler_AUXBeforeKeyspaceEvent(void);
@@ -68,6 +69,21 @@ static int _GraphContextType_AuxLoad(RedisModuleIO *rdb, int encver, int when) {
 	return REDISMODULE_OK;
 };
 
+/* Report graph memory usage, called on Redis main thread which holds the GIL,
+ * writers acquire the GIL prior to the graph's write lock, as such
+ * acquiring the read lock here won't wait on a writer awaiting the GIL. */
+static size_t _GraphContextType_MemUsage(const void *value) {
+	GraphContext *gc = (GraphContext *)value;
+	GraphMemoryUsage usage;
+
+	Graph_AcquireReadLock(gc->g);
+	GraphMemory_Compute(gc, GRAPH_MEMORY_DEFAULT_SAMPLES, &usage);
+	Graph_ReleaseLock(gc->g);
+
+	GraphMemory_Free(&usage);
+	return usage.total;
+}
+
 static void _GraphContextType_Free(void *value) {
 	GraphContext *gc = value;
 	GraphContext_Delete(gc);
@@ -79,6 +95,7 @@ int GraphContextType_Register(RedisModuleCtx *ctx) {
 								 .rdb_save = _GraphContextType_RdbSave,
 								 .aof_rewrite = _GraphContextType_AofRewrite,
 								 .free = _GraphContextType_Free,
+								 .mem_usage = _GraphContextType_MemUsage,
 								};
 
 	if(Redis_Version_GreaterOrEqual(6, 0, 0)) {
@@ -38,18 +38,46 @@ static inline void _ReplyWithRoundedDouble(RedisModuleCtx *ctx, double d) {
 	RedisModule_ReplyWithStringBuffer(ctx, str, len);
 }
 
+static void _SlowLogDetails_Copy(SlowLogDetails *dest, const SlowLogDetails *src) {
+	*dest = (SlowLogDetails) {0};
+	if(!src) return;
+
+	dest->cached = src->cached;
+	dest->queue_wait = src->queue_wait;
+	dest->lock_wait = src->lock_wait;
+	if(src->params) dest->params = rm_strdup(src->params);
+	else if(src->render_params) dest->params = src->render_params();
+	if(src->profile) {
+		uint count = array_len(src->profile);
+		dest->profile = array_new(char *, count);
+		for(uint i = 0; i < count; i++) array_append(dest->profile, rm_strdup(src->profile[i]));
+	}
+}
+
+static void _SlowLogDetails_Free(SlowLogDetails *details) {
+	if(details->params) rm_free(details->params);
+	if(details->profile) {
+		uint count = array_len(details->profile);
+		for(uint i = 0; i < count; i++) rm_free(details->profile[i]);
+		array_free(details->profile);
+	}
+	*details = (SlowLogDetails) {0};
+}
+
 static SlowLogItem *_SlowLogItem_New
 (
 	const char *cmd,
 	const char *query,
 	double latency,
-	time_t t
+	time_t t,
+	const SlowLogDetails *details
 ) {
 	SlowLogItem *item = rm_malloc(sizeof(SlowLogItem));
 	item->time = t;
 	item->latency = latency;
 	item->cmd = rm_strdup(cmd);
 	item->query = rm_strdup(query);
+	_SlowLogDetails_Copy(&item->details, details);
 	return item;
 }
 
@@ -57,9 +85,27 @@ static void _SlowLog_Item_Free(SlowLogItem *item) {
 	assert(item);
 	rm_free(item->cmd);
 	rm_free(item->query);
+	_SlowLogDetails_Free(&item->details);
 	rm_free(item);
 }
 
+static void _ReplyWithDetails(RedisModuleCtx *ctx, const SlowLogDetails *details) {
+	if(details->params) {
+		RedisModule_ReplyWithStringBuffer(ctx, details->params, strlen(details->params));
+	} else {
+		RedisModule_ReplyWithNull(ctx);
+	}
+	RedisModule_ReplyWithLongLong(ctx, details->cached);
+	_ReplyWithRoundedDouble(ctx, details->queue_wait);
+	_ReplyWithRoundedDouble(ctx, details->lock_wait);
+
+	uint count = (details->profile) ? array_len(details->profile) : 0;
+	RedisModule_ReplyWithArray(ctx, count);
+	for(uint i = 0; i < count; i++) {
+		RedisModule_ReplyWithStringBuffer(ctx, details->profile[i], strlen(details->profile[i]));
+	}
+}
+
 // Compares two heap record nodes.
 static int _slowlog_elem_compare(const void *A, const void *B, const void *udata) {
 	SlowLogItem *a = (SlowLogItem *)A;
@@ -115,7 +161,7 @@ SlowLog *SlowLog_New() {
 }
 
 void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
-				 double latency, time_t *t) {
+				 double latency, time_t *t, const SlowLogDetails *details) {
 	assert(slowlog && cmd && query && latency >= 0);
 
 	char *key;
@@ -144,6 +190,8 @@ void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
 			if(existing_item->latency < latency) {
 				existing_item->time = _time;
 				existing_item->latency = latency;
+				_SlowLogDetails_Free(&existing_item->details);
+				_SlowLogDetails_Copy(&existing_item->details, details);
 			}
 			goto cleanup;
 		}
@@ -165,7 +213,7 @@ void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
 		}
 
 		if(introduce_item) {
-			SlowLogItem *item = _SlowLogItem_New(cmd, query, latency, _time);
+			SlowLogItem *item = _SlowLogItem_New(cmd, query, latency, _time, details);
 			heap_offer(slowlog->min_heap + t_id, item);
 			raxInsert(lookup, (unsigned char *)key, key_len, item, NULL);
 		}
@@ -191,7 +239,7 @@ void SlowLog_Replay(const SlowLog *slowlog, RedisModuleCtx *ctx) {
 			while(raxNext(&iter)) {
 				SlowLogItem *item = iter.data;
 				SlowLog_Add(aggregated_slowlog, item->cmd, item->query,
-						item->latency, &item->time);
+						item->latency, &item->time, &item->details);
 			}
 			raxStop(&iter);
 			// End of critical section.
@@ -204,11 +252,12 @@ void SlowLog_Replay(const SlowLog *slowlog, RedisModuleCtx *ctx) {
 
 	while(heap_count(heap)) {
 		SlowLogItem *item = heap_poll(heap);
-		RedisModule_ReplyWithArray(ctx, 4);
+		RedisModule_ReplyWithArray(ctx, 9);
 		RedisModule_ReplyWithDouble(ctx, item->time);
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)item->cmd, strlen(item->cmd));
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)item->query, strlen(item->query));
 		_ReplyWithRoundedDouble(ctx, item->latency);
+		_ReplyWithDetails(ctx, &item->details);
 	}
 
 	SlowLog_Free(aggregated_slowlog);
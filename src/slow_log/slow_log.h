@@ -9,17 +9,29 @@
 #define SLOW_LOG_SIZE 10
 
 #include <pthread.h>
+#include <stdbool.h>
 
 #include "../util/heap.h"
 #include "../redismodule.h"
 #include "../../deps/rax/rax.h"
 
+// Details of a logged query, where it spent its time and how it was executed.
+typedef struct {
+	char *params;       // Parameters bound to a prepared statement, NULL if none.
+	char *(*render_params)(void); // Renders params once the item is logged, used if params is NULL.
+	bool cached;        // Whether the execution plan was cached.
+	double queue_wait;  // Time spent waiting for a worker thread, in milliseconds.
+	double lock_wait;   // Time spent waiting for the graph's locks, in milliseconds.
+	char **profile;     // Profiled operations, one per line, NULL if not profiled.
+} SlowLogDetails;
+
 // Slowlog item.
 typedef struct {
     char *cmd;          // Redis command.
     time_t time;        // Item creation time.
 	char *query;        // Query.
 	double latency;     // How much time query was processed.
+	SlowLogDetails details; // Query details.
 } SlowLogItem;
 
 // Slowlog, maintains N slowest queries.
@@ -40,7 +52,8 @@ void SlowLog_Add
 	const char *cmd,			// command being logged
 	const char *query,			// query being logged
 	double latency,				// command latency
-	time_t *time				// optional time command was issued
+	time_t *time,				// optional time command was issued
+	const SlowLogDetails *details	// optional query details, copied by the slowlog
 );
 
 // Replies with slow log content.
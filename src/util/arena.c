@@ -0,0 +1,104 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "arena.h"
+#include "../RG.h"
+#include "rmalloc.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define ARENA_ALIGNMENT _Alignof(max_align_t)
+#define ARENA_ALIGN(n) (((n) + (ARENA_ALIGNMENT - 1)) & ~(ARENA_ALIGNMENT - 1))
+
+struct ArenaBlock {
+	ArenaBlock *next;       // Previously filled block.
+	size_t cap;             // Number of bytes block can hold.
+	size_t used;            // Number of bytes handed out.
+	_Alignas(max_align_t) char data[];
+};
+
+static ArenaBlock *_Arena_AddBlock(Arena *arena, size_t n) {
+	// Allocations larger than the default block size get a block of their own.
+	size_t cap = (n > arena->block_size) ? n : arena->block_size;
+	ArenaBlock *block = rm_malloc(sizeof(ArenaBlock) + cap);
+	block->cap = cap;
+	block->used = 0;
+	block->next = arena->head;
+	arena->head = block;
+	arena->allocated += cap;
+	return block;
+}
+
+Arena *Arena_New(size_t block_size) {
+	ASSERT(block_size > 0);
+	Arena *arena = rm_malloc(sizeof(Arena));
+	arena->head = NULL;
+	arena->allocated = 0;
+	arena->block_size = ARENA_ALIGN(block_size);
+	return arena;
+}
+
+void *Arena_Alloc(Arena *arena, size_t n) {
+	ASSERT(arena != NULL);
+	n = ARENA_ALIGN(n > 0 ? n : 1);
+
+	ArenaBlock *block = arena->head;
+	if(block == NULL || block->cap - block->used < n) block = _Arena_AddBlock(arena, n);
+
+	void *ptr = block->data + block->used;
+	block->used += n;
+	return ptr;
+}
+
+void *Arena_Calloc(Arena *arena, size_t nelem, size_t elemsz) {
+	ASSERT(elemsz == 0 || nelem <= SIZE_MAX / elemsz);
+	size_t n = nelem * elemsz;
+	void *ptr = Arena_Alloc(arena, n);
+	memset(ptr, 0, n);
+	return ptr;
+}
+
+char *Arena_Strdup(Arena *arena, const char *s) {
+	size_t n = strlen(s) + 1;
+	char *dup = Arena_Alloc(arena, n);
+	memcpy(dup, s, n);
+	return dup;
+}
+
+ArenaMark Arena_Mark(const Arena *arena) {
+	ArenaMark mark = {.block = arena->head, .used = 0};
+	if(arena->head) mark.used = arena->head->used;
+	return mark;
+}
+
+void Arena_Rewind(Arena *arena, ArenaMark mark) {
+	// Drop blocks added after mark was taken.
+	while(arena->head != mark.block) {
+		ArenaBlock *block = arena->head;
+		ASSERT(block != NULL);
+		arena->head = block->next;
+		arena->allocated -= block->cap;
+		rm_free(block);
+	}
+	if(arena->head) arena->head->used = mark.used;
+}
+
+size_t Arena_Size(const Arena *arena) {
+	return arena->allocated;
+}
+
+void Arena_Free(Arena *arena) {
+	if(arena == NULL) return;
+	ArenaBlock *block = arena->head;
+	while(block) {
+		ArenaBlock *next = block->next;
+		rm_free(block);
+		block = next;
+	}
+	rm_free(arena);
+}
+
@@ -0,0 +1,53 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stddef.h>
+
+/* Arena is a bump allocator, memory is carved out of large blocks
+ * and is released all at once when the arena is freed.
+ * Individual allocations can't be freed nor resized.
+ * An arena is not thread safe. */
+
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct {
+	ArenaBlock *head;       // Block currently allocated from.
+	size_t block_size;      // Default size of a new block.
+	size_t allocated;       // Total number of bytes held by arena blocks.
+} Arena;
+
+// Position within an arena, see Arena_Rewind.
+typedef struct {
+	ArenaBlock *block;
+	size_t used;
+} ArenaMark;
+
+// Create a new arena, allocating blocks of 'block_size' bytes.
+Arena *Arena_New(size_t block_size);
+
+// Allocate 'n' bytes, memory is aligned to max_align_t.
+void *Arena_Alloc(Arena *arena, size_t n);
+
+// Allocate zeroed memory for an array of 'nelem' elements of 'elemsz' bytes.
+void *Arena_Calloc(Arena *arena, size_t nelem, size_t elemsz);
+
+// Duplicate string.
+char *Arena_Strdup(Arena *arena, const char *s);
+
+// Returns current arena position.
+ArenaMark Arena_Mark(const Arena *arena);
+
+// Release every allocation made after 'mark' was taken.
+void Arena_Rewind(Arena *arena, ArenaMark mark);
+
+// Number of bytes held by arena.
+size_t Arena_Size(const Arena *arena);
+
+// Free arena and all of its allocations.
+void Arena_Free(Arena *arena);
+
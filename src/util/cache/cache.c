@@ -37,6 +37,7 @@ Cache *Cache_New(uint size, CacheItemFreeFunc freeCB) {
 	cache->list = CacheList_New(size, freeCB);
 	// Instantiate the lookup map for fast cache retrievals.
 	cache->lookup = HT_dictCreate(&HT_dictTypeHeapStrings, NULL);
+	cache->size = 0;
 	return cache;
 }
 
@@ -49,7 +50,7 @@ inline void *Cache_GetValue(const Cache *cache, const char *key) {
 	return elem->value;
 }
 
-void Cache_SetValue(Cache *cache, const char *orig_key, void *value) {
+void Cache_SetValue(Cache *cache, const char *orig_key, void *value, size_t size) {
 	CacheListNode *node;
 	if(CacheList_IsFull(cache->list)) {
 		/* The list is full, evict the least-recently-used element
@@ -58,6 +59,7 @@ void Cache_SetValue(Cache *cache, const char *orig_key, void *value) {
 		// Remove evicted element from the lookup map.
 		HT_dictDelete(cache->lookup, node->key);
 		rm_free(node->key);
+		__atomic_sub_fetch(&cache->size, node->size, __ATOMIC_RELAXED);
 	} else {
 		// The list has not yet been filled, introduce a new node.
 		node = CacheList_GetUnused(cache->list);
@@ -66,11 +68,21 @@ void Cache_SetValue(Cache *cache, const char *orig_key, void *value) {
 	char *key = rm_strdup(orig_key);
 	// Populate the node.
 	CacheList_PopulateNode(cache->list, node, key, value);
+	node->size = strlen(key) + 1 + size;
+	__atomic_add_fetch(&cache->size, node->size, __ATOMIC_RELAXED);
 
 	// Add the new node to the mapping.
 	HT_dictAdd(cache->lookup, (void *)key, node);
 }
 
+size_t Cache_MemoryUsage(const Cache *cache) {
+	size_t size = sizeof(Cache) + sizeof(CacheList);
+	size += cache->list->buffer_cap * sizeof(CacheListNode);
+	// The lookup map holds an entry per cached key.
+	size += cache->list->buffer_cap * (sizeof(dictEntry) + sizeof(dictEntry *));
+	return size + __atomic_load_n(&cache->size, __ATOMIC_RELAXED);
+}
+
 void Cache_Free(Cache *cache) {
 	CacheList_Free(cache->list);
 	HT_dictRelease(cache->lookup);
@@ -16,6 +16,7 @@
 typedef struct Cache {
 	dict *lookup;           // Map of hash keys to cache values for fast lookups.
 	CacheList *list;        // Doubly-linked list container for cache elements.
+	size_t size;            // Bytes held by cached keys and values.
 } Cache;
 
 /**
@@ -42,8 +43,17 @@ void *Cache_GetValue(const Cache *cache, const char *key);
  * @param  *cache: cache pointer.
  * @param  *key: Key for associating with value (bytes array).
  * @param  *value: pointer with the relevant value.
+ * @param  size: number of bytes held by value.
  */
-void Cache_SetValue(Cache *cache, const char *key, void *value);
+void Cache_SetValue(Cache *cache, const char *key, void *value, size_t size);
+
+/**
+ * @brief  Returns the number of bytes held by the cache.
+ * @param  *cache: cache pointer.
+ * @note   May be called concurrently with cache updates, in which case
+ *         the returned size might not reflect the latest update.
+ */
+size_t Cache_MemoryUsage(const Cache *cache);
 
 /**
  * @brief  Destroy a cache and free all of the stored items.
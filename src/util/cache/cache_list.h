@@ -19,6 +19,7 @@ typedef void (*CacheItemFreeFunc)(void *);
 typedef struct CacheListNode_t {
 	void *value;                    // Node stored value.
 	char *key;                      // Key
+	size_t size;                    // Bytes held by the node's key and value.
 	struct CacheListNode_t *prev;   // Previous node in the linked list.
 	struct CacheListNode_t *next;   // Next node in the linked list.
 } CacheListNode;
@@ -17,51 +17,140 @@
 #define ITEM_COUNT_TO_BLOCK_COUNT(n) \
     ceil((double)n / DATABLOCK_BLOCK_CAP)
 
-// Computes block index from item index.
-#define ITEM_INDEX_TO_BLOCK_INDEX(idx) \
-    (idx / DATABLOCK_BLOCK_CAP)
-
-// Computes item position within a block.
-#define ITEM_POSITION_WITHIN_BLOCK(idx) \
-    (idx % DATABLOCK_BLOCK_CAP)
-
 // Retrieves block in which item with index resides.
 #define GET_ITEM_BLOCK(dataBlock, idx) \
     dataBlock->blocks[ITEM_INDEX_TO_BLOCK_INDEX(idx)]
 
+// Returns the closest live block preceding block i, NULL if there's none.
+static Block *_DataBlock_PrevLiveBlock(const DataBlock *dataBlock, uint i) {
+	while(i > 0) {
+		Block *block = dataBlock->blocks[--i];
+		if(block) return block;
+	}
+	return NULL;
+}
+
+// Returns the closest live block following block i, NULL if there's none.
+static Block *_DataBlock_NextLiveBlock(const DataBlock *dataBlock, uint i) {
+	for(i++; i < dataBlock->blockCount; i++) {
+		if(dataBlock->blocks[i]) return dataBlock->blocks[i];
+	}
+	return NULL;
+}
+
+// Link block i to its neighbours, skipping released blocks.
+static void _DataBlock_LinkBlock(DataBlock *dataBlock, uint i) {
+	Block *block = dataBlock->blocks[i];
+	block->next = _DataBlock_NextLiveBlock(dataBlock, i);
+	Block *prev = _DataBlock_PrevLiveBlock(dataBlock, i);
+	if(prev) prev->next = block;
+}
+
 static void _DataBlock_AddBlocks(DataBlock *dataBlock, uint blockCount) {
 	assert(dataBlock && blockCount > 0);
 
 	uint prevBlockCount = dataBlock->blockCount;
 	dataBlock->blockCount += blockCount;
-	if(!dataBlock->blocks)
+	if(!dataBlock->blocks) {
 		dataBlock->blocks = rm_malloc(sizeof(Block *) * dataBlock->blockCount);
-	else
+		dataBlock->bitmaps = rm_malloc(sizeof(uint64_t *) * dataBlock->blockCount);
+	} else {
 		dataBlock->blocks = rm_realloc(dataBlock->blocks, sizeof(Block *) * dataBlock->blockCount);
+		dataBlock->bitmaps = rm_realloc(dataBlock->bitmaps,
+										sizeof(uint64_t *) * dataBlock->blockCount);
+	}
 
-	uint i;
-	for(i = prevBlockCount; i < dataBlock->blockCount; i++) {
+	for(uint i = prevBlockCount; i < dataBlock->blockCount; i++) {
 		dataBlock->blocks[i] = Block_New(dataBlock->itemSize, DATABLOCK_BLOCK_CAP);
-		if(i > 0) dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
+		dataBlock->bitmaps[i] = rm_calloc(DATABLOCK_BITMAP_WORDS, sizeof(uint64_t));
+		if(i > prevBlockCount) dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
 	}
-	dataBlock->blocks[i - 1]->next = NULL;
+
+	// New blocks trail the datablock, link the first to its predecessor.
+	Block *prev = _DataBlock_PrevLiveBlock(dataBlock, prevBlockCount);
+	if(prev) prev->next = dataBlock->blocks[prevBlockCount];
 
 	dataBlock->itemCap = dataBlock->blockCount * DATABLOCK_BLOCK_CAP;
 }
 
+// Reallocate released block i, its slots other than skip become free indices.
+static void _DataBlock_RestoreBlock(DataBlock *dataBlock, uint i, uint64_t skip) {
+	dataBlock->blocks[i] = Block_New(dataBlock->itemSize, DATABLOCK_BLOCK_CAP);
+	_DataBlock_LinkBlock(dataBlock, i);
+
+	uint released = array_len(dataBlock->releasedBlocks);
+	for(uint j = 0; j < released; j++) {
+		if(dataBlock->releasedBlocks[j] != i) continue;
+		array_del_fast(dataBlock->releasedBlocks, j);
+		break;
+	}
+
+	// Pushed in reverse, such that lower positions are reused first.
+	uint64_t first = (uint64_t)i * DATABLOCK_BLOCK_CAP;
+	for(uint64_t pos = first + DATABLOCK_BLOCK_CAP; pos > first; pos--) {
+		if(pos - 1 != skip) dataBlock->deletedIdx = array_append(dataBlock->deletedIdx, pos - 1);
+	}
+}
+
+// Reallocate block holding item idx, in case it was released by compaction.
+static inline void _DataBlock_EnsureBlock(DataBlock *dataBlock, uint64_t idx) {
+	uint i = ITEM_INDEX_TO_BLOCK_INDEX(idx);
+	if(dataBlock->blocks[i] == NULL) _DataBlock_RestoreBlock(dataBlock, i, idx);
+}
+
+// Orders free indices in descending order, such that lower indices are reused first.
+static int _DataBlock_CompareIdx(const void *a, const void *b) {
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+	return (y > x) - (y < x);
+}
+
+// Returns the position following the last used slot.
+static inline uint64_t _DataBlock_End(const DataBlock *dataBlock) {
+	return dataBlock->itemCount + dataBlock->deletedCount;
+}
+
 // Checks to see if idx is within global array bounds
 // array bounds are between 0 and itemCount + #deleted indices
 // e.g. [3, 7, 2, D, 1, D, 5] where itemCount = 5 and #deleted indices is 2
 // and so it is valid to query the array with idx 6.
 static inline bool _DataBlock_IndexOutOfBounds(const DataBlock *dataBlock, uint64_t idx) {
-	return (idx >= (dataBlock->itemCount + array_len(dataBlock->deletedIdx)));
+	return (idx >= _DataBlock_End(dataBlock));
+}
+
+static inline bool _DataBlock_IsOccupied(const DataBlock *dataBlock, uint64_t idx) {
+	return *ITEM_BITMAP_WORD(dataBlock, idx) & ITEM_BITMAP_BIT(idx);
 }
 
-static inline DataBlockItemHeader *DataBlock_GetItemHeader(const DataBlock *dataBlock,
-														   uint64_t idx) {
+/* Removes stale entries from deletedIdx: indices reused by DataBlock_AllocateItemAt,
+ * duplicates of indices freed again since and indices of released blocks. */
+static void _DataBlock_PurgeDeletedIdx(DataBlock *dataBlock) {
+	uint64_t kept = 0;
+	uint64_t deleted = array_len(dataBlock->deletedIdx);
+	qsort(dataBlock->deletedIdx, deleted, sizeof(uint64_t), _DataBlock_CompareIdx);
+
+	for(uint64_t i = 0; i < deleted; i++) {
+		uint64_t idx = dataBlock->deletedIdx[i];
+		if(GET_ITEM_BLOCK(dataBlock, idx) == NULL) continue;
+		if(_DataBlock_IsOccupied(dataBlock, idx)) continue;
+		if(kept > 0 && dataBlock->deletedIdx[kept - 1] == idx) continue;
+		dataBlock->deletedIdx[kept++] = idx;
+	}
+
+	dataBlock->deletedIdx = array_trimm_len(dataBlock->deletedIdx, kept);
+	dataBlock->staleCount = 0;
+}
+
+static inline void *_DataBlock_ItemData(const DataBlock *dataBlock, uint64_t idx) {
 	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
-	idx = ITEM_POSITION_WITHIN_BLOCK(idx);
-	return (DataBlockItemHeader *)block->data + (idx * block->itemSize);
+	return block->data + (ITEM_POSITION_WITHIN_BLOCK(idx) * block->itemSize);
+}
+
+// Issue a read prefetch of item at position idx.
+static inline void _DataBlock_PrefetchItem(const DataBlock *dataBlock, uint64_t idx) {
+	// Released blocks hold no items.
+	if(GET_ITEM_BLOCK(dataBlock, idx) == NULL) return;
+	__builtin_prefetch(_DataBlock_ItemData(dataBlock, idx), 0, 1);
 }
 
 /* --------- DataBlock API implementation --------*/
@@ -69,10 +158,15 @@ static inline DataBlockItemHeader *DataBlock_GetItemHeader(const DataBlock *data
 DataBlock *DataBlock_New(uint64_t itemCap, uint itemSize, fpDestructor fp) {
 	DataBlock *dataBlock = rm_malloc(sizeof(DataBlock));
 	dataBlock->itemCount = 0;
-	dataBlock->itemSize = itemSize + ITEM_HEADER_SIZE;
+	dataBlock->itemSize = itemSize;
 	dataBlock->blockCount = 0;
 	dataBlock->blocks = NULL;
+	dataBlock->bitmaps = NULL;
+	dataBlock->compactCursor = 0;
+	dataBlock->deletedCount = 0;
 	dataBlock->deletedIdx = array_new(uint64_t, 128);
+	dataBlock->staleCount = 0;
+	dataBlock->releasedBlocks = array_new(uint, 0);
 	dataBlock->destructor = fp;
 	assert(pthread_mutex_init(&dataBlock->mutex, NULL) == 0);
 	_DataBlock_AddBlocks(dataBlock, ITEM_COUNT_TO_BLOCK_COUNT(itemCap));
@@ -81,12 +175,11 @@ DataBlock *DataBlock_New(uint64_t itemCap, uint itemSize, fpDestructor fp) {
 
 DataBlockIterator *DataBlock_Scan(const DataBlock *dataBlock) {
 	assert(dataBlock);
-	Block *startBlock = dataBlock->blocks[0];
 
 	// Deleted items are skipped, we're about to perform
-	// array_len(dataBlock->deletedIdx) skips during out scan.
-	int64_t endPos = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
-	return DataBlockIterator_New(startBlock, 0, endPos, 1);
+	// dataBlock->deletedCount skips during out scan.
+	int64_t endPos = _DataBlock_End(dataBlock);
+	return DataBlockIterator_New(dataBlock, 0, endPos, 1);
 }
 
 // Make sure datablock can accommodate at least k items.
@@ -106,12 +199,26 @@ void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx) {
 
 	ASSERT(!_DataBlock_IndexOutOfBounds(dataBlock, idx));
 
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, idx);
-
 	// Incase item is marked as deleted, return NULL.
-	if(IS_ITEM_DELETED(item_header)) return NULL;
+	if(!_DataBlock_IsOccupied(dataBlock, idx)) return NULL;
 
-	return ITEM_DATA(item_header);
+	return _DataBlock_ItemData(dataBlock, idx);
+}
+
+void DataBlock_GetItemsBatch(const DataBlock *dataBlock, const uint64_t *idx, uint64_t count,
+							 void **items) {
+	assert(dataBlock);
+
+	// Prefetch the head of the batch.
+	uint64_t lookahead = (count < DATABLOCK_PREFETCH_DISTANCE) ? count : DATABLOCK_PREFETCH_DISTANCE;
+	for(uint64_t i = 0; i < lookahead; i++) _DataBlock_PrefetchItem(dataBlock, idx[i]);
+
+	for(uint64_t i = 0; i < count; i++) {
+		// Keep DATABLOCK_PREFETCH_DISTANCE items in flight.
+		uint64_t ahead = i + DATABLOCK_PREFETCH_DISTANCE;
+		if(ahead < count) _DataBlock_PrefetchItem(dataBlock, idx[ahead]);
+		items[i] = DataBlock_GetItem(dataBlock, idx[i]);
+	}
 }
 
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
@@ -124,19 +231,71 @@ void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 	}
 
 	// Get index into which to store item,
-	// prefer reusing free indicies.
-	uint pos = dataBlock->itemCount;
+	// prefer reusing free indicies of live blocks over released ones.
+	uint64_t pos = _DataBlock_End(dataBlock);
+	// Skip entries reused by DataBlock_AllocateItemAt.
+	while(array_len(dataBlock->deletedIdx) > 0 &&
+		  _DataBlock_IsOccupied(dataBlock, array_tail(dataBlock->deletedIdx))) {
+		array_pop(dataBlock->deletedIdx);
+		dataBlock->staleCount--;
+	}
+
 	if(array_len(dataBlock->deletedIdx) > 0) {
 		pos = array_pop(dataBlock->deletedIdx);
+		dataBlock->deletedCount--;
+	} else if(array_len(dataBlock->releasedBlocks) > 0) {
+		pos = (uint64_t)array_tail(dataBlock->releasedBlocks) * DATABLOCK_BLOCK_CAP;
+		dataBlock->deletedCount--;
 	}
 	dataBlock->itemCount++;
 
 	if(idx) *idx = pos;
 
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, pos);
-	MARK_HEADER_AS_NOT_DELETED(item_header);
+	_DataBlock_EnsureBlock(dataBlock, pos);
+	__atomic_fetch_or(ITEM_BITMAP_WORD(dataBlock, pos), ITEM_BITMAP_BIT(pos), __ATOMIC_RELAXED);
 
-	return ITEM_DATA(item_header);
+	return _DataBlock_ItemData(dataBlock, pos);
+}
+
+void *DataBlock_AllocateItemAt(DataBlock *dataBlock, uint64_t idx) {
+	uint64_t end = _DataBlock_End(dataBlock);
+	// idx may originate from an untrusted source.
+	if(idx > end + DATABLOCK_ALLOCATE_AT_SLACK) return NULL;
+
+	if(idx < end) {
+		if(_DataBlock_IsOccupied(dataBlock, idx)) return NULL;
+		if(GET_ITEM_BLOCK(dataBlock, idx) == NULL) {
+			// Released block, its remaining slots become free indicies.
+			_DataBlock_EnsureBlock(dataBlock, idx);
+		} else if(array_len(dataBlock->deletedIdx) > 0 && array_tail(dataBlock->deletedIdx) == idx) {
+			// Replaying DataBlock_AllocateItem, which reuses the most recently deleted index.
+			array_pop(dataBlock->deletedIdx);
+		} else {
+			// idx's entry turns stale, skipped by DataBlock_AllocateItem.
+			dataBlock->staleCount++;
+		}
+		dataBlock->deletedCount--;
+	} else {
+		// Make sure we've got room for items up to idx.
+		if(idx >= dataBlock->itemCap) {
+			uint requiredAdditionalBlocks = ITEM_COUNT_TO_BLOCK_COUNT(idx + 1) - dataBlock->blockCount;
+			_DataBlock_AddBlocks(dataBlock, requiredAdditionalBlocks);
+		}
+		// Positions skipped over are free.
+		for(uint64_t pos = end; pos < idx; pos++) {
+			dataBlock->deletedIdx = array_append(dataBlock->deletedIdx, pos);
+		}
+		dataBlock->deletedCount += idx - end;
+	}
+	dataBlock->itemCount++;
+	__atomic_fetch_or(ITEM_BITMAP_WORD(dataBlock, idx), ITEM_BITMAP_BIT(idx), __ATOMIC_RELAXED);
+
+	// Stale entries make up half of the free indicies.
+	if(dataBlock->staleCount * 2 > array_len(dataBlock->deletedIdx)) {
+		_DataBlock_PurgeDeletedIdx(dataBlock);
+	}
+
+	return _DataBlock_ItemData(dataBlock, idx);
 }
 
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
@@ -144,16 +303,15 @@ void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 	ASSERT(!_DataBlock_IndexOutOfBounds(dataBlock, idx));
 
 	// Return if item already deleted.
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, idx);
-	if(IS_ITEM_DELETED(item_header)) return;
+	if(!_DataBlock_IsOccupied(dataBlock, idx)) return;
 
 	// Call item destructor.
 	if(dataBlock->destructor) {
-		unsigned char *item = ITEM_DATA(item_header);
-		dataBlock->destructor(item);
+		dataBlock->destructor(_DataBlock_ItemData(dataBlock, idx));
 	}
 
-	MARK_HEADER_AS_DELETED(item_header);
+	// Items sharing a bitmap word may be deleted concurrently.
+	__atomic_fetch_and(ITEM_BITMAP_WORD(dataBlock, idx), ~ITEM_BITMAP_BIT(idx), __ATOMIC_RELAXED);
 
 	/* DataBlock_DeleteItem should be thread-safe as it's being called
 	 * from GraphBLAS concurent operations, e.g. GxB_SelectOp.
@@ -164,20 +322,107 @@ void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 	pthread_mutex_lock(&dataBlock->mutex);
 	{
 		dataBlock->deletedIdx = array_append(dataBlock->deletedIdx, idx);
+		dataBlock->deletedCount++;
 		dataBlock->itemCount--;
 	}
 	pthread_mutex_unlock(&dataBlock->mutex);
 }
 
 uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock) {
-	return array_len(dataBlock->deletedIdx);
+	return dataBlock->deletedCount;
+}
+
+uint64_t DataBlock_DeletedItem(DataBlock *dataBlock, uint64_t i) {
+	ASSERT(i < dataBlock->deletedCount);
+	if(dataBlock->staleCount > 0) _DataBlock_PurgeDeletedIdx(dataBlock);
+
+	uint64_t live = array_len(dataBlock->deletedIdx);
+	if(i < live) return dataBlock->deletedIdx[i];
+
+	// Slots of released blocks follow, block by block.
+	i -= live;
+	uint64_t block = dataBlock->releasedBlocks[i / DATABLOCK_BLOCK_CAP];
+	return block * DATABLOCK_BLOCK_CAP + ITEM_POSITION_WITHIN_BLOCK(i);
+}
+
+uint64_t DataBlock_NextItemPosition(const DataBlock *dataBlock, uint64_t pos, uint64_t end) {
+	// Skip empty bitmap words as a whole.
+	while(pos < end) {
+		uint64_t shift = ITEM_POSITION_WITHIN_BLOCK(pos) % 64;
+		uint64_t word = *ITEM_BITMAP_WORD(dataBlock, pos) >> shift;
+		if(word) {
+			pos += __builtin_ctzl(word);
+			break;
+		}
+		pos += 64 - shift;
+	}
+
+	return (pos < end) ? pos : end;
+}
+
+bool DataBlock_Compact(DataBlock *dataBlock, uint budget) {
+	assert(dataBlock);
+
+	// Only blocks whose every slot was used are considered,
+	// spare capacity at the end of the datablock is retained.
+	uint64_t used = _DataBlock_End(dataBlock);
+	uint fullBlocks = used / DATABLOCK_BLOCK_CAP;
+	bool released = false;
+
+	for(; budget > 0 && dataBlock->compactCursor < fullBlocks; budget--) {
+		uint i = dataBlock->compactCursor++;
+		Block *block = dataBlock->blocks[i];
+		if(block == NULL) continue;
+
+		const uint64_t *bitmap = dataBlock->bitmaps[i];
+		bool empty = true;
+		for(uint w = 0; w < DATABLOCK_BITMAP_WORDS && empty; w++) empty = (bitmap[w] == 0);
+		if(!empty) continue;
+
+		// Link over the released block.
+		Block *prev = _DataBlock_PrevLiveBlock(dataBlock, i);
+		if(prev) prev->next = block->next;
+		dataBlock->blocks[i] = NULL;
+		Block_Free(block);
+		dataBlock->releasedBlocks = array_append(dataBlock->releasedBlocks, i);
+		released = true;
+	}
+
+	// Free slots of live blocks are reused ahead of released ones.
+	if(released) _DataBlock_PurgeDeletedIdx(dataBlock);
+
+	if(dataBlock->compactCursor < fullBlocks) return false;
+
+	// Pass completed, next pass starts from the first block.
+	dataBlock->compactCursor = 0;
+	return true;
+}
+
+uint DataBlock_ReleasedBlockCount(const DataBlock *dataBlock) {
+	return array_len(dataBlock->releasedBlocks);
+}
+
+size_t DataBlock_MemoryUsage(const DataBlock *dataBlock) {
+	uint liveBlocks = dataBlock->blockCount - DataBlock_ReleasedBlockCount(dataBlock);
+	size_t size = sizeof(DataBlock);
+	size += liveBlocks * (sizeof(Block) + (size_t)DATABLOCK_BLOCK_CAP * dataBlock->itemSize);
+	size += dataBlock->blockCount * (sizeof(Block *) + sizeof(uint64_t *) +
+									 DATABLOCK_BITMAP_WORDS * sizeof(uint64_t));
+	size += array_sizeof(array_hdr(dataBlock->deletedIdx));
+	size += array_sizeof(array_hdr(dataBlock->releasedBlocks));
+	return size;
 }
 
 void DataBlock_Free(DataBlock *dataBlock) {
-	for(uint i = 0; i < dataBlock->blockCount; i++) Block_Free(dataBlock->blocks[i]);
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		if(dataBlock->blocks[i]) Block_Free(dataBlock->blocks[i]);
+		rm_free(dataBlock->bitmaps[i]);
+	}
 
 	rm_free(dataBlock->blocks);
+	rm_free(dataBlock->bitmaps);
 	array_free(dataBlock->deletedIdx);
+	array_free(dataBlock->releasedBlocks);
 	assert(pthread_mutex_destroy(&dataBlock->mutex) == 0);
 	rm_free(dataBlock);
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <pthread.h>
 #include "../block.h"
 #include "./datablock_iterator.h"
@@ -16,46 +17,61 @@ typedef void (*fpDestructor)(void *);
 // Number of items in a block. Should always be a power of 2.
 #define DATABLOCK_BLOCK_CAP 16384
 
-// Returns the item header size.
-#define ITEM_HEADER_SIZE 1
+// Number of items prefetched ahead of the item being retrieved by DataBlock_GetItemsBatch.
+#define DATABLOCK_PREFETCH_DISTANCE 8
 
-// DataBlock item is stored as ||header|data||. This macro retrive the data pointer out of the header pointer.
-#define ITEM_DATA(header) ((void *)((header) + ITEM_HEADER_SIZE))
+// Number of positions DataBlock_AllocateItemAt may skip past the end of the datablock.
+#define DATABLOCK_ALLOCATE_AT_SLACK DATABLOCK_BLOCK_CAP
 
-// DataBlock item is stored as ||header|data||. This macro retrive the header pointer out of the data pointer.
-#define GET_ITEM_HEADER(item) ((item) - ITEM_HEADER_SIZE)
+// Number of 64 bit words in a block's occupancy bitmap.
+#define DATABLOCK_BITMAP_WORDS (DATABLOCK_BLOCK_CAP / 64)
 
-// Sets the deleted bit in the header to 1.
-#define MARK_HEADER_AS_DELETED(header) ((header)->deleted |= 1)
+// Computes block index from item index.
+#define ITEM_INDEX_TO_BLOCK_INDEX(idx) \
+    ((idx) / DATABLOCK_BLOCK_CAP)
 
-// Sets the deleted bit in the header to 0.
-#define MARK_HEADER_AS_NOT_DELETED(header) ((header)->deleted &= 0)
+// Computes item position within a block.
+#define ITEM_POSITION_WITHIN_BLOCK(idx) \
+    ((idx) % DATABLOCK_BLOCK_CAP)
 
-// Checks if the deleted bit in the header is 1 or not.
-#define IS_ITEM_DELETED(header) ((header)->deleted & 1)
+// Retrieves the occupancy bitmap word holding item idx.
+#define ITEM_BITMAP_WORD(dataBlock, idx) \
+    ((dataBlock)->bitmaps[ITEM_INDEX_TO_BLOCK_INDEX(idx)] + ITEM_POSITION_WITHIN_BLOCK(idx) / 64)
 
+// Retrieves item idx bit within its bitmap word.
+#define ITEM_BITMAP_BIT(idx) \
+    (1UL << (ITEM_POSITION_WITHIN_BLOCK(idx) % 64))
 
 /* The DataBlock is a container structure for holding arbitrary items of a uniform type
  * in order to reduce the number of alloc/free calls and improve locality of reference.
  * Item deletions are thread-safe, and a DataBlockIterator can be used to traverse a
- * range within the block. */
-typedef struct {
+ * range within the block.
+ *
+ * Each block is accompanied by a bitmap marking its occupied slots,
+ * blocks in which every slot was deleted are released by DataBlock_Compact
+ * leaving a NULL block, which is reallocated once free slots of live blocks
+ * are exhausted or one of its slots is explicitly reused.
+ * Slots of released blocks are not part of deletedIdx.
+ *
+ * DataBlock_AllocateItemAt doesn't search deletedIdx for the reused index,
+ * the entry is left in place and skipped once it is popped, such entries are
+ * purged in bulk once they make up half of deletedIdx. */
+typedef struct DataBlock {
 	uint64_t itemCount;         // Number of items stored in datablock.
 	uint64_t itemCap;           // Number of items datablock can hold.
 	uint blockCount;            // Number of blocks in datablock.
 	uint itemSize;              // Size of a single item in bytes.
-	Block **blocks;             // Array of blocks.
-	uint64_t *deletedIdx;       // Array of free indicies.
+	Block **blocks;             // Array of blocks, NULL if released by compaction.
+	uint64_t **bitmaps;         // Per block bitmap of occupied slots.
+	uint compactCursor;         // Next block to be examined by compaction.
+	uint64_t deletedCount;      // Number of free indicies, including released blocks' slots.
+	uint64_t *deletedIdx;       // Array of free indicies within live blocks, may hold stale entries.
+	uint64_t staleCount;        // Upper bound on the number of stale deletedIdx entries.
+	uint *releasedBlocks;       // Array of blocks released by compaction.
 	pthread_mutex_t mutex;      // Mutex guarding from concurent updates.
 	fpDestructor destructor;    // Function pointer to a clean-up function of an item.
 } DataBlock;
 
-// This struct is for data block item header data.
-// TODO: Consider using pragma pack/pop for tight memory/word alignment.
-typedef struct {
-	unsigned char deleted: 1;  // A bit indicate if the current item is deleted or not.
-} DataBlockItemHeader;
-
 // Create a new DataBlock
 // itemCap - number of items datablock can hold before resizing.
 // itemSize - item size in bytes.
@@ -71,16 +87,45 @@ DataBlockIterator *DataBlock_Scan(const DataBlock *dataBlock);
 // Get item at position idx
 void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx);
 
+// Get items at positions idx[0..count), items[i] is set to NULL if item idx[i] is deleted.
+// Items are prefetched ahead of their retrieval, reducing the cost of random access.
+void DataBlock_GetItemsBatch(const DataBlock *dataBlock, const uint64_t *idx, uint64_t count,
+							 void **items);
+
 // Allocate a new item within given dataBlock,
 // if idx is not NULL, idx will contain item position
 // return a pointer to the newly allocated item.
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx);
 
+// Allocate a new item at position idx, positions skipped over are considered deleted.
+// return a pointer to the newly allocated item, NULL if idx is occupied or
+// lies more than DATABLOCK_ALLOCATE_AT_SLACK positions past the end of the datablock.
+void *DataBlock_AllocateItemAt(DataBlock *dataBlock, uint64_t idx);
+
 // Removes item at position idx.
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx);
 
 // Returns the number of deleted items.
 uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock);
 
+// Returns the i'th deleted item position, i < DataBlock_DeletedItemsCount.
+// Stale free indices are purged by the first call following a modification.
+uint64_t DataBlock_DeletedItem(DataBlock *dataBlock, uint64_t i);
+
+// Returns the position of the first item at or after pos, end if no item precedes end.
+uint64_t DataBlock_NextItemPosition(const DataBlock *dataBlock, uint64_t pos, uint64_t end);
+
+// Release blocks in which every slot was deleted, examining at most
+// `budget` blocks, resuming where the previous call stopped.
+// Returns true once the last block was examined.
+bool DataBlock_Compact(DataBlock *dataBlock, uint budget);
+
+// Returns the number of blocks released by compaction.
+uint DataBlock_ReleasedBlockCount(const DataBlock *dataBlock);
+
+// Returns the number of bytes held by the datablock,
+// excluding allocations referred to by its items.
+size_t DataBlock_MemoryUsage(const DataBlock *dataBlock);
+
 // Free block.
 void DataBlock_Free(DataBlock *block);
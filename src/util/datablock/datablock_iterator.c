@@ -11,13 +11,12 @@
 #include <assert.h>
 #include <stdbool.h>
 
-DataBlockIterator *DataBlockIterator_New(Block *block, uint64_t start_pos, uint64_t end_pos, uint step) {
-	assert(block && end_pos >= start_pos && step >= 1);
+DataBlockIterator *DataBlockIterator_New(const DataBlock *dataBlock, uint64_t start_pos,
+										 uint64_t end_pos, uint step) {
+	assert(dataBlock && end_pos >= start_pos && step >= 1);
 
 	DataBlockIterator *iter = rm_malloc(sizeof(DataBlockIterator));
-	iter->_start_block = block;
-	iter->_current_block = block;
-	iter->_block_pos = start_pos % DATABLOCK_BLOCK_CAP;
+	iter->_dataBlock = dataBlock;
 	iter->_start_pos = start_pos;
 	iter->_current_pos = iter->_start_pos;
 	iter->_end_pos = end_pos;
@@ -26,46 +25,42 @@ DataBlockIterator *DataBlockIterator_New(Block *block, uint64_t start_pos, uint6
 }
 
 DataBlockIterator *DataBlockIterator_Clone(const DataBlockIterator *it) {
-	return DataBlockIterator_New(it->_start_block, it->_start_pos, it->_end_pos, it->_step);
+	return DataBlockIterator_New(it->_dataBlock, it->_start_pos, it->_end_pos, it->_step);
 }
 
 void *DataBlockIterator_Next(DataBlockIterator *iter, uint64_t *id) {
 	assert(iter);
 
-	// Set default.
-	void *item = NULL;
-	DataBlockItemHeader *item_header = NULL;
+	const DataBlock *dataBlock = iter->_dataBlock;
 
 	// Have we reached the end of our iterator?
-	while(iter->_current_pos < iter->_end_pos && iter->_current_block != NULL) {
-		// Get item at current position.
-		Block *block = iter->_current_block;
-		item_header = (DataBlockItemHeader *)block->data + (iter->_block_pos * block->itemSize);
+	while(iter->_current_pos < iter->_end_pos) {
+		uint64_t pos = iter->_current_pos;
 
-		// Advance to next position.
-		iter->_block_pos += iter->_step;
-		iter->_current_pos += iter->_step;
-
-		// Advance to next block if current block consumed.
-		if(iter->_block_pos >= DATABLOCK_BLOCK_CAP) {
-			iter->_block_pos -= DATABLOCK_BLOCK_CAP;
-			iter->_current_block = iter->_current_block->next;
+		if(iter->_step == 1) {
+			// Skip deleted items using the occupancy bitmaps.
+			pos = DataBlock_NextItemPosition(dataBlock, pos, iter->_end_pos);
+			if(pos == iter->_end_pos) {
+				iter->_current_pos = pos;
+				break;
+			}
 		}
 
-		if(!IS_ITEM_DELETED(item_header)) {
-			item = ITEM_DATA(item_header);
-			if(id) *id = iter->_current_pos - iter->_step;
-			break;
+		// Advance to next position.
+		iter->_current_pos = pos + iter->_step;
+
+		void *item = DataBlock_GetItem(dataBlock, pos);
+		if(item) {
+			if(id) *id = pos;
+			return item;
 		}
 	}
 
-	return item;
+	return NULL;
 }
 
 void DataBlockIterator_Reset(DataBlockIterator *iter) {
 	assert(iter);
-	iter->_block_pos = iter->_start_pos % DATABLOCK_BLOCK_CAP;
-	iter->_current_block = iter->_start_block;
 	iter->_current_pos = iter->_start_pos;
 }
 
@@ -7,14 +7,14 @@
 #pragma once
 
 #include <stdint.h>
-#include "../block.h"
+#include <sys/types.h>
+
+struct DataBlock;
 
 /* Datablock iterator iterates over items within a datablock. */
 
 typedef struct {
-	Block *_start_block;			// First block accessed by iterator.
-	Block *_current_block;			// Current block.
-	uint _block_pos;				// Position within a block.
+	const struct DataBlock *_dataBlock;	// Iterated datablock.
 	uint64_t _start_pos;			// Iterator initial position.
 	uint64_t _current_pos;			// Iterator current position.
 	uint64_t _end_pos;				// Iterator won't pass end position.
@@ -23,7 +23,7 @@ typedef struct {
 
 // Creates a new datablock iterator.
 DataBlockIterator *DataBlockIterator_New(
-	Block *block,       // Block from which iteration begins.
+	const struct DataBlock *dataBlock,  // Datablock to iterate.
 	uint64_t start_pos,	// Iteration starts here.
 	uint64_t end_pos,	// Iteration stops here.
 	uint step           // To scan entire range, set step to 1.
@@ -0,0 +1,98 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "histogram.h"
+#include <math.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+static inline uint _Histogram_BucketIndex(uint64_t value) {
+	if(value < HISTOGRAM_SUB_BUCKETS) return value;
+	// Position of the most significant bit selects the power of two range,
+	// the bits following it select the linear bucket within the range.
+	uint msb = 63 - __builtin_clzll(value);
+	uint shift = msb - HISTOGRAM_SUB_BUCKET_BITS;
+	uint sub = (value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1);
+	return HISTOGRAM_SUB_BUCKETS + shift * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+// Returns the largest value mapped to bucket idx.
+static inline uint64_t _Histogram_BucketUpperBound(uint idx) {
+	if(idx < HISTOGRAM_SUB_BUCKETS) return idx;
+	uint shift = (idx - HISTOGRAM_SUB_BUCKETS) / HISTOGRAM_SUB_BUCKETS;
+	uint64_t sub = (idx - HISTOGRAM_SUB_BUCKETS) % HISTOGRAM_SUB_BUCKETS;
+	return ((HISTOGRAM_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+void Histogram_Record(Histogram *h, uint64_t value) {
+	if(value > HISTOGRAM_MAX_VALUE) value = HISTOGRAM_MAX_VALUE;
+
+	__atomic_fetch_add(&h->buckets[_Histogram_BucketIndex(value)], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->count, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->sum, value, __ATOMIC_RELAXED);
+
+	uint64_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+	while(value > max &&
+		  !__atomic_compare_exchange_n(&h->max, &max, value, true, __ATOMIC_RELAXED,
+									   __ATOMIC_RELAXED));
+}
+
+void Histogram_Merge(Histogram *dest, const Histogram *src) {
+	for(uint i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		dest->buckets[i] += __atomic_load_n(&src->buckets[i], __ATOMIC_RELAXED);
+	}
+	dest->count += __atomic_load_n(&src->count, __ATOMIC_RELAXED);
+	dest->sum += __atomic_load_n(&src->sum, __ATOMIC_RELAXED);
+	uint64_t max = __atomic_load_n(&src->max, __ATOMIC_RELAXED);
+	if(max > dest->max) dest->max = max;
+}
+
+uint64_t Histogram_Count(const Histogram *h) {
+	return __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+}
+
+double Histogram_Mean(const Histogram *h) {
+	uint64_t count = Histogram_Count(h);
+	if(count == 0) return 0;
+	return (double)__atomic_load_n(&h->sum, __ATOMIC_RELAXED) / count;
+}
+
+uint64_t Histogram_Max(const Histogram *h) {
+	return __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+}
+
+uint64_t Histogram_Percentile(const Histogram *h, double p) {
+	// Buckets are read individually, the total is taken from them
+	// rather than from count, which might be updated concurrently.
+	uint64_t total = 0;
+	for(uint i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		total += __atomic_load_n(&h->buckets[i], __ATOMIC_RELAXED);
+	}
+	if(total == 0) return 0;
+
+	uint64_t rank = (uint64_t)ceil(p / 100.0 * total);
+	if(rank == 0) rank = 1;
+
+	uint64_t max = Histogram_Max(h);
+	uint64_t seen = 0;
+	for(uint i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		seen += __atomic_load_n(&h->buckets[i], __ATOMIC_RELAXED);
+		if(seen < rank) continue;
+		// No recorded value exceeds max.
+		uint64_t bound = _Histogram_BucketUpperBound(i);
+		return (max > 0 && bound > max) ? max : bound;
+	}
+	return max;
+}
+
+void Histogram_Reset(Histogram *h) {
+	for(uint i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		__atomic_store_n(&h->buckets[i], 0, __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(&h->count, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&h->sum, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&h->max, 0, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,50 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/* Log-linear histogram, in the spirit of HDR histograms:
+ * each power of two range is split into HISTOGRAM_SUB_BUCKETS linear buckets,
+ * bounding the relative error of reported percentiles by 1 / HISTOGRAM_SUB_BUCKETS.
+ * Recording is lock free and may run concurrently with reads and resets,
+ * values larger than HISTOGRAM_MAX_VALUE are clamped. */
+
+#define HISTOGRAM_SUB_BUCKET_BITS 5  // ~3% relative error.
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_MAX_BITS 32
+#define HISTOGRAM_MAX_VALUE ((UINT64_C(1) << HISTOGRAM_MAX_BITS) - 1)
+#define HISTOGRAM_BUCKETS \
+	(HISTOGRAM_SUB_BUCKETS * (HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BUCKET_BITS + 1))
+
+typedef struct {
+	uint64_t count;                         // Number of recorded values.
+	uint64_t sum;                           // Sum of recorded values.
+	uint64_t max;                           // Largest recorded value.
+	uint64_t buckets[HISTOGRAM_BUCKETS];    // Number of values recorded in each bucket.
+} Histogram;
+
+// Record value.
+void Histogram_Record(Histogram *h, uint64_t value);
+
+// Add the values recorded by src to dest, dest is expected to be private to the caller.
+void Histogram_Merge(Histogram *dest, const Histogram *src);
+
+// Returns the number of recorded values.
+uint64_t Histogram_Count(const Histogram *h);
+
+// Returns the mean of recorded values, 0 if none were recorded.
+double Histogram_Mean(const Histogram *h);
+
+// Returns the largest recorded value.
+uint64_t Histogram_Max(const Histogram *h);
+
+// Returns an upper bound of the value at percentile p, 0 <= p <= 100.
+uint64_t Histogram_Percentile(const Histogram *h, double p);
+
+// Discard all recorded values.
+void Histogram_Reset(Histogram *h);
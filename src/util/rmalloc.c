@@ -1,4 +1,42 @@
 #include "rmalloc.h"
+#include <malloc.h>
+#include <stdbool.h>
+
+__thread bool alloc_tracking = false;     // Is the calling thread tracking.
+
+static __thread int64_t _tracked = 0;     // Bytes allocated by the calling thread.
+static __thread size_t _allocated = 0;    // Bytes allocated by the calling thread, disregarding frees.
+
+void Alloc_Track(void *p, int sign) {
+	if(!alloc_tracking || p == NULL) return;
+	size_t size = RedisModule_MallocSize(p);
+	_tracked += sign * (int64_t)size;
+	if(sign > 0) _allocated += size;
+}
+
+bool Alloc_TrackBegin(void) {
+#ifdef REDIS_MODULE_TARGET
+	// Allocation sizes can't be inspected on Redis versions prior to 6.0.
+	if(RedisModule_MallocSize == NULL || alloc_tracking) return false;
+	_tracked = 0;
+	_allocated = 0;
+	alloc_tracking = true;
+	return true;
+#else
+	return false;
+#endif
+}
+
+size_t Alloc_TrackAllocated(void) {
+	return _allocated;
+}
+
+size_t Alloc_TrackEnd(void) {
+	if(!alloc_tracking) return 0;
+	alloc_tracking = false;
+	// Releasing allocations made prior to tracking might result in a negative sum.
+	return (_tracked > 0) ? _tracked : 0;
+}
 
 /* Redefine the allocator functions to use the malloc family.
  * Only to be used when running module code from a non-Redis
@@ -9,4 +47,5 @@ void Alloc_Reset() {
   RedisModule_Calloc = calloc;
   RedisModule_Free = free;
   RedisModule_Strdup = strdup;
+  RedisModule_MallocSize = malloc_usable_size;
 }
@@ -3,24 +3,61 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include "../redismodule.h"
 
+/* Allocation tracking measures the memory held by objects composed of
+ * many allocations, e.g. execution plans, by summing the sizes of the
+ * allocations made by a thread between Alloc_TrackBegin and Alloc_TrackEnd.
+ * Allocations are only inspected by the tracking thread, other threads test
+ * a thread local flag. */
+extern __thread bool alloc_tracking;
+
+#define ALLOC_TRACKING __builtin_expect(alloc_tracking, 0)
+
+// Account for allocation p, the calling thread must be tracking,
+// sign is 1 for a new allocation and -1 for a released one.
+void Alloc_Track(void *p, int sign);
+
+// Start tracking the calling thread's allocations,
+// returns false if allocations can't be tracked or the thread is already tracking.
+bool Alloc_TrackBegin(void);
+
+// Returns the number of bytes allocated since Alloc_TrackBegin, disregarding frees.
+size_t Alloc_TrackAllocated(void);
+
+// Stop tracking the calling thread's allocations,
+// returns the number of bytes allocated and not freed since Alloc_TrackBegin.
+size_t Alloc_TrackEnd(void);
+
 #ifdef REDIS_MODULE_TARGET /* Set this when compiling your code as a module */
 
 static inline void *rm_malloc(size_t n) {
-	return RedisModule_Alloc(n);
+	void *p = RedisModule_Alloc(n);
+	if(ALLOC_TRACKING) Alloc_Track(p, 1);
+	return p;
 }
 static inline void *rm_calloc(size_t nelem, size_t elemsz) {
-	return RedisModule_Calloc(nelem, elemsz);
+	void *p = RedisModule_Calloc(nelem, elemsz);
+	if(ALLOC_TRACKING) Alloc_Track(p, 1);
+	return p;
 }
 static inline void *rm_realloc(void *p, size_t n) {
-	return RedisModule_Realloc(p, n);
+	if(!ALLOC_TRACKING) return RedisModule_Realloc(p, n);
+	Alloc_Track(p, -1);
+	p = RedisModule_Realloc(p, n);
+	Alloc_Track(p, 1);
+	return p;
 }
 static inline void rm_free(void *p) {
+	if(ALLOC_TRACKING) Alloc_Track(p, -1);
 	RedisModule_Free(p);
 }
 static inline char *rm_strdup(const char *s) {
-	return RedisModule_Strdup(s);
+	char *p = RedisModule_Strdup(s);
+	if(ALLOC_TRACKING) Alloc_Track(p, 1);
+	return p;
 }
 
 static inline char *rm_strndup(const char *s, size_t n) {
@@ -4,6 +4,9 @@
  * Description:  Library providing a threading pool where you can add
  *               work. For usage, check the thpool.h file or README.md
  *
+ *               Jobs are scheduled from weighted priority lanes, fair
+ *               among the groups (graphs) queued within each lane.
+ *
  */ /** @file thpool.h */ /*
    *
    ********************************/
@@ -35,33 +38,37 @@
 #define err(str)
 #endif
 
+#define NO_LANE -1
+
 static volatile int threads_keepalive;
 static volatile int threads_on_hold;
 
 /* ========================== STRUCTURES ============================ */
 
-/* Binary semaphore */
-typedef struct bsem {
-	pthread_mutex_t mutex;
-	pthread_cond_t cond;
-	int v;
-} bsem;
-
 /* Job */
 typedef struct job {
-	struct job *prev;            /* pointer to previous job   */
-	void (*function)(void *arg); /* function pointer          */
-	void *arg;                   /* function's argument       */
+	struct job *next;             /* next job within its group */
+	void (*function)(void *arg);  /* function pointer          */
+	void *arg;                    /* function's argument       */
+	struct timespec queued_at;    /* time job was added        */
 } job;
 
-/* Job queue */
-typedef struct jobqueue {
-	pthread_mutex_t rwmutex; /* used for queue r/w access */
-	job *front;              /* pointer to front of queue */
-	job *rear;               /* pointer to rear  of queue */
-	bsem *has_jobs;          /* flag as binary semaphore  */
-	int len;                 /* number of jobs in queue   */
-} jobqueue;
+/* Queued jobs of a single group, in order of arrival */
+typedef struct group {
+	const void *key;              /* group key                 */
+	job *front;                   /* pointer to front of group */
+	job *rear;                    /* pointer to rear of group  */
+	struct group *next;           /* next group to be served   */
+} group;
+
+/* Priority lane, serves its groups in round robin */
+typedef struct lane {
+	group *front;                 /* group to be served next   */
+	group *rear;                  /* group served last         */
+	int len;                      /* number of jobs in lane    */
+	int weight;                   /* lane's share of the pool  */
+	int credit;                   /* weighted round robin state */
+} lane;
 
 /* Thread */
 typedef struct thread {
@@ -73,13 +80,19 @@ typedef struct thread {
 /* Threadpool */
 typedef struct thpool_ {
 	thread **threads;                 /* pointer to threads        */
+	int num_threads;                  /* threads created           */
 	volatile int num_threads_alive;   /* threads currently alive   */
 	volatile int num_threads_working; /* threads currently working */
-	pthread_mutex_t thcount_lock;     /* used for thread count etc */
+	int num_threads_heavy;            /* threads running heavy jobs */
+	pthread_mutex_t lock;             /* used for lanes, counters  */
+	pthread_cond_t has_jobs;          /* signal to idle threads    */
 	pthread_cond_t threads_all_idle;  /* signal to thpool_wait     */
-	jobqueue jobqueue;                /* job queue                 */
+	lane lanes[THPOOL_LANE_COUNT];    /* priority lanes            */
 } thpool_;
 
+static __thread thread *current_thread = NULL;  /* pool thread running caller */
+static __thread double current_job_wait = 0;    /* current job's queue time   */
+
 /* ========================== PROTOTYPES ============================ */
 
 static int thread_init(thpool_* thpool_p, struct thread **thread_p, int id);
@@ -87,17 +100,15 @@ static void *thread_do(struct thread *thread_p);
 static void thread_hold(int sig_id);
 static void thread_destroy(struct thread *thread_p);
 
-static int jobqueue_init(jobqueue *jobqueue_p);
-static void jobqueue_clear(jobqueue *jobqueue_p);
-static void jobqueue_push(jobqueue *jobqueue_p, struct job *newjob_p);
-static struct job *jobqueue_pull(jobqueue *jobqueue_p);
-static void jobqueue_destroy(jobqueue *jobqueue_p);
+static job *job_new(void (*function_p)(void *), void *arg_p);
+static double job_wait_time(const job *job_p);
+
+static void lane_push(lane *lane_p, const void *key, job *newjob_p);
+static job *lane_pull(lane *lane_p);
+static void lane_clear(lane *lane_p);
 
-static void bsem_init(struct bsem *bsem_p, int value);
-static void bsem_reset(struct bsem *bsem_p);
-static void bsem_post(struct bsem *bsem_p);
-static void bsem_post_all(struct bsem *bsem_p);
-static void bsem_wait(struct bsem *bsem_p);
+static job *lanes_pull(thpool_* thpool_p, int *lane_id);
+static int lanes_len(thpool_* thpool_p);
 
 /* ========================== THREADPOOL ============================ */
 
@@ -113,31 +124,26 @@ struct thpool_ *thpool_init(int num_threads) {
 
 	/* Make new thread pool */
 	thpool_* thpool_p;
-	thpool_p = (struct thpool_ *)malloc(sizeof(struct thpool_));
+	thpool_p = (struct thpool_ *)calloc(1, sizeof(struct thpool_));
 	if(thpool_p == NULL) {
 		err("thpool_init(): Could not allocate memory for thread pool\n");
 		return NULL;
 	}
-	thpool_p->num_threads_alive = 0;
-	thpool_p->num_threads_working = 0;
+	thpool_p->num_threads = num_threads;
 
-	/* Initialise the job queue */
-	if(jobqueue_init(&thpool_p->jobqueue) == -1) {
-		err("thpool_init(): Could not allocate memory for job queue\n");
-		free(thpool_p);
-		return NULL;
-	}
+	/* Initialise the lanes */
+	for(int l = 0; l < THPOOL_LANE_COUNT; l++) thpool_p->lanes[l].weight = 1;
 
 	/* Make threads in pool */
 	thpool_p->threads = (struct thread **)malloc(num_threads * sizeof(struct thread *));
 	if(thpool_p->threads == NULL) {
 		err("thpool_init(): Could not allocate memory for threads\n");
-		jobqueue_destroy(&thpool_p->jobqueue);
 		free(thpool_p);
 		return NULL;
 	}
 
-	pthread_mutex_init(&(thpool_p->thcount_lock), NULL);
+	pthread_mutex_init(&(thpool_p->lock), NULL);
+	pthread_cond_init(&thpool_p->has_jobs, NULL);
 	pthread_cond_init(&thpool_p->threads_all_idle, NULL);
 
 	/* Thread init */
@@ -156,33 +162,45 @@ struct thpool_ *thpool_init(int num_threads) {
 	return thpool_p;
 }
 
-/* Add work to the thread pool */
+/* Set the lanes' weights */
+void thpool_set_lane_weights(thpool_* thpool_p, const int weights[THPOOL_LANE_COUNT]) {
+	pthread_mutex_lock(&thpool_p->lock);
+	for(int l = 0; l < THPOOL_LANE_COUNT; l++) {
+		assert(weights[l] > 0);
+		thpool_p->lanes[l].weight = weights[l];
+		thpool_p->lanes[l].credit = 0;
+	}
+	pthread_mutex_unlock(&thpool_p->lock);
+}
+
+/* Add work to the thread pool, lane-less jobs are background work */
 int thpool_add_work(thpool_* thpool_p, void (*function_p)(void *), void *arg_p) {
-	job *newjob;
+	return thpool_add_work_lane(thpool_p, function_p, arg_p, THPOOL_LANE_HEAVY, NULL);
+}
 
-	newjob = (struct job *)malloc(sizeof(struct job));
-	if(newjob == NULL) {
-		err("thpool_add_work(): Could not allocate memory for new job\n");
-		return -1;
-	}
+/* Add work to a priority lane */
+int thpool_add_work_lane(thpool_* thpool_p, void (*function_p)(void *), void *arg_p,
+						 thpool_lane lane, const void *group) {
+	assert(lane >= 0 && lane < THPOOL_LANE_COUNT);
 
-	/* add function and argument */
-	newjob->function = function_p;
-	newjob->arg = arg_p;
+	job *newjob = job_new(function_p, arg_p);
+	if(newjob == NULL) return -1;
 
-	/* add job to queue */
-	jobqueue_push(&thpool_p->jobqueue, newjob);
+	pthread_mutex_lock(&thpool_p->lock);
+	lane_push(&thpool_p->lanes[lane], group, newjob);
+	pthread_cond_signal(&thpool_p->has_jobs);
+	pthread_mutex_unlock(&thpool_p->lock);
 
 	return 0;
 }
 
 /* Wait until all jobs have finished */
 void thpool_wait(thpool_* thpool_p) {
-	pthread_mutex_lock(&thpool_p->thcount_lock);
-	while(thpool_p->jobqueue.len || thpool_p->num_threads_working) {
-		pthread_cond_wait(&thpool_p->threads_all_idle, &thpool_p->thcount_lock);
+	pthread_mutex_lock(&thpool_p->lock);
+	while(lanes_len(thpool_p) || thpool_p->num_threads_working) {
+		pthread_cond_wait(&thpool_p->threads_all_idle, &thpool_p->lock);
 	}
-	pthread_mutex_unlock(&thpool_p->thcount_lock);
+	pthread_mutex_unlock(&thpool_p->lock);
 }
 
 /* Destroy the threadpool */
@@ -201,19 +219,24 @@ void thpool_destroy(thpool_* thpool_p) {
 	double tpassed = 0.0;
 	time(&start);
 	while(tpassed < TIMEOUT && thpool_p->num_threads_alive) {
-		bsem_post_all(thpool_p->jobqueue.has_jobs);
+		pthread_mutex_lock(&thpool_p->lock);
+		pthread_cond_broadcast(&thpool_p->has_jobs);
+		pthread_mutex_unlock(&thpool_p->lock);
 		time(&end);
 		tpassed = difftime(end, start);
 	}
 
 	/* Poll remaining threads */
 	while(thpool_p->num_threads_alive) {
-		bsem_post_all(thpool_p->jobqueue.has_jobs);
+		pthread_mutex_lock(&thpool_p->lock);
+		pthread_cond_broadcast(&thpool_p->has_jobs);
+		pthread_mutex_unlock(&thpool_p->lock);
 		sleep(1);
 	}
 
-	/* Job queue cleanup */
-	jobqueue_destroy(&thpool_p->jobqueue);
+	/* Job queues cleanup */
+	for(int l = 0; l < THPOOL_LANE_COUNT; l++) lane_clear(&thpool_p->lanes[l]);
+
 	/* Deallocs */
 	int n;
 	for(n = 0; n < threads_total; n++) {
@@ -255,6 +278,12 @@ int thpool_num_threads(thpool_* thpool_p) {
 }
 
 int thpool_get_thread_id(thpool_* thpool_p, pthread_t pthread) {
+	// Fast path, caller asks for its own id.
+	if(current_thread && current_thread->thpool_p == thpool_p &&
+	   pthread_equal(current_thread->pthread, pthread)) {
+		return current_thread->id;
+	}
+
 	for(int i = 0; i < thpool_p->num_threads_alive; i++) {
 		thread *thread = thpool_p->threads[i];
 		if(thread->pthread == pthread) return thread->id;
@@ -264,6 +293,10 @@ int thpool_get_thread_id(thpool_* thpool_p, pthread_t pthread) {
 	return -1;
 }
 
+double thpool_job_wait_time(void) {
+	return (current_thread) ? current_job_wait : 0;
+}
+
 /* ============================ THREAD ============================== */
 
 /* Initialize a thread in the thread pool
@@ -275,7 +308,7 @@ int thpool_get_thread_id(thpool_* thpool_p, pthread_t pthread) {
 static int thread_init(thpool_* thpool_p, struct thread **thread_p, int id) {
 
 	*thread_p = (struct thread *)malloc(sizeof(struct thread));
-	if(thread_p == NULL) {
+	if(*thread_p == NULL) {
 		err("thread_init(): Could not allocate memory for thread\n");
 		return -1;
 	}
@@ -297,6 +330,27 @@ static void thread_hold(int sig_id) {
 	}
 }
 
+/* Get the next job to run, blocks until one is available
+ *
+ * @param  thread_p      thread looking for work
+ * @param  lane_id       set to the job's lane
+ * @return job, NULL once the pool is destroyed
+ */
+static job *thread_next_job(thread *thread_p, int *lane_id) {
+	thpool_* thpool_p = thread_p->thpool_p;
+	job *job_p = NULL;
+
+	/* Sleep until a job is added, pushes and heavy job completions
+	 * signal under the pool lock, as such no wake up is missed */
+	pthread_mutex_lock(&thpool_p->lock);
+	while(threads_keepalive && (job_p = lanes_pull(thpool_p, lane_id)) == NULL) {
+		pthread_cond_wait(&thpool_p->has_jobs, &thpool_p->lock);
+	}
+	pthread_mutex_unlock(&thpool_p->lock);
+
+	return job_p;
+}
+
 /* What each thread is doing
 *
 * In principle this is an endless loop. The only time this loop gets interuppted is once
@@ -322,6 +376,7 @@ static void *thread_do(struct thread *thread_p) {
 
 	/* Assure all threads have been created before starting serving */
 	thpool_* thpool_p = thread_p->thpool_p;
+	current_thread = thread_p;
 
 	/* Register signal handler */
 	struct sigaction act;
@@ -333,42 +388,40 @@ static void *thread_do(struct thread *thread_p) {
 	}
 
 	/* Mark thread as alive (initialized) */
-	pthread_mutex_lock(&thpool_p->thcount_lock);
+	pthread_mutex_lock(&thpool_p->lock);
 	thpool_p->num_threads_alive += 1;
-	pthread_mutex_unlock(&thpool_p->thcount_lock);
+	pthread_mutex_unlock(&thpool_p->lock);
 
 	while(threads_keepalive) {
-
-		bsem_wait(thpool_p->jobqueue.has_jobs);
-
-		if(threads_keepalive) {
-
-			pthread_mutex_lock(&thpool_p->thcount_lock);
-			thpool_p->num_threads_working++;
-			pthread_mutex_unlock(&thpool_p->thcount_lock);
-
-			/* Read job from queue and execute it */
-			void (*func_buff)(void *);
-			void *arg_buff;
-			job *job_p = jobqueue_pull(&thpool_p->jobqueue);
-			if(job_p) {
-				func_buff = job_p->function;
-				arg_buff = job_p->arg;
-				func_buff(arg_buff);
-				free(job_p);
-			}
-
-			pthread_mutex_lock(&thpool_p->thcount_lock);
-			thpool_p->num_threads_working--;
-			if(!thpool_p->num_threads_working) {
-				pthread_cond_signal(&thpool_p->threads_all_idle);
-			}
-			pthread_mutex_unlock(&thpool_p->thcount_lock);
+		int lane_id;
+		job *job_p = thread_next_job(thread_p, &lane_id);
+		if(job_p == NULL) break;
+
+		pthread_mutex_lock(&thpool_p->lock);
+		thpool_p->num_threads_working++;
+		pthread_mutex_unlock(&thpool_p->lock);
+
+		/* Execute job */
+		current_job_wait = job_wait_time(job_p);
+		job_p->function(job_p->arg);
+		current_job_wait = 0;
+		free(job_p);
+
+		pthread_mutex_lock(&thpool_p->lock);
+		thpool_p->num_threads_working--;
+		if(lane_id == THPOOL_LANE_HEAVY) {
+			/* A heavy job held back by the heavy threads limit may run now */
+			thpool_p->num_threads_heavy--;
+			pthread_cond_signal(&thpool_p->has_jobs);
 		}
+		if(!thpool_p->num_threads_working) {
+			pthread_cond_broadcast(&thpool_p->threads_all_idle);
+		}
+		pthread_mutex_unlock(&thpool_p->lock);
 	}
-	pthread_mutex_lock(&thpool_p->thcount_lock);
+	pthread_mutex_lock(&thpool_p->lock);
 	thpool_p->num_threads_alive--;
-	pthread_mutex_unlock(&thpool_p->thcount_lock);
+	pthread_mutex_unlock(&thpool_p->lock);
 
 	return NULL;
 }
@@ -378,139 +431,145 @@ static void thread_destroy(thread *thread_p) {
 	free(thread_p);
 }
 
-/* ============================ JOB QUEUE =========================== */
-
-/* Initialize queue */
-static int jobqueue_init(jobqueue *jobqueue_p) {
-	jobqueue_p->len = 0;
-	jobqueue_p->front = NULL;
-	jobqueue_p->rear = NULL;
+/* ============================== JOB =============================== */
 
-	jobqueue_p->has_jobs = (struct bsem *)malloc(sizeof(struct bsem));
-	if(jobqueue_p->has_jobs == NULL) {
-		return -1;
+/* Allocate a new job, recording its creation time */
+static job *job_new(void (*function_p)(void *), void *arg_p) {
+	job *newjob = (struct job *)malloc(sizeof(struct job));
+	if(newjob == NULL) {
+		err("thpool_add_work(): Could not allocate memory for new job\n");
+		return NULL;
 	}
 
-	pthread_mutex_init(&(jobqueue_p->rwmutex), NULL);
-	bsem_init(jobqueue_p->has_jobs, 0);
-
-	return 0;
+	/* add function and argument */
+	newjob->next = NULL;
+	newjob->function = function_p;
+	newjob->arg = arg_p;
+	clock_gettime(CLOCK_MONOTONIC, &newjob->queued_at);
+	return newjob;
 }
 
-/* Clear the queue */
-static void jobqueue_clear(jobqueue *jobqueue_p) {
-
-	while(jobqueue_p->len) {
-		free(jobqueue_pull(jobqueue_p));
-	}
-
-	jobqueue_p->front = NULL;
-	jobqueue_p->rear = NULL;
-	bsem_reset(jobqueue_p->has_jobs);
-	jobqueue_p->len = 0;
+/* Time elapsed since job was added, in milliseconds */
+static double job_wait_time(const job *job_p) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - job_p->queued_at.tv_sec) * 1000.0 +
+		   (now.tv_nsec - job_p->queued_at.tv_nsec) / 1000000.0;
 }
 
-/* Add (allocated) job to queue
- */
-static void jobqueue_push(jobqueue *jobqueue_p, struct job *newjob) {
-
-	pthread_mutex_lock(&jobqueue_p->rwmutex);
-	newjob->prev = NULL;
-
-	switch(jobqueue_p->len) {
+/* ============================== LANE ============================== */
 
-	case 0: /* if no jobs in queue */
-		jobqueue_p->front = newjob;
-		jobqueue_p->rear = newjob;
-		break;
-
-	default: /* if jobs in queue */
-		jobqueue_p->rear->prev = newjob;
-		jobqueue_p->rear = newjob;
+/* Add job to the rear of its group, groups are few (one per active graph)
+ * and are looked up linearly
+ *
+ * Notice: Caller MUST hold the pool lock
+ */
+static void lane_push(lane *lane_p, const void *key, job *newjob_p) {
+	group *group_p = lane_p->front;
+	while(group_p && group_p->key != key) group_p = group_p->next;
+
+	if(group_p == NULL) {
+		/* new group joins the round robin last */
+		group_p = (struct group *)malloc(sizeof(struct group));
+		group_p->key = key;
+		group_p->front = NULL;
+		group_p->rear = NULL;
+		group_p->next = NULL;
+		if(lane_p->rear) lane_p->rear->next = group_p;
+		else lane_p->front = group_p;
+		lane_p->rear = group_p;
 	}
-	jobqueue_p->len++;
 
-	bsem_post(jobqueue_p->has_jobs);
-	pthread_mutex_unlock(&jobqueue_p->rwmutex);
+	if(group_p->rear) group_p->rear->next = newjob_p;
+	else group_p->front = newjob_p;
+	group_p->rear = newjob_p;
+	lane_p->len++;
 }
 
-/* Get first job from queue(removes it from queue)
+/* Get the first job of the front group, the group then moves to the rear
  *
- * Notice: Caller MUST hold a mutex
+ * Notice: Caller MUST hold the pool lock
  */
-static struct job *jobqueue_pull(jobqueue *jobqueue_p) {
-
-	pthread_mutex_lock(&jobqueue_p->rwmutex);
-	job *job_p = jobqueue_p->front;
-
-	switch(jobqueue_p->len) {
-
-	case 0: /* if no jobs in queue */
-		break;
-
-	case 1: /* if one job in queue */
-		jobqueue_p->front = NULL;
-		jobqueue_p->rear = NULL;
-		jobqueue_p->len = 0;
-		break;
-
-	default: /* if >1 jobs in queue */
-		jobqueue_p->front = job_p->prev;
-		jobqueue_p->len--;
-		/* more than one job in queue -> post it */
-		bsem_post(jobqueue_p->has_jobs);
+static job *lane_pull(lane *lane_p) {
+	group *group_p = lane_p->front;
+	if(group_p == NULL) return NULL;
+
+	job *job_p = group_p->front;
+	group_p->front = job_p->next;
+	if(group_p->front == NULL) group_p->rear = NULL;
+	job_p->next = NULL;
+	lane_p->len--;
+
+	/* detach group from front */
+	lane_p->front = group_p->next;
+	if(lane_p->front == NULL) lane_p->rear = NULL;
+	group_p->next = NULL;
+
+	if(group_p->front == NULL) {
+		free(group_p);
+	} else {
+		/* group has more jobs, serve it again once other groups were served */
+		if(lane_p->rear) lane_p->rear->next = group_p;
+		else lane_p->front = group_p;
+		lane_p->rear = group_p;
 	}
 
-	pthread_mutex_unlock(&jobqueue_p->rwmutex);
 	return job_p;
 }
 
-/* Free all queue resources back to the system */
-static void jobqueue_destroy(jobqueue *jobqueue_p) {
-	jobqueue_clear(jobqueue_p);
-	free(jobqueue_p->has_jobs);
+/* Free all lane resources back to the system */
+static void lane_clear(lane *lane_p) {
+	job *job_p;
+	while((job_p = lane_pull(lane_p))) free(job_p);
 }
 
-/* ======================== SYNCHRONISATION ========================= */
+/* Maximum number of threads running heavy jobs,
+ * one thread is kept for other lanes */
+static inline int heavy_threads_limit(thpool_* thpool_p) {
+	return (thpool_p->num_threads > 1) ? thpool_p->num_threads - 1 : 1;
+}
 
-/* Init semaphore to 1 or 0 */
-static void bsem_init(bsem *bsem_p, int value) {
-	if(value < 0 || value > 1) {
-		err("bsem_init(): Binary semaphore can take only values 1 or 0");
-		exit(1);
+/* Whether lane can be served */
+static inline int lane_runnable(thpool_* thpool_p, int l) {
+	if(thpool_p->lanes[l].len == 0) return 0;
+	if(l == THPOOL_LANE_HEAVY) {
+		return thpool_p->num_threads_heavy < heavy_threads_limit(thpool_p);
 	}
-	pthread_mutex_init(&(bsem_p->mutex), NULL);
-	pthread_cond_init(&(bsem_p->cond), NULL);
-	bsem_p->v = value;
+	return 1;
 }
 
-/* Reset semaphore to 0 */
-static void bsem_reset(bsem *bsem_p) {
-	bsem_init(bsem_p, 0);
+/* Number of jobs in lanes
+ *
+ * Notice: Caller MUST hold the pool lock
+ */
+static int lanes_len(thpool_* thpool_p) {
+	int len = 0;
+	for(int l = 0; l < THPOOL_LANE_COUNT; l++) len += thpool_p->lanes[l].len;
+	return len;
 }
 
-/* Post to at least one thread */
-static void bsem_post(bsem *bsem_p) {
-	pthread_mutex_lock(&bsem_p->mutex);
-	bsem_p->v = 1;
-	pthread_cond_signal(&bsem_p->cond);
-	pthread_mutex_unlock(&bsem_p->mutex);
-}
+/* Pull a job from the lanes, lanes are chosen by smooth weighted round robin:
+ * each runnable lane gains its weight in credit, the lane with the most credit
+ * is served and pays the total weight of the runnable lanes
+ *
+ * Notice: Caller MUST hold the pool lock
+ */
+static job *lanes_pull(thpool_* thpool_p, int *lane_id) {
+	int chosen = NO_LANE;
+	int total_weight = 0;
+
+	for(int l = 0; l < THPOOL_LANE_COUNT; l++) {
+		if(!lane_runnable(thpool_p, l)) continue;
+		lane *lane_p = &thpool_p->lanes[l];
+		lane_p->credit += lane_p->weight;
+		total_weight += lane_p->weight;
+		if(chosen == NO_LANE || lane_p->credit > thpool_p->lanes[chosen].credit) chosen = l;
+	}
 
-/* Post to all threads */
-static void bsem_post_all(bsem *bsem_p) {
-	pthread_mutex_lock(&bsem_p->mutex);
-	bsem_p->v = 1;
-	pthread_cond_broadcast(&bsem_p->cond);
-	pthread_mutex_unlock(&bsem_p->mutex);
-}
+	*lane_id = chosen;
+	if(chosen == NO_LANE) return NULL;
 
-/* Wait on semaphore until semaphore has value 0 */
-static void bsem_wait(bsem *bsem_p) {
-	pthread_mutex_lock(&bsem_p->mutex);
-	while(bsem_p->v != 1) {
-		pthread_cond_wait(&bsem_p->cond, &bsem_p->mutex);
-	}
-	bsem_p->v = 0;
-	pthread_mutex_unlock(&bsem_p->mutex);
+	thpool_p->lanes[chosen].credit -= total_weight;
+	if(chosen == THPOOL_LANE_HEAVY) thpool_p->num_threads_heavy++;
+	return lane_pull(&thpool_p->lanes[chosen]);
 }
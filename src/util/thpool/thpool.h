@@ -7,6 +7,8 @@
 #ifndef _THPOOL_
 #define _THPOOL_
 
+#include <pthread.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -17,6 +19,17 @@ extern "C" {
 typedef struct thpool_* threadpool;
 
 
+/* Jobs are queued in priority lanes, idle threads choose the lane to serve
+ * next in proportion to the lanes' weights, such that a burst of heavy jobs
+ * doesn't delay short ones. Heavy jobs never occupy every thread. */
+typedef enum {
+	THPOOL_LANE_READ,     /* read only queries               */
+	THPOOL_LANE_WRITE,    /* write queries                   */
+	THPOOL_LANE_HEAVY,    /* procedures, background tasks    */
+	THPOOL_LANE_COUNT
+} thpool_lane;
+
+
 /**
  * @brief  Initialize threadpool
  *
@@ -67,6 +80,44 @@ threadpool thpool_init(int num_threads);
 int thpool_add_work(threadpool, void (*function_p)(void*), void* arg_p);
 
 
+/**
+ * @brief Add work to a priority lane
+ *
+ * Within a lane jobs are grouped by their group key, groups are served in
+ * round robin, such that a group with many queued jobs doesn't starve others.
+ *
+ * @param  threadpool    threadpool to which the work will be added
+ * @param  function_p    pointer to function to add as work
+ * @param  arg_p         pointer to an argument
+ * @param  lane          lane to queue the job in
+ * @param  group         group key, e.g. the graph the job operates on, may be NULL
+ * @return 0 on successs, -1 otherwise.
+ */
+int thpool_add_work_lane(threadpool, void (*function_p)(void*), void* arg_p, thpool_lane lane,
+						 const void *group);
+
+
+/**
+ * @brief Set the lanes' weights
+ *
+ * A lane with weight w is served w times for every time a lane with weight 1
+ * is served, as long as both have queued jobs. Default weights are 1.
+ *
+ * @param threadpool     the threadpool of interest
+ * @param weights        positive weight of each lane
+ * @return nothing
+ */
+void thpool_set_lane_weights(threadpool, const int weights[THPOOL_LANE_COUNT]);
+
+
+/**
+ * @brief Returns the time the calling thread's current job spent queued
+ *
+ * @return double        wait time in milliseconds, 0 if called outside of a pool thread
+ */
+double thpool_job_wait_time(void);
+
+
 /**
  * @brief Wait for all queued jobs to finish
  *
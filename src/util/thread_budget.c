@@ -0,0 +1,102 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "thread_budget.h"
+#include "../RG.h"
+#include "simple_timer.h"
+#include <sys/param.h>
+
+//------------------------------------------------------------------------------
+// Data structures
+//------------------------------------------------------------------------------
+
+// Budget object
+typedef struct {
+	int cores;          // number of cores shared by GraphBLAS operations
+	threadpool pool;    // pool running queries
+	int granted;        // threads granted to in-flight operations
+	int active;         // number of in-flight operations
+} THREAD_BUDGET;
+
+static THREAD_BUDGET budget = {.cores = 1, .pool = NULL, .granted = 0, .active = 0};
+
+static __thread int grant = 0;                          // caller's in-flight grant
+static __thread GrB_Descriptor desc_default = GrB_NULL; // caller's default descriptor
+static __thread ThreadBudgetStats *stats = NULL;        // caller's stats
+static __thread double timer[2];                        // caller's in-flight operation timer
+
+//------------------------------------------------------------------------------
+// Budget
+//------------------------------------------------------------------------------
+
+// Number of threads to grant the calling thread
+static int _ThreadBudget_Grant(void) {
+	int cores = budget.cores;
+
+	// Queries running on the pool, each occupying at least a single core.
+	int busy = (budget.pool) ? thpool_num_threads_working(budget.pool) : 0;
+	busy = MAX(busy, 1);
+
+	// Cores occupied by others: in-flight grants and
+	// queries other than the caller which are not within an operation.
+	int granted = __atomic_load_n(&budget.granted, __ATOMIC_RELAXED);
+	int active = __atomic_load_n(&budget.active, __ATOMIC_RELAXED);
+	int occupied = granted + MAX(busy - active - 1, 0);
+
+	int idle = cores - occupied;
+	int fair_share = MAX(cores / busy, 1);
+	return MAX(MIN(idle, fair_share), 1);
+}
+
+void ThreadBudget_Init(int cores, threadpool pool) {
+	ASSERT(cores > 0);
+	budget.cores = cores;
+	budget.pool = pool;
+}
+
+GrB_Descriptor ThreadBudget_Acquire(GrB_Descriptor desc) {
+	ASSERT(grant == 0);
+
+	grant = _ThreadBudget_Grant();
+	__atomic_add_fetch(&budget.granted, grant, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&budget.active, 1, __ATOMIC_RELAXED);
+
+	if(stats) {
+		stats->min_threads = (stats->calls) ? MIN(stats->min_threads, grant) : grant;
+		stats->max_threads = (stats->calls) ? MAX(stats->max_threads, grant) : grant;
+		stats->calls++;
+		simple_tic(timer);
+	}
+
+	if(desc == GrB_NULL) {
+		if(desc_default == GrB_NULL) GrB_Descriptor_new(&desc_default);
+		desc = desc_default;
+	}
+
+	GrB_Info info = GxB_Desc_set(desc, GxB_NTHREADS, grant);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+
+	return desc;
+}
+
+void ThreadBudget_Release(void) {
+	ASSERT(grant > 0);
+	if(stats) stats->time += simple_toc(timer);
+	__atomic_sub_fetch(&budget.granted, grant, __ATOMIC_RELAXED);
+	__atomic_sub_fetch(&budget.active, 1, __ATOMIC_RELAXED);
+	grant = 0;
+}
+
+void ThreadBudget_AddTime(double seconds) {
+	if(stats) stats->time += seconds;
+}
+
+ThreadBudgetStats *ThreadBudget_SetStats(ThreadBudgetStats *s) {
+	ThreadBudgetStats *prev = stats;
+	stats = s;
+	return prev;
+}
@@ -0,0 +1,58 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "thpool/thpool.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+/* Thread budget coordinates the OpenMP threads used by GraphBLAS operations
+ * with the thread pool: each pool thread running a query occupies a core,
+ * a GraphBLAS operation is granted the cores left idle by other queries,
+ * bounded by a fair share of the cores among the running queries.
+ * A lone heavy query is granted every core while concurrent queries are
+ * granted a single core each, avoiding oversubscription. */
+
+// Budget decisions made within a scope, e.g. a profiled operation
+typedef struct {
+	uint calls;         // number of GraphBLAS operations granted threads
+	int min_threads;    // fewest threads granted to a single operation
+	int max_threads;    // most threads granted to a single operation
+	double time;        // seconds spent within GraphBLAS
+} ThreadBudgetStats;
+
+// Initialize budget, should be called once
+void ThreadBudget_Init
+(
+	int cores,          // number of cores shared by GraphBLAS operations
+	threadpool pool     // [optional] pool running queries
+);
+
+// Grant threads to a single GraphBLAS operation
+// sets the thread count of desc, or of a thread local descriptor
+// if desc is GrB_NULL, returns the descriptor to pass to the operation
+// must be followed by a call to ThreadBudget_Release
+GrB_Descriptor ThreadBudget_Acquire
+(
+	GrB_Descriptor desc
+);
+
+// Return threads granted by the last call to ThreadBudget_Acquire
+void ThreadBudget_Release(void);
+
+// Account for time spent within GraphBLAS outside of budgeted operations
+// e.g. flushing a matrix's pending changes, recorded into the caller's stats
+void ThreadBudget_AddTime
+(
+	double seconds
+);
+
+// Record the calling thread's budget decisions into stats
+// returns the previous stats, NULL stops recording
+ThreadBudgetStats *ThreadBudget_SetStats
+(
+	ThreadBudgetStats *stats
+);
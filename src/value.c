@@ -14,6 +14,7 @@
 #include <ctype.h>
 #include <sys/param.h>
 #include <assert.h>
+#include "util/arr.h"
 #include "util/rmalloc.h"
 #include "datatypes/array.h"
 #include "datatypes/path/sipath.h"
@@ -101,6 +102,46 @@ SIValue SI_TransferStringVal(char *s) {
 	};
 }
 
+SIValue SI_SharedStringVal(const char *s) {
+	size_t len = strlen(s) + 1;
+	char *str = SI_RefAlloc(len);
+	memcpy(str, s, len);
+	return (SIValue) {
+		.stringval = str, .type = T_STRING, .allocation = M_SHARED
+	};
+}
+
+// Header preceding a ref-counted payload, sized to keep the payload 8 bytes aligned.
+typedef struct {
+	uint32_t refcount;
+	uint32_t pad;
+} SIRefHeader;
+
+#define SI_REF_HEADER(payload) ((SIRefHeader *)((char *)(payload) - sizeof(SIRefHeader)))
+
+void *SI_RefAlloc(size_t n) {
+	SIRefHeader *hdr = rm_malloc(sizeof(SIRefHeader) + n);
+	hdr->refcount = 1;
+	return hdr + 1;
+}
+
+void SI_RefRetain(void *payload) {
+	// Payloads might be shared by concurrent readers, e.g. graph entity properties.
+	__atomic_fetch_add(&SI_REF_HEADER(payload)->refcount, 1, __ATOMIC_RELAXED);
+}
+
+bool SI_RefRelease(void *payload) {
+	return __atomic_sub_fetch(&SI_REF_HEADER(payload)->refcount, 1, __ATOMIC_ACQ_REL) == 0;
+}
+
+void SI_RefFree(void *payload) {
+	rm_free(SI_REF_HEADER(payload));
+}
+
+uint32_t SI_RefCount(const void *payload) {
+	return __atomic_load_n(&SI_REF_HEADER(payload)->refcount, __ATOMIC_ACQUIRE);
+}
+
 /* Make an SIValue that reuses the original's allocations, if any.
  * The returned value is not responsible for freeing any allocations,
  * and is not guaranteed that these allocations will remain in scope. */
@@ -108,6 +149,7 @@ SIValue SI_ShareValue(const SIValue v) {
 	SIValue dup = v;
 	// If the original value owns an allocation, mark that the duplicate shares it.
 	if(v.allocation == M_SELF) dup.allocation = M_VOLATILE;
+	else if(v.allocation == M_SHARED) dup.allocation = M_SHARED | M_VOLATILE;
 	return dup;
 }
 
@@ -118,8 +160,15 @@ SIValue SI_CloneValue(const SIValue v) {
 	if(v.allocation == M_NONE) return v; // Stack value; no allocation necessary.
 
 	if(v.type == T_STRING) {
-		// Allocate a new copy of the input's string value.
-		return SI_DuplicateStringVal(v.stringval);
+		// Ref-counted strings are immutable, add a reference.
+		if(v.allocation & M_SHARED) {
+			SI_RefRetain(v.stringval);
+			SIValue ref = v;
+			ref.allocation = M_SHARED;
+			return ref;
+		}
+		// Allocate a new ref-counted copy of the input's string value.
+		return SI_SharedStringVal(v.stringval);
 	}
 
 	if(v.type == T_ARRAY) {
@@ -154,7 +203,9 @@ SIValue SI_CloneValue(const SIValue v) {
  *  to remain in scope. This is most frequently the case for GraphEntity properties. */
 SIValue SI_ConstValue(const SIValue v) {
 	SIValue dup = v;
-	if(v.allocation != M_NONE) dup.allocation = M_CONST;
+	// Ref-counted allocations remain shared, such that clones only add a reference.
+	if(v.allocation & M_SHARED) dup.allocation = M_SHARED | M_CONST;
+	else if(v.allocation != M_NONE) dup.allocation = M_CONST;
 	return dup;
 }
 
@@ -163,6 +214,7 @@ SIValue SI_ConstValue(const SIValue v) {
  * This is used in cases like performing shallow copies of scalars in Record entries. */
 void SIValue_MakeVolatile(SIValue *v) {
 	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	else if(v->allocation == M_SHARED) v->allocation = M_SHARED | M_VOLATILE;
 }
 
 /* Ensure that any allocation held by the given SIValue is guaranteed to not go out
@@ -171,9 +223,10 @@ void SIValue_MakeVolatile(SIValue *v) {
  * or a GraphEntity property, are not modified. */
 void SIValue_Persist(SIValue *v) {
 	// Do nothing for non-volatile values.
-	if(v->allocation != M_VOLATILE) return;
+	if(!(v->allocation & M_VOLATILE)) return;
 
-	// For volatile values, persisting uses the same logic as cloning.
+	// For volatile values, persisting uses the same logic as cloning,
+	// which only adds a reference to ref-counted allocations.
 	*v = SI_CloneValue(*v);
 }
 
@@ -620,11 +673,15 @@ XXH64_hash_t SIValue_HashCode(SIValue v) {
 }
 
 void SIValue_Free(SIValue v) {
-	// The free routine only performs work if it owns a heap allocation.
-	if(v.allocation != M_SELF) return;
+	// The free routine only performs work if it owns a heap allocation or a reference.
+	if(v.allocation != M_SELF && v.allocation != M_SHARED) return;
 
 	switch(v.type) {
 	case T_STRING:
+		if(v.allocation == M_SHARED) {
+			if(SI_RefRelease(v.stringval)) SI_RefFree(v.stringval);
+			return;
+		}
 		rm_free(v.stringval);
 		v.stringval = NULL;
 		return;
@@ -643,3 +700,31 @@ void SIValue_Free(SIValue v) {
 	}
 }
 
+size_t SIValue_HeapSize(SIValue v) {
+	// Only owned allocations and references are accounted for.
+	if(v.allocation != M_SELF && v.allocation != M_SHARED) return 0;
+
+	size_t size;
+	void *payload;
+	switch(v.type) {
+	case T_STRING:
+		payload = v.stringval;
+		size = strlen(v.stringval) + 1;
+		break;
+	case T_ARRAY: {
+		array_hdr_t *hdr = array_hdr(v.array);
+		payload = hdr;
+		size = array_sizeof(hdr);
+		for(uint32_t i = 0; i < hdr->len; i++) size += SIValue_HeapSize(v.array[i]);
+		break;
+	}
+	default:
+		return 0;
+	}
+
+	if(v.allocation == M_SHARED) {
+		size = (size + sizeof(SIRefHeader)) / MAX(SI_RefCount(payload), 1);
+	}
+	return size;
+}
+
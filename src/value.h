@@ -43,9 +43,15 @@ typedef enum {
 	M_NONE = 0,       // SIValue is not heap-allocated
 	M_SELF = 0x1,     // SIValue is responsible for freeing its reference
 	M_VOLATILE = 0x2, // SIValue does not own its reference and may go out of scope
-	M_CONST = 0x4     // SIValue does not own its allocation, but its access is safe
+	M_CONST = 0x4,    // SIValue does not own its allocation, but its access is safe
+	M_SHARED = 0x8    // SIValue holds a reference to an immutable, ref-counted allocation
 } SIAllocation;
 
+/* M_SHARED can be combined with M_VOLATILE or M_CONST, in which case the SIValue
+ * borrows the ref-counted allocation rather than holding a reference of its own.
+ * Cloning or persisting a value backed by a ref-counted allocation
+ * only adds a reference. */
+
 #define SI_TYPE(value) (value).type
 #define SI_NUMERIC (T_INT64 | T_DOUBLE)
 #define SI_GRAPHENTITY (T_NODE | T_EDGE)
@@ -102,12 +108,28 @@ SIValue SI_DuplicateStringVal(const char *s);
 SIValue SI_ConstStringVal(char *s);
 // Don't duplicate input string, but assume ownership.
 SIValue SI_TransferStringVal(char *s);
+// Duplicate input string into an immutable, ref-counted allocation.
+SIValue SI_SharedStringVal(const char *s);
+
+/* Ref-counted allocations, the reference count precedes the returned payload. */
+// Allocate a payload of 'n' bytes with a single reference.
+void *SI_RefAlloc(size_t n);
+// Add a reference to payload.
+void SI_RefRetain(void *payload);
+// Drop a reference to payload, returns true if this was the last reference,
+// in which case the caller should release payload using SI_RefFree.
+bool SI_RefRelease(void *payload);
+// Free payload.
+void SI_RefFree(void *payload);
+// Number of references to payload.
+uint32_t SI_RefCount(const void *payload);
 
 /* Functions for copying and guaranteeing memory safety for SIValues. */
 // SI_ShareValue creates an SIValue that shares all of the original's allocations.
 SIValue SI_ShareValue(const SIValue v);
 
-// SI_CloneValue creates an SIValue that duplicates all of the original's allocations.
+// SI_CloneValue creates an SIValue that duplicates all of the original's allocations,
+// strings and arrays are duplicated into ref-counted allocations which later clones share.
 SIValue SI_CloneValue(const SIValue v);
 
 // SI_ConstValue creates an SIValue that shares the original's allocations, but does not need to persist them.
@@ -174,3 +196,7 @@ XXH64_hash_t SIValue_HashCode(SIValue v);
  * by this object. */
 void SIValue_Free(SIValue v);
 
+/* Returns the number of heap bytes held by an SIValue, ref-counted allocations
+ * are split evenly between their references. */
+size_t SIValue_HeapSize(SIValue v);
+
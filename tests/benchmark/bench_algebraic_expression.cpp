@@ -0,0 +1,95 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "synthetic_graph.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/config.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/arithmetic/algebraic_expression.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+RG_Config config; // Global module configuration
+
+// Number of source nodes traversed from at once, matches conditional traverse.
+#define FRONTIER_SIZE 16
+
+static void _setup(void) {
+	static bool initialized = false;
+	if(initialized) return;
+	initialized = true;
+
+	// Use the malloc family for allocations
+	Alloc_Reset();
+
+	// Ensure that transposed matrices are constructed.
+	config.maintain_transposed_matrices = true;
+
+	// Initialize GraphBLAS.
+	GrB_init(GrB_NONBLOCKING);
+	GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW); // all matrices in CSR format
+	GxB_Global_Option_set(GxB_HYPER, GxB_NEVER_HYPER); // matrices are never hypersparse
+}
+
+/* Evaluate F * R^hops, where F is a frontier of FRONTIER_SIZE source nodes,
+ * as done by conditional traverse for a batch of records. */
+static void BM_AlgebraicExpressionEval(benchmark::State &state) {
+	_setup();
+	int relation;
+	int hops = state.range(0);
+	GraphShape shape = (GraphShape)state.range(1);
+	uint64_t node_count = state.range(2);
+	Graph *g = SyntheticGraph_New(shape, node_count, &relation);
+	GrB_Matrix R = Graph_GetRelationMatrix(g, relation);
+	GrB_Index dim = Graph_RequiredMatrixDim(g);
+	state.SetLabel(SyntheticGraph_ShapeName(shape));
+
+	// Frontier, sources spread evenly across the graph.
+	GrB_Matrix F;
+	GrB_Matrix_new(&F, GrB_BOOL, FRONTIER_SIZE, dim);
+	for(GrB_Index i = 0; i < FRONTIER_SIZE; i++) {
+		GrB_Matrix_setElement_BOOL(F, true, i, i * (node_count / FRONTIER_SIZE));
+	}
+
+	AlgebraicExpression *exp = AlgebraicExpression_NewOperation(AL_EXP_MUL);
+	AlgebraicExpression_AddChild(exp, AlgebraicExpression_NewOperand(F, false, "f", "a", NULL, NULL));
+	for(int i = 0; i < hops; i++) {
+		AlgebraicExpression_AddChild(exp, AlgebraicExpression_NewOperand(R, false, "a", "b", "e", NULL));
+	}
+
+	GrB_Matrix M;
+	GrB_Matrix_new(&M, GrB_BOOL, FRONTIER_SIZE, dim);
+	for(auto _ : state) {
+		AlgebraicExpression_Eval(exp, M);
+	}
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, M);
+	state.counters["reached"] = nvals;
+	state.SetItemsProcessed(state.iterations() * FRONTIER_SIZE);
+
+	AlgebraicExpression_Free(exp);
+	GrB_Matrix_free(&M);
+	GrB_Matrix_free(&F);
+	Graph_Free(g);
+}
+
+static void _EvalArgs(benchmark::internal::Benchmark *b) {
+	b->ArgNames({"hops", "shape", "nodes"});
+	for(int hops = 1; hops <= 3; hops++) {
+		for(int shape = 0; shape < GRAPH_SHAPE_COUNT; shape++) {
+			for(int64_t scale : SYNTHETIC_GRAPH_SCALES) b->Args({hops, shape, scale});
+		}
+	}
+	b->Unit(benchmark::kMicrosecond);
+}
+BENCHMARK(BM_AlgebraicExpressionEval)->Apply(_EvalArgs);
@@ -0,0 +1,121 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include <stdio.h>
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/query_ctx.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/arithmetic/funcs.h"
+#include "../../src/arithmetic/agg_funcs.h"
+#include "../../src/execution_plan/record.h"
+#include "../../src/arithmetic/arithmetic_program.h"
+#include "../../src/arithmetic/arithmetic_expression.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+static char _aliases[64][8];
+
+static void _setup(void) {
+	static bool initialized = false;
+	if(initialized) return;
+	initialized = true;
+
+	// Use the malloc family for allocations
+	Alloc_Reset();
+
+	// Prepare thread-local variables
+	QueryCtx_Init();
+
+	// Register functions
+	AR_RegisterFuncs();
+	Agg_RegisterFuncs();
+
+	for(int i = 0; i < 64; i++) snprintf(_aliases[i], sizeof(_aliases[i]), "e%d", i);
+}
+
+// Record holding entry_count integers, e0 = 0, e1 = 1, ...
+static Record _record(int entry_count) {
+	rax *mapping = raxNew();
+	for(intptr_t i = 0; i < entry_count; i++) {
+		raxInsert(mapping, (unsigned char *)_aliases[i], strlen(_aliases[i]), (void *)i, NULL);
+	}
+	Record r = Record_New(mapping);
+	for(int i = 0; i < entry_count; i++) Record_AddScalar(r, i, SI_LongVal(i));
+	return r;
+}
+
+static void _free_record(Record r) {
+	rax *mapping = r->mapping;
+	Record_Free(r);
+	raxFree(mapping);
+}
+
+/* Build an expression over term_count record entries:
+ * e0 * 2 + e1 * 2 + ... + eN * 2 */
+static AR_ExpNode *_expression(int term_count) {
+	AR_ExpNode *root = NULL;
+	for(int i = 0; i < term_count; i++) {
+		AR_ExpNode *mul = AR_EXP_NewOpNode("mul", 2);
+		mul->op.children[0] = AR_EXP_NewVariableOperandNode(_aliases[i]);
+		mul->op.children[1] = AR_EXP_NewConstOperandNode(SI_LongVal(2));
+		if(root == NULL) {
+			root = mul;
+		} else {
+			AR_ExpNode *add = AR_EXP_NewOpNode("add", 2);
+			add->op.children[0] = root;
+			add->op.children[1] = mul;
+			root = add;
+		}
+	}
+	return root;
+}
+
+// Evaluate an expression tree against a record.
+static void BM_AR_EXP_Evaluate(benchmark::State &state) {
+	_setup();
+	int term_count = state.range(0);
+	Record r = _record(term_count);
+	AR_ExpNode *exp = _expression(term_count);
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(AR_EXP_Evaluate(exp, r));
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	AR_EXP_Free(exp);
+	_free_record(r);
+}
+BENCHMARK(BM_AR_EXP_Evaluate)->RangeMultiplier(4)->Range(1, 64);
+
+// Evaluate the same expression compiled into a program.
+static void BM_AR_Program_Evaluate(benchmark::State &state) {
+	_setup();
+	int term_count = state.range(0);
+	Record r = _record(term_count);
+	AR_ExpNode *exp = _expression(term_count);
+	AR_Program *program = AR_Program_FromExpression(exp);
+	if(program == NULL) {
+		state.SkipWithError("expression can't be compiled");
+	} else {
+		for(auto _ : state) {
+			benchmark::DoNotOptimize(AR_Program_Evaluate(program, r));
+		}
+		state.SetItemsProcessed(state.iterations());
+		AR_Program_Free(program);
+	}
+
+	AR_EXP_Free(exp);
+	_free_record(r);
+}
+BENCHMARK(BM_AR_Program_Evaluate)->RangeMultiplier(4)->Range(1, 64);
@@ -0,0 +1,113 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/datablock/datablock.h"
+#include "../../src/util/datablock/datablock_iterator.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Size of items stored in benchmarked datablocks, matches the size of an entity.
+#define ITEM_SIZE 16
+
+static DataBlock *_populate(uint64_t item_count) {
+	uint64_t idx;
+	DataBlock *dataBlock = DataBlock_New(item_count, ITEM_SIZE, NULL);
+	for(uint64_t i = 0; i < item_count; i++) DataBlock_AllocateItem(dataBlock, &idx);
+	return dataBlock;
+}
+
+// Allocate items in an empty datablock.
+static void BM_DataBlockAllocate(benchmark::State &state) {
+	Alloc_Reset();
+	uint64_t idx;
+	uint64_t item_count = state.range(0);
+
+	for(auto _ : state) {
+		DataBlock *dataBlock = DataBlock_New(1024, ITEM_SIZE, NULL);
+		for(uint64_t i = 0; i < item_count; i++) {
+			benchmark::DoNotOptimize(DataBlock_AllocateItem(dataBlock, &idx));
+		}
+		DataBlock_Free(dataBlock);
+	}
+	state.SetItemsProcessed(state.iterations() * item_count);
+}
+BENCHMARK(BM_DataBlockAllocate)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+// Re-allocate items freed by a deletion of every other item.
+static void BM_DataBlockAllocateDeleted(benchmark::State &state) {
+	Alloc_Reset();
+	uint64_t idx;
+	uint64_t item_count = state.range(0);
+	DataBlock *dataBlock = _populate(item_count);
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		for(uint64_t i = 0; i < item_count; i += 2) DataBlock_DeleteItem(dataBlock, i);
+		state.ResumeTiming();
+		for(uint64_t i = 0; i < item_count; i += 2) {
+			benchmark::DoNotOptimize(DataBlock_AllocateItem(dataBlock, &idx));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * (item_count / 2));
+	DataBlock_Free(dataBlock);
+}
+BENCHMARK(BM_DataBlockAllocateDeleted)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void _IterateArgs(benchmark::internal::Benchmark *b) {
+	b->ArgNames({"items", "deleted"});
+	for(int64_t items = 1 << 10; items <= 1 << 18; items <<= 4) {
+		b->Args({items, 0});
+		b->Args({items, 1});
+	}
+}
+
+// Scan every item in a datablock.
+static void BM_DataBlockIterate(benchmark::State &state) {
+	Alloc_Reset();
+	uint64_t id;
+	uint64_t item_count = state.range(0);
+	DataBlock *dataBlock = _populate(item_count);
+	// Holes in the datablock are skipped by the iterator.
+	if(state.range(1)) {
+		for(uint64_t i = 0; i < item_count; i += 4) DataBlock_DeleteItem(dataBlock, i);
+	}
+
+	for(auto _ : state) {
+		DataBlockIterator *it = DataBlock_Scan(dataBlock);
+		void *item;
+		while((item = DataBlockIterator_Next(it, &id))) benchmark::DoNotOptimize(item);
+		DataBlockIterator_Free(it);
+	}
+	state.SetItemsProcessed(state.iterations() * item_count);
+	DataBlock_Free(dataBlock);
+}
+BENCHMARK(BM_DataBlockIterate)->Apply(_IterateArgs);
+
+// Random access lookups.
+static void BM_DataBlockGetItem(benchmark::State &state) {
+	Alloc_Reset();
+	uint64_t item_count = state.range(0);
+	DataBlock *dataBlock = _populate(item_count);
+	uint64_t idx = 0;
+
+	for(auto _ : state) {
+		// Large stride, such that consecutive lookups rarely share a block.
+		idx = (idx + 7919) % item_count;
+		benchmark::DoNotOptimize(DataBlock_GetItem(dataBlock, idx));
+	}
+	state.SetItemsProcessed(state.iterations());
+	DataBlock_Free(dataBlock);
+}
+BENCHMARK(BM_DataBlockGetItem)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
@@ -0,0 +1,72 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "synthetic_graph.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/config.h"
+#include "../../src/util/rmalloc.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+RG_Config config; // Global module configuration
+
+static void _setup(void) {
+	static bool initialized = false;
+	if(initialized) return;
+	initialized = true;
+
+	// Use the malloc family for allocations
+	Alloc_Reset();
+
+	// Ensure that transposed matrices are constructed.
+	config.maintain_transposed_matrices = true;
+
+	// Initialize GraphBLAS.
+	GrB_init(GrB_NONBLOCKING);
+	GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW); // all matrices in CSR format
+	GxB_Global_Option_set(GxB_HYPER, GxB_NEVER_HYPER); // matrices are never hypersparse
+}
+
+// Form every edge of a synthetic graph, including the synchronization
+// of pending changes into the relation matrices.
+static void BM_GraphConnectNodes(benchmark::State &state) {
+	_setup();
+	Edge e;
+	int relation;
+	GraphShape shape = (GraphShape)state.range(0);
+	uint64_t node_count = state.range(1);
+	SyntheticEdge *edges = SyntheticGraph_Edges(shape, node_count);
+	uint edge_count = array_len(edges);
+	state.SetLabel(SyntheticGraph_ShapeName(shape));
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		Graph *g = SyntheticGraph_NewNodes(node_count, &relation);
+		Graph_AcquireWriteLock(g);
+		state.ResumeTiming();
+
+		for(uint i = 0; i < edge_count; i++) {
+			Graph_ConnectNodes(g, edges[i].src, edges[i].dest, relation, &e);
+		}
+		Graph_ApplyAllPending(g);
+
+		state.PauseTiming();
+		Graph_ReleaseLock(g);
+		Graph_Free(g);
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * edge_count);
+
+	array_free(edges);
+}
+BENCHMARK(BM_GraphConnectNodes)->Apply(SyntheticGraph_Args);
@@ -0,0 +1,105 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include <stdio.h>
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/grouping/group.h"
+#include "../../src/grouping/group_cache.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Group keys, as produced by Group_KeyStr for a (string, integer) key.
+static char **_keys(int group_count) {
+	char buf[64];
+	char **keys = array_new(char *, group_count);
+	for(int i = 0; i < group_count; i++) {
+		snprintf(buf, sizeof(buf), "customer,%d", i);
+		keys = array_append(keys, rm_strdup(buf));
+	}
+	return keys;
+}
+
+static void _free_keys(char **keys) {
+	uint key_count = array_len(keys);
+	for(uint i = 0; i < key_count; i++) rm_free(keys[i]);
+	array_free(keys);
+}
+
+static CacheGroup *_cache(char **keys) {
+	CacheGroup *groups = CacheGroupNew();
+	uint key_count = array_len(keys);
+	for(uint i = 0; i < key_count; i++) {
+		CacheGroupAdd(groups, keys[i], NewGroup(NULL, 0, NULL, 0, NULL));
+	}
+	return groups;
+}
+
+// Populate a group cache.
+static void BM_CacheGroupAdd(benchmark::State &state) {
+	Alloc_Reset();
+	int group_count = state.range(0);
+	char **keys = _keys(group_count);
+
+	for(auto _ : state) {
+		CacheGroup *groups = _cache(keys);
+		state.PauseTiming();
+		FreeGroupCache(groups);
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * group_count);
+
+	_free_keys(keys);
+}
+BENCHMARK(BM_CacheGroupAdd)->RangeMultiplier(16)->Range(1 << 4, 1 << 16);
+
+// Lookup existing groups, as done by aggregations for every record.
+static void BM_CacheGroupGet(benchmark::State &state) {
+	Alloc_Reset();
+	int group_count = state.range(0);
+	char **keys = _keys(group_count);
+	CacheGroup *groups = _cache(keys);
+	int i = 0;
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(CacheGroupGet(groups, keys[i]));
+		if(++i == group_count) i = 0;
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	FreeGroupCache(groups);
+	_free_keys(keys);
+}
+BENCHMARK(BM_CacheGroupGet)->RangeMultiplier(16)->Range(1 << 4, 1 << 16);
+
+// Compute a group's key string.
+static void BM_GroupKeyStr(benchmark::State &state) {
+	Alloc_Reset();
+	SIValue *keys = (SIValue *)rm_malloc(sizeof(SIValue) * 2);
+	keys[0] = SI_DuplicateStringVal("customer");
+	keys[1] = SI_LongVal(123456);
+	Group *group = NewGroup(keys, 2, NULL, 0, NULL);
+
+	for(auto _ : state) {
+		char *key;
+		Group_KeyStr(group, &key);
+		benchmark::DoNotOptimize(key);
+		rm_free(key);
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	FreeGroup(group);
+}
+BENCHMARK(BM_GroupKeyStr);
@@ -0,0 +1,95 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include <stdio.h>
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/execution_plan/record.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Create a record mapping of entry_count aliases.
+static rax *_mapping(int entry_count) {
+	char alias[32];
+	rax *mapping = raxNew();
+	for(intptr_t i = 0; i < entry_count; i++) {
+		int len = snprintf(alias, sizeof(alias), "e%ld", (long)i);
+		raxInsert(mapping, (unsigned char *)alias, len, (void *)i, NULL);
+	}
+	return mapping;
+}
+
+// Populate record with a mix of scalars, nodes and edges.
+static void _populate(Record r, int entry_count) {
+	Node n = {};
+	Edge e = {};
+	for(int i = 0; i < entry_count; i++) {
+		switch(i % 4) {
+		case 0:
+			Record_AddScalar(r, i, SI_LongVal(i));
+			break;
+		case 1:
+			Record_AddScalar(r, i, SI_DuplicateStringVal("benchmark"));
+			break;
+		case 2:
+			Record_AddNode(r, i, n);
+			break;
+		default:
+			Record_AddEdge(r, i, e);
+			break;
+		}
+	}
+}
+
+// Clone a record into an existing record, as done by operations producing
+// multiple records out of a single child record.
+static void BM_RecordClone(benchmark::State &state) {
+	Alloc_Reset();
+	int entry_count = state.range(0);
+	rax *mapping = _mapping(entry_count);
+	Record r = Record_New(mapping);
+	Record clone = Record_New(mapping);
+	_populate(r, entry_count);
+
+	for(auto _ : state) {
+		Record_Clone(r, clone);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	Record_Free(clone);
+	Record_Free(r);
+	raxFree(mapping);
+}
+BENCHMARK(BM_RecordClone)->RangeMultiplier(4)->Range(4, 64);
+
+// Allocate, clone and free a record.
+static void BM_RecordCloneNew(benchmark::State &state) {
+	Alloc_Reset();
+	int entry_count = state.range(0);
+	rax *mapping = _mapping(entry_count);
+	Record r = Record_New(mapping);
+	_populate(r, entry_count);
+
+	for(auto _ : state) {
+		Record clone = Record_New(mapping);
+		Record_Clone(r, clone);
+		Record_Free(clone);
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	Record_Free(r);
+	raxFree(mapping);
+}
+BENCHMARK(BM_RecordCloneNew)->RangeMultiplier(4)->Range(4, 64);
@@ -0,0 +1,79 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Kinds of values compared and hashed.
+enum {
+	VALUE_INT,
+	VALUE_DOUBLE,
+	VALUE_MIXED,    // Integer against double.
+	VALUE_STRING,
+};
+
+static const char *_names[] = {"int", "double", "mixed", "string"};
+
+// Values of given kind, distinct but sharing a long prefix when strings.
+static void _values(int kind, SIValue *a, SIValue *b) {
+	switch(kind) {
+	case VALUE_INT:
+		*a = SI_LongVal(1234567);
+		*b = SI_LongVal(1234568);
+		break;
+	case VALUE_DOUBLE:
+		*a = SI_DoubleVal(1234.567);
+		*b = SI_DoubleVal(1234.568);
+		break;
+	case VALUE_MIXED:
+		*a = SI_LongVal(1234);
+		*b = SI_DoubleVal(1234.5);
+		break;
+	default:
+		*a = SI_ConstStringVal((char *)"RedisGraph benchmark value A");
+		*b = SI_ConstStringVal((char *)"RedisGraph benchmark value B");
+		break;
+	}
+}
+
+static void BM_SIValueCompare(benchmark::State &state) {
+	Alloc_Reset();
+	SIValue a;
+	SIValue b;
+	int disjointOrNull = 0;
+	_values(state.range(0), &a, &b);
+	state.SetLabel(_names[state.range(0)]);
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(SIValue_Compare(a, b, &disjointOrNull));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SIValueCompare)->DenseRange(VALUE_INT, VALUE_STRING);
+
+static void BM_SIValueHashCode(benchmark::State &state) {
+	Alloc_Reset();
+	SIValue a;
+	SIValue b;
+	_values(state.range(0), &a, &b);
+	state.SetLabel(_names[state.range(0)]);
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(SIValue_HashCode(a));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SIValueHashCode)->DenseRange(VALUE_INT, VALUE_STRING);
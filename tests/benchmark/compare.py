@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""
+Compare Google Benchmark JSON results against a stored baseline.
+
+usage: compare.py [--threshold PERCENT] BASELINE_DIR RESULTS_DIR
+
+Every JSON file in RESULTS_DIR is matched by name against BASELINE_DIR,
+benchmarks are matched by name within each file.
+Exits with a non-zero status if any benchmark slowed down by more than
+PERCENT percent (default 10).
+"""
+
+import os
+import sys
+import json
+import argparse
+
+# Conversion of Google Benchmark's time units to nanoseconds.
+TIME_UNITS = {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    """Map benchmark name to its real time in nanoseconds."""
+    with open(path) as f:
+        report = json.load(f)
+
+    times = {}
+    for b in report.get("benchmarks", []):
+        # Skip mean, median and stddev entries reported for repetitions.
+        if b.get("run_type") == "aggregate":
+            continue
+        times[b["name"]] = b["real_time"] * TIME_UNITS[b.get("time_unit", "ns")]
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare benchmark results against a baseline.")
+    parser.add_argument("baseline", help="directory holding baseline JSON results")
+    parser.add_argument("results", help="directory holding current JSON results")
+    parser.add_argument("--threshold", type=float, default=10,
+                        help="maximal slowdown in percent before failing")
+    args = parser.parse_args()
+
+    regressions = []
+    print("%-72s %14s %14s %9s" % ("Benchmark", "Baseline (ns)", "Current (ns)", "Change"))
+
+    for filename in sorted(os.listdir(args.results)):
+        if not filename.endswith(".json"):
+            continue
+        baseline_path = os.path.join(args.baseline, filename)
+        if not os.path.exists(baseline_path):
+            print("%s: no baseline, skipping" % filename)
+            continue
+
+        baseline = load(baseline_path)
+        current = load(os.path.join(args.results, filename))
+
+        for name, time in current.items():
+            if name not in baseline:
+                print("%-72s %14s %14.1f %9s" % (name, "-", time, "new"))
+                continue
+            change = (time - baseline[name]) / baseline[name] * 100
+            print("%-72s %14.1f %14.1f %+8.1f%%" % (name, baseline[name], time, change))
+            if change > args.threshold:
+                regressions.append((name, change))
+
+    if regressions:
+        print("\n%d benchmark(s) slowed down by more than %.1f%%:" % (len(regressions), args.threshold))
+        for name, change in regressions:
+            print("  %s %+.1f%%" % (name, change))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
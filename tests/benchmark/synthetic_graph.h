@@ -0,0 +1,140 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/graph/graph.h"
+#include "../../src/util/arr.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Synthetic graph shapes benchmarks are parameterized over.
+typedef enum {
+	GRAPH_UNIFORM,      // Destinations drawn uniformly, every node has the same out degree.
+	GRAPH_POWER_LAW,    // Destinations skewed towards low IDs, few nodes have most in edges.
+	GRAPH_GRID,         // Square lattice, nodes connect to their right and bottom neighbours.
+	GRAPH_SHAPE_COUNT
+} GraphShape;
+
+// Average out degree of uniform and power-law graphs.
+#define SYNTHETIC_GRAPH_DEGREE 4
+
+// Node counts synthetic graphs are generated at.
+static const int64_t SYNTHETIC_GRAPH_SCALES[] = {1 << 10, 1 << 14, 1 << 18};
+
+// Edge described by its endpoints.
+typedef struct {
+	NodeID src;
+	NodeID dest;
+} SyntheticEdge;
+
+static inline const char *SyntheticGraph_ShapeName(GraphShape shape) {
+	switch(shape) {
+	case GRAPH_UNIFORM:
+		return "uniform";
+	case GRAPH_POWER_LAW:
+		return "power-law";
+	case GRAPH_GRID:
+		return "grid";
+	default:
+		return "unknown";
+	}
+}
+
+// xorshift64*, fixed seed such that runs are comparable.
+static inline uint64_t _SyntheticGraph_Rand(uint64_t *state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 0x2545F4914F6CDD1DULL;
+}
+
+// Describe the edges of a graph of given shape over node_count nodes,
+// returns an arr of edges, to be freed by the caller with array_free.
+static inline SyntheticEdge *SyntheticGraph_Edges(GraphShape shape, uint64_t node_count) {
+	uint64_t seed = 0x9E3779B97F4A7C15ULL;
+	SyntheticEdge *edges = array_new(SyntheticEdge, node_count * SYNTHETIC_GRAPH_DEGREE);
+
+	if(shape == GRAPH_GRID) {
+		uint64_t side = (uint64_t)sqrt((double)node_count);
+		for(uint64_t row = 0; row < side; row++) {
+			for(uint64_t col = 0; col < side; col++) {
+				NodeID id = row * side + col;
+				if(col + 1 < side) edges = array_append(edges, ((SyntheticEdge) {id, id + 1}));
+				if(row + 1 < side) edges = array_append(edges, ((SyntheticEdge) {id, id + side}));
+			}
+		}
+		return edges;
+	}
+
+	for(uint64_t src = 0; src < node_count; src++) {
+		for(int i = 0; i < SYNTHETIC_GRAPH_DEGREE; i++) {
+			uint64_t r = _SyntheticGraph_Rand(&seed);
+			NodeID dest;
+			if(shape == GRAPH_POWER_LAW) {
+				// Cubing a uniform sample in [0, 1) concentrates destinations
+				// near zero, in-degree decays polynomially with node ID.
+				double u = (double)(r >> 11) / (double)(1ULL << 53);
+				dest = (NodeID)(u * u * u * node_count);
+			} else {
+				dest = r % node_count;
+			}
+			edges = array_append(edges, ((SyntheticEdge) {src, dest}));
+		}
+	}
+	return edges;
+}
+
+// Create a graph holding node_count unlabeled nodes and no edges,
+// the single relation type is stored in relation.
+static inline Graph *SyntheticGraph_NewNodes(uint64_t node_count, int *relation) {
+	Node n;
+	Graph *g = Graph_New(node_count, node_count);
+	Graph_AcquireWriteLock(g);
+	*relation = Graph_AddRelationType(g);
+	Graph_AllocateNodes(g, node_count);
+	for(uint64_t i = 0; i < node_count; i++) Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+	Graph_ReleaseLock(g);
+	return g;
+}
+
+// Create a graph of given shape, pending changes are applied to its matrices.
+static inline Graph *SyntheticGraph_New(GraphShape shape, uint64_t node_count, int *relation) {
+	Edge e;
+	Graph *g = SyntheticGraph_NewNodes(node_count, relation);
+	SyntheticEdge *edges = SyntheticGraph_Edges(shape, node_count);
+	uint edge_count = array_len(edges);
+
+	Graph_AcquireWriteLock(g);
+	for(uint i = 0; i < edge_count; i++) {
+		Graph_ConnectNodes(g, edges[i].src, edges[i].dest, *relation, &e);
+	}
+	Graph_ApplyAllPending(g);
+	Graph_ReleaseLock(g);
+
+	array_free(edges);
+	return g;
+}
+
+// Register a benchmark over every shape and scale,
+// arguments are accessible as state.range(0) (shape) and state.range(1) (node count).
+static inline void SyntheticGraph_Args(benchmark::internal::Benchmark *b) {
+	b->ArgNames({"shape", "nodes"});
+	for(int shape = 0; shape < GRAPH_SHAPE_COUNT; shape++) {
+		for(int64_t scale : SYNTHETIC_GRAPH_SCALES) b->Args({shape, scale});
+	}
+	b->Unit(benchmark::kMicrosecond);
+}
@@ -0,0 +1,70 @@
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "batch"
+redis_con = None
+
+def decode(value):
+    # Replies may be returned as bytes, depending on connection settings.
+    if isinstance(value, list):
+        return [decode(v) for v in value]
+    return value.decode() if isinstance(value, bytes) else value
+
+# GRAPH.BATCH executes a sequence of queries under a single lock acquisition,
+# replying with each query's reply, a failing query does not affect the others.
+
+class testBatch(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        redis_con = self.env.getConnection()
+
+    def batch(self, *queries):
+        res = redis_con.execute_command("GRAPH.BATCH", GRAPH_ID, *queries)
+        return [r if isinstance(r, Exception) else decode(r) for r in res]
+
+    def test01_write_batch(self):
+        res = self.batch("CYPHER name='a' CREATE (:P {name: $name})",
+                         "CYPHER name='b' CREATE (:P {name: $name})",
+                         "CYPHER name='c' CREATE (:P {name: $name})",
+                         "MATCH (p:P) RETURN p.name ORDER BY p.name")
+        # Each query is replied to individually.
+        self.env.assertEquals(len(res), 4)
+        for i in range(3):
+            self.env.assertTrue("Nodes created: 1" in res[i][-1])
+        # Later queries observe the changes made by earlier ones.
+        self.env.assertEquals(res[3][1], [["a"], ["b"], ["c"]])
+
+    def test02_error_isolation(self):
+        res = self.batch("CREATE (:E)",
+                         "RETURN 1 +",
+                         "MATCH (e:E) RETURN count(e)",
+                         "CREATE (:E)")
+        self.env.assertEquals(len(res), 4)
+        self.env.assertTrue(isinstance(res[1], redis.exceptions.ResponseError))
+        self.env.assertEquals(res[2][1], [[1]])
+        self.env.assertTrue("Nodes created: 1" in res[3][-1])
+
+        # Changes of all succeeding queries are applied.
+        graph = Graph(GRAPH_ID, redis_con)
+        result = graph.query("MATCH (e:E) RETURN count(e)")
+        self.env.assertEquals(result.result_set, [[2]])
+
+    def test03_read_batch(self):
+        res = self.batch("MATCH (p:P) RETURN count(p)",
+                         "CYPHER name='b' MATCH (p:P {name: $name}) RETURN p.name",
+                         "--compact")
+        self.env.assertEquals(len(res), 2)
+        # Compact replies carry value types alongside values.
+        self.env.assertEquals(res[0][1][0][0][1], 3)
+        self.env.assertEquals(res[1][1][0][0][1], "b")
+
+    def test04_invalid_arity(self):
+        try:
+            redis_con.execute_command("GRAPH.BATCH", GRAPH_ID)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
@@ -0,0 +1,108 @@
+import os
+import sys
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "composite_index"
+redis_graph = None
+
+class testCompositeIndexFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # Identical data under an indexed label (L) and an unindexed one (U).
+        for label in ['L', 'U']:
+            query = """UNWIND range(0, 399) AS x
+                       CREATE (:%s {a: x %% 4, b: (x / 4) %% 10, c: x, s: 'v' + toString(x %% 7)})""" % label
+            redis_graph.query(query)
+        # Nodes missing a key property or holding an unkeyed type.
+        redis_graph.query("CREATE (:L {a: 1, c: -1}), (:U {a: 1, c: -1})")
+        redis_graph.query("CREATE (:L {a: 1, b: [1], c: -2}), (:U {a: 1, b: [1], c: -2})")
+
+        result = redis_graph.query("CREATE INDEX ON :L(a, b)")
+        self.env.assertEquals(result.indices_created, 1)
+        result = redis_graph.query("CREATE INDEX ON :L(s, a)")
+        self.env.assertEquals(result.indices_created, 1)
+        # Composite key already exists.
+        result = redis_graph.query("CREATE INDEX ON :L(a, b)")
+        self.env.assertEquals(result.indices_created, 0)
+
+    # Validate query results against the unindexed label.
+    def validate(self, predicate, indexed=True):
+        query = "MATCH (n:%s) WHERE " + predicate + " RETURN n.c ORDER BY n.c"
+        plan = redis_graph.execution_plan(query % 'L')
+        if indexed:
+            self.env.assertIn('Index Scan', plan)
+        else:
+            self.env.assertNotIn('Index Scan', plan)
+        expected = redis_graph.query(query % 'U').result_set
+        actual = redis_graph.query(query % 'L').result_set
+        self.env.assertEquals(actual, expected)
+        return plan
+
+    def test01_equality_prefix(self):
+        plan = self.validate("n.a = 1 AND n.b = 3")
+        # Both predicates are resolved by the composite key.
+        self.env.assertNotIn('Filter', plan)
+        # Leading property alone.
+        self.validate("n.a = 2")
+        self.validate("n.s = 'v3'")
+
+    def test02_range_suffix(self):
+        for predicate in ["n.a = 1 AND n.b > 3", "n.a = 1 AND n.b >= 3",
+                          "n.a = 1 AND n.b < 7", "n.a = 1 AND n.b <= 7",
+                          "n.a = 1 AND n.b > 3 AND n.b <= 7",
+                          "n.s = 'v2' AND n.a >= 2", "n.s > 'v4'", "n.a < 2"]:
+            plan = self.validate(predicate)
+            self.env.assertNotIn('Filter', plan)
+
+    def test03_unresolved_predicates(self):
+        # Range on the leading property leaves the following ones to a filter.
+        plan = self.validate("n.a > 1 AND n.b = 3")
+        self.env.assertIn('Filter', plan)
+        # Type mismatch and empty ranges.
+        self.validate("n.a = '1' AND n.b = 3")
+        self.validate("n.a = 1 AND n.b > 5 AND n.b < 2")
+        # Key doesn't lead with b.
+        self.validate("n.b = 3", False)
+
+    def test04_intersection(self):
+        result = redis_graph.query("CREATE INDEX ON :L(c)")
+        self.env.assertEquals(result.indices_created, 1)
+        # Composite key range intersected with a single property range.
+        plan = self.validate("n.a = 1 AND n.b > 2 AND n.c < 200")
+        self.env.assertNotIn('Filter', plan)
+        self.validate("n.a = 1 AND (n.c < 50 OR n.c > 350)")
+
+    def test05_updates(self):
+        redis_graph.query("MATCH (n) WHERE n.c = 5 SET n.b = 100")
+        redis_graph.query("MATCH (n) WHERE n.c = 9 DELETE n")
+        redis_graph.query("CREATE (:L {a: 1, b: 100, c: 1000}), (:U {a: 1, b: 100, c: 1000})")
+        self.validate("n.a = 1 AND n.b = 100")
+        self.validate("n.a = 1 AND n.b > 1")
+
+    def test06_persistency(self):
+        redis_graph.redis_con.execute_command("DEBUG", "RELOAD")
+        self.validate("n.a = 1 AND n.b > 3")
+        self.validate("n.s = 'v2' AND n.a >= 2")
+
+    def test07_drop(self):
+        result = redis_graph.query("DROP INDEX ON :L(a, b)")
+        self.env.assertEquals(result.indices_deleted, 1)
+        try:
+            redis_graph.query("DROP INDEX ON :L(a, b)")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Unable to drop index on :L(a, b)", str(e))
+        # Remaining indices are intact.
+        self.validate("n.s = 'v2' AND n.a >= 2")
+        self.validate("n.c < 10")
@@ -339,3 +339,37 @@ class testConcurrentQueryFlow(FlowTestsBase):
         for i in range(CLIENT_COUNT):
             self.env.assertIsNone(exceptions[i])
             self.env.assertEquals(1000, len(assertions[i].result_set))
+
+    def test_10_queue_wait_time_reported(self):
+        # Every query reports the time it waited for a thread.
+        redis_con = self.env.getConnection()
+        queries = ["MATCH (n) RETURN count(n)",
+                   "CREATE ()",
+                   "CALL db.labels()"]
+        for q in queries:
+            res = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, q)
+            stats = [s.decode() if isinstance(s, bytes) else s for s in res[-1]]
+            wait_stats = [s for s in stats if s.startswith("Query queue wait time")]
+            self.env.assertEquals(len(wait_stats), 1)
+            wait = float(wait_stats[0].split(":")[1].split()[0])
+            self.env.assertGreaterEqual(wait, 0)
+
+        # Queries of different graphs and lanes run concurrently to completion.
+        global assertions
+        global exceptions
+        assertions = [True] * CLIENT_COUNT
+        exceptions = [None] * CLIENT_COUNT
+        threads = []
+        for i in range(CLIENT_COUNT):
+            g = Graph("lane_%d" % (i % 4), self.env.getConnection())
+            q = ["MATCH (n) RETURN count(n)", "CREATE ()", "CALL db.labels()"][i % 3]
+            t = threading.Thread(target=thread_run_query, args=(g, q, i))
+            t.setDaemon(True)
+            threads.append(t)
+            t.start()
+
+        for t in threads:
+            t.join()
+
+        for i in range(CLIENT_COUNT):
+            self.env.assertIsNone(exceptions[i])
@@ -0,0 +1,101 @@
+import time
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "effects"
+
+# Write queries are replicated by their effects, GRAPH.EFFECT,
+# replicas must reach the exact same graph, entity IDs included,
+# without re-running the query.
+
+class testEffects(FlowTestsBase):
+    def __init__(self):
+        # skip test if we're running under Valgrind
+        if Env().envRunner.debugger is not None:
+            Env().skip() # valgrind is not working correctly with replication
+
+        self.env = Env(env='oss', useSlaves=True, moduleArgs='REPLICATE_EFFECTS yes')
+        self.source_con = self.env.getConnection()
+        self.replica_con = self.env.getSlaveConnection()
+        # enable write commands on slave, required as all RedisGraph
+        # commands are registered as write commands
+        self.replica_con.config_set("slave-read-only", "no")
+        self.graph = Graph(GRAPH_ID, self.source_con)
+        self.replica = Graph(GRAPH_ID, self.replica_con)
+
+    def assert_replica_consistent(self):
+        # give replica some time to catch up
+        time.sleep(1)
+        queries = ["MATCH (n) RETURN id(n), labels(n), n ORDER BY id(n)",
+                   "MATCH (a)-[e]->(b) RETURN id(e), type(e), id(a), id(b), e ORDER BY id(e)"]
+        for q in queries:
+            self.env.assertEquals(self.replica.query(q).result_set, self.graph.query(q).result_set)
+
+    def test01_non_deterministic_functions(self):
+        # rand() is evaluated once, on the master.
+        self.graph.query("UNWIND range(0, 99) AS x CREATE (:R {v: rand(), x: x})")
+        self.graph.query("MATCH (r:R) WHERE r.x % 2 = 0 SET r.w = rand()")
+        self.assert_replica_consistent()
+
+    def test02_property_types(self):
+        q = """CREATE (:T {i: -7, big: 9223372036854775807, d: -0.25, b: true, f: false,
+               s: 'str', empty: '', l: [1, 'a', [2.5, null], false]})"""
+        self.graph.query(q)
+        # Update, add and remove properties.
+        self.graph.query("MATCH (t:T) SET t.i = t.i * 2, t.s = NULL, t.new = 'n', t.b = NULL")
+        # Removing a missing property leaves no trace.
+        self.graph.query("MATCH (t:T) SET t.missing = NULL")
+        self.assert_replica_consistent()
+        result = self.replica.query("MATCH (t:T) RETURN keys(t)")
+        self.env.assertNotIn("missing", result.result_set[0][0])
+
+    def test03_edges(self):
+        # Multiple edges of different types connecting the same pair of nodes.
+        q = """CREATE (a:A {v: 1}), (b:B {v: 2}),
+               (a)-[:X {w: 1}]->(b), (a)-[:X {w: 2}]->(b), (a)-[:Y]->(b), (b)-[:X]->(b)"""
+        self.graph.query(q)
+        self.graph.query("MATCH (:A)-[e:X {w: 1}]->(:B) SET e.w = 10, e.tag = 'updated'")
+        self.graph.query("MATCH (:A)-[e:X {w: 2}]->(:B) DELETE e")
+        self.assert_replica_consistent()
+
+    def test04_deleted_ids_reuse(self):
+        # Detach delete nodes, freeing node and edge IDs,
+        # the order in which IDs are reused must match on the replica.
+        self.graph.query("UNWIND range(0, 49) AS x CREATE (:D {x: x})-[:E {x: x}]->(:D {x: -x})")
+        self.graph.query("MATCH (d:D) WHERE d.x % 3 = 0 DELETE d")
+        self.graph.query("UNWIND range(0, 29) AS x CREATE (:N {x: x})-[:E]->(:N)")
+        self.assert_replica_consistent()
+
+    def test05_merge(self):
+        q = "MERGE (m:M {k: 1}) ON CREATE SET m.created = rand() ON MATCH SET m.matched = rand()"
+        self.graph.query(q)
+        self.graph.query(q)
+        self.assert_replica_consistent()
+
+    def test06_index_maintenance(self):
+        # Index creation is replicated by query, index updates by effects.
+        self.graph.query("CREATE INDEX ON :I(v)")
+        self.graph.query("UNWIND range(0, 9) AS x CREATE (:I {v: x})")
+        self.graph.query("MATCH (i:I {v: 3}) SET i.v = 30")
+        self.graph.query("MATCH (i:I {v: 4}) DELETE i")
+        self.assert_replica_consistent()
+
+        q = "MATCH (i:I) WHERE i.v = 30 OR i.v = 4 OR i.v = 5 RETURN i.v ORDER BY i.v"
+        self.env.assertIn("Index Scan", self.replica.execution_plan("MATCH (i:I {v: 30}) RETURN i"))
+        self.env.assertEquals(self.replica.query(q).result_set, [[5], [30]])
+
+    def test07_client_effects_rejected(self):
+        # Effects are only accepted through replication and the AOF,
+        # clients can't apply them, well formed or not.
+        for effects in [b"\x01\xff\x00", b"\x7f", b"\x01\x01\x00\x08Rejected\xff"]:
+            for con in [self.source_con, self.replica_con]:
+                try:
+                    con.execute_command("GRAPH.EFFECT", GRAPH_ID, effects)
+                    self.env.assertTrue(False)
+                except redis.exceptions.ResponseError as e:
+                    self.env.assertIn("only accepted from the master", str(e))
+        labels = self.graph.query("CALL db.labels()").result_set
+        self.env.assertNotIn(["Rejected"], labels)
@@ -0,0 +1,83 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "memory_test"
+redis_con = None
+redis_graph = None
+
+def to_dict(pairs):
+    # Convert a flat name, value array into a dictionary.
+    names = [name.decode() if isinstance(name, bytes) else name for name in pairs[::2]]
+    values = [to_dict(v) if isinstance(v, list) else v for v in pairs[1::2]]
+    return dict(zip(names, values))
+
+class testGraphMemory(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:Person {v: x})-[:KNOWS]->(:City {v: x})")
+        # Connect the same pair of nodes multiple times.
+        redis_graph.query("MATCH (a:Person {v: 0}), (b:City {v: 0}) CREATE (a)-[:VISITED]->(b), (a)-[:VISITED]->(b)")
+
+    def memory(self, *args):
+        return to_dict(redis_con.execute_command("GRAPH.MEMORY", GRAPH_ID, *args))
+
+    def test01_breakdown(self):
+        usage = self.memory()
+        self.env.assertEquals(sorted(usage["label_matrices"].keys()), ["City", "Person"])
+        self.env.assertEquals(sorted(usage["relation_matrices"].keys()), ["KNOWS", "VISITED"])
+        self.env.assertGreater(usage["nodes"], 0)
+        self.env.assertGreater(usage["edges"], 0)
+        self.env.assertGreater(usage["node_attributes"], 0)
+        self.env.assertEquals(usage["edge_attributes"], 0)
+        self.env.assertGreater(usage["adjacency_matrix"], 0)
+        self.env.assertGreater(usage["multi_edges"]["VISITED"], 0)
+        self.env.assertEquals(usage["multi_edges"]["KNOWS"], 0)
+
+        components = ["nodes", "edges", "node_attributes", "edge_attributes",
+                      "adjacency_matrix", "indices", "plan_caches", "prepared_statements"]
+        total = sum(usage[c] for c in components)
+        total += sum(usage["label_matrices"].values())
+        total += sum(usage["relation_matrices"].values())
+        total += sum(usage["multi_edges"].values())
+        self.env.assertGreater(usage["total"], total)
+
+    def test02_exact(self):
+        # Graph is small enough for default sampling to examine every entity.
+        sampled = self.memory()
+        exact = self.memory(0)
+        self.env.assertEquals(sampled["node_attributes"], exact["node_attributes"])
+        self.env.assertEquals(sampled["multi_edges"], exact["multi_edges"])
+
+    def test03_attributes(self):
+        before = self.memory(0)
+        redis_graph.query("MATCH (p:Person) SET p.bio = 'x' + toString(p.v) + '" + "y" * 1000 + "'")
+        after = self.memory(0)
+        self.env.assertGreaterEqual(after["node_attributes"] - before["node_attributes"], 100 * 1000)
+
+    def test04_index(self):
+        before = self.memory()
+        redis_graph.query("CREATE INDEX ON :Person(v)")
+        after = self.memory()
+        self.env.assertGreater(after["indices"], before["indices"])
+
+    def test05_memory_usage(self):
+        usage = self.memory()
+        # MEMORY USAGE accounts for the key in addition to the graph.
+        self.env.assertGreaterEqual(redis_con.execute_command("MEMORY", "USAGE", GRAPH_ID), usage["total"])
+
+    def test06_invalid_samples(self):
+        for samples in ["-1", "abc"]:
+            try:
+                redis_con.execute_command("GRAPH.MEMORY", GRAPH_ID, samples)
+                self.env.assertTrue(False)
+            except Exception as e:
+                self.env.assertIn("Failed to parse samples value", str(e))
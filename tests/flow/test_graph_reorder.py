@@ -0,0 +1,88 @@
+import redis
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "reorder_test"
+redis_con = None
+redis_graph = None
+
+class testGraphReorder(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # Create a chain of persons, interleaved with nodes which are later deleted.
+        redis_graph.query("UNWIND range(0, 19) AS x CREATE (:Person {v: x}), (:Temp)")
+        redis_graph.query("MATCH (a:Person), (b:Person) WHERE b.v = a.v + 1 CREATE (a)-[:NEXT]->(b)")
+        redis_graph.query("MATCH (a:Person {v: 0}), (b:Person {v: 1}) CREATE (a)-[:LINK]->(b), (a)-[:LINK]->(b)")
+        redis_graph.query("MATCH (t:Temp) DELETE t")
+        redis_graph.query("CREATE INDEX ON :Person(v)")
+
+    def snapshot(self):
+        q = """MATCH (a:Person)-[e]->(b:Person) RETURN id(a), a.v, type(e), id(b), b.v ORDER BY a.v, b.v, type(e)"""
+        return redis_graph.query(q).result_set
+
+    def test01_reorder(self):
+        before = self.snapshot()
+
+        for strategy in ["BFS", "DEGREE", "RCM"]:
+            res = redis_con.execute_command("GRAPH.REORDER", GRAPH_ID, strategy, "MAPPING")
+            status = res[0].decode() if isinstance(res[0], bytes) else res[0]
+            self.env.assertIn("Nodes reordered: 20", status)
+            mapping = res[1]
+            self.env.assertEquals(sorted(mapping), sorted(set(mapping)))
+
+            # Node IDs are dense once deleted nodes are discarded.
+            ids = redis_graph.query("MATCH (n) RETURN id(n) ORDER BY id(n)").result_set
+            self.env.assertEquals([row[0] for row in ids], list(range(20)))
+
+            # Connections and attributes are retained, IDs follow the mapping.
+            after = self.snapshot()
+            self.env.assertEquals(len(after), len(before))
+            for old, new in zip(before, after):
+                self.env.assertEquals(old[1:3] + old[4:], new[1:3] + new[4:])
+                self.env.assertEquals(mapping[new[0]], old[0])
+                self.env.assertEquals(mapping[new[3]], old[3])
+            before = after
+
+        # Path neighbors are placed next to one another.
+        q = """MATCH (a:Person)-[:NEXT]->(b:Person) RETURN abs(id(a) - id(b))"""
+        for row in redis_graph.query(q).result_set:
+            self.env.assertEquals(row[0], 1)
+
+    def test02_index_rebuilt(self):
+        q = """MATCH (p:Person) WHERE p.v = 7 RETURN id(p), p.v"""
+        plan = redis_graph.execution_plan(q)
+        self.env.assertIn("Index Scan", plan)
+        index_res = redis_graph.query(q).result_set
+
+        q = """MATCH (p:Person) WITH p WHERE p.v = 7 RETURN id(p), p.v"""
+        scan_res = redis_graph.query(q).result_set
+        self.env.assertEquals(index_res, scan_res)
+
+    def test03_invalid_strategy(self):
+        for args in [["SHUFFLE"], ["SHUFFLE", "MAPPING"]]:
+            try:
+                redis_con.execute_command("GRAPH.REORDER", GRAPH_ID, *args)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("Unknown reorder strategy", str(e))
+
+    def test04_summary(self):
+        # The mapping is only replied when asked for.
+        for args in [[], ["BFS"]]:
+            res = redis_con.execute_command("GRAPH.REORDER", GRAPH_ID, *args)
+            self.env.assertEquals(len(res), 1)
+            status = res[0].decode() if isinstance(res[0], bytes) else res[0]
+            self.env.assertIn("Nodes reordered: 20", status)
+
+        res = redis_con.execute_command("GRAPH.REORDER", GRAPH_ID, "MAPPING")
+        self.env.assertEquals(len(res), 2)
+        self.env.assertEquals(sorted(res[1]), list(range(20)))
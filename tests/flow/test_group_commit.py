@@ -0,0 +1,79 @@
+import time
+import threading
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "group_commit"
+CLIENT_COUNT = 16       # Number of concurrent writers.
+WRITES_PER_CLIENT = 20  # Number of write queries issued by each writer.
+
+# Concurrent write queries are committed in groups,
+# every query must be applied exactly once, replied to individually
+# and replicated.
+
+def writer(graph, threadID, errors):
+    try:
+        for i in range(WRITES_PER_CLIENT):
+            res = graph.query("CREATE (:W {client: %d, seq: %d})" % (threadID, i))
+            if res.nodes_created != 1:
+                errors.append("client %d: expected a single node created" % threadID)
+    except Exception as e:
+        errors.append(str(e))
+
+class testGroupCommit(FlowTestsBase):
+    def __init__(self):
+        # skip test if we're running under Valgrind
+        if Env().envRunner.debugger is not None:
+            Env().skip() # valgrind is not working correctly with replication
+
+        self.env = Env(env='oss', useSlaves=True, moduleArgs="GROUP_COMMIT yes GROUP_COMMIT_MAX_BATCH 8")
+
+    def test01_concurrent_writes(self):
+        source_con = self.env.getConnection()
+        replica_con = self.env.getSlaveConnection()
+        replica_con.config_set("slave-read-only", "no")
+
+        errors = []
+        threads = []
+        for i in range(CLIENT_COUNT):
+            g = Graph(GRAPH_ID, self.env.getConnection())
+            t = threading.Thread(target=writer, args=(g, i, errors))
+            t.setDaemon(True)
+            threads.append(t)
+            t.start()
+
+        for t in threads:
+            t.join()
+
+        self.env.assertEquals(errors, [])
+
+        # Each client's writes are applied exactly once.
+        graph = Graph(GRAPH_ID, source_con)
+        q = "MATCH (w:W) RETURN w.client, count(w), max(w.seq) ORDER BY w.client"
+        expected = [[i, WRITES_PER_CLIENT, WRITES_PER_CLIENT - 1] for i in range(CLIENT_COUNT)]
+        self.env.assertEquals(graph.query(q).result_set, expected)
+
+        # Replica receives every grouped write.
+        time.sleep(1)
+        replica = Graph(GRAPH_ID, replica_con)
+        self.env.assertEquals(replica.query(q).result_set, expected)
+
+    def test02_mixed_reads_and_writes(self):
+        # Reads and failing writes interleaved with grouped writes.
+        con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, con)
+        graph.query("CREATE (:M {v: 1})")
+        res = graph.query("MATCH (m:M) SET m.v = m.v + 1 RETURN m.v")
+        self.env.assertEquals(res.result_set, [[2]])
+
+        try:
+            graph.query("CREATE (:E) WITH 1 AS x RETURN x / 'a'")
+            self.env.assertTrue(False)
+        except Exception:
+            pass
+
+        # Graph remains writable after a failed write.
+        res = graph.query("CREATE (:M {v: 3})")
+        self.env.assertEquals(res.nodes_created, 1)
@@ -0,0 +1,70 @@
+import os
+import sys
+import time
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "background_index"
+NODE_COUNT = 100000
+redis_graph = None
+
+class testIndexBackgroundBuildFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(0, %d) AS x CREATE (:person {v: x})" % (NODE_COUNT - 1))
+
+    def wait_for_index(self, query):
+        # Index is utilized once it is online.
+        for i in range(1000):
+            if 'Index Scan' in redis_graph.execution_plan(query):
+                return True
+            time.sleep(0.01)
+        return False
+
+    # Writes issued while the index is being populated must be reflected once it is online.
+    def test01_writes_during_build(self):
+        query = "MATCH (p:person) WHERE p.v >= 0 RETURN count(p)"
+        # Cache a plan prior to index creation.
+        redis_graph.query(query)
+
+        result = redis_graph.query("CREATE INDEX ON :person(v)")
+        self.env.assertEquals(result.indices_created, 1)
+
+        # Create, update and delete nodes while the index is populated.
+        redis_graph.query("UNWIND range(%d, %d) AS x CREATE (:person {v: x})" % (NODE_COUNT, NODE_COUNT + 99))
+        redis_graph.query("MATCH (p:person) WHERE p.v < 100 SET p.v = -1")
+        redis_graph.query("MATCH (p:person) WHERE p.v >= 100 AND p.v < 200 DELETE p")
+
+        self.env.assertTrue(self.wait_for_index(query))
+
+        # Cached plan is replaced by one utilizing the index.
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set[0][0], NODE_COUNT - 200 + 100)
+
+        result = redis_graph.query("MATCH (p:person) WHERE p.v = -1 RETURN count(p)")
+        self.env.assertEquals(result.result_set[0][0], 100)
+
+        result = redis_graph.query("MATCH (p:person) WHERE p.v = 150 RETURN count(p)")
+        self.env.assertEquals(result.result_set[0][0], 0)
+
+        result = redis_graph.query("MATCH (p:person) WHERE p.v = %d RETURN p.v" % (NODE_COUNT + 50))
+        self.env.assertEquals(result.result_set[0][0], NODE_COUNT + 50)
+
+    # Dropping an index while it is being populated.
+    def test02_drop_during_build(self):
+        redis_graph.query("CREATE INDEX ON :person(w)")
+        redis_graph.query("MATCH (p:person) WHERE p.v < 10 SET p.w = p.v")
+        result = redis_graph.query("DROP INDEX ON :person(w)")
+        self.env.assertEquals(result.indices_deleted, 1)
+
+        # Server remains responsive once the cancelled build is disposed.
+        time.sleep(0.5)
+        result = redis_graph.query("MATCH (p:person) WHERE p.w = 5 RETURN count(p)")
+        self.env.assertEquals(result.result_set[0][0], 1)
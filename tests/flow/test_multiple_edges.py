@@ -99,3 +99,30 @@ class testGraphMultipleEdgeFlow(FlowTestsBase):
         actual_result = redis_graph.query(query)
         edge_count = actual_result.result_set[0][0]
         self.env.assertEquals(edge_count, 1)
+
+    # Traverse labeled endpoints in both directions, mixing single and multiple edges.
+    def test_multiple_edges_traversal_directions(self):
+        g = Graph("multi_edge_directions", self.env.getConnection())
+        query = """CREATE (a:L {v:1}), (b:L {v:2}), (c:L {v:3}),
+                   (a)-[:R {v:1}]->(b), (a)-[:R {v:2}]->(b), (a)-[:R {v:3}]->(c), (a)-[:S {v:4}]->(c)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.relationships_created, 4)
+
+        # Outgoing.
+        query = """MATCH (a:L {v:1})-[e:R]->(b:L) RETURN b.v, e.v ORDER BY e.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[2, 1], [2, 2], [3, 3]])
+
+        # Incoming.
+        query = """MATCH (b:L)<-[e:R]-(a:L {v:1}) RETURN b.v, e.v ORDER BY e.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[2, 1], [2, 2], [3, 3]])
+
+        query = """MATCH (b:L {v:2})<-[e:R]-(a) RETURN a.v, e.v ORDER BY e.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[1, 1], [1, 2]])
+
+        # Multiple relation types.
+        query = """MATCH (a:L {v:1})-[e:R|S]->(c:L {v:3}) RETURN e.v ORDER BY e.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[3], [4]])
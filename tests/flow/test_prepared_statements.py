@@ -0,0 +1,155 @@
+import time
+import struct
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "prepared"
+
+# Bulk insert property type tags.
+BI_NULL = 0
+BI_BOOL = 1
+BI_DOUBLE = 2
+BI_STRING = 3
+BI_LONG = 4
+BI_ARRAY = 5
+
+# Prepared statements are executed by handle, binding binary parameters.
+
+def decode(value):
+    # Replies may be returned as bytes, depending on connection settings.
+    if isinstance(value, list):
+        return [decode(v) for v in value]
+    return value.decode() if isinstance(value, bytes) else value
+
+def encode_value(v):
+    if v is None:
+        return struct.pack("=B", BI_NULL)
+    if isinstance(v, bool):
+        return struct.pack("=BB", BI_BOOL, v)
+    if isinstance(v, int):
+        return struct.pack("=Bq", BI_LONG, v)
+    if isinstance(v, float):
+        return struct.pack("=Bd", BI_DOUBLE, v)
+    if isinstance(v, str):
+        return struct.pack("=B", BI_STRING) + v.encode() + b"\x00"
+    if isinstance(v, list):
+        return struct.pack("=Bq", BI_ARRAY, len(v)) + b"".join(encode_value(e) for e in v)
+    raise TypeError(type(v))
+
+def encode_params(params):
+    blob = struct.pack("=I", len(params))
+    for name, value in params.items():
+        blob += name.encode() + b"\x00" + encode_value(value)
+    return blob
+
+class testPreparedStatements(FlowTestsBase):
+    def __init__(self):
+        # skip test if we're running under Valgrind
+        if Env().envRunner.debugger is not None:
+            Env().skip() # valgrind is not working correctly with replication
+
+        self.env = Env(env='oss', useSlaves=True)
+        self.con = self.env.getConnection()
+        self.replica_con = self.env.getSlaveConnection()
+        self.replica_con.config_set("slave-read-only", "no")
+        self.graph = Graph(GRAPH_ID, self.con)
+
+    def prepare(self, query):
+        return self.con.execute_command("GRAPH.PREPARE", GRAPH_ID, query)
+
+    def execute(self, handle, params, *flags):
+        res = self.con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, encode_params(params), *flags)
+        return decode(res)
+
+    def test01_execute(self):
+        create = self.prepare("UNWIND $values AS v CREATE (:N {v: v, tag: $tag, weight: $weight})")
+        res = self.execute(create, {"values": list(range(100)), "tag": "a", "weight": 1.5})
+        self.env.assertTrue("Nodes created: 100" in res[-1])
+
+        # Preparing a query again returns the same handle.
+        self.env.assertEquals(self.prepare("UNWIND $values AS v CREATE (:N {v: v, tag: $tag, weight: $weight})"), create)
+
+        lookup = self.prepare("MATCH (n:N) WHERE n.v IN $ids AND n.tag = $tag RETURN n.v, n.weight = 1.5 ORDER BY n.v")
+        self.env.assertNotEqual(lookup, create)
+        res = self.execute(lookup, {"ids": [1, 5, 500], "tag": "a"})
+        self.env.assertEquals(res[1], [[1, "true"], [5, "true"]])
+
+        # Compact replies are supported.
+        res = self.execute(lookup, {"ids": [7], "tag": "a"}, "--compact")
+        self.env.assertEquals(res[1][0][0][1], 7)
+
+    def test02_value_types(self):
+        handle = self.prepare("RETURN $n IS NULL, $b, $l, size($nested), $nested[1][0], $nested[1][1]")
+        res = self.execute(handle, {"n": None, "b": True, "l": -42, "nested": [1, ["x", False]]})
+        self.env.assertEquals(res[1], [["true", "true", -42, 2, "x", "false"]])
+
+    def test03_errors(self):
+        # Parameter values are bound on execution.
+        try:
+            self.prepare("CYPHER v=1 RETURN $v")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("bound on execution", str(e))
+
+        # Invalid queries are reported on prepare.
+        try:
+            self.prepare("RETURN 1 +")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+
+        # Unknown handle.
+        try:
+            self.execute(1000, {})
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Unknown prepared statement handle", str(e))
+
+        # Malformed parameters.
+        handle = self.prepare("RETURN $v")
+        for blob in [b"", b"\x01\x00\x00\x00v\x00\x09", encode_params({"v": 1}) + b"\x00",
+                     struct.pack("=I", 1) + b"v\x00" + struct.pack("=Bq", BI_ARRAY, 1 << 40)]:
+            try:
+                self.con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, blob)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("Malformed", str(e))
+
+    def test04_replication(self):
+        # Changes made by prepared statements reach the replica as effects.
+        handle = self.prepare("MATCH (n:N) WHERE n.v IN $ids SET n.updated = $value")
+        self.execute(handle, {"ids": [1, 2, 3], "value": "yes"})
+        time.sleep(1)
+        replica = Graph(GRAPH_ID, self.replica_con)
+        q = "MATCH (n:N) WHERE n.updated = 'yes' RETURN n.v ORDER BY n.v"
+        self.env.assertEquals(replica.query(q).result_set, [[1], [2], [3]])
+
+    def test05_deallocate(self):
+        query = "MATCH (n:N) WHERE n.v = $v RETURN n.v"
+        handle = self.prepare(query)
+        usage = self.con.execute_command("GRAPH.MEMORY", GRAPH_ID)
+        before = usage[usage.index(b"prepared_statements") + 1]
+        self.env.assertGreater(before, 0)
+
+        self.env.assertEquals(self.con.execute_command("GRAPH.DEALLOCATE", GRAPH_ID, handle), b"OK")
+        usage = self.con.execute_command("GRAPH.MEMORY", GRAPH_ID)
+        self.env.assertLess(usage[usage.index(b"prepared_statements") + 1], before)
+
+        # Removed statements can't be executed nor removed again.
+        for cmd in [lambda: self.execute(handle, {"v": 1}),
+                    lambda: self.con.execute_command("GRAPH.DEALLOCATE", GRAPH_ID, handle),
+                    lambda: self.con.execute_command("GRAPH.DEALLOCATE", GRAPH_ID, "-1")]:
+            try:
+                cmd()
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("Unknown prepared statement handle", str(e))
+
+        # Handles are not reused.
+        new_handle = self.prepare(query)
+        self.env.assertGreater(new_handle, handle)
+        res = self.execute(new_handle, {"v": 1})
+        self.env.assertEquals(res[1], [[1]])
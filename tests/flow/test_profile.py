@@ -35,3 +35,70 @@ class testProfile(FlowTestsBase):
         self.env.assertIn("Project | Records produced: 2", profile)
         self.env.assertIn("Filter | Records produced: 2", profile)
         self.env.assertIn("Node By Label Scan | (p:Person) | Records produced: 3", profile)
+
+    def test_profile_graphblas_threads(self):
+        # Traversals report the threads granted to their GraphBLAS operations.
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:L {v:x})-[:R]->(:L)")
+        q = "MATCH (a:L)-[:R]->(b:L) RETURN count(b)"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+        traverse = [x for x in profile if x.startswith("Conditional Traverse")]
+        self.env.assertEquals(len(traverse), 1)
+        self.env.assertIn("GraphBLAS operations:", traverse[0])
+
+        # Running alone, the query is granted at least a single thread.
+        threads = traverse[0].split("threads: ")[1]
+        self.env.assertGreaterEqual(int(threads.split("-")[0]), 1)
+
+        # Operations which do not call GraphBLAS report no threads.
+        results = [x for x in profile if x.startswith("Results")]
+        self.env.assertNotIn("GraphBLAS", results[0])
+
+    def test_profile_stats(self):
+        redis_graph.query("UNWIND range(1, 20) AS x CREATE (:S {v:x})")
+        q = "MATCH (s:S) WHERE s.v > 10 RETURN s.v"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+
+        # Operations report the records consumed from their children.
+        filter_op = [x for x in profile if x.strip().startswith("Filter")][0]
+        self.env.assertIn("Records consumed: 20", filter_op)
+        scan = [x for x in profile if x.strip().startswith("Node By Label Scan")][0]
+        self.env.assertIn("Records consumed: 0", scan)
+
+        # Label scans are estimated by the number of labeled nodes.
+        self.env.assertIn("Estimated records: 20", scan)
+
+    def test_profile_compact(self):
+        def to_dict(op):
+            op = [x.decode() if isinstance(x, bytes) else x for x in op]
+            d = {op[i]: op[i + 1] for i in range(0, len(op), 2)}
+            d["children"] = [to_dict(child) for child in d["children"]]
+            return d
+
+        redis_graph.query("UNWIND range(1, 20) AS x CREATE (:C {v:x})-[:Q]->(:D)")
+        q = "MATCH (c:C) WHERE c.v > 10 RETURN c.v"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q, "--compact")
+        root = to_dict(profile)
+
+        # Plan is returned as a tree of operations.
+        self.env.assertEquals(root["operation"], "Results")
+        self.env.assertEquals(root["records_produced"], 10)
+        self.env.assertEquals(len(root["children"]), 1)
+
+        op = root
+        while len(op["children"]) > 0:
+            op = op["children"][0]
+        self.env.assertEquals(op["operation"], "Node By Label Scan | (c:C)")
+        self.env.assertEquals(op["records_produced"], 20)
+        self.env.assertEquals(op["records_consumed"], 0)
+        self.env.assertEquals(op["estimated_records"], 20)
+        self.env.assertGreaterEqual(float(op["execution_time_ms"]), 0)
+        self.env.assertEquals(op["graphblas_operations"], 0)
+
+        # Traversals report the time spent within GraphBLAS.
+        q = "MATCH (c:C)-[:Q]->(d:D) RETURN count(d)"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q, "--compact")
+        op = to_dict(profile)
+        while not op["operation"].startswith("Conditional Traverse"):
+            op = op["children"][0]
+        self.env.assertGreater(op["graphblas_operations"], 0)
+        self.env.assertGreaterEqual(float(op["graphblas_time_ms"]), 0)
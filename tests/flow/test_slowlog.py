@@ -1,4 +1,5 @@
 import redis
+import struct
 from RLTest import Env
 from redisgraph import Graph
 from base import FlowTestsBase
@@ -7,6 +8,12 @@ GRAPH_ID = "slowlog_test"
 redis_con = None
 redis_graph = None
 
+def decode(value):
+    # Replies may be returned as bytes, depending on connection settings.
+    if isinstance(value, list):
+        return [decode(v) for v in value]
+    return value.decode() if isinstance(value, bytes) else value
+
 class testSlowLog(FlowTestsBase):
     def __init__(self):
         self.env = Env()
@@ -41,3 +48,63 @@ class testSlowLog(FlowTestsBase):
         B = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
 
         self.env.assertNotEqual(A, B)
+
+    def test_slowlog_details(self):
+        redis_con.delete(GRAPH_ID)
+        redis_graph.query("""CREATE ({v:1})""")
+        redis_graph.query("""MATCH (n) RETURN n""")
+        redis_graph.query("""MATCH (n) RETURN n""")
+
+        # Execute a prepared statement, its parameters are logged alongside it.
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "MATCH (n) WHERE n.v = $v RETURN n")
+        params = struct.pack("=I", 1) + b"v\x00" + struct.pack("=Bq", 4, 1)
+        redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, params)
+
+        slowlog = decode(redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID))
+        self.env.assertEquals(len(slowlog), 3)
+        for entry in slowlog:
+            # time, command, query, latency, parameters, cached, queue wait, lock wait, profile
+            self.env.assertEquals(len(entry), 9)
+            self.env.assertGreaterEqual(float(entry[6]), 0)
+            self.env.assertGreaterEqual(float(entry[7]), 0)
+            # Queries are not profiled by default.
+            self.env.assertEquals(entry[8], [])
+
+            if entry[1] == "GRAPH.EXECUTE":
+                self.env.assertEquals(entry[4], "v: 1")
+            else:
+                self.env.assertEquals(entry[4], None)
+
+            if entry[2] == "MATCH (n) RETURN n":
+                # Depending on the serving thread, the repeated query may have been cached.
+                self.env.assertIn(entry[5], [0, 1])
+            elif entry[2] == "CREATE ({v:1})":
+                self.env.assertEquals(entry[5], 0)
+
+class testSlowLogProfile(FlowTestsBase):
+    def __init__(self):
+        # Profile every query taking a millisecond or longer.
+        self.env = Env(moduleArgs="SLOWLOG_PROFILE_THRESHOLD 1 SLOWLOG_PROFILE_SAMPLE_RATE 1")
+        self.con = self.env.getConnection()
+        self.graph = Graph(GRAPH_ID, self.con)
+
+    def test_slowlog_profile(self):
+        self.graph.query("""UNWIND range(1, 500) AS x CREATE ({v:x})""")
+        self.graph.query("""MATCH (n), (m) RETURN count(*)""")
+
+        slowlog = decode(self.con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID))
+        entry = [e for e in slowlog if e[2] == "MATCH (n), (m) RETURN count(*)"][0]
+        latency = float(entry[3])
+        profile = entry[8]
+        if latency < 1:
+            # Query was quick enough not to be profiled.
+            self.env.assertEquals(profile, [])
+            return
+
+        # Profile lists the plan's operations along with the records they produced.
+        self.env.assertGreater(len(profile), 0)
+        self.env.assertIn("Results", profile[0])
+        self.env.assertTrue(any("Aggregate" in line for line in profile))
+        for line in profile:
+            self.env.assertIn("Records produced", line)
+        self.env.assertTrue(any("Cartesian Product" in line for line in profile))
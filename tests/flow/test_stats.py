@@ -0,0 +1,137 @@
+import redis
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "stats"
+redis_con = None
+redis_graph = None
+
+STAGES = ["queue", "parse", "plan", "lock", "execute", "reply", "total"]
+
+def decode(value):
+    # Replies may be returned as bytes, depending on connection settings.
+    if isinstance(value, list):
+        return [decode(v) for v in value]
+    return value.decode() if isinstance(value, bytes) else value
+
+def to_dict(pairs):
+    # Convert a flat array of name, value pairs into a dictionary.
+    d = {}
+    for i in range(0, len(pairs), 2):
+        value = pairs[i + 1]
+        if isinstance(value, list) and len(value) > 0 and isinstance(value[0], str):
+            value = to_dict(value)
+        d[pairs[i]] = value
+    return d
+
+class testStats(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def stats(self, *args):
+        reply = redis_con.execute_command("GRAPH.STATS", GRAPH_ID, *args)
+        return to_dict(decode(reply))
+
+    def test01_counters(self):
+        redis_graph.query("CREATE ({v:1}), ({v:2})")
+        redis_graph.query("MATCH (n) RETURN n.v")
+        redis_graph.query("MATCH (n) RETURN n.v")
+        redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, "MATCH (n) RETURN n.v")
+
+        stats = self.stats()
+        self.env.assertEquals(stats["queries"], 4)
+        self.env.assertEquals(stats["errors"], 0)
+        # Each MATCH query returns two records.
+        self.env.assertEquals(stats["rows_returned"], 6)
+        # Plan caches are kept per thread, repeated queries may miss.
+        self.env.assertEquals(stats["plan_cache_hits"] + stats["plan_cache_misses"], 4)
+        self.env.assertGreaterEqual(stats["plan_cache_misses"], 2)
+
+        commands = stats["commands"]
+        self.env.assertEquals(commands["query"]["queries"], 3)
+        self.env.assertEquals(commands["ro_query"]["queries"], 1)
+        self.env.assertEquals(commands["execute"]["queries"], 0)
+        self.env.assertEquals(commands["batch"]["queries"], 0)
+
+    def test02_stages(self):
+        stats = self.stats()
+        queries = stats["queries"]
+        for stage in STAGES:
+            histogram = stats["stages"][stage]
+            self.env.assertEquals(histogram["count"], queries)
+            p50 = float(histogram["p50_ms"])
+            p99 = float(histogram["p99_ms"])
+            max_ms = float(histogram["max_ms"])
+            self.env.assertGreaterEqual(p50, 0)
+            self.env.assertLessEqual(p50, p99)
+            self.env.assertLessEqual(p99, max_ms)
+
+        # Each command reports its own stages.
+        query_stages = stats["commands"]["query"]["stages"]
+        self.env.assertEquals(query_stages["total"]["count"], 3)
+
+    def test03_errors(self):
+        try:
+            redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, "CREATE ()")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+
+        stats = self.stats()
+        self.env.assertEquals(stats["errors"], 1)
+        self.env.assertEquals(stats["commands"]["ro_query"]["errors"], 1)
+
+    def test04_reset(self):
+        self.env.assertEquals(decode(redis_con.execute_command("GRAPH.STATS", GRAPH_ID, "RESET")), "OK")
+        stats = self.stats()
+        self.env.assertEquals(stats["queries"], 0)
+        self.env.assertEquals(stats["stages"]["total"]["count"], 0)
+
+        redis_graph.query("MATCH (n) RETURN n")
+        stats = self.stats()
+        self.env.assertEquals(stats["queries"], 1)
+
+        self.env.assertEquals(decode(redis_con.execute_command("GRAPH.STATS", GRAPH_ID, "RESET", "ALL")), "OK")
+        self.env.assertEquals(self.stats()["queries"], 0)
+
+    def test05_graphs_are_independent(self):
+        other = Graph("stats_other", redis_con)
+        other.query("CREATE ()")
+        other.query("MATCH (n) RETURN n")
+        self.env.assertEquals(self.stats()["queries"], 0)
+        reply = redis_con.execute_command("GRAPH.STATS", "stats_other")
+        self.env.assertEquals(to_dict(decode(reply))["queries"], 2)
+
+    def test06_invalid_arguments(self):
+        for args in [["INVALID"], ["RESET", "INVALID"]]:
+            try:
+                redis_con.execute_command("GRAPH.STATS", GRAPH_ID, *args)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError:
+                pass
+
+        # Graph does not exist.
+        try:
+            redis_con.execute_command("GRAPH.STATS", "stats_missing")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+
+    def test07_info(self):
+        # INFO sections for modules are available as of Redis 6.0.
+        version = redis_con.info("server")["redis_version"]
+        if int(version.split(".")[0]) < 6:
+            self.env.skip()
+            return
+
+        redis_graph.query("MATCH (n) RETURN n")
+        info = redis_con.info("everything")
+        self.env.assertGreaterEqual(info["graph_queries"], 1)
+        self.env.assertIn("graph_command_query", info)
+        self.env.assertIn("graph_stage_total", info)
@@ -0,0 +1,418 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/* Load generator, replays a mixed read/write query workload against
+ * a synthetic social network hosted by a Redis server with RedisGraph loaded,
+ * reporting throughput and latency percentiles per query class.
+ *
+ * Usage: loadgen [options], see loadgen --help. */
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include "resp.h"
+#include "social_graph.h"
+#include "../../src/util/histogram.h"
+
+//------------------------------------------------------------------------------
+// Query classes
+//------------------------------------------------------------------------------
+
+typedef enum {
+	Q_LOOKUP,       // Point lookup of a person.
+	Q_EXPAND2,      // Friends of friends.
+	Q_AGGREGATE,    // Popular tags among friends' posts.
+	Q_VARLEN,       // Persons reachable through 1 to 3 KNOWS edges.
+	Q_CREATE,       // Create a post.
+	Q_UPDATE,       // Update a person's property.
+	Q_CLASS_COUNT
+} QueryClass;
+
+typedef struct {
+	const char *name;
+	const char *query;  // Query template, parameters are formatted into the CYPHER prefix.
+	bool write;         // Class modifies the graph.
+	int weight;         // Default share of the mix, in percent.
+} QueryClassDesc;
+
+static QueryClassDesc classes[Q_CLASS_COUNT] = {
+	[Q_LOOKUP] = {
+		"lookup",
+		"CYPHER id=%lu MATCH (p:Person {id: $id}) RETURN p.firstName, p.lastName, p.age",
+		false, 40
+	},
+	[Q_EXPAND2] = {
+		"expand2",
+		"CYPHER id=%lu MATCH (p:Person {id: $id})-[:KNOWS]->(:Person)-[:KNOWS]->(f:Person) "
+		"RETURN count(DISTINCT f)",
+		false, 20
+	},
+	[Q_AGGREGATE] = {
+		"aggregate",
+		"CYPHER id=%lu MATCH (p:Person {id: $id})-[:KNOWS]->(f:Person)<-[:HAS_CREATOR]-(m:Post)"
+		"-[:HAS_TAG]->(t:Tag) RETURN t.name, count(m) AS posts ORDER BY posts DESC LIMIT 10",
+		false, 10
+	},
+	[Q_VARLEN] = {
+		"varlen",
+		"CYPHER id=%lu MATCH (p:Person {id: $id})-[:KNOWS*1..3]->(f:Person) RETURN count(DISTINCT f)",
+		false, 10
+	},
+	[Q_CREATE] = {
+		"create",
+		"CYPHER id=%lu post=%lu length=%lu MATCH (p:Person {id: $id}) "
+		"CREATE (:Post {id: $post, length: $length})-[:HAS_CREATOR]->(p)",
+		true, 10
+	},
+	[Q_UPDATE] = {
+		"update",
+		"CYPHER id=%lu age=%lu MATCH (p:Person {id: $id}) SET p.age = $age",
+		true, 10
+	},
+};
+
+//------------------------------------------------------------------------------
+// Configuration
+//------------------------------------------------------------------------------
+
+typedef struct {
+	const char *host;
+	int port;
+	const char *graph;
+	uint64_t persons;       // Scale of the generated graph.
+	uint64_t seed;
+	bool load;              // Generate and load the graph prior to running the workload.
+	int clients;            // Number of concurrent connections.
+	int duration;           // Seconds to run the workload for.
+	uint64_t requests;      // Number of queries to issue, 0 for unlimited.
+	int weights[Q_CLASS_COUNT];
+} Config;
+
+static Config config = {
+	.host = "127.0.0.1",
+	.port = 6379,
+	.graph = "social",
+	.persons = 10000,
+	.seed = 1,
+	.load = true,
+	.clients = 8,
+	.duration = 30,
+	.requests = 0,
+};
+
+static void _Usage(const char *prog) {
+	fprintf(stderr,
+			"Usage: %s [options]\n"
+			"  -h, --host HOST         server host (default 127.0.0.1)\n"
+			"  -p, --port PORT         server port (default 6379)\n"
+			"  -g, --graph NAME        graph key (default social)\n"
+			"  -s, --scale PERSONS     number of persons in the generated graph (default 10000)\n"
+			"  -S, --seed SEED         seed of the graph and workload generators (default 1)\n"
+			"  -L, --no-load           reuse an existing graph rather than generating one\n"
+			"  -c, --clients N         concurrent connections (default 8)\n"
+			"  -d, --duration SECONDS  workload duration, 0 for no limit (default 30)\n"
+			"  -n, --requests N        stop after N queries\n"
+			"  -m, --mix CLASS=W,...   weight of each query class: lookup, expand2, aggregate,\n"
+			"                          varlen, create, update (default 40,20,10,10,10,10)\n",
+			prog);
+}
+
+// Parse a mix specification, e.g. lookup=50,update=50, unspecified classes are disabled.
+static bool _ParseMix(const char *spec) {
+	char *copy = strdup(spec);
+	char *saveptr;
+	for(int i = 0; i < Q_CLASS_COUNT; i++) config.weights[i] = 0;
+
+	for(char *tok = strtok_r(copy, ",", &saveptr); tok; tok = strtok_r(NULL, ",", &saveptr)) {
+		char *eq = strchr(tok, '=');
+		if(eq == NULL) goto error;
+		*eq = '\0';
+		int i;
+		for(i = 0; i < Q_CLASS_COUNT; i++) if(strcmp(tok, classes[i].name) == 0) break;
+		if(i == Q_CLASS_COUNT) goto error;
+		config.weights[i] = atoi(eq + 1);
+		if(config.weights[i] < 0) goto error;
+	}
+
+	free(copy);
+	return true;
+
+error:
+	fprintf(stderr, "invalid mix: %s\n", spec);
+	free(copy);
+	return false;
+}
+
+static bool _ParseArgs(int argc, char **argv) {
+	static struct option options[] = {
+		{"host", required_argument, NULL, 'h'},
+		{"port", required_argument, NULL, 'p'},
+		{"graph", required_argument, NULL, 'g'},
+		{"scale", required_argument, NULL, 's'},
+		{"seed", required_argument, NULL, 'S'},
+		{"no-load", no_argument, NULL, 'L'},
+		{"clients", required_argument, NULL, 'c'},
+		{"duration", required_argument, NULL, 'd'},
+		{"requests", required_argument, NULL, 'n'},
+		{"mix", required_argument, NULL, 'm'},
+		{"help", no_argument, NULL, 'H'},
+		{NULL, 0, NULL, 0}
+	};
+
+	for(int i = 0; i < Q_CLASS_COUNT; i++) config.weights[i] = classes[i].weight;
+
+	int opt;
+	while((opt = getopt_long(argc, argv, "h:p:g:s:S:Lc:d:n:m:", options, NULL)) != -1) {
+		switch(opt) {
+		case 'h':
+			config.host = optarg;
+			break;
+		case 'p':
+			config.port = atoi(optarg);
+			break;
+		case 'g':
+			config.graph = optarg;
+			break;
+		case 's':
+			config.persons = strtoull(optarg, NULL, 10);
+			break;
+		case 'S':
+			config.seed = strtoull(optarg, NULL, 10);
+			break;
+		case 'L':
+			config.load = false;
+			break;
+		case 'c':
+			config.clients = atoi(optarg);
+			break;
+		case 'd':
+			config.duration = atoi(optarg);
+			break;
+		case 'n':
+			config.requests = strtoull(optarg, NULL, 10);
+			break;
+		case 'm':
+			if(!_ParseMix(optarg)) return false;
+			break;
+		default:
+			_Usage(argv[0]);
+			return false;
+		}
+	}
+
+	int total = 0;
+	for(int i = 0; i < Q_CLASS_COUNT; i++) total += config.weights[i];
+	if(total == 0 || config.clients <= 0 || config.persons == 0) {
+		_Usage(argv[0]);
+		return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Workload
+//------------------------------------------------------------------------------
+
+typedef struct {
+	int id;
+	pthread_t thread;
+	RespConn *conn;
+	uint64_t rng;
+	uint64_t posts;                         // Posts created by this client.
+	uint64_t counts[Q_CLASS_COUNT];         // Successful queries.
+	uint64_t errors[Q_CLASS_COUNT];         // Failed queries.
+	Histogram latency[Q_CLASS_COUNT];       // Latency of successful queries, microseconds.
+} Client;
+
+static SocialGraph graph;
+static volatile bool stop = false;
+static uint64_t issued = 0;                 // Queries issued by all clients.
+
+static inline uint64_t _Now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Pick a query class according to the configured weights.
+static QueryClass _PickClass(Client *c, int total_weight) {
+	int r = SocialGraph_Rand(&c->rng) % total_weight;
+	for(int i = 0; i < Q_CLASS_COUNT; i++) {
+		if(r < config.weights[i]) return i;
+		r -= config.weights[i];
+	}
+	return Q_LOOKUP;
+}
+
+static void _FormatQuery(Client *c, QueryClass q, char *buf, size_t len) {
+	unsigned long person = SocialGraph_Rand(&c->rng) % graph.persons;
+	switch(q) {
+	case Q_CREATE: {
+		// Post IDs are unique across clients and distinct from generated posts.
+		unsigned long post = graph.posts + c->posts++ * config.clients + c->id;
+		snprintf(buf, len, classes[q].query, person, post,
+				 (unsigned long)(SocialGraph_Rand(&c->rng) % 2000));
+		break;
+	}
+	case Q_UPDATE:
+		snprintf(buf, len, classes[q].query, person,
+				 (unsigned long)(18 + SocialGraph_Rand(&c->rng) % 62));
+		break;
+	default:
+		snprintf(buf, len, classes[q].query, person);
+		break;
+	}
+}
+
+static void *_ClientRun(void *arg) {
+	Client *c = arg;
+	char query[1024];
+	int total_weight = 0;
+	for(int i = 0; i < Q_CLASS_COUNT; i++) total_weight += config.weights[i];
+
+	while(!stop) {
+		if(config.requests &&
+		   __atomic_fetch_add(&issued, 1, __ATOMIC_RELAXED) >= config.requests) break;
+
+		QueryClass q = _PickClass(c, total_weight);
+		_FormatQuery(c, q, query, sizeof(query));
+
+		const char *argv[] = {
+			classes[q].write ? "GRAPH.QUERY" : "GRAPH.RO_QUERY", config.graph, query, "--compact"
+		};
+		size_t argvlen[] = {strlen(argv[0]), strlen(argv[1]), strlen(argv[2]), strlen(argv[3])};
+
+		uint64_t start = _Now();
+		RespReply *reply = Resp_Command(c->conn, 4, argv, argvlen);
+		uint64_t elapsed = _Now() - start;
+
+		if(reply == NULL) {
+			fprintf(stderr, "client %d: connection lost\n", c->id);
+			c->errors[q]++;
+			break;
+		}
+		if(reply->type == RESP_ERROR) {
+			c->errors[q]++;
+		} else {
+			c->counts[q]++;
+			Histogram_Record(&c->latency[q], elapsed);
+		}
+		RespReply_Free(reply);
+	}
+	return NULL;
+}
+
+//------------------------------------------------------------------------------
+// Reporting
+//------------------------------------------------------------------------------
+
+static void _ReportRow(const char *name, uint64_t count, uint64_t errors, const Histogram *h,
+					   double seconds) {
+	printf("%-10s %10lu %8lu %10.1f %10.3f %10.3f %10.3f %10.3f %10.3f\n", name,
+		   (unsigned long)count, (unsigned long)errors, count / seconds,
+		   Histogram_Mean(h) / 1000.0,
+		   Histogram_Percentile(h, 50) / 1000.0,
+		   Histogram_Percentile(h, 99) / 1000.0,
+		   Histogram_Percentile(h, 99.9) / 1000.0,
+		   Histogram_Max(h) / 1000.0);
+}
+
+static void _Report(Client *clients, double seconds) {
+	Histogram total = {0};
+	uint64_t total_count = 0;
+	uint64_t total_errors = 0;
+
+	printf("\n%d clients, %.1f seconds\n\n", config.clients, seconds);
+	printf("%-10s %10s %8s %10s %10s %10s %10s %10s %10s\n", "class", "queries", "errors",
+		   "qps", "mean(ms)", "p50(ms)", "p99(ms)", "p999(ms)", "max(ms)");
+
+	for(int q = 0; q < Q_CLASS_COUNT; q++) {
+		if(config.weights[q] == 0) continue;
+		Histogram h = {0};
+		uint64_t count = 0;
+		uint64_t errors = 0;
+		for(int i = 0; i < config.clients; i++) {
+			Histogram_Merge(&h, &clients[i].latency[q]);
+			count += clients[i].counts[q];
+			errors += clients[i].errors[q];
+		}
+		_ReportRow(classes[q].name, count, errors, &h, seconds);
+		Histogram_Merge(&total, &h);
+		total_count += count;
+		total_errors += errors;
+	}
+	_ReportRow("total", total_count, total_errors, &total, seconds);
+}
+
+//------------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+	if(!_ParseArgs(argc, argv)) return 1;
+
+	graph = SocialGraph_New(config.persons, config.seed);
+
+	if(config.load) {
+		RespConn *conn = Resp_Connect(config.host, config.port);
+		if(conn == NULL) {
+			fprintf(stderr, "failed to connect to %s:%d\n", config.host, config.port);
+			return 1;
+		}
+
+		// Start from an empty key, GRAPH.BULK only creates new graphs.
+		const char *del[] = {"DEL", config.graph};
+		size_t del_len[] = {3, strlen(config.graph)};
+		RespReply_Free(Resp_Command(conn, 2, del, del_len));
+
+		printf("loading %lu persons, %lu cities, %lu tags and %lu posts into '%s'\n",
+			   (unsigned long)graph.persons, (unsigned long)graph.cities,
+			   (unsigned long)graph.tags, (unsigned long)graph.posts, config.graph);
+		uint64_t start = _Now();
+		int64_t edges = SocialGraph_Load(&graph, conn, config.graph);
+		Resp_Close(conn);
+		if(edges < 0) return 1;
+		printf("loaded %ld edges in %.2f seconds\n", (long)edges, (_Now() - start) / 1e6);
+	}
+
+	Client *clients = calloc(config.clients, sizeof(Client));
+	for(int i = 0; i < config.clients; i++) {
+		clients[i].id = i;
+		clients[i].rng = (config.seed + 1) * 0x9E3779B97F4A7C15ULL + i;
+		clients[i].conn = Resp_Connect(config.host, config.port);
+		if(clients[i].conn == NULL) {
+			fprintf(stderr, "failed to connect to %s:%d\n", config.host, config.port);
+			return 1;
+		}
+	}
+
+	uint64_t start = _Now();
+	for(int i = 0; i < config.clients; i++) {
+		pthread_create(&clients[i].thread, NULL, _ClientRun, &clients[i]);
+	}
+
+	// Run for the configured duration, or until all requests were issued.
+	while(!stop) {
+		usleep(10000);
+		if(config.duration > 0 && _Now() - start >= (uint64_t)config.duration * 1000000) stop = true;
+		if(config.requests && __atomic_load_n(&issued, __ATOMIC_RELAXED) >= config.requests) break;
+	}
+	stop = true;
+
+	for(int i = 0; i < config.clients; i++) pthread_join(clients[i].thread, NULL);
+	double seconds = (_Now() - start) / 1e6;
+
+	_Report(clients, seconds);
+
+	for(int i = 0; i < config.clients; i++) Resp_Close(clients[i].conn);
+	free(clients);
+	return 0;
+}
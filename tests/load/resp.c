@@ -0,0 +1,205 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "resp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define RESP_BUFFER_SIZE (64 * 1024)
+
+struct RespConn {
+	int fd;
+	char *buf;      // Received data.
+	size_t len;     // Number of bytes in buf.
+	size_t pos;     // Read position within buf.
+};
+
+RespConn *Resp_Connect(const char *host, int port) {
+	char service[16];
+	struct addrinfo hints = {0};
+	struct addrinfo *addrs;
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	snprintf(service, sizeof(service), "%d", port);
+	if(getaddrinfo(host, service, &hints, &addrs) != 0) return NULL;
+
+	int fd = -1;
+	for(struct addrinfo *a = addrs; a; a = a->ai_next) {
+		fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+		if(fd == -1) continue;
+		if(connect(fd, a->ai_addr, a->ai_addrlen) == 0) break;
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(addrs);
+	if(fd == -1) return NULL;
+
+	// Requests are small and latency sensitive.
+	int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	RespConn *conn = malloc(sizeof(RespConn));
+	conn->fd = fd;
+	conn->buf = malloc(RESP_BUFFER_SIZE);
+	conn->len = 0;
+	conn->pos = 0;
+	return conn;
+}
+
+static bool _Resp_Write(RespConn *conn, const char *data, size_t len) {
+	while(len > 0) {
+		ssize_t n = write(conn->fd, data, len);
+		if(n <= 0) return false;
+		data += n;
+		len -= n;
+	}
+	return true;
+}
+
+// Make sure at least one unread byte is buffered.
+static bool _Resp_Fill(RespConn *conn) {
+	if(conn->pos < conn->len) return true;
+	ssize_t n = read(conn->fd, conn->buf, RESP_BUFFER_SIZE);
+	if(n <= 0) return false;
+	conn->len = n;
+	conn->pos = 0;
+	return true;
+}
+
+// Read exactly len bytes into dest.
+static bool _Resp_ReadBytes(RespConn *conn, char *dest, size_t len) {
+	while(len > 0) {
+		if(!_Resp_Fill(conn)) return false;
+		size_t n = conn->len - conn->pos;
+		if(n > len) n = len;
+		memcpy(dest, conn->buf + conn->pos, n);
+		conn->pos += n;
+		dest += n;
+		len -= n;
+	}
+	return true;
+}
+
+// Read a CRLF terminated line, the terminator is dropped.
+static char *_Resp_ReadLine(RespConn *conn, size_t *len) {
+	size_t cap = 64;
+	size_t n = 0;
+	char *line = malloc(cap);
+	while(true) {
+		if(!_Resp_Fill(conn)) {
+			free(line);
+			return NULL;
+		}
+		char c = conn->buf[conn->pos++];
+		if(c == '\n' && n > 0 && line[n - 1] == '\r') break;
+		if(n + 1 == cap) line = realloc(line, cap *= 2);
+		line[n++] = c;
+	}
+	line[--n] = '\0';
+	*len = n;
+	return line;
+}
+
+static RespReply *_Resp_ReadReply(RespConn *conn) {
+	char type;
+	size_t len;
+	if(!_Resp_ReadBytes(conn, &type, 1)) return NULL;
+	char *line = _Resp_ReadLine(conn, &len);
+	if(line == NULL) return NULL;
+
+	RespReply *reply = calloc(1, sizeof(RespReply));
+	switch(type) {
+	case '+':
+	case '-':
+		reply->type = (type == '+') ? RESP_STRING : RESP_ERROR;
+		reply->str = line;
+		reply->len = len;
+		return reply;
+	case ':':
+		reply->type = RESP_INTEGER;
+		reply->integer = strtoll(line, NULL, 10);
+		break;
+	case '$': {
+		long long n = strtoll(line, NULL, 10);
+		if(n < 0) {
+			reply->type = RESP_NIL;
+			break;
+		}
+		reply->type = RESP_STRING;
+		reply->len = n;
+		reply->str = malloc(n + 2);
+		if(!_Resp_ReadBytes(conn, reply->str, n + 2)) goto error;
+		reply->str[n] = '\0';
+		break;
+	}
+	case '*': {
+		long long n = strtoll(line, NULL, 10);
+		if(n < 0) {
+			reply->type = RESP_NIL;
+			break;
+		}
+		reply->type = RESP_ARRAY;
+		reply->elements = calloc(n, sizeof(RespReply *));
+		for(long long i = 0; i < n; i++) {
+			reply->elements[i] = _Resp_ReadReply(conn);
+			if(reply->elements[i] == NULL) goto error;
+			reply->count++;
+		}
+		break;
+	}
+	default:
+		goto error;
+	}
+
+	free(line);
+	return reply;
+
+error:
+	free(line);
+	RespReply_Free(reply);
+	return NULL;
+}
+
+RespReply *Resp_Command(RespConn *conn, int argc, const char **argv, const size_t *argvlen) {
+	// Encode command as an array of bulk strings.
+	size_t cap = 32;
+	for(int i = 0; i < argc; i++) cap += argvlen[i] + 32;
+	char *cmd = malloc(cap);
+	size_t len = sprintf(cmd, "*%d\r\n", argc);
+	for(int i = 0; i < argc; i++) {
+		len += sprintf(cmd + len, "$%zu\r\n", argvlen[i]);
+		memcpy(cmd + len, argv[i], argvlen[i]);
+		len += argvlen[i];
+		cmd[len++] = '\r';
+		cmd[len++] = '\n';
+	}
+
+	bool sent = _Resp_Write(conn, cmd, len);
+	free(cmd);
+	if(!sent) return NULL;
+	return _Resp_ReadReply(conn);
+}
+
+void RespReply_Free(RespReply *reply) {
+	if(reply == NULL) return;
+	for(size_t i = 0; i < reply->count; i++) RespReply_Free(reply->elements[i]);
+	free(reply->elements);
+	free(reply->str);
+	free(reply);
+}
+
+void Resp_Close(RespConn *conn) {
+	if(conn == NULL) return;
+	close(conn->fd);
+	free(conn->buf);
+	free(conn);
+}
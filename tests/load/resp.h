@@ -0,0 +1,46 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Minimal blocking Redis client speaking RESP2,
+ * sufficient for driving a server from the load generator
+ * without depending on an external client library. */
+
+typedef enum {
+	RESP_STRING,    // Simple and bulk strings.
+	RESP_ERROR,
+	RESP_INTEGER,
+	RESP_NIL,
+	RESP_ARRAY,
+} RespType;
+
+typedef struct RespReply {
+	RespType type;
+	long long integer;              // RESP_INTEGER value.
+	char *str;                      // RESP_STRING and RESP_ERROR value, null-terminated.
+	size_t len;                     // Length of str.
+	struct RespReply **elements;    // RESP_ARRAY elements.
+	size_t count;                   // Number of elements.
+} RespReply;
+
+typedef struct RespConn RespConn;
+
+// Connect to a Redis server, returns NULL on failure.
+RespConn *Resp_Connect(const char *host, int port);
+
+// Send a command and wait for its reply.
+// Returns NULL if the connection failed, a server error is returned as a RESP_ERROR reply.
+RespReply *Resp_Command(RespConn *conn, int argc, const char **argv, const size_t *argvlen);
+
+// Free reply.
+void RespReply_Free(RespReply *reply);
+
+// Close connection.
+void Resp_Close(RespConn *conn);
@@ -0,0 +1,265 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "social_graph.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Maximal number of entities described by a single GRAPH.BULK blob.
+#define BULK_BATCH 100000
+
+// Average number of persons known by a person.
+#define KNOWS_DEGREE 10
+
+// Property types, as defined by GRAPH.BULK.
+#define BI_STRING 3
+#define BI_LONG 4
+
+static const char *first_names[] = {
+	"Alice", "Bob", "Carol", "Dan", "Eve", "Frank", "Grace", "Heidi",
+	"Ivan", "Judy", "Mallory", "Niaj", "Olivia", "Peggy", "Rupert", "Sybil"
+};
+
+static const char *last_names[] = {
+	"Smith", "Jones", "Garcia", "Chen", "Kumar", "Cohen", "Silva", "Novak",
+	"Muller", "Rossi", "Tanaka", "Kim", "Dubois", "Ivanova", "Okafor", "Larsen"
+};
+
+#define NAME_COUNT (sizeof(first_names) / sizeof(first_names[0]))
+
+//------------------------------------------------------------------------------
+// Bulk blob construction
+//------------------------------------------------------------------------------
+
+typedef struct {
+	char *data;
+	size_t len;
+	size_t cap;
+} Blob;
+
+static void _Blob_Append(Blob *b, const void *data, size_t len) {
+	if(b->len + len > b->cap) {
+		while(b->len + len > b->cap) b->cap = (b->cap) ? b->cap * 2 : 4096;
+		b->data = realloc(b->data, b->cap);
+	}
+	memcpy(b->data + b->len, data, len);
+	b->len += len;
+}
+
+static void _Blob_String(Blob *b, const char *s) {
+	_Blob_Append(b, s, strlen(s) + 1);
+}
+
+static void _Blob_ID(Blob *b, uint64_t id) {
+	_Blob_Append(b, &id, sizeof(id));
+}
+
+static void _Blob_LongProperty(Blob *b, int64_t v) {
+	char t = BI_LONG;
+	_Blob_Append(b, &t, 1);
+	_Blob_Append(b, &v, sizeof(v));
+}
+
+static void _Blob_StringProperty(Blob *b, const char *s) {
+	char t = BI_STRING;
+	_Blob_Append(b, &t, 1);
+	_Blob_String(b, s);
+}
+
+// Blob header: entity name, property count and property names.
+static void _Blob_Header(Blob *b, const char *name, uint32_t prop_count, const char **props) {
+	b->len = 0;
+	_Blob_String(b, name);
+	_Blob_Append(b, &prop_count, sizeof(prop_count));
+	for(uint32_t i = 0; i < prop_count; i++) _Blob_String(b, props[i]);
+}
+
+//------------------------------------------------------------------------------
+// Loading
+//------------------------------------------------------------------------------
+
+typedef struct {
+	RespConn *conn;
+	const char *name;
+	bool begin;     // Next query is the first of the graph.
+	bool failed;
+} Loader;
+
+// Send a single blob holding 'nodes' nodes or 'edges' edges.
+static void _Loader_Send(Loader *l, const Blob *b, uint64_t nodes, uint64_t edges) {
+	if(l->failed) return;
+
+	char node_count[32];
+	char edge_count[32];
+	snprintf(node_count, sizeof(node_count), "%lu", (unsigned long)nodes);
+	snprintf(edge_count, sizeof(edge_count), "%lu", (unsigned long)edges);
+
+	const char *argv[6];
+	size_t argvlen[6];
+	int argc = 0;
+	argv[argc++] = "GRAPH.BULK";
+	argv[argc++] = l->name;
+	if(l->begin) argv[argc++] = "BEGIN";
+	argv[argc++] = node_count;
+	argv[argc++] = edge_count;
+	argv[argc++] = b->data;
+	for(int i = 0; i < argc; i++) argvlen[i] = strlen(argv[i]);
+	argvlen[argc - 1] = b->len;
+
+	RespReply *reply = Resp_Command(l->conn, argc, argv, argvlen);
+	if(reply == NULL || reply->type == RESP_ERROR) {
+		fprintf(stderr, "GRAPH.BULK failed: %s\n", reply ? reply->str : "connection error");
+		l->failed = true;
+	}
+	RespReply_Free(reply);
+	l->begin = false;
+}
+
+static void _LoadPersons(const SocialGraph *sg, Loader *l, Blob *b) {
+	const char *props[] = {"id", "firstName", "lastName", "age", "creationDate"};
+	uint64_t rng = sg->seed ^ 0x1;
+	for(uint64_t start = 0; start < sg->persons; start += BULK_BATCH) {
+		uint64_t end = (start + BULK_BATCH < sg->persons) ? start + BULK_BATCH : sg->persons;
+		_Blob_Header(b, "Person", 5, props);
+		for(uint64_t i = start; i < end; i++) {
+			_Blob_LongProperty(b, i);
+			_Blob_StringProperty(b, first_names[SocialGraph_Rand(&rng) % NAME_COUNT]);
+			_Blob_StringProperty(b, last_names[SocialGraph_Rand(&rng) % NAME_COUNT]);
+			_Blob_LongProperty(b, 18 + SocialGraph_Rand(&rng) % 62);
+			_Blob_LongProperty(b, 1262304000 + SocialGraph_Rand(&rng) % 315360000);
+		}
+		_Loader_Send(l, b, end - start, 0);
+	}
+}
+
+// Cities and tags, holding an id and a name.
+static void _LoadNamed(Loader *l, Blob *b, const char *label, uint64_t count) {
+	const char *props[] = {"id", "name"};
+	char name[64];
+	for(uint64_t start = 0; start < count; start += BULK_BATCH) {
+		uint64_t end = (start + BULK_BATCH < count) ? start + BULK_BATCH : count;
+		_Blob_Header(b, label, 2, props);
+		for(uint64_t i = start; i < end; i++) {
+			snprintf(name, sizeof(name), "%s_%lu", label, (unsigned long)i);
+			_Blob_LongProperty(b, i);
+			_Blob_StringProperty(b, name);
+		}
+		_Loader_Send(l, b, end - start, 0);
+	}
+}
+
+static void _LoadPosts(const SocialGraph *sg, Loader *l, Blob *b) {
+	const char *props[] = {"id", "length", "creationDate"};
+	uint64_t rng = sg->seed ^ 0x2;
+	for(uint64_t start = 0; start < sg->posts; start += BULK_BATCH) {
+		uint64_t end = (start + BULK_BATCH < sg->posts) ? start + BULK_BATCH : sg->posts;
+		_Blob_Header(b, "Post", 3, props);
+		for(uint64_t i = start; i < end; i++) {
+			_Blob_LongProperty(b, i);
+			_Blob_LongProperty(b, SocialGraph_Rand(&rng) % 2000);
+			_Blob_LongProperty(b, 1262304000 + SocialGraph_Rand(&rng) % 315360000);
+		}
+		_Loader_Send(l, b, end - start, 0);
+	}
+}
+
+/* Generates the edges of a relationship type, for each source in [0, sources)
+ * 'degree' returns its out degree and 'dest' its i-th destination,
+ * both relative to the first node of their label. */
+typedef struct {
+	const char *relation;
+	uint64_t sources;       // Number of source nodes.
+	uint64_t src_offset;    // ID of the first source node.
+	uint64_t dest_offset;   // ID of the first destination node.
+	uint64_t dests;         // Number of destination nodes.
+	uint64_t min_degree;
+	uint64_t max_degree;
+	bool skewed;            // Favor low destination IDs.
+	bool since;             // Edges have a 'since' property.
+} EdgeSpec;
+
+static int64_t _LoadEdges(const SocialGraph *sg, Loader *l, Blob *b, const EdgeSpec *spec,
+						  uint64_t salt) {
+	const char *props[] = {"since"};
+	uint32_t prop_count = spec->since ? 1 : 0;
+	uint64_t rng = sg->seed ^ salt;
+	uint64_t edges = 0;
+	uint64_t total = 0;
+
+	_Blob_Header(b, spec->relation, prop_count, props);
+	for(uint64_t src = 0; src < spec->sources; src++) {
+		uint64_t range = spec->max_degree - spec->min_degree + 1;
+		uint64_t degree = spec->min_degree + SocialGraph_Rand(&rng) % range;
+		for(uint64_t i = 0; i < degree; i++) {
+			uint64_t dest = spec->skewed ? SocialGraph_RandSkewed(&rng, spec->dests) :
+							SocialGraph_Rand(&rng) % spec->dests;
+			_Blob_ID(b, spec->src_offset + src);
+			_Blob_ID(b, spec->dest_offset + dest);
+			if(spec->since) _Blob_LongProperty(b, 1262304000 + SocialGraph_Rand(&rng) % 315360000);
+			edges++;
+		}
+		if(edges >= BULK_BATCH) {
+			_Loader_Send(l, b, 0, edges);
+			_Blob_Header(b, spec->relation, prop_count, props);
+			total += edges;
+			edges = 0;
+		}
+	}
+	if(edges > 0) _Loader_Send(l, b, 0, edges);
+	return total + edges;
+}
+
+SocialGraph SocialGraph_New(uint64_t persons, uint64_t seed) {
+	SocialGraph sg;
+	sg.persons = (persons > 0) ? persons : 1;
+	sg.cities = sg.persons / 100 + 10;
+	sg.tags = sg.persons / 20 + 10;
+	sg.posts = sg.persons * 5;
+	sg.seed = seed;
+	return sg;
+}
+
+int64_t SocialGraph_Load(const SocialGraph *sg, RespConn *conn, const char *name) {
+	Blob b = {0};
+	Loader l = {.conn = conn, .name = name, .begin = true, .failed = false};
+
+	// Node IDs are assigned in creation order.
+	uint64_t person_offset = 0;
+	uint64_t city_offset = sg->persons;
+	uint64_t tag_offset = city_offset + sg->cities;
+	uint64_t post_offset = tag_offset + sg->tags;
+
+	_LoadPersons(sg, &l, &b);
+	_LoadNamed(&l, &b, "City", sg->cities);
+	_LoadNamed(&l, &b, "Tag", sg->tags);
+	_LoadPosts(sg, &l, &b);
+
+	EdgeSpec specs[] = {
+		{"KNOWS", sg->persons, person_offset, person_offset, sg->persons, 1, 2 * KNOWS_DEGREE - 1, true, true},
+		{"LIVES_IN", sg->persons, person_offset, city_offset, sg->cities, 1, 1, true, false},
+		{"INTERESTED_IN", sg->persons, person_offset, tag_offset, sg->tags, 1, 5, true, false},
+		{"HAS_CREATOR", sg->posts, post_offset, person_offset, sg->persons, 1, 1, true, false},
+		{"HAS_TAG", sg->posts, post_offset, tag_offset, sg->tags, 1, 3, true, false},
+	};
+
+	int64_t edges = 0;
+	for(size_t i = 0; i < sizeof(specs) / sizeof(specs[0]); i++) {
+		edges += _LoadEdges(sg, &l, &b, &specs[i], 0x10 + i);
+	}
+	free(b.data);
+	if(l.failed) return -1;
+
+	// Index person IDs, used by every workload query to locate its starting point.
+	const char *argv[] = {"GRAPH.QUERY", name, "CREATE INDEX ON :Person(id)"};
+	size_t argvlen[] = {strlen(argv[0]), strlen(argv[1]), strlen(argv[2])};
+	RespReply *reply = Resp_Command(conn, 3, argv, argvlen);
+	bool ok = reply && reply->type != RESP_ERROR;
+	if(!ok) fprintf(stderr, "index creation failed: %s\n", reply ? reply->str : "connection error");
+	RespReply_Free(reply);
+
+	return ok ? edges : -1;
+}
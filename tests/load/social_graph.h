@@ -0,0 +1,57 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "resp.h"
+
+/* Synthetic social network, modeled after the LDBC social network benchmark:
+ *
+ * (:Person {id, firstName, lastName, age, creationDate})
+ * (:City {id, name}), (:Tag {id, name}), (:Post {id, length, creationDate})
+ *
+ * (:Person)-[:KNOWS {since}]->(:Person)
+ * (:Person)-[:LIVES_IN]->(:City)
+ * (:Person)-[:INTERESTED_IN]->(:Tag)
+ * (:Post)-[:HAS_CREATOR]->(:Person)
+ * (:Post)-[:HAS_TAG]->(:Tag)
+ *
+ * Entity counts derive from the number of persons. Popularity is skewed:
+ * a small fraction of persons, cities and tags are the endpoint of
+ * most edges, yielding power-law in-degree distributions.
+ * Graphs generated with the same scale and seed are identical. */
+
+typedef struct {
+	uint64_t persons;
+	uint64_t cities;
+	uint64_t tags;
+	uint64_t posts;
+	uint64_t seed;
+} SocialGraph;
+
+// Describe a social network of given number of persons.
+SocialGraph SocialGraph_New(uint64_t persons, uint64_t seed);
+
+// Create graph 'name' holding the social network through GRAPH.BULK,
+// followed by an index on :Person(id).
+// Returns the number of edges created, or -1 on failure.
+int64_t SocialGraph_Load(const SocialGraph *sg, RespConn *conn, const char *name);
+
+// Random number generator shared with the workload, xorshift64*.
+static inline uint64_t SocialGraph_Rand(uint64_t *state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 0x2545F4914F6CDD1DULL;
+}
+
+// Random value in [0, n) skewed towards 0,
+// the probability of value k decays polynomially with k.
+static inline uint64_t SocialGraph_RandSkewed(uint64_t *state, uint64_t n) {
+	double u = (double)(SocialGraph_Rand(state) >> 11) / (double)(1ULL << 53);
+	return (uint64_t)(u * u * u * n);
+}
@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/arena.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class ArenaTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(ArenaTest, Alloc) {
+	Arena *arena = Arena_New(64);
+
+	char *a = (char *)Arena_Alloc(arena, 3);
+	char *b = (char *)Arena_Alloc(arena, 5);
+	ASSERT_NE(a, b);
+	ASSERT_EQ((uintptr_t)a % alignof(max_align_t), 0);
+	ASSERT_EQ((uintptr_t)b % alignof(max_align_t), 0);
+
+	// Allocation larger than block size.
+	char *big = (char *)Arena_Alloc(arena, 1024);
+	memset(big, 1, 1024);
+	ASSERT_GE(Arena_Size(arena), 1024 + 64);
+
+	int *zeros = (int *)Arena_Calloc(arena, 32, sizeof(int));
+	for(int i = 0; i < 32; i++) ASSERT_EQ(zeros[i], 0);
+
+	char *s = Arena_Strdup(arena, "arena");
+	ASSERT_STREQ(s, "arena");
+
+	Arena_Free(arena);
+}
+
+TEST_F(ArenaTest, Rewind) {
+	Arena *arena = Arena_New(64);
+	Arena_Alloc(arena, 16);
+
+	ArenaMark mark = Arena_Mark(arena);
+	size_t size = Arena_Size(arena);
+	void *first = Arena_Alloc(arena, 16);
+	for(int i = 0; i < 100; i++) Arena_Alloc(arena, 32);
+	ASSERT_GT(Arena_Size(arena), size);
+
+	// Memory past mark is reused.
+	Arena_Rewind(arena, mark);
+	ASSERT_EQ(Arena_Size(arena), size);
+	ASSERT_EQ(Arena_Alloc(arena, 16), first);
+
+	Arena_Free(arena);
+}
+
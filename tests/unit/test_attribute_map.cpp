@@ -0,0 +1,98 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/attribute_map.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class AttributeMapTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(AttributeMapTest, FindOrAdd) {
+	AttributeMap *map = AttributeMap_New(4);
+	ASSERT_EQ(AttributeMap_Count(map), 0);
+	ASSERT_EQ(AttributeMap_GetID(map, "name"), ATTRIBUTE_NOTFOUND);
+
+	ASSERT_EQ(AttributeMap_FindOrAdd(map, "name"), 0);
+	ASSERT_EQ(AttributeMap_FindOrAdd(map, "age"), 1);
+	// Existing attribute retains its ID.
+	ASSERT_EQ(AttributeMap_FindOrAdd(map, "name"), 0);
+	ASSERT_EQ(AttributeMap_Count(map), 2);
+
+	ASSERT_EQ(AttributeMap_GetID(map, "age"), 1);
+	ASSERT_STREQ(AttributeMap_GetName(map, 0), "name");
+	ASSERT_STREQ(AttributeMap_GetName(map, 1), "age");
+
+	AttributeMap_Free(map);
+}
+
+TEST_F(AttributeMapTest, Grow) {
+	char name[32];
+	AttributeMap *map = AttributeMap_New(1);
+
+	// Force multiple table replacements.
+	for(int i = 0; i < 1000; i++) {
+		sprintf(name, "attr_%d", i);
+		ASSERT_EQ(AttributeMap_FindOrAdd(map, name), i);
+	}
+	ASSERT_EQ(AttributeMap_Count(map), 1000);
+
+	for(int i = 0; i < 1000; i++) {
+		sprintf(name, "attr_%d", i);
+		ASSERT_EQ(AttributeMap_GetID(map, name), i);
+		ASSERT_STREQ(AttributeMap_GetName(map, i), name);
+	}
+
+	AttributeMap_Free(map);
+}
+
+static void *_add_attributes(void *arg) {
+	char name[32];
+	AttributeMap *map = (AttributeMap *)arg;
+	for(int i = 0; i < 500; i++) {
+		sprintf(name, "attr_%d", i);
+		Attribute_ID id = AttributeMap_FindOrAdd(map, name);
+		// Readers must always observe a consistent mapping.
+		if(strcmp(AttributeMap_GetName(map, id), name) != 0) return (void *)1;
+	}
+	return NULL;
+}
+
+TEST_F(AttributeMapTest, ConcurrentAdd) {
+	const int thread_count = 4;
+	pthread_t threads[thread_count];
+	AttributeMap *map = AttributeMap_New(1);
+
+	for(int i = 0; i < thread_count; i++) {
+		pthread_create(threads + i, NULL, _add_attributes, map);
+	}
+	for(int i = 0; i < thread_count; i++) {
+		void *res;
+		pthread_join(threads[i], &res);
+		ASSERT_TRUE(res == NULL);
+	}
+
+	// Each attribute is added exactly once.
+	ASSERT_EQ(AttributeMap_Count(map), 500);
+
+	AttributeMap_Free(map);
+}
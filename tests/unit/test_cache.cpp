@@ -35,15 +35,15 @@ TEST_F(CacheTest, ExecutionPlanCache) {
 	ASSERT_FALSE(Cache_GetValue(cache, query1));
 
 	// Add single entry
-	Cache_SetValue(cache, query1, ep1);
+	Cache_SetValue(cache, query1, ep1, sizeof(ExecutionPlan));
 	ASSERT_EQ(ep1, Cache_GetValue(cache, query1));
 
 	// Add multiple entries.
-	Cache_SetValue(cache, query2, ep2);
+	Cache_SetValue(cache, query2, ep2, sizeof(ExecutionPlan));
 	ASSERT_EQ(ep2, Cache_GetValue(cache, query2));
-	Cache_SetValue(cache, query3, ep3);
+	Cache_SetValue(cache, query3, ep3, sizeof(ExecutionPlan));
 	ASSERT_EQ(ep3, Cache_GetValue(cache, query3));
-	Cache_SetValue(cache, query4, ep4);
+	Cache_SetValue(cache, query4, ep4, sizeof(ExecutionPlan));
 	ASSERT_EQ(ep4, Cache_GetValue(cache, query4));
 
 	// Verify that oldest entry do not exists - queue is [ 4 | 3 | 2 ].
@@ -52,3 +52,23 @@ TEST_F(CacheTest, ExecutionPlanCache) {
 	Cache_Free(cache);
 }
 
+TEST_F(CacheTest, MemoryUsage) {
+	Cache *cache = Cache_New(2, (CacheItemFreeFunc)rm_free);
+	size_t empty = Cache_MemoryUsage(cache);
+
+	const char *query1 = "MATCH (a) RETURN a";
+	const char *query2 = "MATCH (b) RETURN b";
+	const char *query3 = "MATCH (c) RETURN c";
+	size_t key_size = strlen(query1) + 1;
+
+	Cache_SetValue(cache, query1, rm_malloc(100), 100);
+	ASSERT_EQ(empty + key_size + 100, Cache_MemoryUsage(cache));
+	Cache_SetValue(cache, query2, rm_malloc(200), 200);
+	ASSERT_EQ(empty + 2 * key_size + 300, Cache_MemoryUsage(cache));
+
+	// Evicted entries are no longer accounted for - queue is [ 3 | 2 ].
+	Cache_SetValue(cache, query3, rm_malloc(50), 50);
+	ASSERT_EQ(empty + 2 * key_size + 250, Cache_MemoryUsage(cache));
+
+	Cache_Free(cache);
+}
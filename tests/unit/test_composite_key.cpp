@@ -0,0 +1,155 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <math.h>
+#include "../../src/value.h"
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/index/composite_key.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class CompositeKeyTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+
+	// Encode values into a null terminated key, to be freed with array_free.
+	static char *_Key(const SIValue *values, uint count) {
+		char *key = array_new(char, 32);
+		for(uint i = 0; i < count; i++) EXPECT_TRUE(CompositeKey_AppendValue(&key, values[i]));
+		return array_append(key, '\0');
+	}
+
+	// Checks if key lies within [min, max] or [min, max), depending on include_max.
+	static bool _InRange(const char *key, const char *min, const char *max, bool include_max) {
+		if(strcmp(key, min) < 0) return false;
+		int c = strcmp(key, max);
+		return include_max ? c <= 0 : c < 0;
+	}
+};
+
+TEST_F(CompositeKeyTest, NumericOrder) {
+	double values[] = {-INFINITY, -1e300, -5.5, -1, -0.0, 0, 1e-300, 1, 2, 3.5, 1e300, INFINITY};
+	uint count = sizeof(values) / sizeof(values[0]);
+
+	for(uint i = 0; i + 1 < count; i++) {
+		SIValue a = SI_DoubleVal(values[i]);
+		SIValue b = SI_DoubleVal(values[i + 1]);
+		char *x = _Key(&a, 1);
+		char *y = _Key(&b, 1);
+		// -0.0 and 0 share a key.
+		if(values[i] == values[i + 1]) ASSERT_EQ(strcmp(x, y), 0);
+		else ASSERT_LT(strcmp(x, y), 0);
+		array_free(x);
+		array_free(y);
+	}
+
+	// Integers and doubles of equal value share a key.
+	SIValue i = SI_LongVal(3);
+	SIValue d = SI_DoubleVal(3);
+	char *x = _Key(&i, 1);
+	char *y = _Key(&d, 1);
+	ASSERT_STREQ(x, y);
+	array_free(x);
+	array_free(y);
+}
+
+TEST_F(CompositeKeyTest, StringOrder) {
+	// Terminator and escape bytes within strings keep their order.
+	const char *values[] = {"", "\x01", "\x01\x01", "\x02", "\x03", "a", "a\x01", "ab", "b", "\xc3\xa9"};
+	uint count = sizeof(values) / sizeof(values[0]);
+
+	for(uint i = 0; i + 1 < count; i++) {
+		SIValue a = SI_ConstStringVal((char *)values[i]);
+		SIValue b = SI_ConstStringVal((char *)values[i + 1]);
+		char *x = _Key(&a, 1);
+		char *y = _Key(&b, 1);
+		ASSERT_LT(strcmp(x, y), 0);
+		array_free(x);
+		array_free(y);
+	}
+}
+
+TEST_F(CompositeKeyTest, LexicographicOrder) {
+	// (1, 'b') < (1, 'ba') < (2, 'a')
+	SIValue a[2] = {SI_DoubleVal(1), SI_ConstStringVal((char *)"b")};
+	SIValue b[2] = {SI_DoubleVal(1), SI_ConstStringVal((char *)"ba")};
+	SIValue c[2] = {SI_DoubleVal(2), SI_ConstStringVal((char *)"a")};
+	char *x = _Key(a, 2);
+	char *y = _Key(b, 2);
+	char *z = _Key(c, 2);
+	ASSERT_LT(strcmp(x, y), 0);
+	ASSERT_LT(strcmp(y, z), 0);
+	array_free(x);
+	array_free(y);
+	array_free(z);
+
+	// Types can't be keyed.
+	char *key = array_new(char, 1);
+	ASSERT_FALSE(CompositeKey_AppendValue(&key, SI_NullVal()));
+	array_free(key);
+}
+
+TEST_F(CompositeKeyTest, PrefixRange) {
+	// a = 1 AND b within (2, 5), every combination of inclusive and unbounded ends.
+	SIValue a = SI_DoubleVal(1);
+	SIValue lower = SI_DoubleVal(2);
+	SIValue upper = SI_DoubleVal(5);
+
+	for(int bounds = 0; bounds < 16; bounds++) {
+		bool lower_bound = bounds & 1;
+		bool upper_bound = bounds & 2;
+		bool include_min = bounds & 4;
+		bool include_max = bounds & 8;
+
+		char *min = array_new(char, 32);
+		char *max = array_new(char, 32);
+		CompositeKey_AppendValue(&min, a);
+		CompositeKey_AppendValue(&max, a);
+		CompositeKey_AppendLowerBound(&min, COMPOSITE_KEY_NUMERIC, lower_bound ? &lower : NULL,
+									  include_min);
+		bool inclusive = CompositeKey_AppendUpperBound(&max, COMPOSITE_KEY_NUMERIC,
+													   upper_bound ? &upper : NULL, include_max);
+		min = array_append(min, '\0');
+		max = array_append(max, '\0');
+
+		for(double x = 0; x <= 2; x++) {
+			for(double y = -1; y <= 7; y += 0.5) {
+				// Keys of two and three properties, the last of either type.
+				for(int suffix = 0; suffix < 3; suffix++) {
+					SIValue values[3] = {SI_DoubleVal(x), SI_DoubleVal(y),
+										 suffix == 1 ? SI_DoubleVal(-3) : SI_ConstStringVal((char *)"z")
+										};
+					char *key = _Key(values, suffix ? 3 : 2);
+					bool expected = (x == 1) &&
+									(!lower_bound || (include_min ? y >= 2 : y > 2)) &&
+									(!upper_bound || (include_max ? y <= 5 : y < 5));
+					ASSERT_EQ(_InRange(key, min, max, inclusive), expected);
+					array_free(key);
+				}
+			}
+		}
+
+		// Strings don't fall within numeric ranges.
+		SIValue values[2] = {a, SI_ConstStringVal((char *)"x")};
+		char *key = _Key(values, 2);
+		ASSERT_FALSE(_InRange(key, min, max, inclusive));
+		array_free(key);
+
+		array_free(min);
+		array_free(max);
+	}
+}
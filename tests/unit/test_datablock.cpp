@@ -16,6 +16,7 @@ extern "C" {
 #include "../../src/util/datablock/datablock.h"
 #include "../../src/util/datablock/oo_datablock.h"
 #include "../../src/util/rmalloc.h"
+#include "../../src/util/simple_timer.h"
 
 #ifdef __cplusplus
 }
@@ -38,7 +39,8 @@ TEST_F(DataBlockTest, New) {
 
 	ASSERT_EQ(dataBlock->itemCount, 0);     // No items were added.
 	ASSERT_GE(dataBlock->itemCap, 1024);
-	ASSERT_EQ(dataBlock->itemSize, itemSize + ITEM_HEADER_SIZE);
+	// Items carry no header, deleted items are tracked by per block bitmaps.
+	ASSERT_EQ(dataBlock->itemSize, itemSize);
 	ASSERT_GE(dataBlock->blockCount, 1024 / DATABLOCK_BLOCK_CAP);
 
 	for(int i = 0; i < dataBlock->blockCount; i++) {
@@ -159,8 +161,7 @@ TEST_F(DataBlockTest, RemoveItem) {
 	DataBlock_DeleteItem(dataBlock, 0);
 	ASSERT_EQ(dataBlock->itemCount, itemCount - 1);
 	ASSERT_EQ(array_len(dataBlock->deletedIdx), 1);
-	DataBlockItemHeader *header = (DataBlockItemHeader *)dataBlock->blocks[0]->data;
-	ASSERT_TRUE(IS_ITEM_DELETED(header));
+	ASSERT_EQ(dataBlock->bitmaps[0][0] & 1, 0);
 
 	// Try to get item from deleted cell.
 	item = (int *)DataBlock_GetItem(dataBlock, 0);
@@ -180,7 +181,8 @@ TEST_F(DataBlockTest, RemoveItem) {
 	int *newItem = (int *)DataBlock_AllocateItem(dataBlock, NULL);
 	ASSERT_EQ(dataBlock->itemCount, itemCount);
 	ASSERT_EQ(array_len(dataBlock->deletedIdx), 0);
-	ASSERT_TRUE((void *)newItem == (void *)((dataBlock->blocks[0]->data) + ITEM_HEADER_SIZE));
+	ASSERT_TRUE((void *)newItem == (void *)(dataBlock->blocks[0]->data));
+	ASSERT_EQ(dataBlock->bitmaps[0][0] & 1, 1);
 
 	it = DataBlock_Scan(dataBlock);
 	counter = 0;
@@ -239,3 +241,247 @@ TEST_F(DataBlockTest, OutOfOrderBuilding) {
 	DataBlock_Free(dataBlock);
 }
 
+TEST_F(DataBlockTest, AllocateItemAt) {
+	// Replays allocations made by another datablock, regardless of deletion order.
+	DataBlock *dataBlock = DataBlock_New(1, sizeof(int), NULL);
+
+	for(int i = 0; i < 6; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+	DataBlock_DeleteItem(dataBlock, 1);
+	DataBlock_DeleteItem(dataBlock, 4);
+	DataBlock_DeleteItem(dataBlock, 2);
+
+	// Reuse a free index which isn't the most recently deleted one.
+	int *item = (int *)DataBlock_AllocateItemAt(dataBlock, 4);
+	*item = 4;
+	ASSERT_EQ(4, dataBlock->itemCount);
+	ASSERT_EQ(2, DataBlock_DeletedItemsCount(dataBlock));
+	ASSERT_EQ(4, *(int *)DataBlock_GetItem(dataBlock, 4));
+
+	// Occupied positions can't be reallocated.
+	ASSERT_TRUE(DataBlock_AllocateItemAt(dataBlock, 4) == NULL);
+	ASSERT_TRUE(DataBlock_AllocateItemAt(dataBlock, 0) == NULL);
+
+	// Allocate past the end, skipped positions are free.
+	item = (int *)DataBlock_AllocateItemAt(dataBlock, 8);
+	*item = 8;
+	ASSERT_EQ(5, dataBlock->itemCount);
+	ASSERT_EQ(4, DataBlock_DeletedItemsCount(dataBlock));
+	ASSERT_TRUE(DataBlock_GetItem(dataBlock, 6) == NULL);
+	ASSERT_TRUE(DataBlock_GetItem(dataBlock, 7) == NULL);
+
+	// Positions too far past the end are rejected.
+	uint64_t end = dataBlock->itemCount + DataBlock_DeletedItemsCount(dataBlock);
+	ASSERT_TRUE(DataBlock_AllocateItemAt(dataBlock, end + DATABLOCK_ALLOCATE_AT_SLACK + 1) == NULL);
+	ASSERT_EQ(5, dataBlock->itemCount);
+
+	// Allocate past the datablock's capacity.
+	uint64_t idx = DATABLOCK_BLOCK_CAP + 3;
+	item = (int *)DataBlock_AllocateItemAt(dataBlock, idx);
+	*item = idx;
+	ASSERT_GT(dataBlock->itemCap, idx);
+	ASSERT_EQ(6, dataBlock->itemCount);
+	ASSERT_EQ(idx, *(int *)DataBlock_GetItem(dataBlock, idx));
+
+	// Deleted items listing excludes reallocated positions.
+	uint64_t deleted = DataBlock_DeletedItemsCount(dataBlock);
+	for(uint64_t i = 0; i < deleted; i++) {
+		uint64_t pos = DataBlock_DeletedItem(dataBlock, i);
+		ASSERT_TRUE(DataBlock_GetItem(dataBlock, pos) == NULL);
+		ASSERT_NE(4, pos);
+	}
+
+	// Regular allocations reuse remaining free indices.
+	for(uint64_t i = 0; i < deleted; i++) {
+		uint64_t pos;
+		DataBlock_AllocateItem(dataBlock, &pos);
+		ASSERT_LT(pos, idx);
+	}
+	ASSERT_EQ(idx + 1, dataBlock->itemCount);
+	ASSERT_EQ(0, DataBlock_DeletedItemsCount(dataBlock));
+	ASSERT_EQ(0, array_len(dataBlock->deletedIdx));
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, ScanSkipsDeletedRanges) {
+	DataBlock *dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, sizeof(int), NULL);
+	uint itemCount = DATABLOCK_BLOCK_CAP * 3;
+	DataBlock_Accommodate(dataBlock, itemCount);
+
+	for(int i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Delete everything but a handful of items, spread across blocks.
+	uint64_t kept[5] = {0, 63, 64, DATABLOCK_BLOCK_CAP + 1000, itemCount - 1};
+	uint k = 0;
+	for(uint64_t i = 0; i < itemCount; i++) {
+		if(k < 5 && kept[k] == i) {
+			k++;
+			continue;
+		}
+		DataBlock_DeleteItem(dataBlock, i);
+	}
+
+	uint64_t id;
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	for(uint i = 0; i < 5; i++) {
+		int *item = (int *)DataBlockIterator_Next(it, &id);
+		ASSERT_TRUE(item != NULL);
+		ASSERT_EQ(id, kept[i]);
+		ASSERT_EQ(*item, kept[i]);
+	}
+	ASSERT_TRUE(DataBlockIterator_Next(it, NULL) == NULL);
+	DataBlockIterator_Free(it);
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, Compact) {
+	DataBlock *dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, sizeof(int), NULL);
+	uint itemCount = DATABLOCK_BLOCK_CAP * 3;
+	DataBlock_Accommodate(dataBlock, itemCount + DATABLOCK_BLOCK_CAP);
+
+	for(int i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Delete the entire second block and all but one item of the first block.
+	for(uint64_t i = 1; i < DATABLOCK_BLOCK_CAP * 2; i++) DataBlock_DeleteItem(dataBlock, i);
+
+	size_t usage = DataBlock_MemoryUsage(dataBlock);
+
+	// Compact one block at a time.
+	ASSERT_FALSE(DataBlock_Compact(dataBlock, 1));
+	ASSERT_EQ(DataBlock_ReleasedBlockCount(dataBlock), 0);
+	ASSERT_FALSE(DataBlock_Compact(dataBlock, 1));
+	ASSERT_EQ(DataBlock_ReleasedBlockCount(dataBlock), 1);
+	ASSERT_TRUE(DataBlock_Compact(dataBlock, 1));
+	ASSERT_TRUE(dataBlock->blocks[1] == NULL);
+
+	// Spare capacity is retained.
+	ASSERT_TRUE(dataBlock->blocks[3] != NULL);
+	ASSERT_EQ(DataBlock_ReleasedBlockCount(dataBlock), 1);
+
+	// Released block's memory is no longer accounted for, its index is.
+	ASSERT_EQ(usage - DataBlock_MemoryUsage(dataBlock),
+			  sizeof(Block) + DATABLOCK_BLOCK_CAP * sizeof(int) - sizeof(uint));
+
+	// Released items are reported as deleted.
+	ASSERT_TRUE(DataBlock_GetItem(dataBlock, DATABLOCK_BLOCK_CAP + 5) == NULL);
+	ASSERT_EQ(*(int *)DataBlock_GetItem(dataBlock, 0), 0);
+	ASSERT_EQ(DataBlock_DeletedItemsCount(dataBlock), DATABLOCK_BLOCK_CAP * 2 - 1);
+	ASSERT_EQ(DataBlock_DeletedItem(dataBlock, DATABLOCK_BLOCK_CAP * 2 - 2),
+			  DATABLOCK_BLOCK_CAP * 2 - 1);
+
+	// Free indices of the released block are dropped, blocks are linked over it.
+	ASSERT_EQ(array_len(dataBlock->deletedIdx), DATABLOCK_BLOCK_CAP - 1);
+	ASSERT_TRUE(dataBlock->blocks[0]->next == dataBlock->blocks[2]);
+
+	// Scan skips released block.
+	uint counter = 0;
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	while(DataBlockIterator_Next(it, NULL)) counter++;
+	DataBlockIterator_Free(it);
+	ASSERT_EQ(counter, DATABLOCK_BLOCK_CAP + 1);
+
+	// Free slots of live blocks are reused first,
+	// reusing a released slot reallocates its block.
+	uint64_t idx;
+	uint allocations = 0;
+	while(true) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, &idx);
+		*item = -1;
+		allocations++;
+		if(idx / DATABLOCK_BLOCK_CAP == 1) break;
+	}
+	ASSERT_EQ(allocations, DATABLOCK_BLOCK_CAP);
+	ASSERT_TRUE(dataBlock->blocks[1] != NULL);
+	ASSERT_TRUE(dataBlock->blocks[0]->next == dataBlock->blocks[1]);
+	ASSERT_TRUE(dataBlock->blocks[1]->next == dataBlock->blocks[2]);
+	ASSERT_EQ(array_len(dataBlock->deletedIdx), DATABLOCK_BLOCK_CAP - 1);
+	ASSERT_EQ(*(int *)DataBlock_GetItem(dataBlock, idx), -1);
+	ASSERT_EQ(DataBlock_ReleasedBlockCount(dataBlock), 0);
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, GetItemsBatch) {
+	DataBlock *dataBlock = DataBlock_New(16, sizeof(int), NULL);
+	uint itemCount = 100;
+	DataBlock_Accommodate(dataBlock, itemCount);
+
+	for(int i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Delete every third item.
+	for(uint i = 0; i < itemCount; i += 3) DataBlock_DeleteItem(dataBlock, i);
+
+	// Request items in reverse order, spanning multiple blocks.
+	uint64_t idx[itemCount];
+	void *items[itemCount];
+	for(uint i = 0; i < itemCount; i++) idx[i] = itemCount - 1 - i;
+	DataBlock_GetItemsBatch(dataBlock, idx, itemCount, items);
+
+	for(uint i = 0; i < itemCount; i++) {
+		ASSERT_EQ(items[i], DataBlock_GetItem(dataBlock, idx[i]));
+		if(idx[i] % 3 == 0) {
+			ASSERT_TRUE(items[i] == NULL);
+		} else {
+			ASSERT_EQ(*(int *)items[i], idx[i]);
+		}
+	}
+
+	// Empty batch.
+	DataBlock_GetItemsBatch(dataBlock, idx, 0, items);
+
+	DataBlock_Free(dataBlock);
+}
+
+// Compare random access lookups with and without prefetching,
+// run with --gtest_also_run_disabled_tests.
+TEST_F(DataBlockTest, DISABLED_BenchmarkGetItemsBatch) {
+	uint64_t itemCount = 1 << 22;
+	uint64_t batchSize = 64;
+	uint64_t lookups = 1 << 24;
+	DataBlock *dataBlock = DataBlock_New(16384, sizeof(uint64_t) * 8, NULL);
+	DataBlock_Accommodate(dataBlock, itemCount);
+	for(uint64_t i = 0; i < itemCount; i++) {
+		uint64_t *item = (uint64_t *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	uint64_t *idx = (uint64_t *)malloc(sizeof(uint64_t) * lookups);
+	for(uint64_t i = 0; i < lookups; i++) idx[i] = rand() % itemCount;
+
+	double tic[2];
+	uint64_t sum = 0;
+	simple_tic(tic);
+	for(uint64_t i = 0; i < lookups; i++) {
+		sum += *(uint64_t *)DataBlock_GetItem(dataBlock, idx[i]);
+	}
+	double single = simple_toc(tic);
+
+	uint64_t batchSum = 0;
+	void *items[batchSize];
+	simple_tic(tic);
+	for(uint64_t i = 0; i < lookups; i += batchSize) {
+		DataBlock_GetItemsBatch(dataBlock, idx + i, batchSize, items);
+		for(uint64_t j = 0; j < batchSize; j++) batchSum += *(uint64_t *)items[j];
+	}
+	double batched = simple_toc(tic);
+
+	ASSERT_EQ(sum, batchSum);
+	printf("%lu random lookups, DataBlock_GetItem: %.6f sec, DataBlock_GetItemsBatch: %.6f sec\n",
+		   lookups, single, batched);
+
+	free(idx);
+	DataBlock_Free(dataBlock);
+}
@@ -44,8 +44,7 @@ class FilterTreeTest: public ::testing::Test {
 		 * accessible via thread local storage, as such we're creating a
 		 * fake graph context and placing it within thread local storage. */
 		GraphContext *gc = (GraphContext *)calloc(1, sizeof(GraphContext));
-		gc->attributes = raxNew();
-		pthread_rwlock_init(&gc->_attribute_rwlock, NULL);
+		gc->attributes = AttributeMap_New(64);
 
 		// No indicies.
 		gc->index_count = 0;
@@ -489,3 +488,43 @@ TEST_F(FilterTreeTest, FilterTree_Compact) {
 	FilterTree_Free(expected);
 }
 
+
+TEST_F(FilterTreeTest, FilterTree_Compile) {
+	const char *q = "MATCH (a), (b) WHERE a + b > 2 AND a + b < 10 OR b = 0 RETURN a";
+	FT_FilterNode *tree = build_tree_from_query(q);
+	AR_Program *program = FilterTree_Compile(tree);
+	ASSERT_TRUE(program != NULL);
+
+	// a + b is computed once.
+	uint add_count = 0;
+	uint ins_count = array_len(program->code);
+	for(uint i = 0; i < ins_count; i++) {
+		if(program->code[i].code == AR_INS_ADD) add_count++;
+	}
+	ASSERT_EQ(add_count, 1);
+
+	rax *mapping = raxNew();
+	raxInsert(mapping, (unsigned char *)"a", 1, (void *)0, NULL);
+	raxInsert(mapping, (unsigned char *)"b", 1, (void *)1, NULL);
+	Record r = Record_New(mapping);
+
+	// Compiled program and filter tree should agree.
+	SIValue values[6] = {SI_LongVal(1), SI_LongVal(5), SI_DoubleVal(2.5), SI_NullVal(),
+						 SI_LongVal(0), SI_ConstStringVal("str")
+						};
+	for(int i = 0; i < 6; i++) {
+		for(int j = 0; j < 6; j++) {
+			Record_AddScalar(r, 0, values[i]);
+			Record_AddScalar(r, 1, values[j]);
+			int expected = FilterTree_applyFilters(tree, r);
+			SIValue actual = AR_Program_Evaluate(program, r);
+			ASSERT_EQ(SI_TYPE(actual), T_BOOL);
+			ASSERT_EQ(actual.longval, expected);
+		}
+	}
+
+	Record_Free(r);
+	raxFree(mapping);
+	AR_Program_Free(program);
+	FilterTree_Free(tree);
+}
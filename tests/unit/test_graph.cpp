@@ -14,6 +14,7 @@ extern "C"
 #include "../../src/config.h"
 #include "../../src/util/arr.h"
 #include "../../src/graph/graph.h"
+#include "../../src/graph/graph_reorder.h"
 #include "../../src/util/rmalloc.h"
 #include "../../src/util/simple_timer.h"
 #include "../../deps/GraphBLAS/Include/GraphBLAS.h"
@@ -658,6 +659,200 @@ TEST_F(GraphTest, GetNode) {
 	Graph_Free(g);
 }
 
+TEST_F(GraphTest, GetNodeLabel) {
+	Node n;
+	size_t nodeCount = 16;
+	Graph *g = Graph_New(nodeCount, nodeCount);
+
+	Graph_AcquireWriteLock(g);
+	{
+		int l0 = Graph_AddLabel(g);
+		int l1 = Graph_AddLabel(g);
+		// Alternate between unlabeled, l0 and l1 nodes.
+		int labels[3] = {GRAPH_NO_LABEL, l0, l1};
+		for(int i = 0; i < nodeCount; i++) Graph_CreateNode(g, labels[i % 3], &n);
+
+		for(NodeID i = 0; i < nodeCount; i++) {
+			ASSERT_EQ(Graph_GetNodeLabel(g, i), labels[i % 3]);
+		}
+
+		// Deleted node's label is cleared from its label matrix.
+		Graph_GetNode(g, 1, &n);
+		Graph_DeleteNode(g, &n);
+		ASSERT_EQ(Graph_GetNodeLabel(g, 1), GRAPH_NO_LABEL);
+
+		bool x = false;
+		GrB_Matrix M = Graph_GetLabelMatrix(g, l0);
+		ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, M, 1, 1), GrB_NO_VALUE);
+
+		// Node reusing the deleted ID carries its own label.
+		Graph_CreateNode(g, l1, &n);
+		ASSERT_EQ(ENTITY_GET_ID(&n), 1);
+		ASSERT_EQ(Graph_GetNodeLabel(g, 1), l1);
+	}
+	Graph_ReleaseLock(g);
+
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, GetTypedIncomingEdges) {
+	// Validate typed incoming edges with and without maintained transposes.
+	bool maintain_transpose[2] = {true, false};
+	for(int t = 0; t < 2; t++) {
+		config.maintain_transposed_matrices = maintain_transpose[t];
+
+		Edge e;
+		Node n;
+		Graph *g = Graph_New(8, 8);
+		Graph_AcquireWriteLock(g);
+		for(int i = 0; i < 4; i++) Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+		int r0 = Graph_AddRelationType(g);
+		int r1 = Graph_AddRelationType(g);
+
+		/* Connections:
+		 * 0 -[r0]-> 3, twice.
+		 * 1 -[r0]-> 3.
+		 * 2 -[r1]-> 3.
+		 * 3 -[r0]-> 0. */
+		Graph_ConnectNodes(g, 0, 3, r0, &e);
+		Graph_ConnectNodes(g, 0, 3, r0, &e);
+		Graph_ConnectNodes(g, 1, 3, r0, &e);
+		Graph_ConnectNodes(g, 2, 3, r1, &e);
+		Graph_ConnectNodes(g, 3, 0, r0, &e);
+		Graph_ReleaseLock(g);
+
+		Edge *edges = (Edge *)array_new(Edge, 4);
+		Graph_GetNode(g, 3, &n);
+
+		Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, r0, &edges);
+		ASSERT_EQ(array_len(edges), 3);
+		for(uint i = 0; i < array_len(edges); i++) {
+			ASSERT_EQ(Edge_GetDestNodeID(edges + i), 3);
+			ASSERT_EQ(Edge_GetRelationID(edges + i), r0);
+			ASSERT_NE(Edge_GetSrcNodeID(edges + i), 2);
+		}
+
+		array_clear(edges);
+		Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, r1, &edges);
+		ASSERT_EQ(array_len(edges), 1);
+		ASSERT_EQ(Edge_GetSrcNodeID(edges), 2);
+
+		array_clear(edges);
+		Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_OUTGOING, r0, &edges);
+		ASSERT_EQ(array_len(edges), 1);
+		ASSERT_EQ(Edge_GetDestNodeID(edges), 0);
+
+		// Incoming edges reflect modifications made after they were first retrieved.
+		Graph_AcquireWriteLock(g);
+		Graph_ConnectNodes(g, 2, 3, r0, &e);
+		Graph_ReleaseLock(g);
+
+		array_clear(edges);
+		Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, r0, &edges);
+		ASSERT_EQ(array_len(edges), 4);
+
+		// Deleted edges and edges of newly created nodes are reflected as well.
+		Graph_AcquireWriteLock(g);
+		Graph_DeleteEdge(g, &e);
+		Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+		Graph_ConnectNodes(g, 4, 3, r0, &e);
+		Graph_ReleaseLock(g);
+
+		array_clear(edges);
+		Graph_GetNode(g, 3, &n);
+		Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, r0, &edges);
+		ASSERT_EQ(array_len(edges), 4);
+		for(uint i = 0; i < array_len(edges); i++) ASSERT_NE(Edge_GetSrcNodeID(edges + i), 2);
+
+		array_free(edges);
+		Graph_Free(g);
+	}
+
+	config.maintain_transposed_matrices = true;
+}
+
+TEST_F(GraphTest, Reorder) {
+	/* Path 0 - 5 - 2 - 7 - 9 - 4 - 8 - 1 - 6
+	 * with a multi-edge between 0 and 5 and node 3 deleted. */
+	EdgeDesc path[8] = {{0, 5, 0}, {5, 2, 1}, {7, 2, 0}, {7, 9, 0},
+		{9, 4, 1}, {8, 4, 0}, {8, 1, 0}, {1, 6, 1}};
+	ReorderStrategy strategies[3] = {REORDER_BFS, REORDER_DEGREE, REORDER_RCM};
+
+	for(int s = 0; s < 3; s++) {
+		Edge e;
+		Node n;
+		Graph *g = Graph_New(16, 16);
+		Graph_AcquireWriteLock(g);
+		int l = Graph_AddLabel(g);
+		Graph_AddRelationType(g);
+		Graph_AddRelationType(g);
+		for(int i = 0; i < 10; i++) Graph_CreateNode(g, (i % 2) ? l : GRAPH_NO_LABEL, &n);
+		for(int i = 0; i < 8; i++) {
+			Graph_ConnectNodes(g, path[i].srcId, path[i].destId, path[i].relationId, &e);
+		}
+		Graph_ConnectNodes(g, 0, 5, 0, &e);
+		Graph_GetNode(g, 3, &n);
+		Graph_DeleteNode(g, &n);
+
+		NodeID *order = GraphReorder_ComputeOrder(g, strategies[s]);
+		uint64_t count = array_len(order);
+		ASSERT_EQ(count, 9);
+
+		// Order is a permutation of the remaining nodes.
+		NodeID inv[10];
+		int labels[10];
+		for(int i = 0; i < 10; i++) inv[i] = INVALID_ENTITY_ID;
+		for(uint64_t i = 0; i < count; i++) {
+			ASSERT_NE(order[i], 3);
+			ASSERT_EQ(inv[order[i]], INVALID_ENTITY_ID);
+			inv[order[i]] = i;
+			labels[order[i]] = Graph_GetNodeLabel(g, order[i]);
+		}
+
+		Graph_RelabelNodes(g, order, count);
+
+		// Deleted slots are discarded.
+		ASSERT_EQ(Graph_NodeCount(g), 9);
+		ASSERT_EQ(Graph_DeletedNodeCount(g), 0);
+		ASSERT_EQ(Graph_RequiredMatrixDim(g), 9);
+
+		// Labels moved along with their nodes.
+		GrB_Matrix L = Graph_GetLabelMatrix(g, l);
+		for(uint64_t i = 0; i < count; i++) {
+			bool labeled = false;
+			ASSERT_TRUE(Graph_GetNode(g, i, &n));
+			ASSERT_EQ(Graph_GetNodeLabel(g, i), labels[order[i]]);
+			GrB_Info info = GrB_Matrix_extractElement_BOOL(&labeled, L, i, i);
+			ASSERT_EQ(info == GrB_SUCCESS, labels[order[i]] == l);
+		}
+
+		// Connections moved along with their nodes.
+		Edge *edges = (Edge *)array_new(Edge, 2);
+		for(int i = 0; i < 8; i++) {
+			NodeID src = inv[path[i].srcId];
+			NodeID dest = inv[path[i].destId];
+			array_clear(edges);
+			Graph_GetEdgesConnectingNodes(g, src, dest, path[i].relationId, &edges);
+			ASSERT_EQ(array_len(edges), (i == 0) ? 2 : 1);
+
+			// Search based orders place path neighbors next to one another.
+			if(strategies[s] != REORDER_DEGREE) {
+				ASSERT_EQ((src > dest) ? src - dest : dest - src, 1);
+			}
+		}
+
+		array_clear(edges);
+		Graph_GetNode(g, inv[2], &n);
+		Graph_GetNodeEdges(g, &n, GRAPH_EDGE_DIR_INCOMING, GRAPH_NO_RELATION, &edges);
+		ASSERT_EQ(array_len(edges), 2);
+
+		array_free(edges);
+		array_free(order);
+		Graph_ReleaseLock(g);
+		Graph_Free(g);
+	}
+}
+
 TEST_F(GraphTest, GetEdge) {
 	/* Create a graph with both nodes and edges.
 	 * Make sure edge retrival works as expected:
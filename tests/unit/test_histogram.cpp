@@ -0,0 +1,142 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../src/util/histogram.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class HistogramTest: public ::testing::Test {
+  protected:
+	Histogram h;
+
+	void SetUp() {
+		memset(&h, 0, sizeof(Histogram));
+	}
+
+	static int _CompareValues(const void *a, const void *b) {
+		uint64_t x = *(const uint64_t *)a;
+		uint64_t y = *(const uint64_t *)b;
+		return (x > y) - (x < y);
+	}
+};
+
+TEST_F(HistogramTest, Empty) {
+	ASSERT_EQ(Histogram_Count(&h), 0);
+	ASSERT_EQ(Histogram_Mean(&h), 0);
+	ASSERT_EQ(Histogram_Max(&h), 0);
+	ASSERT_EQ(Histogram_Percentile(&h, 50), 0);
+	ASSERT_EQ(Histogram_Percentile(&h, 100), 0);
+}
+
+TEST_F(HistogramTest, SmallValuesAreExact) {
+	// Values smaller than the number of sub buckets have buckets of their own.
+	for(uint64_t i = 0; i < HISTOGRAM_SUB_BUCKETS; i++) Histogram_Record(&h, i);
+
+	ASSERT_EQ(Histogram_Count(&h), HISTOGRAM_SUB_BUCKETS);
+	ASSERT_EQ(Histogram_Max(&h), HISTOGRAM_SUB_BUCKETS - 1);
+	for(uint64_t i = 0; i < HISTOGRAM_SUB_BUCKETS; i++) {
+		double p = (i + 1) * 100.0 / HISTOGRAM_SUB_BUCKETS;
+		ASSERT_EQ(Histogram_Percentile(&h, p), i);
+	}
+}
+
+TEST_F(HistogramTest, Percentiles) {
+	for(uint64_t i = 1; i <= 1000; i++) Histogram_Record(&h, i);
+
+	ASSERT_EQ(Histogram_Count(&h), 1000);
+	ASSERT_EQ(Histogram_Max(&h), 1000);
+	ASSERT_DOUBLE_EQ(Histogram_Mean(&h), 500.5);
+
+	// Reported percentiles are upper bounds, within the histogram's relative error.
+	double percentiles[4] = {50, 90, 99, 99.9};
+	for(int i = 0; i < 4; i++) {
+		uint64_t expected = percentiles[i] * 10;
+		uint64_t actual = Histogram_Percentile(&h, percentiles[i]);
+		ASSERT_GE(actual, expected);
+		ASSERT_LE(actual, expected + expected / HISTOGRAM_SUB_BUCKETS);
+	}
+
+	// Percentiles never exceed the largest recorded value.
+	ASSERT_EQ(Histogram_Percentile(&h, 100), 1000);
+}
+
+TEST_F(HistogramTest, Accuracy) {
+	// Values spread over several orders of magnitude, e.g. microsecond latencies.
+	const int count = 10000;
+	uint64_t *values = (uint64_t *)malloc(sizeof(uint64_t) * count);
+	uint64_t x = 88172645463325252ULL;
+	for(int i = 0; i < count; i++) {
+		// xorshift, values between 1 and 2^30.
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		values[i] = (x >> (34 + x % 30)) + 1;
+		Histogram_Record(&h, values[i]);
+	}
+	qsort(values, count, sizeof(uint64_t), _CompareValues);
+
+	// Reported percentiles are within ~3% of the exact ones.
+	double percentiles[7] = {1, 10, 50, 90, 99, 99.9, 99.99};
+	for(int i = 0; i < 7; i++) {
+		uint64_t rank = (uint64_t)ceil(percentiles[i] / 100.0 * count);
+		uint64_t exact = values[rank - 1];
+		uint64_t actual = Histogram_Percentile(&h, percentiles[i]);
+		ASSERT_GE(actual, exact);
+		ASSERT_LE((double)(actual - exact), exact * 0.032);
+	}
+
+	free(values);
+}
+
+TEST_F(HistogramTest, Clamp) {
+	Histogram_Record(&h, UINT64_MAX);
+	ASSERT_EQ(Histogram_Count(&h), 1);
+	ASSERT_EQ(Histogram_Max(&h), HISTOGRAM_MAX_VALUE);
+	ASSERT_EQ(Histogram_Percentile(&h, 100), HISTOGRAM_MAX_VALUE);
+}
+
+TEST_F(HistogramTest, Merge) {
+	Histogram other;
+	memset(&other, 0, sizeof(Histogram));
+	for(uint64_t i = 1; i <= 100; i++) Histogram_Record(&h, i);
+	for(uint64_t i = 101; i <= 200; i++) Histogram_Record(&other, i);
+
+	Histogram merged;
+	memset(&merged, 0, sizeof(Histogram));
+	Histogram_Merge(&merged, &h);
+	Histogram_Merge(&merged, &other);
+
+	ASSERT_EQ(Histogram_Count(&merged), 200);
+	ASSERT_EQ(Histogram_Max(&merged), 200);
+	ASSERT_DOUBLE_EQ(Histogram_Mean(&merged), 100.5);
+	uint64_t median = Histogram_Percentile(&merged, 50);
+	ASSERT_GE(median, 100);
+	ASSERT_LE(median, 125);
+}
+
+TEST_F(HistogramTest, Reset) {
+	for(uint64_t i = 1; i <= 100; i++) Histogram_Record(&h, i);
+	Histogram_Reset(&h);
+
+	ASSERT_EQ(Histogram_Count(&h), 0);
+	ASSERT_EQ(Histogram_Max(&h), 0);
+	ASSERT_EQ(Histogram_Percentile(&h, 99), 0);
+
+	Histogram_Record(&h, 7);
+	ASSERT_EQ(Histogram_Count(&h), 1);
+	ASSERT_EQ(Histogram_Percentile(&h, 50), 7);
+}
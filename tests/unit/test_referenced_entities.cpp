@@ -451,3 +451,42 @@ TEST_F(TestReferencedEntities, TestNamedPath) {
 
 }
 
+TEST_F(TestReferencedEntities, TestMaterializedEntities) {
+	// Entities only traversed are not materialized.
+	char *q = "MATCH (n)-[e]->(m) RETURN count(*) AS c";
+	AST *ast = buildAST(q);
+	uint *segmentIndices = getASTSegmentIndices(ast);
+	AST *astSegment = AST_NewSegment(ast, 0, segmentIndices[0]);
+	ASSERT_FALSE(AST_AliasRequiresMaterialization(astSegment, "n"));
+	ASSERT_FALSE(AST_AliasRequiresMaterialization(astSegment, "m"));
+	AST_Free(astSegment);
+
+	// Entities passed to id() are referenced but not materialized.
+	q = "MATCH (n)-[e]->(m) RETURN id(m) AS i, labels(n) AS l";
+	ast = buildAST(q);
+	segmentIndices = getASTSegmentIndices(ast);
+	astSegment = AST_NewSegment(ast, 0, segmentIndices[0]);
+	ASSERT_TRUE(AST_AliasIsReferenced(astSegment, "m"));
+	ASSERT_FALSE(AST_AliasRequiresMaterialization(astSegment, "n"));
+	ASSERT_FALSE(AST_AliasRequiresMaterialization(astSegment, "m"));
+	AST_Free(astSegment);
+
+	// Attribute access, inline filters and projected entities are materialized.
+	q = "MATCH (n {v: 1})-[e]->(m)-[]->(x) WHERE m.v > id(x) RETURN n, m.v AS v";
+	ast = buildAST(q);
+	segmentIndices = getASTSegmentIndices(ast);
+	astSegment = AST_NewSegment(ast, 0, segmentIndices[0]);
+	ASSERT_TRUE(AST_AliasRequiresMaterialization(astSegment, "n"));
+	ASSERT_TRUE(AST_AliasRequiresMaterialization(astSegment, "m"));
+	ASSERT_FALSE(AST_AliasRequiresMaterialization(astSegment, "x"));
+	AST_Free(astSegment);
+
+	// Modified entities are materialized.
+	q = "MATCH (n)-[e]->(m) SET n.v = 1 DELETE m";
+	ast = buildAST(q);
+	segmentIndices = getASTSegmentIndices(ast);
+	astSegment = AST_NewSegment(ast, 0, segmentIndices[0]);
+	ASSERT_TRUE(AST_AliasRequiresMaterialization(astSegment, "n"));
+	ASSERT_TRUE(AST_AliasRequiresMaterialization(astSegment, "m"));
+	AST_Free(astSegment);
+}
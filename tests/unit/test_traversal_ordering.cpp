@@ -40,8 +40,7 @@ class TraversalOrderingTest: public ::testing::Test {
 		 * accessible via thread local storage, as such we're creating a
 		 * fake graph context and placing it within thread local storage. */
 		GraphContext *gc = (GraphContext *)calloc(1, sizeof(GraphContext));
-		gc->attributes = raxNew();
-		pthread_rwlock_init(&gc->_attribute_rwlock, NULL);
+		gc->attributes = AttributeMap_New(64);
 
 		// Prepare thread-local variables
 		ASSERT_TRUE(QueryCtx_Init());
@@ -205,6 +205,87 @@ TEST_F(ValueTest, TestArray) {
 	ASSERT_EQ(origHashCode, otherHashCode);
 }
 
+TEST_F(ValueTest, TestSharedValues) {
+	// Cloning a string produces a ref-counted copy.
+	SIValue str = SI_DuplicateStringVal("shared");
+	SIValue clone = SI_CloneValue(str);
+	ASSERT_EQ(clone.allocation, M_SHARED);
+	ASSERT_NE(clone.stringval, str.stringval);
+	ASSERT_STREQ(clone.stringval, "shared");
+	ASSERT_EQ(SI_RefCount(clone.stringval), 1);
+	SIValue_Free(str);
+
+	// Further clones share the allocation.
+	SIValue other = SI_CloneValue(clone);
+	ASSERT_EQ(other.stringval, clone.stringval);
+	ASSERT_EQ(SI_RefCount(clone.stringval), 2);
+
+	// Persisting a volatile view adds a reference.
+	SIValue view = SI_ShareValue(clone);
+	ASSERT_EQ(view.allocation, M_SHARED | M_VOLATILE);
+	SIValue_Free(view); // No-op, view doesn't hold a reference.
+	ASSERT_EQ(SI_RefCount(clone.stringval), 2);
+	SIValue_Persist(&view);
+	ASSERT_EQ(view.allocation, M_SHARED);
+	ASSERT_EQ(view.stringval, clone.stringval);
+	ASSERT_EQ(SI_RefCount(clone.stringval), 3);
+
+	SIValue_Free(view);
+	SIValue_Free(other);
+	ASSERT_EQ(SI_RefCount(clone.stringval), 1);
+	SIValue_Free(clone);
+
+	// Arrays.
+	SIValue arr = SI_EmptyArray();
+	SIArray_Append(&arr, SI_LongVal(1));
+	SIArray_Append(&arr, SI_ConstStringVal((char *)"element"));
+
+	SIValue arrClone = SI_CloneValue(arr);
+	ASSERT_EQ(arrClone.allocation, M_SHARED);
+	ASSERT_EQ(SIArray_Length(arrClone), 2);
+	ASSERT_EQ(SIValue_HashCode(arr), SIValue_HashCode(arrClone));
+	SIValue_Free(arr);
+
+	SIValue arrOther = SI_CloneValue(arrClone);
+	ASSERT_EQ(arrOther.array, arrClone.array);
+	SIValue elem = SIArray_Get(arrOther, 1);
+	ASSERT_STREQ(elem.stringval, "element");
+
+	SIValue_Free(arrClone);
+	ASSERT_EQ(SIArray_Get(arrOther, 0).longval, 1);
+	SIValue_Free(arrOther);
+}
+
+TEST_F(ValueTest, TestConstSharedValues) {
+	// Property values are accessed as constants, e.g. n.name.
+	SIValue prop = SI_SharedStringVal("property");
+	SIValue view = SI_ConstValue(prop);
+	ASSERT_EQ(view.allocation, M_SHARED | M_CONST);
+	SIValue_Free(view); // No-op, view doesn't hold a reference.
+	ASSERT_EQ(SI_RefCount(prop.stringval), 1);
+
+	// Cloning a constant view adds a reference rather than copying the string.
+	SIValue clone = SI_CloneValue(view);
+	ASSERT_EQ(clone.allocation, M_SHARED);
+	ASSERT_EQ(clone.stringval, prop.stringval);
+	ASSERT_EQ(SI_RefCount(prop.stringval), 2);
+
+	// Persisting a constant view is a no-op.
+	SIValue_Persist(&view);
+	ASSERT_EQ(view.allocation, M_SHARED | M_CONST);
+	ASSERT_EQ(SI_RefCount(prop.stringval), 2);
+
+	SIValue_Free(clone);
+	ASSERT_EQ(SI_RefCount(prop.stringval), 1);
+	SIValue_Free(prop);
+
+	// Non ref-counted allocations are merely borrowed.
+	SIValue str = SI_DuplicateStringVal("owned");
+	view = SI_ConstValue(str);
+	ASSERT_EQ(view.allocation, M_CONST);
+	SIValue_Free(str);
+}
+
 /* Test for difference in hash code for the same binary representation
  * for different types. The value boolean "true" and the integer value "1"
  * have the same binary representation. Given that, their types are different,